@@ -18,9 +18,11 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "../util/connection_string_keys.h"
 #include "../util/rds_strings.h"
+#include "../util/sql_lexer.h"
 
 struct DBC;
 class OdbcHelper;
@@ -47,12 +49,23 @@ public:
     virtual int GetDefaultPort() { return 0; }
     virtual std::string GetWriterIdColumnName() { return ""; };
     virtual std::string GetTopologyQuery() { return ""; };
+    // Topology rows each followed by the id and role of the connected instance, so one round trip returns both.
+    // Empty when the dialect needs separate queries.
+    virtual std::string GetTopologyAndIdentityQuery() { return ""; };
     virtual std::string GetWriterIdQuery() { return ""; };
     virtual std::string GetReplicaSourceQuery() { return ""; };
     virtual std::string GetNodeIdQuery() { return ""; };
     virtual std::string GetIsReaderQuery() { return ""; };
     virtual std::string GetSetReadOnlyQuery() { return ""; };
     virtual std::string GetSetReadWriteQuery() { return ""; };
+    // Discards session state before a pooled connection is handed to another user
+    virtual std::string GetResetSessionQuery() { return ""; };
+    // Single row with the session's value of each variable, NULL where the variable is not set
+    virtual std::string GetSessionVariablesQuery(const std::vector<std::string>& variables) { return ""; };
+    // Holds the isolation level set by SET SESSION ... ISOLATION LEVEL
+    virtual std::string GetIsolationLevelVariable() { return ""; };
+    // A backslash escapes the next character in every string literal, not only in E'...' strings
+    virtual bool UsesBackslashEscapes() { return false; };
     virtual DatabaseDialectType GetUpdateCandidate() { return UNKNOWN_DIALECT; };
 
     virtual bool IsSqlStateAccessError(const char* sql_state) { return false; };
@@ -64,7 +77,15 @@ public:
     virtual DatabaseDialectType GetDialectType() { return DatabaseDialectType::UNKNOWN_DIALECT; };
     virtual bool IsDialect(DBC* dbc, std::shared_ptr<OdbcHelper> odbc_helper) { return true; };
 
-    virtual std::optional<bool> DoesStatementSetReadOnly(std::string statement) { return {}; };
+    virtual std::optional<bool> DoesStatementSetReadOnly(const SqlStatementHead& statement) {
+        if (statement.StartsWith(GetSetReadOnlyQuery())) {
+            return true;
+        }
+        if (statement.StartsWith(GetSetReadWriteQuery())) {
+            return false;
+        }
+        return {};
+    };
 
     static DatabaseDialectType DatabaseDialectFromString(const std::string &database_dialect) {
         std::string local_str = database_dialect;
@@ -28,6 +28,7 @@ class DialectAuroraMySql : virtual public Dialect, DialectBlueGreen {
 public:
     int GetDefaultPort() override { return DEFAULT_MYSQL_PORT; };
     std::string GetTopologyQuery() override { return TOPOLOGY_QUERY; };
+    std::string GetTopologyAndIdentityQuery() override { return TOPOLOGY_AND_IDENTITY_QUERY; };
     std::string GetWriterIdQuery() override { return WRITER_ID_QUERY; };
     std::string GetNodeIdQuery() override { return NODE_ID_QUERY; };
     std::string GetIsReaderQuery() override { return IS_READER_QUERY; };
@@ -35,6 +36,15 @@ public:
     std::string GetBlueGreenStatusQuery() override { return BG_STATUS_QUERY; };
     std::string GetSetReadOnlyQuery() override { return SET_READ_ONLY_QUERY; };
     std::string GetSetReadWriteQuery() override { return SET_READ_WRITE_QUERY; };
+    std::string GetSessionVariablesQuery(const std::vector<std::string>& variables) override {
+        std::string query = "SELECT ";
+        for (size_t i = 0; i < variables.size(); i++) {
+            query += (i == 0 ? "" : ", ") + std::string("@@SESSION.") + variables[i];
+        }
+        return query;
+    };
+    std::string GetIsolationLevelVariable() override { return "transaction_isolation"; };
+    bool UsesBackslashEscapes() override { return true; };
     DatabaseDialectType GetUpdateCandidate() override { return MULTI_AZ_MYSQL; };
 
     bool IsSqlStateAccessError(const char* sql_state) override {
@@ -53,17 +63,6 @@ public:
 
     DatabaseDialectType GetDialectType() override { return DatabaseDialectType::AURORA_MYSQL; };
 
-protected:
-    std::optional<bool> DoesStatementSetReadOnly(std::string statement) override {
-        if (statement.starts_with(SET_READ_ONLY_QUERY)) {
-            return true;
-        }
-        if (statement.starts_with(SET_READ_WRITE_QUERY)) {
-            return false;
-        }
-        return {};
-    }
-
 private:
     const int DEFAULT_MYSQL_PORT = 3306;
     const std::string TOPOLOGY_QUERY =
@@ -72,6 +71,13 @@ private:
         FROM information_schema.replica_host_status \
         WHERE time_to_sec(timediff(now(), LAST_UPDATE_TIMESTAMP)) <= 300 OR SESSION_ID = 'MASTER_SESSION_ID'";
 
+    // TOPOLOGY_QUERY followed by NODE_ID_QUERY and IS_READER_QUERY
+    const std::string TOPOLOGY_AND_IDENTITY_QUERY =
+        "SELECT SERVER_ID, CASE WHEN SESSION_ID = 'MASTER_SESSION_ID' THEN TRUE ELSE FALSE END, \
+        CPU, REPLICA_LAG_IN_MILLISECONDS, @@aurora_server_id, @@innodb_read_only \
+        FROM information_schema.replica_host_status \
+        WHERE time_to_sec(timediff(now(), LAST_UPDATE_TIMESTAMP)) <= 300 OR SESSION_ID = 'MASTER_SESSION_ID'";
+
     const std::string WRITER_ID_QUERY =
         "SELECT SERVER_ID FROM information_schema.replica_host_status \
         WHERE SESSION_ID = 'MASTER_SESSION_ID' AND SERVER_ID = @@aurora_server_id";
@@ -118,6 +124,8 @@ public:
     std::string GetReplicaSourceQuery() override { return REPLICA_SOURCE_QUERY; };
     std::string GetIsReaderQuery() override { return IS_READER_QUERY; };
     std::string GetTopologyQuery() override { return TOPOLOGY_QUERY; };
+    // The writer is only known from SHOW REPLICA STATUS, which cannot be combined with the topology
+    std::string GetTopologyAndIdentityQuery() override { return ""; };
     std::string GetNodeIdQuery() override { return NODE_ID_QUERY; };
     DatabaseDialectType GetUpdateCandidate() override { return UNKNOWN_DIALECT; };
 
@@ -28,6 +28,7 @@ class DialectAuroraPostgres : virtual public Dialect, DialectBlueGreen {
 public:
     int GetDefaultPort() override { return DEFAULT_POSTGRES_PORT; };
     std::string GetTopologyQuery() override { return TOPOLOGY_QUERY; };
+    std::string GetTopologyAndIdentityQuery() override { return TOPOLOGY_AND_IDENTITY_QUERY; };
     std::string GetWriterIdQuery() override { return WRITER_ID_QUERY; };
     std::string GetNodeIdQuery() override { return NODE_ID_QUERY; };
     std::string GetIsReaderQuery() override { return IS_READER_QUERY; };
@@ -35,6 +36,16 @@ public:
     std::string GetBlueGreenStatusQuery() override { return BG_STATUS_QUERY; };
     std::string GetSetReadOnlyQuery() override { return SET_READ_ONLY_QUERY; };
     std::string GetSetReadWriteQuery() override { return SET_READ_WRITE_QUERY; };
+    std::string GetResetSessionQuery() override { return RESET_SESSION_QUERY; };
+    std::string GetSessionVariablesQuery(const std::vector<std::string>& variables) override {
+        std::string query = "SELECT ";
+        for (size_t i = 0; i < variables.size(); i++) {
+            // missing_ok, an unknown custom variable returns NULL instead of failing the query
+            query += (i == 0 ? "" : ", ") + std::string("pg_catalog.current_setting('") + variables[i] + "', true)";
+        }
+        return query;
+    };
+    std::string GetIsolationLevelVariable() override { return "default_transaction_isolation"; };
     DatabaseDialectType GetUpdateCandidate() override { return MULTI_AZ_PG; };
 
     bool IsSqlStateAccessError(const char* sql_state) override {
@@ -68,16 +79,6 @@ public:
 
     virtual DatabaseDialectType GetDialectType() override { return DatabaseDialectType::AURORA_POSTGRESQL; };
 
-    std::optional<bool> DoesStatementSetReadOnly(std::string statement) override {
-        if (statement.starts_with(SET_READ_ONLY_QUERY)) {
-            return true;
-        }
-        if (statement.starts_with(SET_READ_WRITE_QUERY)) {
-            return false;
-        }
-        return {};
-    }
-
 private:
     const int DEFAULT_POSTGRES_PORT = 5432;
     const std::string TOPOLOGY_QUERY =
@@ -87,6 +88,14 @@ private:
         WHERE EXTRACT(EPOCH FROM(pg_catalog.NOW() operator(pg_catalog.-) LAST_UPDATE_TIMESTAMP)) operator(pg_catalog.<=) 300 OR SESSION_ID operator(pg_catalog.=) 'MASTER_SESSION_ID' \
         OR LAST_UPDATE_TIMESTAMP IS NULL";
 
+    // TOPOLOGY_QUERY followed by NODE_ID_QUERY and IS_READER_QUERY
+    const std::string TOPOLOGY_AND_IDENTITY_QUERY =
+        "SELECT SERVER_ID, CASE WHEN SESSION_ID operator(pg_catalog.=) 'MASTER_SESSION_ID' THEN TRUE ELSE FALSE END, \
+        CPU, COALESCE(REPLICA_LAG_IN_MSEC, 0), pg_catalog.aurora_db_instance_identifier(), pg_catalog.pg_is_in_recovery() \
+        FROM pg_catalog.aurora_replica_status() \
+        WHERE EXTRACT(EPOCH FROM(pg_catalog.NOW() operator(pg_catalog.-) LAST_UPDATE_TIMESTAMP)) operator(pg_catalog.<=) 300 OR SESSION_ID operator(pg_catalog.=) 'MASTER_SESSION_ID' \
+        OR LAST_UPDATE_TIMESTAMP IS NULL";
+
     const std::string WRITER_ID_QUERY =
         "SELECT SERVER_ID FROM pg_catalog.aurora_replica_status() WHERE SESSION_ID operator(pg_catalog.=) 'MASTER_SESSION_ID' \
         AND SERVER_ID operator(pg_catalog.=) pg_catalog.aurora_db_instance_identifier()";
@@ -106,6 +115,8 @@ private:
 
     const std::string SET_READ_WRITE_QUERY = "SET SESSION CHARACTERISTICS AS TRANSACTION READ WRITE";
 
+    const std::string RESET_SESSION_QUERY = "DISCARD ALL";
+
     const std::vector<std::string> ACCESS_ERRORS = {
         "28P01",
         "28000"   // PAM authentication errors
@@ -139,6 +150,7 @@ public:
     std::string GetWriterIdColumnName() override { return WRITER_ID_QUERY_COLUMN_NAME; };
     std::string GetReplicaSourceQuery() override { return REPLICA_SOURCE_QUERY; };
     std::string GetTopologyQuery() override { return TOPOLOGY_QUERY; };
+    std::string GetTopologyAndIdentityQuery() override { return TOPOLOGY_AND_IDENTITY_QUERY; };
     std::string GetNodeIdQuery() override { return NODE_ID_QUERY; };
     DatabaseDialectType GetUpdateCandidate() override { return UNKNOWN_DIALECT; };
 
@@ -166,6 +178,12 @@ public:
 private:
     const std::string IS_RDS_CLUSTER_QUERY = "SELECT multi_az_db_cluster_source_dbi_resource_id FROM rds_tools.multi_az_db_cluster_source_dbi_resource_id()";
     const std::string TOPOLOGY_QUERY = "SELECT id, endpoint, port FROM rds_tools.show_topology()";
+    // TOPOLOGY_QUERY followed by the id of the connected instance and the id of the writer,
+    // the replica source is empty when connected to the writer
+    const std::string TOPOLOGY_AND_IDENTITY_QUERY = "SELECT id, endpoint, port, self_id, " \
+        "COALESCE((SELECT multi_az_db_cluster_source_dbi_resource_id FROM rds_tools.multi_az_db_cluster_source_dbi_resource_id() " \
+        "WHERE multi_az_db_cluster_source_dbi_resource_id OPERATOR(pg_catalog.!=) self_id), self_id) " \
+        "FROM rds_tools.show_topology(), (SELECT dbi_resource_id AS self_id FROM rds_tools.dbi_resource_id()) AS self";
     const std::string NODE_ID_QUERY = "SELECT id, SUBSTRING(endpoint FROM 0 FOR POSITION('.' IN endpoint)) FROM rds_tools.show_topology() WHERE id OPERATOR(pg_catalog.=) rds_tools.dbi_resource_id()";
     const std::string REPLICA_SOURCE_QUERY = "SELECT multi_az_db_cluster_source_dbi_resource_id FROM rds_tools.multi_az_db_cluster_source_dbi_resource_id() " \
         "WHERE multi_az_db_cluster_source_dbi_resource_id OPERATOR(pg_catalog.!=) " \
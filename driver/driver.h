@@ -56,15 +56,18 @@
 #include <sql.h>
 
 #include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <vector>
 
 #include "error.h"
+#include "util/session_state_tracker.h"
 
 /* Forward Declarations */
 struct ENV;
@@ -77,6 +80,7 @@ struct RdsLibResult;
 class BasePlugin;
 class RdsLibLoader;
 class LoggerWrapper;
+class MonitoringQuerySession;
 class PluginService;
 
 /* Const Lengths */
@@ -122,6 +126,20 @@ struct DBC {
 
     // TODO - May need to change SQLPOINTER to an actual object
     std::map<SQLINTEGER, std::pair<SQLPOINTER, SQLINTEGER>> attr_map;  // Key, <Value, Length>
+    // Session state set through attributes and SQL, replayed when the underlying connection changes
+    SessionStateTracker session_state;
+    // Last time the underlying connection completed a call, it is not probed again within validation_freshness
+    std::atomic<std::chrono::steady_clock::time_point> last_activity{};
+    std::chrono::milliseconds validation_freshness{0};
+    // Set while a plugin reconnects on the application's behalf, only these connects may reuse a pooled connection
+    bool internal_reconnect = false;
+    // Key the underlying connection is pooled under, derived from the connection attributes it was opened with
+    std::string pool_key;
+    // Incremented when the underlying connection is opened, replaced or closed.
+    // The base driver may hand out the same handle again, so the handle alone does not identify a connection.
+    std::atomic<uint64_t> connection_generation{0};
+    // Prepared statements of a monitoring connection, released before it disconnects
+    std::shared_ptr<MonitoringQuerySession> monitoring_session;
 
     // Connection Information, i.e. Server, Port, UID, Pass, Plugin Info, etc
     std::map<std::string, std::string> conn_attr;  // Key, Value
@@ -162,6 +180,26 @@ struct BoundParamBuffer {
     std::shared_ptr<SQLLEN> local_str_len = std::make_shared<SQLLEN>(0);
 };
 
+// SQLBindParameter arguments as passed to the underlying driver
+struct ParamBinding {
+    SQLSMALLINT             input_output_type;
+    SQLSMALLINT             value_type;
+    SQLSMALLINT             param_type;
+    SQLULEN                 column_size;
+    SQLSMALLINT             decimal_digits;
+    SQLPOINTER              value_ptr;
+    SQLLEN                  buffer_length;
+    SQLLEN*                 str_len_or_ind_ptr;
+};
+
+// SQLBindCol arguments as passed to the underlying driver
+struct ColBinding {
+    SQLSMALLINT             target_type;
+    SQLPOINTER              target_value_ptr;
+    SQLLEN                  buffer_length;
+    SQLLEN*                 str_len_or_ind_ptr;
+};
+
 struct STMT {
     // TODO - Do we need lock?
     std::recursive_mutex lock;
@@ -177,6 +215,11 @@ struct STMT {
     std::map<SQLINTEGER, std::pair<SQLPOINTER, SQLINTEGER>> attr_map;  // Key, <Value, Length>
     std::string cursor_name;
 
+    // Restored on a new underlying statement after failover or a read/write splitting switch
+    std::optional<std::string> prepared_query;
+    std::map<SQLUSMALLINT, ParamBinding> param_bindings;
+    std::map<SQLUSMALLINT, ColBinding> col_bindings;
+
     // Buffers for UTF32 support
     std::vector<BoundColBuffer> bound_col_buffers;      // Intercepted WCHAR column bindings
     std::vector<BoundParamBuffer> bound_param_buffers;  // Intercepted WCHAR param bindings
@@ -0,0 +1,123 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "host_health_registry.h"
+
+#include <algorithm>
+
+#include "util/logger_wrapper.h"
+
+HostHealthRegistry::HostHealthRegistry(
+    const int failure_threshold,
+    const std::chrono::milliseconds base_backoff_ms,
+    const std::chrono::milliseconds max_backoff_ms)
+    : failure_threshold_{ std::max(failure_threshold, 1) },
+      base_backoff_ms_{ std::max(base_backoff_ms, std::chrono::milliseconds(1)) },
+      max_backoff_ms_{ std::max(max_backoff_ms, base_backoff_ms_) } {}
+
+HostHealthRegistry& HostHealthRegistry::Global() {
+    // Never destroyed, selections may still happen on threads outliving static destruction
+    static HostHealthRegistry* registry = new HostHealthRegistry();
+    return *registry;
+}
+
+void HostHealthRegistry::RecordSuccess(const std::string& host, const std::chrono::milliseconds latency_ms) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    HostHealth& health = hosts_[host];
+    if (health.state != CIRCUIT_CLOSED) {
+        LOG(INFO) << "Closing circuit of host: " << host;
+        tripped_count_--;
+    }
+    health.state = CIRCUIT_CLOSED;
+    health.consecutive_failures = 0;
+    health.backoff_ms = std::chrono::milliseconds(0);
+    health.latency_ms = health.latency_ms.count() == 0 ? latency_ms : (health.latency_ms * 3 + latency_ms) / 4;
+}
+
+void HostHealthRegistry::RecordFailure(const std::string& host) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    HostHealth& health = hosts_[host];
+    RecordFailureLocked(host, health, false);
+}
+
+void HostHealthRegistry::OpenCircuit(const std::string& host) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    HostHealth& health = hosts_[host];
+    RecordFailureLocked(host, health, true);
+}
+
+void HostHealthRegistry::RecordFailureLocked(const std::string& host, HostHealth& health, const bool open_circuit) {
+    health.consecutive_failures++;
+    switch (health.state) {
+        case CIRCUIT_CLOSED:
+            if (open_circuit || health.consecutive_failures >= failure_threshold_) {
+                tripped_count_++;
+                OpenLocked(health, base_backoff_ms_);
+                LOG(INFO) << "Opening circuit of host: " << host << " for " << health.backoff_ms.count() << "ms";
+            }
+            break;
+        case CIRCUIT_HALF_OPEN:
+            OpenLocked(health, std::min(health.backoff_ms * 2, max_backoff_ms_));
+            LOG(INFO) << "Probe of host failed, reopening its circuit: " << host << " for " << health.backoff_ms.count() << "ms";
+            break;
+        case CIRCUIT_OPEN:
+            // Already skipped, i.e. an attempt that started before the circuit opened
+            break;
+    }
+}
+
+bool HostHealthRegistry::IsAvailable(const std::string& host) {
+    if (tripped_count_.load() == 0) {
+        return true;
+    }
+
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    const auto itr = hosts_.find(host);
+    return itr == hosts_.end() || itr->second.state == CIRCUIT_CLOSED
+        || std::chrono::steady_clock::now() >= itr->second.retry_at;
+}
+
+bool HostHealthRegistry::TryAdmitProbe(const std::string& host) {
+    if (tripped_count_.load() == 0) {
+        return true;
+    }
+
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    const auto itr = hosts_.find(host);
+    if (itr == hosts_.end() || itr->second.state == CIRCUIT_CLOSED) {
+        return true;
+    }
+
+    HostHealth& health = itr->second;
+    const auto now = std::chrono::steady_clock::now();
+    if (now < health.retry_at) {
+        return false;
+    }
+    // The probe holds the host for one more backoff, an abandoned probe does not block it for good
+    health.state = CIRCUIT_HALF_OPEN;
+    health.retry_at = now + health.backoff_ms;
+    return true;
+}
+
+HostHealth HostHealthRegistry::GetHealth(const std::string& host) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    const auto itr = hosts_.find(host);
+    return itr == hosts_.end() ? HostHealth{} : itr->second;
+}
+
+void HostHealthRegistry::OpenLocked(HostHealth& health, const std::chrono::milliseconds backoff_ms) {
+    health.state = CIRCUIT_OPEN;
+    health.backoff_ms = backoff_ms;
+    health.retry_at = std::chrono::steady_clock::now() + backoff_ms;
+}
@@ -0,0 +1,85 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HOST_HEALTH_REGISTRY_H_
+#define HOST_HEALTH_REGISTRY_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+typedef enum {
+    CIRCUIT_CLOSED,
+    CIRCUIT_OPEN,
+    CIRCUIT_HALF_OPEN
+} CIRCUIT_STATE;
+
+struct HostHealth {
+    CIRCUIT_STATE state = CIRCUIT_CLOSED;
+    int consecutive_failures = 0;
+    // Doubled each time a probe fails, reset once the host succeeds again
+    std::chrono::milliseconds backoff_ms{0};
+    std::chrono::steady_clock::time_point retry_at;
+    // Moving average of successful connects, zero until the first one
+    std::chrono::milliseconds latency_ms{0};
+};
+
+// Process-wide record of connection outcomes per host, shared by every connection and host selector.
+// A host failing repeatedly has its circuit opened and is skipped until its backoff has passed,
+// then a single probe is let through. The probe's outcome closes the circuit or opens it again
+// with a longer backoff.
+class HostHealthRegistry {
+public:
+    static constexpr int DEFAULT_FAILURE_THRESHOLD = 2;
+    static constexpr std::chrono::milliseconds DEFAULT_BASE_BACKOFF_MS = std::chrono::seconds(1);
+    static constexpr std::chrono::milliseconds DEFAULT_MAX_BACKOFF_MS = std::chrono::seconds(60);
+
+    explicit HostHealthRegistry(
+        int failure_threshold = DEFAULT_FAILURE_THRESHOLD,
+        std::chrono::milliseconds base_backoff_ms = DEFAULT_BASE_BACKOFF_MS,
+        std::chrono::milliseconds max_backoff_ms = DEFAULT_MAX_BACKOFF_MS);
+
+    static HostHealthRegistry& Global();
+
+    void RecordSuccess(const std::string& host, std::chrono::milliseconds latency_ms);
+    void RecordFailure(const std::string& host);
+    // Opens the circuit without waiting for the failure threshold, for failures that already
+    // show the host is unreachable such as a network error on an established connection
+    void OpenCircuit(const std::string& host);
+    // False while the host's circuit is open and its backoff has not passed, or while a probe
+    // is in progress. Does not change the circuit, hosts can be filtered without admitting a probe.
+    bool IsAvailable(const std::string& host);
+    // To be called for the host actually selected. Once the backoff has passed the first caller
+    // is admitted as the probe, others are turned away for another backoff unless an outcome
+    // is recorded first. Always true for a host with a closed circuit.
+    bool TryAdmitProbe(const std::string& host);
+    HostHealth GetHealth(const std::string& host);
+
+private:
+    void RecordFailureLocked(const std::string& host, HostHealth& health, bool open_circuit);
+    void OpenLocked(HostHealth& health, std::chrono::milliseconds backoff_ms);
+
+    const int failure_threshold_;
+    const std::chrono::milliseconds base_backoff_ms_;
+    const std::chrono::milliseconds max_backoff_ms_;
+
+    std::mutex lock_;
+    std::unordered_map<std::string, HostHealth> hosts_;
+    // Hosts with a circuit that is not closed, lets selections skip the lock while all hosts are healthy
+    std::atomic<size_t> tripped_count_ = 0;
+};
+
+#endif // HOST_HEALTH_REGISTRY_H_
@@ -14,18 +14,21 @@
 
 #include "host_info.h"
 
-HostInfo::HostInfo(std::string host, int port, HOST_STATE state, HOST_ROLE role, uint64_t weight, std::chrono::steady_clock::time_point last_update) :
-    host_ { std::move(host) },
-    port_ { port },
-    state_ { state },
-    role_ { role },
+HostInfo::HostInfo(const std::string& host, int port, HOST_STATE state, HOST_ROLE role, uint64_t weight, std::chrono::steady_clock::time_point last_update) :
+    id_ { HostRegistry::Intern(host, port) },
     weight_ { weight },
+    role_ { role },
+    state_ { state },
     last_update_ {last_update}
-{
-    auto idx = host_.find('.');
-    if (idx != std::string::npos) {
-        host_id_ = host_.substr(0, idx);
-    }
+{}
+
+/**
+ * Returns the interned id of the host and port.
+ *
+ * @return the id of the host and port
+ */
+HostId HostInfo::GetId() const {
+    return id_;
 }
 
 /**
@@ -33,8 +36,8 @@ HostInfo::HostInfo(std::string host, int port, HOST_STATE state, HOST_ROLE role,
  *
  * @return the host
  */
-std::string HostInfo::GetHost() const {
-    return host_;
+const std::string& HostInfo::GetHost() const {
+    return HostRegistry::Get(id_).host;
 }
 
 /**
@@ -43,7 +46,7 @@ std::string HostInfo::GetHost() const {
  * @return the port
  */
 int HostInfo::GetPort() const {
-    return port_;
+    return HostRegistry::Get(id_).port;
 }
 
 /**
@@ -51,8 +54,8 @@ int HostInfo::GetPort() const {
  *
  * @return the Host ID
  */
-std::string HostInfo::GetHostId() const {
-    return host_id_;
+const std::string& HostInfo::GetHostId() const {
+    return HostRegistry::Get(id_).host_id;
 }
 
 /**
@@ -69,8 +72,8 @@ uint64_t HostInfo::GetWeight() const {
  *
  * @return the host:port representation of this host
  */
-std::string HostInfo::GetHostPortPair() const {
-    return host_ + HOST_PORT_SEPARATOR + std::to_string(port_);
+const std::string& HostInfo::GetHostPortPair() const {
+    return HostRegistry::Get(id_).host_port_pair;
 }
 
 HOST_STATE HostInfo::GetHostState() const {
@@ -85,6 +88,15 @@ std::chrono::steady_clock::time_point HostInfo::GetLastUpdate() const {
     return last_update_;
 }
 
+/**
+ * Returns how far the host lagged behind the writer when the topology was queried.
+ *
+ * @return the replica lag
+ */
+std::chrono::milliseconds HostInfo::GetReplicaLag() const {
+    return replica_lag_ms_;
+}
+
 void HostInfo::SetHostState(HOST_STATE state) {
     state_ = state;
 }
@@ -93,6 +105,10 @@ void HostInfo::SetHostRole(HOST_ROLE role) {
     role_ = role;
 }
 
+void HostInfo::SetReplicaLag(std::chrono::milliseconds replica_lag_ms) {
+    replica_lag_ms_ = replica_lag_ms;
+}
+
 bool HostInfo::IsHostWriter() const {
     return role_ == WRITER;
 }
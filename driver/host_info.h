@@ -19,6 +19,9 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <type_traits>
+
+#include "host_registry.h"
 
 typedef enum {
     UP,
@@ -40,7 +43,7 @@ public:
     HostInfo() = default;
 
     HostInfo(
-        std::string host,
+        const std::string& host,
         int port = NO_PORT,
         HOST_STATE state = DOWN,
         HOST_ROLE role = UNKNOWN,
@@ -50,42 +53,50 @@ public:
 
     ~HostInfo() = default;
 
-    std::string GetHost() const;
+    HostId GetId() const;
+    const std::string& GetHost() const;
     int GetPort() const;
-    std::string GetHostId() const;
-    std::string GetHostPortPair() const;
+    const std::string& GetHostId() const;
+    const std::string& GetHostPortPair() const;
     uint64_t GetWeight() const;
     HOST_STATE GetHostState() const;
     HOST_ROLE GetHostRole() const;
     std::chrono::steady_clock::time_point GetLastUpdate() const;
+    std::chrono::milliseconds GetReplicaLag() const;
 
     void SetHostState(HOST_STATE state);
     void SetHostRole(HOST_ROLE state);
+    void SetReplicaLag(std::chrono::milliseconds replica_lag_ms);
 
     bool IsHostWriter() const;
     bool IsHostUp() const;
+    // Same host and port, regardless of role, state and weight
+    bool IsSameHost(const HostInfo& other) const {
+        return this->id_ == other.id_;
+    }
 
     bool operator==(const HostInfo& other) const {
-        return this->host_ == other.GetHost()
-            && this->port_ == other.GetPort()
+        return this->id_ == other.id_
             && this->weight_ == other.GetWeight()
             && this->state_ == other.GetHostState()
             && this->role_ == other.GetHostRole();
     }
 
 private:
-    static constexpr char HOST_PORT_SEPARATOR = ':';
-    std::string host_ = "";
-    std::string host_id_ = "";
-    int port_ = NO_PORT;
+    // Host, port and the names derived from them are interned in the HostRegistry
+    HostId id_ = HostRegistry::EMPTY_HOST_ID;
     uint64_t weight_ = DEFAULT_WEIGHT;
 
     HOST_ROLE role_ = UNKNOWN;
     HOST_STATE state_ = DOWN;
 
     std::chrono::steady_clock::time_point last_update_;
+    // Reported by the topology, zero for writers and where the topology has no lag
+    std::chrono::milliseconds replica_lag_ms_{0};
 };
 
+static_assert(std::is_trivially_copyable_v<HostInfo>, "HostInfo is copied into every topology lookup");
+
 inline std::ostream& operator<<(std::ostream& str, const HostInfo& v) {
     char buf[HostInfo::MAX_HOST_INFO_BUFFER_SIZE];
     snprintf(buf, HostInfo::MAX_HOST_INFO_BUFFER_SIZE,
@@ -16,55 +16,87 @@
 
 #include "../dialect/dialect.h"
 #include "../host_info.h"
+#include "../util/monitoring_query_session.h"
 #include "../util/odbc_helper.h"
 
+#include <algorithm>
 #include <cmath>
 
 AuroraTopologyUtil::AuroraTopologyUtil(const std::shared_ptr<OdbcHelper>& odbc_helper, const std::shared_ptr<Dialect>& dialect) : TopologyUtil(odbc_helper, dialect) {}
 
 std::vector<HostInfo> AuroraTopologyUtil::GetHosts(SQLHDBC hdbc, const HostInfo &initial_host, const HostInfo &host_template) {
-    const DBC* dbc = static_cast<DBC*>(hdbc);
+    DBC* dbc = static_cast<DBC*>(hdbc);
     if (!dbc || !dbc->wrapped_dbc) {
         return {};
     }
 
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
-    RdsLibResult res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-    if (!SQL_SUCCEEDED(res.fn_result)) {
-        return {};
+    return QueryHosts(dbc, dialect_->GetTopologyQuery(), initial_host, host_template, nullptr);
+}
+
+std::optional<TopologyUtil::TopologyAndIdentity> AuroraTopologyUtil::GetHostsAndIdentity(
+    SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template)
+{
+    const std::string query_str = dialect_->GetTopologyAndIdentityQuery();
+    if (query_str.empty()) {
+        return std::nullopt;
     }
 
-    res = this->odbc_helper_->ExecDirect(&stmt, dialect_->GetTopologyQuery());
-    if (!SQL_SUCCEEDED(res.fn_result)) {
-        this->odbc_helper_->BaseFreeStmt(&stmt);
+    TopologyAndIdentity result;
+    result.hosts = QueryHosts(static_cast<DBC*>(hdbc), query_str, initial_host, host_template, &result);
+    return result;
+}
+
+std::vector<HostInfo> AuroraTopologyUtil::QueryHosts(
+    DBC* dbc, const std::string& query_str, const HostInfo& initial_host, const HostInfo& host_template, TopologyAndIdentity* identity)
+{
+    if (identity) {
+        // Cleared once every row has been read
+        identity->query_failed = true;
+    }
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(dbc, this->odbc_helper_);
+    MonitoringQuerySession::Query* query = session->Execute(query_str);
+    if (!query) {
         return {};
     }
 
-    SQLTCHAR node_id[BUFFER_SIZE * 2] = {0};
-    bool is_writer = false;
-    SQLREAL cpu_usage = 0;
-    SQLLEN len = 0;
-    SQLINTEGER replica_lag_ms = 0;
-
-    this->odbc_helper_->BindCol(&stmt, NODE_ID_COL, SQL_C_TCHAR, &node_id, BUFFER_SIZE, &len);
-    this->odbc_helper_->BindCol(&stmt, IS_WRITER_COL, SQL_BIT, &is_writer, sizeof(is_writer), &len);
-    this->odbc_helper_->BindCol(&stmt, CPU_USAGE_COL, SQL_REAL, &cpu_usage, sizeof(cpu_usage), &len);
-    this->odbc_helper_->BindCol(&stmt, REPLICA_LAG_COL, SQL_INTEGER, &replica_lag_ms, sizeof(replica_lag_ms), &len);
+    SQLTCHAR* node_id = static_cast<SQLTCHAR*>(query->BindCol(NODE_ID_COL, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+    const bool* is_writer = static_cast<bool*>(query->BindCol(IS_WRITER_COL, SQL_BIT, sizeof(bool)));
+    const SQLREAL* cpu_usage = static_cast<SQLREAL*>(query->BindCol(CPU_USAGE_COL, SQL_REAL, sizeof(SQLREAL)));
+    const SQLINTEGER* replica_lag_ms = static_cast<SQLINTEGER*>(query->BindCol(REPLICA_LAG_COL, SQL_INTEGER, sizeof(SQLINTEGER)));
+    if (!node_id || !is_writer || !cpu_usage || !replica_lag_ms) {
+        return {};
+    }
+    SQLTCHAR* instance_id = nullptr;
+    const bool* is_reader = nullptr;
+    if (identity) {
+        instance_id = static_cast<SQLTCHAR*>(query->BindCol(INSTANCE_ID_COL, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+        is_reader = static_cast<bool*>(query->BindCol(IS_READER_COL, SQL_BIT, sizeof(bool)));
+        if (!instance_id || !is_reader) {
+            return {};
+        }
+    }
 
     std::vector<HostInfo> hosts;
-    res = this->odbc_helper_->Fetch(&stmt);
+    RdsLibResult res = query->Fetch();
     while (SQL_SUCCEEDED(res.fn_result)) {
 #if UNICODE
         Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), node_id, nullptr, BUFFER_SIZE);
-        const HostInfo new_host = CreateHost(node_id, is_writer, cpu_usage, replica_lag_ms, initial_host, host_template);
-#else
-        const HostInfo new_host = CreateHost(node_id, is_writer, cpu_usage, replica_lag_ms, initial_host, host_template);
 #endif
-        hosts.push_back(new_host);
-        res = this->odbc_helper_->Fetch(&stmt);
+        if (identity && identity->instance_id.empty()) {
+            // Same on every row
+#if UNICODE
+            Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), instance_id, nullptr, BUFFER_SIZE);
+#endif
+            identity->instance_id = AS_UTF8_CSTR(instance_id);
+            identity->role = *is_reader ? READER : WRITER;
+        }
+        hosts.push_back(CreateHost(node_id, *is_writer, *cpu_usage, *replica_lag_ms, initial_host, host_template));
+        res = query->Fetch();
+    }
+    if (identity) {
+        identity->query_failed = res.fn_result != SQL_NO_DATA;
     }
 
-    this->odbc_helper_->BaseFreeStmt(&stmt);
     return hosts;
 }
 
@@ -85,5 +117,9 @@ HostInfo AuroraTopologyUtil::CreateHost(
         host_template.GetPort() : initial_host.GetPort();
     const uint64_t weight = static_cast<uint64_t>((static_cast<float>(replica_lag_ms) * SCALE_TO_PERCENT) + std::round(cpu_usage));
 
-    return TopologyUtil::CreateHost(endpoint_url, port, UP, is_writer ? WRITER : READER, weight, std::chrono::steady_clock::now());
+    HostInfo host = TopologyUtil::CreateHost(endpoint_url, port, UP, is_writer ? WRITER : READER, weight, std::chrono::steady_clock::now());
+    if (!is_writer) {
+        host.SetReplicaLag(std::chrono::milliseconds(std::max<SQLINTEGER>(replica_lag_ms, 0)));
+    }
+    return host;
 }
@@ -31,7 +31,13 @@ public:
     virtual std::vector<HostInfo> GetHosts(SQLHDBC hdbc, const HostInfo &initial_host, const HostInfo &host_template) override;
     virtual HostInfo CreateHost(SQLTCHAR* node_id, bool is_writer, SQLREAL cpu_usage, SQLINTEGER replica_lag_ms, const HostInfo& initial_host, const HostInfo& host_template);
 
+protected:
+    std::optional<TopologyAndIdentity> GetHostsAndIdentity(SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template) override;
+
 private:
+    // Reads the identity columns into identity when given
+    std::vector<HostInfo> QueryHosts(DBC* dbc, const std::string& query_str, const HostInfo& initial_host, const HostInfo& host_template, TopologyAndIdentity* identity);
+
     static constexpr char REPLACE_CHAR = '?';
     static constexpr float SCALE_TO_PERCENT = 100.0;
 
@@ -39,6 +45,8 @@ private:
     static constexpr int IS_WRITER_COL = 2;
     static constexpr int CPU_USAGE_COL = 3;
     static constexpr int REPLICA_LAG_COL = 4;
+    static constexpr int INSTANCE_ID_COL = 5;
+    static constexpr int IS_READER_COL = 6;
 };
 
 #endif // AURORA_TOPOLOGY_UTILS_H_
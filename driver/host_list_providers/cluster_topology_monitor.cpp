@@ -14,6 +14,8 @@
 
 #include "cluster_topology_monitor.h"
 
+#include <algorithm>
+
 #include <sqlext.h>
 
 #include "topology_util.h"
@@ -65,6 +67,33 @@ ClusterTopologyMonitor::ClusterTopologyMonitor(
         refresh_rate_ms_ = std::chrono::milliseconds(std::strtol(
             connection_attributes_.at(KEY_REFRESH_RATE).c_str(), nullptr, 0));
     }
+    if (connection_attributes_.contains(KEY_MIN_REFRESH_RATE)) {
+        min_refresh_rate_ms_ = std::chrono::milliseconds(std::strtol(
+            connection_attributes_.at(KEY_MIN_REFRESH_RATE).c_str(), nullptr, 0));
+    }
+    // Backs off up to the regular refresh rate unless a higher ceiling is given
+    std::chrono::milliseconds max_refresh_rate_ms = refresh_rate_ms_;
+    if (connection_attributes_.contains(KEY_MAX_REFRESH_RATE)) {
+        max_refresh_rate_ms = std::chrono::milliseconds(std::strtol(
+            connection_attributes_.at(KEY_MAX_REFRESH_RATE).c_str(), nullptr, 0));
+    }
+    refresh_policy_ = std::make_unique<TopologyRefreshPolicy>(
+        std::min(min_refresh_rate_ms_, refresh_rate_ms_), max_refresh_rate_ms);
+    // The file only records whole seconds
+    leader_max_age_ = std::chrono::duration_cast<std::chrono::seconds>(
+        LEADER_MISSED_REFRESHES * std::max(refresh_rate_ms_, max_refresh_rate_ms)) + std::chrono::seconds(1);
+    if (connection_attributes_.contains(KEY_PANIC_PROBE_CONCURRENCY)) {
+        probe_concurrency_ = static_cast<size_t>(std::max<long>(1, std::strtol(
+            connection_attributes_.at(KEY_PANIC_PROBE_CONCURRENCY).c_str(), nullptr, 0)));
+    }
+
+    if (connection_attributes_.contains(KEY_TOPOLOGY_CACHE_DIR)) {
+        topology_file_cache_ = std::make_shared<TopologyFileCache>(connection_attributes_.at(KEY_TOPOLOGY_CACHE_DIR));
+        if (connection_attributes_.contains(KEY_SHARED_TOPOLOGY_MONITORING)
+            && connection_attributes_.at(KEY_SHARED_TOPOLOGY_MONITORING) == VALUE_BOOL_TRUE) {
+            leader_lock_ = std::make_unique<TopologyFileLock>(topology_file_cache_->GetLockPath(cluster_id_));
+        }
+    }
 
     connection_attributes_.insert_or_assign(KEY_MONITORING_CONN_UUID, VALUE_BOOL_TRUE);
 
@@ -81,22 +110,27 @@ ClusterTopologyMonitor::ClusterTopologyMonitor(
 
 ClusterTopologyMonitor::~ClusterTopologyMonitor() {
     is_running_.store(false);
-    node_threads_stop_.store(true);
 
-    // Notify node threads if they are stuck waiting
-    {
-        const std::lock_guard lock(request_update_topology_mutex_);
-        request_update_topology_.store(true);
+    // Close main monitor
+    if (const MonitoringScheduler::TaskId task_id = task_id_.load(); task_id != 0) {
+        scheduler_->Cancel(task_id);
     }
-    request_update_topology_cv_.notify_all();
 
-    // Close main monitor
-    if (monitoring_thread_ && monitoring_thread_->joinable()) {
-        monitoring_thread_->join();
+    // Close probes, waiting for connects still in progress
+    StopProbes();
+    for (const MonitoringScheduler::TaskId lane_id : probe_lane_ids_) {
+        probe_scheduler_->Cancel(lane_id);
     }
-    monitoring_thread_ = nullptr;
 
     // Cleanup Handles
+    {
+        const std::lock_guard<std::mutex> writer_hdbc_lock(node_threads_writer_hdbc_mutex_);
+        CleanUpDbc(node_threads_writer_hdbc_);
+    }
+    {
+        const std::lock_guard<std::mutex> reader_hdbc_lock(node_threads_reader_hdbc_mutex_);
+        CleanUpDbc(node_threads_reader_hdbc_);
+    }
     const std::lock_guard hdbc_lock(hdbc_mutex_);
     CleanUpDbc(main_hdbc_);
     odbc_helper_->FreeEnv(&henv_);
@@ -123,11 +157,14 @@ std::vector<HostInfo> ClusterTopologyMonitor::ForceRefresh(const bool verify_wri
     }
 
     if (verify_writer) {
+        if (leader_lock_) {
+            verify_writer_requested_.store(true);
+        }
         const std::lock_guard hdbc_lock(hdbc_mutex_);
         // For Multi-AZ clusters, skip destroying the monitor connection immediately.
         // After failover, the connection is likely dead (RDS terminates the primary),
-        // but we let the monitor's next poll cycle detect this via GetNodeId() returning
-        // empty, which triggers CleanUpDbc in OpenAnyConnGetHosts. This avoids the full
+        // but we let the monitor's next poll cycle detect this via the topology query returning
+        // no instance id, which triggers CleanUpDbc in OpenAnyConnGetHosts. This avoids the full
         // panic-mode node-thread reconnection and allows faster topology rediscovery
         // through the normal monitoring flow.
         std::shared_ptr<Dialect> local_dialect;
@@ -166,31 +203,62 @@ void ClusterTopologyMonitor::StartMonitor() {
     if (is_running_.compare_exchange_strong(expected, true)) {
         plugin_head_ = this->plugin_service_->GetPluginChain();
         is_running_.store(true);
-        this->monitoring_thread_ = std::make_shared<std::thread>(&ClusterTopologyMonitor::Run, this);
+        LOG(INFO) << "Start cluster topology monitoring for " << cluster_id_;
+        this->scheduler_ = PluginService::GetMonitoringScheduler();
+        this->task_id_.store(this->scheduler_->Schedule([this] { return this->Run(); }));
+    }
+}
+
+void ClusterTopologyMonitor::HintTopologyChange(const std::chrono::milliseconds duration) {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    // Only the start of a hinted period cuts a long wait short
+    if (refresh_policy_->Hint(now + duration, now)) {
+        LOG(INFO) << "Topology change expected for " << cluster_id_ << ", refreshing at the minimum rate for " << duration.count() << "ms";
+        if (const MonitoringScheduler::TaskId task_id = task_id_.load(); task_id != 0) {
+            scheduler_->Wake(task_id);
+        }
     }
 }
 
-void ClusterTopologyMonitor::Run() {
+std::shared_ptr<TopologySubscription> ClusterTopologyMonitor::Subscribe(std::function<void()> on_event) {
+    return event_publisher_.Subscribe(std::move(on_event));
+}
+
+std::optional<std::chrono::milliseconds> ClusterTopologyMonitor::Run() {
     try {
-        LOG(INFO) << "Start cluster topology monitoring thread for " << cluster_id_;
-        while (is_running_.load()) {
+        if (is_running_.load()) {
+            // Another process monitors the cluster
+            if (IsFollower() && FollowLeader()) {
+                return request_update_topology_.load() ? TOPOLOGY_REQUEST_WAIT_MS : std::min(refresh_rate_ms_, FOLLOWER_POLL_MS);
+            }
+
             bool should_handle_topology_timing = true;
+            std::chrono::milliseconds delay(0);
             // Panic if main monitor is not connected to the writer instance
             if (InPanicMode()) {
                 should_handle_topology_timing = HandlePanicMode();
+                delay = GetRefreshDelay(true);
             } else {
                 should_handle_topology_timing = HandleRegularMode();
+                // Without topology the monitor panics right away
+                if (should_handle_topology_timing) {
+                    delay = GetRefreshDelay(false);
+                }
             }
             if (should_handle_topology_timing) {
                 HandleIgnoreTopologyTiming();
             }
+            if (!InPanicMode()) {
+                verify_writer_requested_.store(false);
+            }
+            return delay;
         }
-        LOG(INFO) << "Stop cluster topology monitoring thread for " << cluster_id_;
-        is_running_.store(false);
+        LOG(INFO) << "Stop cluster topology monitoring for " << cluster_id_;
     } catch (const std::exception& ex) {
         LOG(ERROR) << "Cluster Topology Main Monitor encountered error: " << ex.what();
     }
-    node_monitoring_threads_.clear();
+    StopProbes();
+    return std::nullopt;
 }
 
 std::vector<HostInfo> ClusterTopologyMonitor::WaitForTopologyUpdate(std::chrono::milliseconds timeout_ms) {
@@ -199,7 +267,9 @@ std::vector<HostInfo> ClusterTopologyMonitor::WaitForTopologyUpdate(std::chrono:
         const std::lock_guard<std::mutex> lock(request_update_topology_mutex_);
         request_update_topology_.store(true);
     }
-    request_update_topology_cv_.notify_all();
+    if (const MonitoringScheduler::TaskId task_id = task_id_.load(); task_id != 0) {
+        scheduler_->Wake(task_id);
+    }
 
     if (timeout_ms.count() <= 0) {
         std::vector<HostInfo> curr_hosts = plugin_service_->GetHosts();
@@ -225,60 +295,124 @@ std::vector<HostInfo> ClusterTopologyMonitor::WaitForTopologyUpdate(std::chrono:
     return plugin_service_->GetHosts();
 }
 
-void ClusterTopologyMonitor::DelayMainThread(bool use_high_refresh_rate) {
-    std::chrono::steady_clock::time_point curr_time = std::chrono::steady_clock::now();
-    if ((high_refresh_end_time_ != std::chrono::steady_clock::time_point() &&
-            curr_time < high_refresh_end_time_) || request_update_topology_.load()) {
-        use_high_refresh_rate = true;
+std::chrono::milliseconds ClusterTopologyMonitor::GetRefreshDelay(bool use_high_refresh_rate) {
+    if (request_update_topology_.load()) {
+        // Requests wake the monitor, one this refresh did not satisfy is retried shortly
+        return TOPOLOGY_REQUEST_WAIT_MS;
     }
 
-    const std::chrono::steady_clock::time_point end = curr_time + (use_high_refresh_rate ?
-        std::chrono::milliseconds(high_refresh_rate_ms_) :
-        std::chrono::milliseconds(refresh_rate_ms_));
-    std::unique_lock<std::mutex> request_lock(request_update_topology_mutex_);
-    do {
-        request_update_topology_cv_.wait_for(request_lock, TOPOLOGY_REQUEST_WAIT_MS);
-        curr_time = std::chrono::steady_clock::now();
-    } while (!request_update_topology_.load() &&
-        curr_time < end && is_running_.load()
-    );
+    const std::chrono::steady_clock::time_point curr_time = std::chrono::steady_clock::now();
+    if (high_refresh_end_time_ != std::chrono::steady_clock::time_point() && curr_time < high_refresh_end_time_) {
+        use_high_refresh_rate = true;
+    }
+    return use_high_refresh_rate ? high_refresh_rate_ms_ : refresh_policy_->NextDelay(curr_time);
 }
 
 std::vector<HostInfo> ClusterTopologyMonitor::FetchTopologyUpdateCache(const SQLHDBC hdbc) {
-    std::vector<HostInfo> hosts;
-    std::shared_ptr<Dialect> local_dialect;
     std::shared_ptr<TopologyUtil> local_topology_util;
     {
         const std::lock_guard<std::mutex> lock(topology_dialect_mutex_);
-        local_dialect = dialect_;
         local_topology_util = topology_util_;
     }
-    if (GetNodeId(hdbc, local_dialect, odbc_helper_).empty()) {
+    return UpdateFetchedTopology(local_topology_util->QueryTopologyAndIdentity(hdbc, initial_host_, template_host_));
+}
+
+std::vector<HostInfo> ClusterTopologyMonitor::UpdateFetchedTopology(const TopologyUtil::TopologyAndIdentity& fetched) {
+    if (fetched.query_failed) {
         LOG(ERROR) << "Cluster Monitor invalid connection for querying for ClusterId: " << cluster_id_;
-        return hosts;
+        return {};
     }
-    hosts = local_topology_util->QueryTopology(hdbc, initial_host_, template_host_);
-    if (hosts.empty()) {
+    if (fetched.hosts.empty()) {
         LOG(ERROR) << "Cluster Monitor queried and found no topology for ClusterId: " << cluster_id_;
     } else {
         // Update if new topology is found
-        UpdateTopologyCache(hosts);
-        TopologyUtil::LogTopology(hosts);
+        UpdateTopologyCache(fetched.hosts);
+        TopologyUtil::LogTopology(fetched.hosts);
     }
 
-    return hosts;
+    return fetched.hosts;
 }
 
 void ClusterTopologyMonitor::UpdateTopologyCache(const std::vector<HostInfo>& hosts) {
-    const std::unique_lock<std::mutex> request_lock(request_update_topology_mutex_);
-    const std::unique_lock<std::mutex> update_lock(topology_updated_mutex_);
+    {
+        const std::unique_lock<std::mutex> request_lock(request_update_topology_mutex_);
+        const std::unique_lock<std::mutex> update_lock(topology_updated_mutex_);
+
+        const std::shared_ptr<const TopologySnapshot> previous_topology = plugin_service_->GetTopologySnapshot();
+        if (!IsSameTopology(hosts, previous_topology->hosts)) {
+            topology_changed_.store(true);
+        }
+        // Update topology and notify threads
+        plugin_service_->SetHosts(hosts);
+        event_publisher_.Publish(previous_topology->hosts, hosts);
+        request_update_topology_.store(false);
+        topology_version_.fetch_add(1);
+        topology_updated_.notify_all();
+    }
+    // Only the leader persists when monitoring is shared
+    if (topology_file_cache_ && (!leader_lock_ || leader_lock_->IsLocked())) {
+        PersistTopology(hosts);
+    }
+}
+
+void ClusterTopologyMonitor::PersistTopology(const std::vector<HostInfo>& hosts) {
+    const std::lock_guard<std::mutex> lock(persisted_hosts_mutex_);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    // Weights follow replica lag and change on most refreshes, the file is only rewritten when hosts or roles change.
+    // Followers select readers by these weights, a leader also rewrites it on weight changes.
+    // A leader also rewrites an unchanged topology once per refresh interval, followers take its age as a heartbeat.
+    const bool unchanged = leader_lock_
+        ? hosts == persisted_hosts_ && now - persisted_at_ < refresh_rate_ms_
+        : IsSameTopology(hosts, persisted_hosts_);
+    if (unchanged) {
+        return;
+    }
+    if (topology_file_cache_->Write(cluster_id_, hosts)) {
+        persisted_hosts_ = hosts;
+        persisted_at_ = now;
+    }
+}
 
-    // Update topology and notify threads
-    plugin_service_->SetHosts(hosts);
-    request_update_topology_.store(false);
-    topology_version_.fetch_add(1);
-    topology_updated_.notify_all();
-    request_update_topology_cv_.notify_one();
+bool ClusterTopologyMonitor::IsSameTopology(const std::vector<HostInfo>& hosts, const std::vector<HostInfo>& other_hosts) {
+    return std::ranges::equal(hosts, other_hosts, [](const HostInfo& a, const HostInfo& b) {
+        return a.IsSameHost(b) && a.GetHostRole() == b.GetHostRole();
+    });
+}
+
+bool ClusterTopologyMonitor::IsFollower() {
+    if (!leader_lock_ || leader_lock_->IsLocked()) {
+        return false;
+    }
+    // Free once the leader stops monitoring or its process exits
+    if (leader_lock_->TryLock()) {
+        LOG(INFO) << "Cluster topology monitor became the shared monitoring leader for: " << cluster_id_;
+        return false;
+    }
+    return !verify_writer_requested_.load();
+}
+
+// Publishes the topology persisted by the leader, returns false when there is none to follow.
+// A leader that stopped refreshing still holds its lock, followers then monitor on their own until it recovers.
+bool ClusterTopologyMonitor::FollowLeader() {
+    const std::vector<HostInfo> hosts = topology_file_cache_->Read(cluster_id_, leader_max_age_);
+    if (hosts.empty()) {
+        return false;
+    }
+
+    // Monitoring connections left from verifying the writer are closed while following
+    StopProbes();
+    {
+        const std::lock_guard hdbc_lock(hdbc_mutex_);
+        CleanUpDbc(main_hdbc_);
+        is_writer_connection_.store(false);
+    }
+
+    // Pending requests are answered with the leader's topology even when unchanged
+    if (hosts != followed_hosts_ || request_update_topology_.load()) {
+        followed_hosts_ = hosts;
+        UpdateTopologyCache(hosts);
+    }
+    return true;
 }
 
 std::string ClusterTopologyMonitor::ConnForHost(const std::string& new_host) const {
@@ -298,6 +432,8 @@ bool ClusterTopologyMonitor::InPanicMode() const {
 std::vector<HostInfo> ClusterTopologyMonitor::OpenAnyConnGetHosts() {
     SQLRETURN rc;
     bool thread_writer_verified = false;
+    // Fetched along with the role of a new connection
+    std::optional<TopologyUtil::TopologyAndIdentity> fetched;
     if (!main_hdbc_) {
         SQLHDBC local_hdbc;
         // Open a new connection
@@ -322,8 +458,9 @@ std::vector<HostInfo> ClusterTopologyMonitor::OpenAnyConnGetHosts() {
                 const std::lock_guard<std::mutex> lock(topology_dialect_mutex_);
                 local_topology_util = topology_util_;
             }
-            if (local_topology_util->GetConnectionRole(local_dbc) == WRITER) {
-                const std::string writer_id = local_topology_util->GetWriterId(local_dbc);
+            fetched = local_topology_util->QueryTopologyAndIdentity(local_dbc, initial_host_, template_host_);
+            if (fetched->role == WRITER) {
+                const std::string& writer_id = fetched->instance_id;
                 LOG(INFO) << "Cluster topology monitor detected writer: " << writer_id;
                 thread_writer_verified = true;
                 is_writer_connection_.store(true);
@@ -341,7 +478,8 @@ std::vector<HostInfo> ClusterTopologyMonitor::OpenAnyConnGetHosts() {
         }
     }
 
-    std::vector<HostInfo> hosts = FetchTopologyUpdateCache(static_cast<SQLHDBC>(*(main_hdbc_)));
+    std::vector<HostInfo> hosts = fetched.has_value() ?
+        UpdateFetchedTopology(fetched.value()) : FetchTopologyUpdateCache(static_cast<SQLHDBC>(*(main_hdbc_)));
     if (thread_writer_verified) {
         // Writer verified at initial connection & failovers but want to ignore new topology requests after failover
         // The first writer will be able to set from epoch to a proper end time
@@ -371,17 +509,16 @@ void ClusterTopologyMonitor::CleanUpDbc(std::shared_ptr<SQLHDBC>& dbc) {
 
 bool ClusterTopologyMonitor::HandlePanicMode() {
     bool should_handle_topology_timing = true;
-    if (node_monitoring_threads_.empty()) {
+    if (!probe_round_) {
         InitNodeMonitors();
     } else {
         should_handle_topology_timing = GetPossibleWriterConn();
     }
-    DelayMainThread(true);
     return should_handle_topology_timing;
 }
 
 bool ClusterTopologyMonitor::HandleRegularMode() {
-    node_monitoring_threads_.clear();
+    StopProbes();
     std::vector<HostInfo> hosts;
     {
         const std::lock_guard hdbc_lock(hdbc_mutex_);
@@ -393,15 +530,16 @@ bool ClusterTopologyMonitor::HandleRegularMode() {
         const std::lock_guard hdbc_lock(hdbc_mutex_);
         CleanUpDbc(main_hdbc_);
         is_writer_connection_.store(false);
+        refresh_policy_->OnConnectionError();
         return false;
     }
+    // Includes changes found in panic mode
+    refresh_policy_->OnRefresh(topology_changed_.exchange(false));
 
     const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
     if (high_refresh_end_time_ != epoch_ && now > high_refresh_end_time_) {
         high_refresh_end_time_ = epoch_;
     }
-
-    DelayMainThread(false);
     return true;
 }
 
@@ -414,7 +552,6 @@ void ClusterTopologyMonitor::HandleIgnoreTopologyTiming() {
 }
 
 void ClusterTopologyMonitor::InitNodeMonitors() {
-    node_threads_stop_.store(false);
     {
         const std::lock_guard<std::mutex> writer_hdbc_lock(node_threads_writer_hdbc_mutex_);
         CleanUpDbc(node_threads_writer_hdbc_);
@@ -426,145 +563,315 @@ void ClusterTopologyMonitor::InitNodeMonitors() {
     node_threads_writer_host_info_ = nullptr;
     node_threads_latest_topology_ = nullptr;
 
-    std::vector<HostInfo> hosts = plugin_service_->GetHosts();
+    std::vector<HostInfo> hosts;
+    // A provisional topology only serves connections until confirmed, the writer is looked up as on a cold start
+    if (const std::shared_ptr<const TopologySnapshot> topology = plugin_service_->GetTopologySnapshot(); !topology->provisional) {
+        hosts = topology->hosts;
+    }
     if (hosts.empty()) {
         hosts = OpenAnyConnGetHosts();
     }
 
     if (!hosts.empty() && !is_writer_connection_.load()) {
-        for (const HostInfo& hi : hosts) {
-            if (const std::string host_id = hi.GetHost(); !node_monitoring_threads_.contains(host_id)) {
-                node_monitoring_threads_[host_id] =
-                    std::make_shared<NodeMonitoringThread>(this, std::make_shared<HostInfo>(hi), main_writer_host_info_, odbc_helper_);
+        std::shared_ptr<HostInfo> lost_writer = main_writer_host_info_;
+        if (!lost_writer) {
+            if (const auto writer = std::ranges::find_if(hosts, [](const HostInfo& hi) { return hi.IsHostWriter(); });
+                writer != hosts.end()) {
+                lost_writer = std::make_shared<HostInfo>(*writer);
             }
         }
+        if (!probe_scheduler_) {
+            probe_scheduler_ = PluginService::GetProbeScheduler();
+        }
+        probe_round_ = std::make_shared<ProbeRound>(this, lost_writer);
+        probe_round_->AddHosts(hosts);
+        AddProbeLanes();
+        LOG(INFO) << "Started probing " << hosts.size() << " hosts for the writer of " << cluster_id_;
     }
 }
 
 bool ClusterTopologyMonitor::GetPossibleWriterConn() {
-    const std::lock_guard<std::mutex> node_lock(node_threads_writer_hdbc_mutex_);
-    const std::lock_guard<std::mutex> hostinfo_lock(node_threads_writer_host_info_mutex_);
-    std::shared_ptr<Dialect> local_dialect;
+    bool writer_found = false;
     {
-        const std::lock_guard<std::mutex> lock(topology_dialect_mutex_);
-        local_dialect = dialect_;
+        const std::lock_guard<std::mutex> node_lock(node_threads_writer_hdbc_mutex_);
+        const std::lock_guard<std::mutex> hostinfo_lock(node_threads_writer_host_info_mutex_);
+        std::shared_ptr<Dialect> local_dialect;
+        {
+            const std::lock_guard<std::mutex> lock(topology_dialect_mutex_);
+            local_dialect = dialect_;
+        }
+        auto* local_hdbc = node_threads_writer_hdbc_ ?
+            static_cast<SQLHDBC>(*node_threads_writer_hdbc_) : SQL_NULL_HDBC;
+        const HostInfo local_hostinfo = node_threads_writer_host_info_ ? *node_threads_writer_host_info_ : HostInfo("", 0, DOWN, READER);
+        if (SQL_NULL_HDBC != local_hdbc && !GetNodeId(local_hdbc, local_dialect, odbc_helper_).empty() && local_hostinfo.IsHostUp()) {
+            LOG(INFO) << "The writer host detected by the node monitors was picked up by the topology monitor: " << local_hostinfo;
+            const std::lock_guard<std::mutex> hdbc_lock(hdbc_mutex_);
+            CleanUpDbc(main_hdbc_);
+            main_hdbc_ = std::move(node_threads_writer_hdbc_);
+            main_writer_host_info_ = std::make_shared<HostInfo>(local_hostinfo);
+            is_writer_connection_.store(true);
+            high_refresh_end_time_ = std::chrono::steady_clock::now() + high_refresh_rate_after_panic_;
+
+            // Writer verified at initial connection & failovers but want to ignore new topology requests after failover
+            // The first writer will be able to set from epoch to a proper end time
+            std::chrono::steady_clock::time_point expected = std::chrono::steady_clock::time_point{}; // Epoch
+            const std::chrono::steady_clock::time_point new_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(ignore_topology_request_ms_);
+            ignore_topology_request_end_ms_.compare_exchange_strong(expected, new_time);
+            writer_found = true;
+        }
     }
-    auto* local_hdbc = node_threads_writer_hdbc_ ?
-        static_cast<SQLHDBC>(*node_threads_writer_hdbc_) : SQL_NULL_HDBC;
-    const HostInfo local_hostinfo = node_threads_writer_host_info_ ? *node_threads_writer_host_info_ : HostInfo("", 0, DOWN, READER);
-    if (SQL_NULL_HDBC != local_hdbc && !GetNodeId(local_hdbc, local_dialect, odbc_helper_).empty() && local_hostinfo.IsHostUp()) {
-        LOG(INFO) << "The writer host detected by the node monitors was picked up by the topology monitor: " << local_hostinfo;
-        const std::lock_guard<std::mutex> hdbc_lock(hdbc_mutex_);
-        CleanUpDbc(main_hdbc_);
-        main_hdbc_ = std::move(node_threads_writer_hdbc_);
-        main_writer_host_info_ = std::make_shared<HostInfo>(local_hostinfo);
-        is_writer_connection_.store(true);
-        high_refresh_end_time_ = std::chrono::steady_clock::now() + high_refresh_rate_after_panic_;
-
-        // Writer verified at initial connection & failovers but want to ignore new topology requests after failover
-        // The first writer will be able to set from epoch to a proper end time
-        std::chrono::steady_clock::time_point expected = std::chrono::steady_clock::time_point{}; // Epoch
-        const std::chrono::steady_clock::time_point new_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(ignore_topology_request_ms_);
-        ignore_topology_request_end_ms_.compare_exchange_strong(expected, new_time);
-
-        node_threads_stop_.store(true);
-        node_monitoring_threads_.clear();
+    if (writer_found) {
+        StopProbes();
         return false;
     }
+
     std::vector<HostInfo> local_topology;
     {
         const std::lock_guard<std::mutex> topology_lock(node_threads_latest_topology_mutex_);
         local_topology = node_threads_latest_topology_ ? *node_threads_latest_topology_ : std::vector<HostInfo>();
     }
-    const auto end = node_monitoring_threads_.end();
-    for (const HostInfo& hi : local_topology) {
-        const std::string host_id = hi.GetHost();
-        if (node_monitoring_threads_.find(host_id) == end) {
-            node_monitoring_threads_[host_id] =
-                std::make_shared<NodeMonitoringThread>(this, std::make_shared<HostInfo>(hi), main_writer_host_info_, odbc_helper_);
+    probe_round_->AddHosts(local_topology);
+    AddProbeLanes();
+    return true;
+}
+
+void ClusterTopologyMonitor::AddProbeLanes() {
+    // Lanes of earlier rounds that finished no longer need to be cancelled
+    std::erase_if(probe_lane_ids_, [this](const MonitoringScheduler::TaskId lane_id) {
+        return !probe_scheduler_->IsScheduled(lane_id);
+    });
+
+    const std::shared_ptr<ProbeRound> round = probe_round_;
+    const size_t lane_count = std::min(probe_concurrency_, round->Size());
+    for (size_t i = round->GetLaneCount(); i < lane_count; i++) {
+        const MonitoringScheduler::TaskId lane_id = probe_scheduler_->Schedule([this, round] { return this->RunProbeLane(round); });
+        round->AddLane(lane_id);
+        probe_lane_ids_.push_back(lane_id);
+    }
+}
+
+void ClusterTopologyMonitor::StopProbes() {
+    if (!probe_round_) {
+        return;
+    }
+
+    std::vector<MonitoringScheduler::TaskId> lane_ids;
+    {
+        // A probe finding the writer after this closes its connection
+        const std::lock_guard<std::mutex> writer_hdbc_lock(node_threads_writer_hdbc_mutex_);
+        lane_ids = probe_round_->Stop();
+    }
+    // Waiting lanes finish right away, lanes still connecting finish once the connect returns
+    for (const MonitoringScheduler::TaskId lane_id : lane_ids) {
+        probe_scheduler_->Wake(lane_id);
+    }
+    probe_round_ = nullptr;
+}
+
+std::optional<std::chrono::milliseconds> ClusterTopologyMonitor::RunProbeLane(const std::shared_ptr<ProbeRound>& round) {
+    if (round->IsStopped() || !is_running_.load()) {
+        return std::nullopt;
+    }
+
+    std::vector<HostInfo> latest_topology;
+    {
+        const std::lock_guard<std::mutex> topology_lock(node_threads_latest_topology_mutex_);
+        latest_topology = node_threads_latest_topology_ ? *node_threads_latest_topology_ : std::vector<HostInfo>();
+    }
+    const std::shared_ptr<HostInfo> lost_writer = round->GetLostWriter();
+    std::chrono::milliseconds wait_ms(0);
+    const std::shared_ptr<NodeProbe> probe = round->Acquire(
+        [&latest_topology, &lost_writer](const HostInfo& host) { return GetProbePriority(host, latest_topology, lost_writer); },
+        wait_ms);
+    if (!probe) {
+        return wait_ms;
+    }
+
+    probe->Probe();
+    round->Release(probe);
+    // Moves on to the next host due for a probe
+    return std::chrono::milliseconds(0);
+}
+
+// A host reported as the writer by the readers is the most likely candidate, followed by the
+// readers with the lowest weight, which favours the least replica lag. The lost writer goes last.
+ClusterTopologyMonitor::ProbePriority ClusterTopologyMonitor::GetProbePriority(
+    const HostInfo& host,
+    const std::vector<HostInfo>& latest_topology,
+    const std::shared_ptr<HostInfo>& lost_writer)
+{
+    uint64_t weight = host.GetWeight();
+    for (const HostInfo& hi : latest_topology) {
+        if (hi.IsSameHost(host)) {
+            if (hi.IsHostWriter()) {
+                return {0, 0};
+            }
+            weight = hi.GetWeight();
+            break;
+        }
+    }
+    const bool is_lost_writer = lost_writer && lost_writer->IsSameHost(host);
+    return {is_lost_writer ? 2 : 1, weight};
+}
+
+ClusterTopologyMonitor::ProbeRound::ProbeRound(ClusterTopologyMonitor* monitor, const std::shared_ptr<HostInfo>& lost_writer)
+    : monitor_{ monitor },
+      lost_writer_{ lost_writer } {}
+
+void ClusterTopologyMonitor::ProbeRound::AddHosts(const std::vector<HostInfo>& hosts) {
+    // Destroyed outside the lock, closing a probe's connection may block
+    std::vector<std::shared_ptr<NodeProbe>> removed;
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!hosts.empty()) {
+        for (auto itr = probes_.begin(); itr != probes_.end();) {
+            const bool in_topology = std::ranges::any_of(hosts, [&itr](const HostInfo& hi) { return hi.GetHost() == itr->first; });
+            if (!in_topology && !itr->second.in_use) {
+                removed.push_back(std::move(itr->second.probe));
+                itr = probes_.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
+    for (const HostInfo& hi : hosts) {
+        if (const std::string host_id = hi.GetHost(); !probes_.contains(host_id)) {
+            probes_[host_id] = ProbeEntry{
+                std::make_shared<NodeProbe>(monitor_, this, std::make_shared<HostInfo>(hi), lost_writer_, monitor_->odbc_helper_),
+                now
+            };
         }
     }
-    return true;
 }
 
-ClusterTopologyMonitor::NodeMonitoringThread::NodeMonitoringThread(
+std::shared_ptr<ClusterTopologyMonitor::NodeProbe> ClusterTopologyMonitor::ProbeRound::Acquire(
+    const std::function<ProbePriority(const HostInfo&)>& get_priority,
+    std::chrono::milliseconds& wait_ms)
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point next_due = now + PROBE_INTERVAL_MS;
+    ProbeEntry* next = nullptr;
+    ProbePriority next_priority;
+    for (auto& [host_id, entry] : probes_) {
+        if (entry.in_use) {
+            continue;
+        }
+        if (entry.next_probe > now) {
+            next_due = std::min(next_due, entry.next_probe);
+            continue;
+        }
+        if (const ProbePriority priority = get_priority(entry.probe->GetHostInfo()); !next || priority < next_priority) {
+            next = &entry;
+            next_priority = priority;
+        }
+    }
+
+    if (!next) {
+        wait_ms = std::chrono::ceil<std::chrono::milliseconds>(next_due - now);
+        return nullptr;
+    }
+    next->in_use = true;
+    return next->probe;
+}
+
+void ClusterTopologyMonitor::ProbeRound::Release(const std::shared_ptr<NodeProbe>& probe) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    if (const auto itr = probes_.find(probe->GetHostInfo().GetHost()); itr != probes_.end()) {
+        itr->second.in_use = false;
+        itr->second.next_probe = std::chrono::steady_clock::now() + PROBE_INTERVAL_MS;
+    }
+}
+
+size_t ClusterTopologyMonitor::ProbeRound::Size() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return probes_.size();
+}
+
+void ClusterTopologyMonitor::ProbeRound::AddLane(const MonitoringScheduler::TaskId lane_id) {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    lane_ids_.push_back(lane_id);
+}
+
+size_t ClusterTopologyMonitor::ProbeRound::GetLaneCount() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return lane_ids_.size();
+}
+
+std::vector<MonitoringScheduler::TaskId> ClusterTopologyMonitor::ProbeRound::Stop() {
+    stopped_.store(true);
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return lane_ids_;
+}
+
+bool ClusterTopologyMonitor::ProbeRound::IsStopped() const {
+    return stopped_.load();
+}
+
+std::shared_ptr<HostInfo> ClusterTopologyMonitor::ProbeRound::GetLostWriter() const {
+    return lost_writer_;
+}
+
+ClusterTopologyMonitor::NodeProbe::NodeProbe(
     ClusterTopologyMonitor* monitor,
+    ProbeRound* round,
     const std::shared_ptr<HostInfo>& host_info,
     const std::shared_ptr<HostInfo>& writer_host_info,
     const std::shared_ptr<OdbcHelper> &odbc_helper)
 {
     this->main_monitor_ = monitor;
+    this->round_ = round;
     this->host_info_ = host_info;
     this->writer_host_info_ = writer_host_info;
     this->odbc_helper_ = odbc_helper;
-    odbc_helper_->AllocDbc(monitor->henv_, hdbc_);
-    DBC *init_dbc = static_cast<DBC*>(hdbc_);
-    init_dbc->attr_map.insert_or_assign(SQL_ATTR_LOGIN_TIMEOUT, std::make_pair(reinterpret_cast<SQLPOINTER>(static_cast<intptr_t>(DEFAULT_TIMEOUT_SECONDS)), 0));
-    init_dbc->attr_map.insert_or_assign(SQL_ATTR_CONNECTION_TIMEOUT, std::make_pair(reinterpret_cast<SQLPOINTER>(static_cast<intptr_t>(DEFAULT_TIMEOUT_SECONDS)), 0));
-    node_thread_ = std::make_shared<std::thread>(&NodeMonitoringThread::Run, this);
+    ConnectionStringHelper::ParseConnectionString(main_monitor_->ConnForHost(host_info_->GetHost()), conn_info_);
     LOG(INFO) << "Started node monitoring for: " << this->host_info_->GetHost();
 }
 
-ClusterTopologyMonitor::NodeMonitoringThread::~NodeMonitoringThread() {
-    if (node_thread_) {
-        if (node_thread_->joinable()) {
-            node_thread_->join();
-        }
-    }
-    node_thread_ = nullptr;
-
-    // Main thread will clean up if this Node was used as a reader connection
-    if (!reader_update_topology_ && hdbc_) {
+ClusterTopologyMonitor::NodeProbe::~NodeProbe() {
+    // A connection handed to the main monitor is no longer owned by the probe
+    if (hdbc_) {
         odbc_helper_->DisconnectAndFree(&hdbc_);
     }
     LOG(INFO) << "Finished node monitoring for: " << this->host_info_->GetHost();
 }
 
-void ClusterTopologyMonitor::NodeMonitoringThread::Run() {
+const HostInfo& ClusterTopologyMonitor::NodeProbe::GetHostInfo() const {
+    return *host_info_;
+}
+
+void ClusterTopologyMonitor::NodeProbe::Probe() {
     const std::string thread_host = host_info_->GetHost();
-    auto updated_conn_str = main_monitor_->ConnForHost(thread_host);
-    DBC* local_dbc = static_cast<DBC*>(hdbc_);
-    ConnectionStringHelper::ParseConnectionString(updated_conn_str, conn_info_);
-    local_dbc->conn_attr = conn_info_;
-    local_dbc->plugin_service = main_monitor_->plugin_service_;
     try {
-        while (!main_monitor_->node_threads_stop_.load()) {
-            std::shared_ptr<Dialect> local_dialect;
-            std::shared_ptr<TopologyUtil> local_topology_util;
-            {
-                const std::lock_guard<std::mutex> lock(main_monitor_->topology_dialect_mutex_);
-                local_dialect = main_monitor_->dialect_;
-                local_topology_util = main_monitor_->topology_util_;
+        std::shared_ptr<TopologyUtil> local_topology_util;
+        {
+            const std::lock_guard<std::mutex> lock(main_monitor_->topology_dialect_mutex_);
+            local_topology_util = main_monitor_->topology_util_;
+        }
+        // The topology comes with the role, a writer's is used without querying again
+        const TopologyUtil::TopologyAndIdentity fetched = local_topology_util->QueryTopologyAndIdentity(
+            hdbc_, main_monitor_->initial_host_, main_monitor_->template_host_);
+        if (fetched.query_failed) {
+            if (hdbc_ != SQL_NULL_HDBC) {
+                // Not an initial connection.
+                LOG(WARNING) << "Failover Monitor for: " << thread_host << " not connected. Trying to reconnect";
             }
-            if (GetNodeId(hdbc_, local_dialect, odbc_helper_).empty()) {
-                if (hdbc_ != SQL_NULL_HDBC) {
-                    // Not an initial connection.
-                    LOG(WARNING) << "Failover Monitor for: " << thread_host << " not connected. Trying to reconnect";
-                }
-                HandleReconnect();
+            HandleReconnect();
+        } else {
+            if (fetched.role == WRITER) {
+                LOG(WARNING) << "Writer detected by node monitoring thread: " << thread_host;
+                HandleWriterConn(fetched);
             } else {
-                const HOST_ROLE role = local_topology_util->GetConnectionRole(hdbc_);
-                if (role == WRITER) {
-                    LOG(WARNING) << "Writer detected by node monitoring thread: " << thread_host;
-                    HandleWriterConn();
-                } else {
-                    HandleReaderConn();
-                }
+                // A connection without topology rows is still alive
+                HandleReaderConn();
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(THREAD_SLEEP_MS_));
         }
     } catch (const std::exception& ex) {
         LOG(ERROR) << "Exception while node monitoring for: " << thread_host << ex.what();
     }
-
-    // Close any open connections / handles
-    if (hdbc_) {
-        odbc_helper_->DisconnectAndFree(&hdbc_);
-        hdbc_ = SQL_NULL_HDBC;
-    }
 }
 
-void ClusterTopologyMonitor::NodeMonitoringThread::HandleReconnect() {
+void ClusterTopologyMonitor::NodeProbe::HandleReconnect() {
     if (hdbc_ != SQL_NULL_HDBC) {
         // Disconnect if hdbc is not null
         odbc_helper_->DisconnectAndFree(&hdbc_);
@@ -584,68 +891,75 @@ void ClusterTopologyMonitor::NodeMonitoringThread::HandleReconnect() {
     }
 }
 
-void ClusterTopologyMonitor::NodeMonitoringThread::HandleWriterConn() {
-    const std::lock_guard<std::mutex> hdbc_lock(main_monitor_->node_threads_writer_hdbc_mutex_);
-    if (main_monitor_->node_threads_writer_hdbc_ != nullptr) {
-        // Writer connection already set
-        // Disconnect this thread's connection
-        LOG(INFO) << "Writer connection already set, disconnect this thread's connection";
-        odbc_helper_->DisconnectAndFree(&hdbc_);
-    } else {
-        // Main monitor now tracks this connection
-        LOG(INFO) << "Main monitor now tracks this connection";
-        main_monitor_->node_threads_writer_hdbc_ = std::make_shared<SQLHDBC>(hdbc_);
-        // Update topology using writer connection
-        LOG(INFO) << "Update topology using writer connection";
-        main_monitor_->FetchTopologyUpdateCache(hdbc_);
-        {
-            const std::lock_guard<std::mutex> host_info_lock(main_monitor_->node_threads_writer_host_info_mutex_);
-            main_monitor_->node_threads_writer_host_info_ = host_info_;
+void ClusterTopologyMonitor::NodeProbe::HandleWriterConn(const TopologyUtil::TopologyAndIdentity& fetched) {
+    {
+        const std::lock_guard<std::mutex> hdbc_lock(main_monitor_->node_threads_writer_hdbc_mutex_);
+        if (round_->IsStopped() || main_monitor_->node_threads_writer_hdbc_ != nullptr) {
+            // Writer connection already set or no longer needed
+            // Disconnect this probe's connection
+            LOG(INFO) << "Writer connection already set, disconnect this probe's connection";
+            odbc_helper_->DisconnectAndFree(&hdbc_);
+        } else {
+            // Main monitor now tracks this connection
+            LOG(INFO) << "Main monitor now tracks this connection";
+            main_monitor_->node_threads_writer_hdbc_ = std::make_shared<SQLHDBC>(hdbc_);
+            // Update topology using writer connection
+            LOG(INFO) << "Update topology using writer connection";
+            main_monitor_->UpdateFetchedTopology(fetched);
+            {
+                const std::lock_guard<std::mutex> host_info_lock(main_monitor_->node_threads_writer_host_info_mutex_);
+                main_monitor_->node_threads_writer_host_info_ = host_info_;
+            }
         }
+        hdbc_ = SQL_NULL_HDBC;
+        round_->Stop();
+    }
+
+    // Have the main monitor pick up the writer connection right away
+    if (const MonitoringScheduler::TaskId task_id = main_monitor_->task_id_.load(); task_id != 0) {
+        main_monitor_->scheduler_->Wake(task_id);
     }
-    hdbc_ = SQL_NULL_HDBC;
-    main_monitor_->node_threads_stop_.store(true);
 }
 
-void ClusterTopologyMonitor::NodeMonitoringThread::HandleReaderConn() {
+void ClusterTopologyMonitor::NodeProbe::HandleReaderConn() {
     if (main_monitor_->node_threads_writer_hdbc_) {
         // Writer already set, no need for reader to update topology
         return;
     }
 
-    // Check if this thread is updating topology
+    // Check if this probe is updating topology
     // If it isn't check if there is already another reader
-    if (reader_update_topology_) {
-        ReaderThreadFetchTopology();
-    } else {
-        {
-            const std::lock_guard<std::mutex> reader_hdbc_lock(main_monitor_->node_threads_reader_hdbc_mutex_);
-            if (!main_monitor_->node_threads_reader_hdbc_) {
-                main_monitor_->node_threads_reader_hdbc_ = std::make_shared<SQLHDBC>(hdbc_);
-                hdbc_ = SQL_NULL_HDBC;
-            }
+    if (!reader_update_topology_) {
+        const std::lock_guard<std::mutex> reader_hdbc_lock(main_monitor_->node_threads_reader_hdbc_mutex_);
+        if (!main_monitor_->node_threads_reader_hdbc_) {
+            main_monitor_->node_threads_reader_hdbc_ = std::make_shared<SQLHDBC>(hdbc_);
+            hdbc_ = SQL_NULL_HDBC;
         }
         reader_update_topology_ = true;
-        ReaderThreadFetchTopology();
     }
+    ReaderThreadFetchTopology();
 }
 
-void ClusterTopologyMonitor::NodeMonitoringThread::ReaderThreadFetchTopology() {
+void ClusterTopologyMonitor::NodeProbe::ReaderThreadFetchTopology() {
+    // Probes share the reader connection, it is used by one probe at a time
+    const std::lock_guard<std::mutex> reader_hdbc_lock(main_monitor_->node_threads_reader_hdbc_mutex_);
+    if (round_->IsStopped() || !main_monitor_->node_threads_reader_hdbc_) {
+        // Closed for a later round
+        return;
+    }
     auto* local_hdbc = static_cast<SQLHDBC>(*main_monitor_->node_threads_reader_hdbc_);
-    std::shared_ptr<Dialect> local_dialect;
     std::shared_ptr<TopologyUtil> local_topology_util;
     {
         const std::lock_guard<std::mutex> lock(main_monitor_->topology_dialect_mutex_);
-        local_dialect = main_monitor_->dialect_;
         local_topology_util = main_monitor_->topology_util_;
     }
-    // Check connection
-    if (GetNodeId(local_hdbc, local_dialect, odbc_helper_).empty()) {
-        return;
-    };
-    // Query for hosts
-    const std::vector<HostInfo> hosts = local_topology_util->QueryTopology(
+    // Query for hosts, checking the connection in the same round trip
+    const TopologyUtil::TopologyAndIdentity fetched = local_topology_util->QueryTopologyAndIdentity(
         local_hdbc, main_monitor_->initial_host_, main_monitor_->template_host_);
+    if (fetched.query_failed || fetched.hosts.empty()) {
+        return;
+    }
+    const std::vector<HostInfo>& hosts = fetched.hosts;
 
     // Share / update topology to main monitor
     {
@@ -662,7 +976,7 @@ void ClusterTopologyMonitor::NodeMonitoringThread::ReaderThreadFetchTopology() {
 
     // Check if writer changed
     for (const HostInfo& hi : hosts) {
-        if (hi.IsHostWriter() && writer_host_info_ && hi.GetHostPortPair() != writer_host_info_->GetHostPortPair()) {
+        if (hi.IsHostWriter() && writer_host_info_ && !hi.IsSameHost(*writer_host_info_)) {
             writer_changed_ = true;
             main_monitor_->UpdateTopologyCache(hosts);
             TopologyUtil::LogTopology(hosts);
@@ -18,11 +18,12 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <utility>
 #include <vector>
 
 #ifdef WIN32
@@ -31,6 +32,9 @@
 #include <sql.h>
 #include <sqltypes.h>
 
+#include "topology_event_publisher.h"
+#include "topology_file_cache.h"
+#include "topology_refresh_policy.h"
 #include "topology_util.h"
 
 #include "../plugin/default_plugin.h"
@@ -40,6 +44,7 @@
 #include "../dialect/dialect.h"
 
 #include "../util/logger_wrapper.h"
+#include "../util/monitoring_scheduler.h"
 #include "../util/odbc_helper.h"
 #include "../util/plugin_service.h"
 #include "../util/rds_strings.h"
@@ -68,17 +73,27 @@ public:
     virtual std::vector<HostInfo> ForceRefresh(SQLHDBC hdbc, std::chrono::milliseconds timeout_ms);
 
     virtual void StartMonitor();
+    // A topology change is expected within the given time, such as during a Blue/Green switchover
+    void HintTopologyChange(std::chrono::milliseconds duration);
+    std::shared_ptr<TopologySubscription> Subscribe(std::function<void()> on_event);
 
 protected:
-    void Run();
+    // Refreshes the topology once, returning the delay until the next refresh
+    std::optional<std::chrono::milliseconds> Run();
     std::vector<HostInfo> WaitForTopologyUpdate(std::chrono::milliseconds timeout_ms);
-    void DelayMainThread(bool use_high_refresh_rate);
+    std::chrono::milliseconds GetRefreshDelay(bool use_high_refresh_rate);
     std::vector<HostInfo> FetchTopologyUpdateCache(SQLHDBC hdbc);
+    // Caches a topology fetched along with the identity of the connection, returning its hosts
+    std::vector<HostInfo> UpdateFetchedTopology(const TopologyUtil::TopologyAndIdentity& fetched);
     void UpdateTopologyCache(const std::vector<HostInfo>& hosts);
     std::string ConnForHost(const std::string& new_host) const;
 
 private:
-    class NodeMonitoringThread;
+    class NodeProbe;
+    class ProbeRound;
+    // Hosts with a lower priority are probed first
+    using ProbePriority = std::pair<int, uint64_t>;
+
     std::shared_ptr<TopologyUtil> topology_util_;
     mutable std::mutex topology_dialect_mutex_;
     bool InPanicMode() const;
@@ -88,8 +103,17 @@ private:
     bool HandlePanicMode();
     bool HandleRegularMode();
     void HandleIgnoreTopologyTiming();
+    void PersistTopology(const std::vector<HostInfo>& hosts);
+    static bool IsSameTopology(const std::vector<HostInfo>& hosts, const std::vector<HostInfo>& other_hosts);
+    bool IsFollower();
+    bool FollowLeader();
     void InitNodeMonitors();
     bool GetPossibleWriterConn();
+    void AddProbeLanes();
+    void StopProbes();
+    std::optional<std::chrono::milliseconds> RunProbeLane(const std::shared_ptr<ProbeRound>& round);
+    static ProbePriority GetProbePriority(const HostInfo& host, const std::vector<HostInfo>& latest_topology,
+        const std::shared_ptr<HostInfo>& lost_writer);
 
     std::shared_ptr<BasePlugin> plugin_head_;
     std::shared_ptr<OdbcHelper> odbc_helper_;
@@ -103,7 +127,7 @@ private:
     // Track Update Request
     std::atomic<bool> request_update_topology_;
     std::mutex request_update_topology_mutex_;
-    std::condition_variable request_update_topology_cv_;
+    // Retry delay while an update request is still pending
     const std::chrono::milliseconds TOPOLOGY_REQUEST_WAIT_MS = std::chrono::milliseconds(50);
 
     // Track Topology Updated
@@ -111,6 +135,25 @@ private:
     std::condition_variable topology_updated_;
     const std::chrono::milliseconds TOPOLOGY_UPDATE_WAIT_MS = std::chrono::milliseconds(1000);
     std::atomic<uint64_t> topology_version_{0};
+    TopologyEventPublisher event_publisher_;
+
+    // Topology cache file, nullptr unless enabled
+    std::shared_ptr<TopologyFileCache> topology_file_cache_;
+    std::mutex persisted_hosts_mutex_;
+    std::vector<HostInfo> persisted_hosts_;
+    std::chrono::steady_clock::time_point persisted_at_;
+
+    // Shared monitoring, only the process holding the leader lock monitors the cluster and
+    // the others follow the topology it persists. nullptr unless enabled.
+    std::unique_ptr<TopologyFileLock> leader_lock_;
+    // Failover in a following process still verifies the writer with its own connection
+    std::atomic<bool> verify_writer_requested_{false};
+    // Last topology published from the leader, only used by the monitoring task
+    std::vector<HostInfo> followed_hosts_;
+    const std::chrono::milliseconds FOLLOWER_POLL_MS = std::chrono::milliseconds(1000);
+    // Followers stop following a topology the leader has not rewritten for this many refresh intervals
+    static constexpr int LEADER_MISSED_REFRESHES = 3;
+    std::chrono::seconds leader_max_age_ = std::chrono::seconds(0);
 
     std::atomic<std::chrono::steady_clock::time_point> ignore_topology_request_end_ms_;
     std::chrono::milliseconds ignore_topology_request_ms_ = std::chrono::seconds(30);
@@ -118,16 +161,25 @@ private:
     std::chrono::milliseconds high_refresh_rate_ms_ = std::chrono::milliseconds(100);
     const std::chrono::seconds high_refresh_rate_after_panic_ = std::chrono::seconds(30);
     std::chrono::milliseconds refresh_rate_ms_ = std::chrono::seconds(30);
+    std::chrono::milliseconds min_refresh_rate_ms_ = std::chrono::seconds(1);
+    // Regular mode delay, shortened after changes and backing off while the topology is stable
+    std::unique_ptr<TopologyRefreshPolicy> refresh_policy_;
+    // Set when a refresh found new hosts or roles, consumed by the next regular mode refresh
+    std::atomic<bool> topology_changed_{false};
     std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::time_point{};
 
-    // Main Thread
-    std::shared_ptr<std::thread> monitoring_thread_;
+    // Main monitoring task, 0 until started
+    std::shared_ptr<MonitoringScheduler> scheduler_;
+    std::atomic<MonitoringScheduler::TaskId> task_id_{0};
     std::atomic<bool> is_running_;
-    // Children / Node Threads
-    std::map<std::string, std::shared_ptr<NodeMonitoringThread>> node_monitoring_threads_;
-    std::atomic<bool> node_threads_stop_;
+    // Panic mode probes, run by at most probe_concurrency_ lanes on the shared probe scheduler
+    std::shared_ptr<MonitoringScheduler> probe_scheduler_;
+    std::shared_ptr<ProbeRound> probe_round_;
+    // Lanes of the current and earlier rounds, earlier lanes may still be finishing a connect
+    std::vector<MonitoringScheduler::TaskId> probe_lane_ids_;
+    size_t probe_concurrency_ = DEFAULT_PROBE_CONCURRENCY;
 
-    // Children Thread Connections & Host Info
+    // Probe Connections & Host Info
     std::shared_ptr<SQLHDBC> node_threads_writer_hdbc_;
     std::shared_ptr<HostInfo> node_threads_writer_host_info_;
     std::shared_ptr<SQLHDBC> node_threads_reader_hdbc_;
@@ -151,32 +203,73 @@ private:
     std::shared_ptr<Dialect> dialect_;
 
     static constexpr int DEFAULT_TIMEOUT_SECONDS = 10;
+    static constexpr size_t DEFAULT_PROBE_CONCURRENCY = 4;
 };
 
-class ClusterTopologyMonitor::NodeMonitoringThread {
+// Probes a single host during panic mode, keeping its connection across probes
+class ClusterTopologyMonitor::NodeProbe {
 public:
-    NodeMonitoringThread(ClusterTopologyMonitor* monitor, const std::shared_ptr<HostInfo>& host_info,
+    NodeProbe(ClusterTopologyMonitor* monitor, ProbeRound* round, const std::shared_ptr<HostInfo>& host_info,
         const std::shared_ptr<HostInfo>& writer_host_info, const std::shared_ptr<OdbcHelper> &odbc_helper);
-    ~NodeMonitoringThread();
+    ~NodeProbe();
+
+    // Checks the role of the host once, connecting first if needed
+    void Probe();
+    const HostInfo& GetHostInfo() const;
 
 private:
-    void Run();
     void HandleReconnect();
-    void HandleWriterConn();
+    void HandleWriterConn(const TopologyUtil::TopologyAndIdentity& fetched);
     void HandleReaderConn();
     void ReaderThreadFetchTopology();
 
     ClusterTopologyMonitor* main_monitor_;
+    ProbeRound* round_;
     std::map<std::string, std::string> conn_info_;
     std::shared_ptr<HostInfo> host_info_;
     std::shared_ptr<HostInfo> writer_host_info_;
     bool writer_changed_ = false;
-    std::shared_ptr<std::thread> node_thread_;
     SQLHDBC hdbc_ = SQL_NULL_HDBC;
     bool reader_update_topology_ = false;
     std::shared_ptr<OdbcHelper> odbc_helper_;
+};
+
+// Probes of one panic episode. Lanes take the most likely writer among the hosts due for a probe,
+// so the number of hosts probed at once is bounded by the number of lanes.
+class ClusterTopologyMonitor::ProbeRound {
+public:
+    ProbeRound(ClusterTopologyMonitor* monitor, const std::shared_ptr<HostInfo>& lost_writer);
+
+    // Adds probes for hosts not probed yet and drops idle probes of hosts that left the topology
+    void AddHosts(const std::vector<HostInfo>& hosts);
+    // Returns nullptr and the time until a probe is due when there is nothing to probe now
+    std::shared_ptr<NodeProbe> Acquire(const std::function<ProbePriority(const HostInfo&)>& get_priority,
+        std::chrono::milliseconds& wait_ms);
+    void Release(const std::shared_ptr<NodeProbe>& probe);
+    size_t Size();
+
+    void AddLane(MonitoringScheduler::TaskId lane_id);
+    size_t GetLaneCount();
+    // Returns the lanes to wake so they finish
+    std::vector<MonitoringScheduler::TaskId> Stop();
+    bool IsStopped() const;
+    std::shared_ptr<HostInfo> GetLostWriter() const;
+
+    static constexpr std::chrono::milliseconds PROBE_INTERVAL_MS = std::chrono::milliseconds(100);
+
+private:
+    struct ProbeEntry {
+        std::shared_ptr<NodeProbe> probe;
+        std::chrono::steady_clock::time_point next_probe;
+        bool in_use = false;
+    };
 
-    const uint32_t THREAD_SLEEP_MS_ = 100;
+    ClusterTopologyMonitor* monitor_;
+    const std::shared_ptr<HostInfo> lost_writer_;
+    std::mutex mutex_;
+    std::map<std::string, ProbeEntry> probes_;
+    std::vector<MonitoringScheduler::TaskId> lane_ids_;
+    std::atomic<bool> stopped_{false};
 };
 
 #endif // CLUSTER_TOPOLOGY_MONITOR_H
@@ -16,6 +16,7 @@
 #define HOST_LIST_PROVIDER_H_
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -26,6 +27,7 @@
 
 class TopologyUtil;
 class Dialect;
+class TopologySubscription;
 
 class HostListProvider {
 public:
@@ -38,6 +40,8 @@ public:
     virtual std::string GetClusterId() { return {}; }
     virtual void UpdateDialect() {}
     virtual void UpdateDialect(const std::shared_ptr<TopologyUtil>& topology_util, const std::shared_ptr<Dialect>& dialect) {}
+    // Topology changes found from now on, nullptr if the provider does not monitor the topology
+    virtual std::shared_ptr<TopologySubscription> Subscribe(std::function<void()> on_event) { return nullptr; }
 
 protected:
     std::string cluster_id_;
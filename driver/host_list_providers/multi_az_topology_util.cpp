@@ -16,36 +16,30 @@
 
 #include <algorithm>
 
+#include "../util/monitoring_query_session.h"
 #include "../util/odbc_helper.h"
 #include "../util/plugin_service.h"
 
 MultiAzTopologyUtil::MultiAzTopologyUtil(const std::shared_ptr<OdbcHelper>& odbc_helper, const std::shared_ptr<Dialect>& dialect) : TopologyUtil(odbc_helper, dialect) {}
 
 std::string MultiAzTopologyUtil::GetWriterId(SQLHDBC hdbc) {
-    const DBC* dbc = static_cast<DBC*>(hdbc);
+    DBC* dbc = static_cast<DBC*>(hdbc);
     if (!dbc || !dbc->wrapped_dbc) {
         return "";
     }
 
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
-    RdsLibResult res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-    if (!SQL_SUCCEEDED(res.fn_result)) {
-        LOG(ERROR) << "Failed to allocate statement";
-        return "";
-    }
-
-    res = this->odbc_helper_->ExecDirect(&stmt, dialect_->GetReplicaSourceQuery());
-
-    if (!SQL_SUCCEEDED(res.fn_result)) {
-        this->odbc_helper_->BaseFreeStmt(&stmt);
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(dbc, this->odbc_helper_);
+    MonitoringQuerySession::Query* query = session->Execute(dialect_->GetReplicaSourceQuery());
+    if (!query) {
         LOG(ERROR) << "Failed to query writer ID";
         return "";
     }
+    const SQLHSTMT stmt = query->GetStmt();
 
     SQLTCHAR writer_id_buf[BUFFER_SIZE * 2] = {0};
     SQLLEN writer_id_len = 0;
 
-    const RdsLibResult fetch_res = this->odbc_helper_->Fetch(&stmt);
+    const RdsLibResult fetch_res = query->Fetch();
 
     std::string writer_id;
 
@@ -86,75 +80,90 @@ std::string MultiAzTopologyUtil::GetWriterId(SQLHDBC hdbc) {
         writer_id = AS_UTF8_CSTR(writer_id_buf);
     } else {
         // Returned nothing -> connected to the writer.
-        // Close the current statement and run the node ID query instead.
-        this->odbc_helper_->BaseFreeStmt(&stmt);
-        stmt = SQL_NULL_HANDLE;
-        res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-        if (!SQL_SUCCEEDED(res.fn_result)) {
-            LOG(ERROR) << "Failed to allocate statement";
-            return "";
-        }
-        res = this->odbc_helper_->ExecDirect(&stmt, dialect_->GetNodeIdQuery());
-        if (SQL_SUCCEEDED(res.fn_result)) {
-            SQLTCHAR id_buf[BUFFER_SIZE * 2] = {0};
-            SQLLEN id_len = 0;
-            this->odbc_helper_->BindCol(&stmt, 1, SQL_C_TCHAR, &id_buf, BUFFER_SIZE, &id_len);
-            const RdsLibResult fetch_res2 = this->odbc_helper_->Fetch(&stmt);
-            if (SQL_SUCCEEDED(fetch_res2.fn_result)) {
-#if UNICODE
-                Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), id_buf, nullptr, BUFFER_SIZE);
-#endif
-                writer_id = AS_UTF8_CSTR(id_buf);
-            }
-        }
+        // Run the node ID query instead.
+        writer_id = QueryString(session, dialect_->GetNodeIdQuery());
     }
-    this->odbc_helper_->BaseFreeStmt(&stmt);
     return writer_id;
 }
 
 std::vector<HostInfo> MultiAzTopologyUtil::GetHosts(SQLHDBC hdbc, const HostInfo& /*initial_host*/, const HostInfo& host_template) {
-    const DBC* dbc = static_cast<DBC*>(hdbc);
+    DBC* dbc = static_cast<DBC*>(hdbc);
     if (!dbc || !dbc->wrapped_dbc) {
         return {};
     }
 
-    const std::string writer_id = GetWriterId(hdbc);
+    return QueryHosts(dbc, dialect_->GetTopologyQuery(), GetWriterId(hdbc), host_template, nullptr);
+}
 
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
-    RdsLibResult res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-    if (!SQL_SUCCEEDED(res.fn_result)) {
-        return {};
+std::optional<TopologyUtil::TopologyAndIdentity> MultiAzTopologyUtil::GetHostsAndIdentity(
+    SQLHDBC hdbc, const HostInfo& /*initial_host*/, const HostInfo& host_template)
+{
+    const std::string query_str = dialect_->GetTopologyAndIdentityQuery();
+    if (query_str.empty()) {
+        return std::nullopt;
     }
 
-    res = this->odbc_helper_->ExecDirect(&stmt, dialect_->GetTopologyQuery());
-    if (!SQL_SUCCEEDED(res.fn_result)) {
-        this->odbc_helper_->BaseFreeStmt(&stmt);
+    TopologyAndIdentity result;
+    result.hosts = QueryHosts(static_cast<DBC*>(hdbc), query_str, "", host_template, &result);
+    return result;
+}
+
+std::vector<HostInfo> MultiAzTopologyUtil::QueryHosts(
+    DBC* dbc, const std::string& query_str, const std::string& writer_id, const HostInfo& host_template, TopologyAndIdentity* identity)
+{
+    if (identity) {
+        // Cleared once every row has been read
+        identity->query_failed = true;
+    }
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(dbc, this->odbc_helper_);
+    MonitoringQuerySession::Query* query = session->Execute(query_str);
+    if (!query) {
         return {};
     }
 
-    SQLTCHAR node_id[BUFFER_SIZE * 2] = {0};
-    SQLTCHAR instance_id[BUFFER_SIZE * 2] = {0};
-    SQLLEN node_id_len = 0;
-    SQLLEN instance_id_len = 0;
-
-    this->odbc_helper_->BindCol(&stmt, 1, SQL_C_TCHAR, &node_id, BUFFER_SIZE, &node_id_len);
-    this->odbc_helper_->BindCol(&stmt, 2, SQL_C_TCHAR, &instance_id, BUFFER_SIZE, &instance_id_len);
+    SQLTCHAR* node_id = static_cast<SQLTCHAR*>(query->BindCol(NODE_ID_COL, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+    SQLTCHAR* endpoint = static_cast<SQLTCHAR*>(query->BindCol(ENDPOINT_COL, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+    if (!node_id || !endpoint) {
+        return {};
+    }
+    SQLTCHAR* instance_id = nullptr;
+    SQLTCHAR* row_writer_id = nullptr;
+    if (identity) {
+        instance_id = static_cast<SQLTCHAR*>(query->BindCol(INSTANCE_ID_COL, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+        row_writer_id = static_cast<SQLTCHAR*>(query->BindCol(WRITER_ID_COL, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+        if (!instance_id || !row_writer_id) {
+            return {};
+        }
+    }
 
+    std::string current_writer_id = writer_id;
     std::vector<HostInfo> hosts;
-    res = this->odbc_helper_->Fetch(&stmt);
+    RdsLibResult res = query->Fetch();
     while (SQL_SUCCEEDED(res.fn_result)) {
 #if UNICODE
         Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), node_id, nullptr, BUFFER_SIZE);
-        Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), instance_id, nullptr, BUFFER_SIZE);
+        Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), endpoint, nullptr, BUFFER_SIZE);
+#endif
+        if (identity && identity->instance_id.empty()) {
+            // Same on every row
+#if UNICODE
+            Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), instance_id, nullptr, BUFFER_SIZE);
+            Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), row_writer_id, nullptr, BUFFER_SIZE);
 #endif
+            identity->instance_id = AS_UTF8_CSTR(instance_id);
+            current_writer_id = AS_UTF8_CSTR(row_writer_id);
+            identity->role = identity->instance_id == current_writer_id ? WRITER : READER;
+        }
         const std::string current_node_id = AS_UTF8_CSTR(node_id);
-        const HOST_ROLE role = (current_node_id == writer_id) ? WRITER : READER;
-        const HostInfo new_host = CreateHost(instance_id, role, host_template);
+        const HOST_ROLE role = (current_node_id == current_writer_id) ? WRITER : READER;
+        const HostInfo new_host = CreateHost(endpoint, role, host_template);
         hosts.push_back(new_host);
-        res = this->odbc_helper_->Fetch(&stmt);
+        res = query->Fetch();
+    }
+    if (identity) {
+        identity->query_failed = res.fn_result != SQL_NO_DATA;
     }
 
-    this->odbc_helper_->BaseFreeStmt(&stmt);
     return hosts;
 }
 
@@ -23,6 +23,18 @@ public:
     std::string GetWriterId(SQLHDBC hdbc) override;
     std::vector<HostInfo> GetHosts(SQLHDBC hdbc, const HostInfo &initial_host, const HostInfo &host_template) override;
     virtual HostInfo CreateHost(SQLTCHAR *endpoint, HOST_ROLE role, const HostInfo &host_template);
+
+protected:
+    std::optional<TopologyAndIdentity> GetHostsAndIdentity(SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template) override;
+
+private:
+    // Rows name the writer themselves when identity is given, writer_id is used otherwise
+    std::vector<HostInfo> QueryHosts(DBC* dbc, const std::string& query_str, const std::string& writer_id, const HostInfo& host_template, TopologyAndIdentity* identity);
+
+    static constexpr int NODE_ID_COL = 1;
+    static constexpr int ENDPOINT_COL = 2;
+    static constexpr int INSTANCE_ID_COL = 4;
+    static constexpr int WRITER_ID_COL = 5;
 };
 
 #endif // MULTI_AZ_TOPOLOGY_UTIL_H
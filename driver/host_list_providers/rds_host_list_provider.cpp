@@ -103,6 +103,23 @@ std::string RdsHostListProvider::GetClusterId() {
     return cluster_id_;
 }
 
+std::shared_ptr<TopologySubscription> RdsHostListProvider::Subscribe(std::function<void()> on_event) {
+    return monitor_->Subscribe(std::move(on_event));
+}
+
+void RdsHostListProvider::HintTopologyChange(const std::string& cluster_id, const std::chrono::milliseconds duration) {
+    std::shared_ptr<ClusterTopologyMonitor> monitor;
+    {
+        const std::lock_guard<std::mutex> lock_guard(monitor_map_mutex_);
+        if (auto itr = monitor_map_.find(cluster_id); itr != monitor_map_.end()) {
+            monitor = itr->second.second;
+        }
+    }
+    if (monitor) {
+        monitor->HintTopologyChange(duration);
+    }
+}
+
 std::shared_ptr<ClusterTopologyMonitor> RdsHostListProvider::GetOrCreateMonitor() {
     const std::lock_guard<std::mutex> lock_guard(monitor_map_mutex_);
     std::shared_ptr<ClusterTopologyMonitor> monitor;
@@ -46,6 +46,10 @@ public:
     virtual std::string GetClusterId() override;
     virtual void UpdateDialect() override;
     virtual void UpdateDialect(const std::shared_ptr<TopologyUtil>& topology_util, const std::shared_ptr<Dialect>& dialect) override;
+    virtual std::shared_ptr<TopologySubscription> Subscribe(std::function<void()> on_event) override;
+
+    // Hints the topology monitor of the cluster, if any, that its topology is about to change
+    static void HintTopologyChange(const std::string& cluster_id, std::chrono::milliseconds duration);
 
 private:
     std::shared_ptr<ClusterTopologyMonitor> GetOrCreateMonitor();
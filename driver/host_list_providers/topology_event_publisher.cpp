@@ -0,0 +1,127 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "topology_event_publisher.h"
+
+#include <algorithm>
+
+#include "../util/logger_wrapper.h"
+
+namespace {
+    const HostInfo* FindWriter(const std::vector<HostInfo>& hosts) {
+        const auto itr = std::ranges::find_if(hosts, [](const HostInfo& host) { return host.IsHostWriter(); });
+        return itr == hosts.end() ? nullptr : &*itr;
+    }
+
+    const HostInfo* FindSameHost(const std::vector<HostInfo>& hosts, const HostInfo& host) {
+        const auto itr = std::ranges::find_if(hosts, [&host](const HostInfo& other) { return other.IsSameHost(host); });
+        return itr == hosts.end() ? nullptr : &*itr;
+    }
+}
+
+TopologySubscription::TopologySubscription(std::function<void()> on_event)
+    : on_event_{ std::move(on_event) } {}
+
+bool TopologySubscription::Poll(TopologyEvent& event) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    event = events_[head % CAPACITY];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool TopologySubscription::TakeOverflow() {
+    return overflowed_.exchange(false);
+}
+
+void TopologySubscription::Push(const TopologyEvent& event) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) >= CAPACITY) {
+        overflowed_.store(true);
+        return;
+    }
+    events_[tail % CAPACITY] = event;
+    tail_.store(tail + 1, std::memory_order_release);
+}
+
+std::shared_ptr<TopologySubscription> TopologyEventPublisher::Subscribe(std::function<void()> on_event) {
+    std::shared_ptr<TopologySubscription> subscription = std::make_shared<TopologySubscription>(std::move(on_event));
+    const std::lock_guard<std::mutex> lock(publish_mutex_);
+    subscriptions_.push_back(subscription);
+    return subscription;
+}
+
+void TopologyEventPublisher::Publish(const std::vector<HostInfo>& previous_hosts, const std::vector<HostInfo>& hosts) {
+    const std::lock_guard<std::mutex> lock(publish_mutex_);
+    std::erase_if(subscriptions_, [](const std::weak_ptr<TopologySubscription>& subscription) { return subscription.expired(); });
+    if (subscriptions_.empty()) {
+        return;
+    }
+
+    const std::vector<TopologyEvent> events = GetEvents(previous_hosts, hosts);
+    if (events.empty()) {
+        return;
+    }
+    for (const std::weak_ptr<TopologySubscription>& weak_subscription : subscriptions_) {
+        const std::shared_ptr<TopologySubscription> subscription = weak_subscription.lock();
+        if (!subscription) {
+            continue;
+        }
+        for (const TopologyEvent& event : events) {
+            subscription->Push(event);
+        }
+        if (subscription->on_event_) {
+            try {
+                subscription->on_event_();
+            } catch (const std::exception& ex) {
+                LOG(ERROR) << "Topology event subscriber encountered error: " << ex.what();
+            }
+        }
+    }
+}
+
+size_t TopologyEventPublisher::GetSubscriptionCount() {
+    const std::lock_guard<std::mutex> lock(publish_mutex_);
+    return std::ranges::count_if(subscriptions_, [](const std::weak_ptr<TopologySubscription>& subscription) {
+        return !subscription.expired();
+    });
+}
+
+std::vector<TopologyEvent> TopologyEventPublisher::GetEvents(const std::vector<HostInfo>& previous_hosts, const std::vector<HostInfo>& hosts) {
+    std::vector<TopologyEvent> events;
+
+    const HostInfo* previous_writer = FindWriter(previous_hosts);
+    const HostInfo* writer = FindWriter(hosts);
+    // A topology without a writer is incomplete, the writer is only reported once found
+    if (writer && (!previous_writer || !writer->IsSameHost(*previous_writer))) {
+        events.push_back({ TopologyEvent::Type::WRITER_CHANGED, *writer, previous_writer ? *previous_writer : HostInfo{} });
+    }
+
+    for (const HostInfo& host : hosts) {
+        if (const HostInfo* previous_host = FindSameHost(previous_hosts, host); !previous_host) {
+            events.push_back({ TopologyEvent::Type::HOST_ADDED, host, HostInfo{} });
+        } else if (previous_host->GetHostState() != host.GetHostState()) {
+            events.push_back({ TopologyEvent::Type::HOST_STATE_CHANGED, host, *previous_host });
+        }
+    }
+    for (const HostInfo& previous_host : previous_hosts) {
+        if (!FindSameHost(hosts, previous_host)) {
+            events.push_back({ TopologyEvent::Type::HOST_REMOVED, previous_host, HostInfo{} });
+        }
+    }
+    return events;
+}
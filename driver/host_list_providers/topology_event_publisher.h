@@ -0,0 +1,89 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TOPOLOGY_EVENT_PUBLISHER_H_
+#define TOPOLOGY_EVENT_PUBLISHER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../host_info.h"
+
+struct TopologyEvent {
+    enum class Type : uint8_t {
+        WRITER_CHANGED,
+        HOST_ADDED,
+        HOST_REMOVED,
+        HOST_STATE_CHANGED
+    };
+
+    Type type;
+    // The new writer, the added or removed host, or the host in its new state
+    HostInfo host;
+    // The previous writer or the host in its previous state, empty otherwise
+    HostInfo previous_host;
+};
+
+// Bounded queue of topology events for a single consumer.
+// Events are pushed without blocking the consumer; when the consumer falls behind
+// by more than CAPACITY events, newer events are dropped and the overflow is reported once.
+class TopologySubscription {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    explicit TopologySubscription(std::function<void()> on_event);
+
+    // Returns false once the queue is empty
+    bool Poll(TopologyEvent& event);
+    // True if events were dropped since the last call, the current topology should be read again
+    bool TakeOverflow();
+
+private:
+    friend class TopologyEventPublisher;
+    // Only called by the publisher, one event at a time
+    void Push(const TopologyEvent& event);
+
+    std::array<TopologyEvent, CAPACITY> events_;
+    // Next event to read, only written by the consumer
+    alignas(64) std::atomic<size_t> head_{0};
+    // Next event to write, only written by the publisher
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<bool> overflowed_{false};
+    // Called by the publisher after pushing events, must neither block nor subscribe
+    const std::function<void()> on_event_;
+};
+
+// Delivers the changes between consecutive topologies of a cluster to its subscriptions.
+// A subscription ends once it is released by the subscriber.
+class TopologyEventPublisher {
+public:
+    std::shared_ptr<TopologySubscription> Subscribe(std::function<void()> on_event = nullptr);
+    void Publish(const std::vector<HostInfo>& previous_hosts, const std::vector<HostInfo>& hosts);
+    size_t GetSubscriptionCount();
+
+    static std::vector<TopologyEvent> GetEvents(const std::vector<HostInfo>& previous_hosts, const std::vector<HostInfo>& hosts);
+
+private:
+    // Serializes publishers, subscribers only take it to subscribe
+    std::mutex publish_mutex_;
+    std::vector<std::weak_ptr<TopologySubscription>> subscriptions_;
+};
+
+#endif // TOPOLOGY_EVENT_PUBLISHER_H_
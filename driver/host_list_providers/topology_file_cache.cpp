@@ -0,0 +1,408 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "topology_file_cache.h"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <thread>
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/file.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "../util/logger_wrapper.h"
+
+namespace {
+    constexpr char MAGIC[8] = { 'A', 'W', 'S', 'T', 'O', 'P', 'O', '\0' };
+    constexpr char FILE_EXTENSION[] = ".topology";
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t format_version;
+        uint32_t host_count;
+        uint64_t payload_size;
+        uint64_t checksum;
+        // Seconds since the system clock epoch, steady clock time is not shared between processes
+        int64_t written_at;
+    };
+
+    // Role, state, port, weight, replica lag and the length of an empty host name
+    constexpr size_t MIN_HOST_RECORD_SIZE =
+        sizeof(uint8_t) + sizeof(uint8_t) + sizeof(int32_t) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(uint16_t);
+
+    // FNV-1a, unlike std::hash stable across processes and builds
+    uint64_t Fnv1a(const char* data, const size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    void Append(std::string& buffer, const T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void AppendString(std::string& buffer, const std::string& value) {
+        Append(buffer, static_cast<uint16_t>(value.size()));
+        buffer.append(value);
+    }
+
+    // Bounds checked reads from the mapped file, which may be unaligned
+    class PayloadReader {
+    public:
+        PayloadReader(const char* data, const size_t size) : data_{ data }, size_{ size } {}
+
+        template <typename T>
+        bool Read(T& value) {
+            if (size_ - offset_ < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, data_ + offset_, sizeof(T));
+            offset_ += sizeof(T);
+            return true;
+        }
+
+        bool ReadString(std::string& value) {
+            uint16_t length = 0;
+            if (!Read(length) || size_ - offset_ < length) {
+                return false;
+            }
+            value.assign(data_ + offset_, length);
+            offset_ += length;
+            return true;
+        }
+
+        size_t Remaining() const { return size_ - offset_; }
+
+    private:
+        const char* data_;
+        size_t size_;
+        size_t offset_ = 0;
+    };
+
+#ifndef WIN32
+    // Files anyone else can write to may point connections at arbitrary hosts.
+    // On Windows the directory ACLs decide who may write.
+    bool IsTrusted(const int fd, const std::filesystem::path& path) {
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+            return false;
+        }
+        if (file_stat.st_uid != geteuid() || (file_stat.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+            LOG(WARNING) << "Ignoring topology cache file not exclusively owned by the current user: " << path.string();
+            return false;
+        }
+        return true;
+    }
+#endif
+
+    // Creates a file only readable and writable by the current user, fails if anything exists at the path
+    bool WriteNewFile(const std::filesystem::path& path, const std::string& contents) {
+#ifdef WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        DWORD written = 0;
+        const bool success = WriteFile(file, contents.data(), static_cast<DWORD>(contents.size()), &written, nullptr)
+            && written == contents.size();
+        CloseHandle(file);
+        return success;
+#else
+        const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd < 0) {
+            return false;
+        }
+        size_t offset = 0;
+        while (offset < contents.size()) {
+            const ssize_t written = write(fd, contents.data() + offset, contents.size() - offset);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        return close(fd) == 0 && offset == contents.size();
+#endif
+    }
+
+    // Read only mapping of a whole file
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& path) {
+#ifdef WIN32
+            file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) {
+                return;
+            }
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart == 0) {
+                return;
+            }
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_) {
+                return;
+            }
+            data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            size_ = data_ ? static_cast<size_t>(file_size.QuadPart) : 0;
+#else
+            const int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            struct stat file_stat {};
+            if (IsTrusted(fd, path) && fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+                void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    data_ = static_cast<const char*>(data);
+                    size_ = static_cast<size_t>(file_stat.st_size);
+                }
+            }
+            // The mapping stays valid once the descriptor is closed
+            close(fd);
+#endif
+        }
+
+        ~MappedFile() {
+#ifdef WIN32
+            if (data_) {
+                UnmapViewOfFile(data_);
+            }
+            if (mapping_) {
+                CloseHandle(mapping_);
+            }
+            if (file_ != INVALID_HANDLE_VALUE) {
+                CloseHandle(file_);
+            }
+#else
+            if (data_) {
+                munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* Data() const { return data_; }
+        size_t Size() const { return size_; }
+
+    private:
+#ifdef WIN32
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#endif
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+}
+
+TopologyFileCache::TopologyFileCache(std::filesystem::path directory) : directory_{ std::move(directory) } {}
+
+std::filesystem::path TopologyFileCache::GetPath(const std::string& cluster_id) const {
+    // Cluster IDs may contain characters that are not valid in file names
+    return directory_ / (std::format("{:016x}", Fnv1a(cluster_id.data(), cluster_id.size())) + FILE_EXTENSION);
+}
+
+std::filesystem::path TopologyFileCache::GetLockPath(const std::string& cluster_id) const {
+    std::filesystem::path path = GetPath(cluster_id);
+    path += ".lock";
+    return path;
+}
+
+std::vector<HostInfo> TopologyFileCache::Read(const std::string& cluster_id, const std::chrono::seconds max_age) const {
+    const std::filesystem::path path = GetPath(cluster_id);
+    const MappedFile file(path);
+    if (!file.Data()) {
+        return {};
+    }
+
+    FileHeader header{};
+    if (file.Size() < sizeof(FileHeader)) {
+        LOG(WARNING) << "Ignoring truncated topology cache file: " << path.string();
+        return {};
+    }
+    std::memcpy(&header, file.Data(), sizeof(FileHeader));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.format_version != FORMAT_VERSION) {
+        LOG(WARNING) << "Ignoring topology cache file with unsupported format: " << path.string();
+        return {};
+    }
+    const char* payload = file.Data() + sizeof(FileHeader);
+    if (header.payload_size != file.Size() - sizeof(FileHeader)
+        || header.checksum != Fnv1a(payload, static_cast<size_t>(header.payload_size))) {
+        LOG(WARNING) << "Ignoring corrupted topology cache file: " << path.string();
+        return {};
+    }
+    const std::chrono::system_clock::time_point written_at{ std::chrono::seconds(header.written_at) };
+    if (std::chrono::system_clock::now() - written_at > max_age) {
+        LOG(INFO) << "Ignoring outdated topology cache file: " << path.string();
+        return {};
+    }
+
+    PayloadReader reader(payload, static_cast<size_t>(header.payload_size));
+    std::string stored_cluster_id;
+    if (!reader.ReadString(stored_cluster_id) || stored_cluster_id != cluster_id) {
+        // Another cluster ID with the same file name
+        return {};
+    }
+    // Checked before reserving, the count must not be trusted further than the payload it describes
+    if (header.host_count > reader.Remaining() / MIN_HOST_RECORD_SIZE) {
+        LOG(WARNING) << "Ignoring malformed topology cache file: " << path.string();
+        return {};
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<HostInfo> hosts;
+    hosts.reserve(header.host_count);
+    for (uint32_t i = 0; i < header.host_count; i++) {
+        uint8_t role = 0;
+        uint8_t state = 0;
+        int32_t port = 0;
+        uint64_t weight = 0;
+        int64_t replica_lag_ms = 0;
+        std::string host;
+        if (!reader.Read(role) || !reader.Read(state) || !reader.Read(port) || !reader.Read(weight)
+            || !reader.Read(replica_lag_ms) || !reader.ReadString(host) || role > UNKNOWN || state > DOWN) {
+            LOG(WARNING) << "Ignoring malformed topology cache file: " << path.string();
+            return {};
+        }
+        hosts.emplace_back(host, port, static_cast<HOST_STATE>(state), static_cast<HOST_ROLE>(role), weight, now);
+        hosts.back().SetReplicaLag(std::chrono::milliseconds(replica_lag_ms));
+    }
+    return hosts;
+}
+
+bool TopologyFileCache::Write(const std::string& cluster_id, const std::vector<HostInfo>& hosts) const {
+    std::string payload;
+    AppendString(payload, cluster_id);
+    for (const HostInfo& host : hosts) {
+        Append(payload, static_cast<uint8_t>(host.GetHostRole()));
+        Append(payload, static_cast<uint8_t>(host.GetHostState()));
+        Append(payload, static_cast<int32_t>(host.GetPort()));
+        Append(payload, host.GetWeight());
+        Append(payload, static_cast<int64_t>(host.GetReplicaLag().count()));
+        AppendString(payload, host.GetHost());
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format_version = FORMAT_VERSION;
+    header.host_count = static_cast<uint32_t>(hosts.size());
+    header.payload_size = payload.size();
+    header.checksum = Fnv1a(payload.data(), payload.size());
+    header.written_at = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    const std::filesystem::path path = GetPath(cluster_id);
+    // Written next to the final file and renamed over it, which replaces it atomically
+    std::filesystem::path temp_path = path;
+    temp_path += std::format(".{}.{}.tmp",
+        std::hash<std::thread::id>{}(std::this_thread::get_id()),
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    std::string contents(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    contents.append(payload);
+    if (!WriteNewFile(temp_path, contents)) {
+        LOG(WARNING) << "Failed to write topology cache file: " << temp_path.string();
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        LOG(WARNING) << "Failed to replace topology cache file: " << path.string() << ", " << ec.message();
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+TopologyFileLock::TopologyFileLock(std::filesystem::path path) : path_{ std::move(path) } {}
+
+TopologyFileLock::~TopologyFileLock() {
+    // Closing releases the lock
+#ifdef WIN32
+    if (handle_) {
+        CloseHandle(handle_);
+    }
+#else
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+#endif
+}
+
+bool TopologyFileLock::TryLock() {
+    if (locked_.load()) {
+        return true;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(path_.parent_path(), ec);
+#ifdef WIN32
+    if (!handle_) {
+        HANDLE handle = CreateFileW(path_.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            LOG(WARNING) << "Failed to open topology lock file: " << path_.string();
+            return false;
+        }
+        handle_ = handle;
+    }
+    OVERLAPPED overlapped{};
+    if (!LockFileEx(handle_, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &overlapped)) {
+        return false;
+    }
+#else
+    if (fd_ < 0) {
+        int fd = open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd < 0 && errno == EEXIST) {
+            // Left behind by an earlier leader, only reused if it was created the same way
+            fd = open(path_.c_str(), O_RDWR | O_NOFOLLOW | O_CLOEXEC);
+            if (fd >= 0 && !IsTrusted(fd, path_)) {
+                close(fd);
+                return false;
+            }
+        }
+        if (fd < 0) {
+            LOG(WARNING) << "Failed to open topology lock file: " << path_.string();
+            return false;
+        }
+        fd_ = fd;
+    }
+    // Unlike fcntl locks, flock locks conflict between descriptors of the same process
+    if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        return false;
+    }
+#endif
+    locked_.store(true);
+    return true;
+}
+
+bool TopologyFileLock::IsLocked() const {
+    return locked_.load();
+}
@@ -0,0 +1,76 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOPOLOGY_FILE_CACHE_H_
+#define TOPOLOGY_FILE_CACHE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../host_info.h"
+
+// Persists the topology of a cluster to a file per cluster ID, so a new process can
+// route to instances before its first topology query completes.
+// Files are versioned and checksummed, anything unreadable is ignored.
+// Files are replaced atomically, readers never see a partially written topology.
+class TopologyFileCache {
+public:
+    // Version 2 adds the replica lag of each host
+    static constexpr uint32_t FORMAT_VERSION = 2;
+    // Older topologies are too likely to be outdated to be worth trying
+    static constexpr std::chrono::hours MAX_AGE = std::chrono::hours(24);
+
+    explicit TopologyFileCache(std::filesystem::path directory);
+
+    // Returns an empty list when there is no usable topology for the cluster,
+    // including one written longer than max_age ago
+    std::vector<HostInfo> Read(const std::string& cluster_id, std::chrono::seconds max_age = MAX_AGE) const;
+    bool Write(const std::string& cluster_id, const std::vector<HostInfo>& hosts) const;
+
+    std::filesystem::path GetPath(const std::string& cluster_id) const;
+    std::filesystem::path GetLockPath(const std::string& cluster_id) const;
+
+private:
+    std::filesystem::path directory_;
+};
+
+// Exclusive lock on a file, held until destroyed or until the owning process exits.
+// Also exclusive between locks of the same file within one process.
+class TopologyFileLock {
+public:
+    explicit TopologyFileLock(std::filesystem::path path);
+    ~TopologyFileLock();
+
+    TopologyFileLock(const TopologyFileLock&) = delete;
+    TopologyFileLock& operator=(const TopologyFileLock&) = delete;
+
+    // Does not wait for the current owner
+    bool TryLock();
+    bool IsLocked() const;
+
+private:
+    std::filesystem::path path_;
+#ifdef WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    std::atomic<bool> locked_ = false;
+};
+
+#endif // TOPOLOGY_FILE_CACHE_H_
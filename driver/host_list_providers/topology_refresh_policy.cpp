@@ -0,0 +1,47 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "topology_refresh_policy.h"
+
+#include <algorithm>
+
+TopologyRefreshPolicy::TopologyRefreshPolicy(const std::chrono::milliseconds floor_ms, const std::chrono::milliseconds ceiling_ms)
+    : floor_ms_{ std::max(floor_ms, std::chrono::milliseconds(1)) },
+      ceiling_ms_{ std::max(ceiling_ms, floor_ms_) },
+      // The first topology is a change from none
+      current_ms_{ floor_ms_ } {}
+
+void TopologyRefreshPolicy::OnRefresh(const bool topology_changed) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    current_ms_ = topology_changed ? floor_ms_ : std::min(current_ms_ * 2, ceiling_ms_);
+}
+
+void TopologyRefreshPolicy::OnConnectionError() {
+    const std::lock_guard<std::mutex> lock(lock_);
+    current_ms_ = floor_ms_;
+}
+
+bool TopologyRefreshPolicy::Hint(const std::chrono::steady_clock::time_point until, const std::chrono::steady_clock::time_point now) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    const bool was_active = now < hint_end_;
+    hint_end_ = std::max(hint_end_, until);
+    // Backs off from the floor once the hinted period is over
+    current_ms_ = floor_ms_;
+    return !was_active;
+}
+
+std::chrono::milliseconds TopologyRefreshPolicy::NextDelay(const std::chrono::steady_clock::time_point now) {
+    const std::lock_guard<std::mutex> lock(lock_);
+    return now < hint_end_ ? floor_ms_ : current_ms_;
+}
@@ -0,0 +1,42 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TOPOLOGY_REFRESH_POLICY_H_
+#define TOPOLOGY_REFRESH_POLICY_H_
+
+#include <chrono>
+#include <mutex>
+
+// Delay between regular topology refreshes of a cluster topology monitor.
+// Refreshes follow closely after the topology changed, a connection failed or a change
+// was hinted, then back off exponentially towards the ceiling while the topology stays the same.
+class TopologyRefreshPolicy {
+public:
+    TopologyRefreshPolicy(std::chrono::milliseconds floor_ms, std::chrono::milliseconds ceiling_ms);
+
+    void OnRefresh(bool topology_changed);
+    void OnConnectionError();
+    // Keeps refreshing at the floor until the given time, returns true unless a hint was already active
+    bool Hint(std::chrono::steady_clock::time_point until, std::chrono::steady_clock::time_point now);
+    std::chrono::milliseconds NextDelay(std::chrono::steady_clock::time_point now);
+
+private:
+    std::mutex lock_;
+    const std::chrono::milliseconds floor_ms_;
+    const std::chrono::milliseconds ceiling_ms_;
+    std::chrono::milliseconds current_ms_;
+    std::chrono::steady_clock::time_point hint_end_;
+};
+
+#endif // TOPOLOGY_REFRESH_POLICY_H_
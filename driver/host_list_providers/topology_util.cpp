@@ -27,6 +27,7 @@
 #include "../driver.h"
 #include "../odbcapi.h"
 #include "../util/logger_wrapper.h"
+#include "../util/monitoring_query_session.h"
 #include "../util/odbc_helper.h"
 #include "../util/rds_strings.h"
 #include "aurora_topology_util.h"
@@ -36,22 +37,19 @@ TopologyUtil::TopologyUtil(const std::shared_ptr<OdbcHelper> &odbc_helper, const
       dialect_{ dialect } {}
 
 HOST_ROLE TopologyUtil::GetConnectionRole(SQLHDBC hdbc) {
-    const DBC* dbc = static_cast<DBC*>(hdbc);
+    DBC* dbc = static_cast<DBC*>(hdbc);
     if (!dbc || !dbc->wrapped_dbc) {
         LOG(ERROR) << "GetConnectionRole passed in null DBC";
         return UNKNOWN;
     }
 
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
     bool is_reader = false;
-    SQLLEN len = 0;
-
-    const RdsLibResult res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-    if (SQL_SUCCEEDED(res.fn_result)) {
-        this->odbc_helper_->ExecDirect(&stmt, dialect_->GetIsReaderQuery());
-        this->odbc_helper_->BindCol(&stmt, IS_READER_COL, SQL_BIT, &is_reader, sizeof(is_reader), &len);
-        this->odbc_helper_->Fetch(&stmt);
-        this->odbc_helper_->BaseFreeStmt(&stmt);
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(dbc, this->odbc_helper_);
+    if (MonitoringQuerySession::Query* query = session->Execute(dialect_->GetIsReaderQuery())) {
+        if (const bool* value = static_cast<bool*>(query->BindCol(IS_READER_COL, SQL_BIT, sizeof(bool)))) {
+            query->Fetch();
+            is_reader = *value;
+        }
     }
 
     return is_reader ? READER : WRITER;
@@ -59,68 +57,41 @@ HOST_ROLE TopologyUtil::GetConnectionRole(SQLHDBC hdbc) {
 
 std::string TopologyUtil::GetWriterId(SQLHDBC hdbc)
 {
-    SQLRETURN rc;
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
-    SQLTCHAR writer_id[BUFFER_SIZE * 2] = {0};
-    SQLLEN len = 0;
-    RdsLibResult res;
-    const DBC* dbc = static_cast<DBC*>(hdbc);
-
+    DBC* dbc = static_cast<DBC*>(hdbc);
     if (!dbc || !dbc->wrapped_dbc) {
         LOG(ERROR) << "Topology Query passed in null DBC";
         return "";
     }
 
-    res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-
-    if (SQL_SUCCEEDED(res.fn_result)) {
-        res = this->odbc_helper_->ExecDirect(&stmt, dialect_->GetWriterIdQuery());
-
-        if (SQL_SUCCEEDED(res.fn_result)) {
-            this->odbc_helper_->BindCol(&stmt, 1, SQL_C_TCHAR, &writer_id, BUFFER_SIZE, &len);
-            this->odbc_helper_->Fetch(&stmt);
-        }
-        this->odbc_helper_->BaseFreeStmt(&stmt);
-    }
-
-#if UNICODE
-    Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), writer_id, nullptr, BUFFER_SIZE);
-    return ConvertUTF16ToUTF8(reinterpret_cast<uint16_t*>(writer_id));
-#endif
-
-    return {reinterpret_cast<const char*>(writer_id)};
+    return QueryString(MonitoringQuerySession::ForConnection(dbc, this->odbc_helper_), dialect_->GetWriterIdQuery());
 }
 
 std::string TopologyUtil::GetInstanceId(SQLHDBC hdbc) {
-    SQLRETURN rc;
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
-    SQLTCHAR instance_id[BUFFER_SIZE * 2] = {0};
-    SQLLEN len = 0;
-    RdsLibResult res;
-    const DBC* dbc = static_cast<DBC*>(hdbc);
-
+    DBC* dbc = static_cast<DBC*>(hdbc);
     if (!dbc || !dbc->wrapped_dbc) {
         LOG(ERROR) << "Topology Query passed in null DBC";
         return "";
     }
 
-    res = this->odbc_helper_->BaseAllocStmt(&dbc->wrapped_dbc, &stmt);
-
-    if (SQL_SUCCEEDED(res.fn_result)) {
-        res = this->odbc_helper_->ExecDirect(&stmt, dialect_->GetNodeIdQuery());
+    return QueryString(MonitoringQuerySession::ForConnection(dbc, this->odbc_helper_), dialect_->GetNodeIdQuery());
+}
 
-        if (SQL_SUCCEEDED(res.fn_result)) {
-            this->odbc_helper_->BindCol(&stmt, 1, SQL_C_TCHAR, &instance_id, BUFFER_SIZE, &len);
-            this->odbc_helper_->Fetch(&stmt);
-        }
-        this->odbc_helper_->BaseFreeStmt(&stmt);
+std::string TopologyUtil::QueryString(const std::shared_ptr<MonitoringQuerySession>& session, const std::string& query_str) {
+    MonitoringQuerySession::Query* query = session->Execute(query_str);
+    if (!query) {
+        return "";
+    }
+    SQLTCHAR* value = static_cast<SQLTCHAR*>(query->BindCol(1, SQL_C_TCHAR, BUFFER_SIZE, BUFFER_SIZE * 2 * sizeof(SQLTCHAR)));
+    if (!value) {
+        return "";
     }
+    query->Fetch();
 
 #if UNICODE
-    Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), instance_id, nullptr, BUFFER_SIZE);
-    return ConvertUTF16ToUTF8(reinterpret_cast<uint16_t*>(instance_id));
+    Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), value, nullptr, BUFFER_SIZE);
+    return ConvertUTF16ToUTF8(reinterpret_cast<uint16_t*>(value));
 #else
-    return {reinterpret_cast<const char*>(instance_id)};
+    return {reinterpret_cast<const char*>(value)};
 #endif
 }
 
@@ -139,6 +110,37 @@ std::vector<HostInfo> TopologyUtil::QueryTopology(SQLHDBC hdbc, const HostInfo&
     return VerifyWriter(hosts);
 }
 
+TopologyUtil::TopologyAndIdentity TopologyUtil::QueryTopologyAndIdentity(
+    SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template)
+{
+    const DBC* dbc = static_cast<DBC*>(hdbc);
+    if (!dbc || !dbc->wrapped_dbc || dbc->conn_status != CONN_CONNECTED) {
+        return {.query_failed = true};
+    }
+
+    std::optional<TopologyAndIdentity> result = GetHostsAndIdentity(hdbc, initial_host, host_template);
+    if (!result.has_value()) {
+        result = TopologyAndIdentity{};
+        result->instance_id = GetInstanceId(hdbc);
+        if (result->instance_id.empty()) {
+            // The node id query returns a row on any live connection
+            return {.query_failed = true};
+        }
+        result->role = GetConnectionRole(hdbc);
+        result->hosts = GetHosts(hdbc, initial_host, host_template);
+    }
+
+    LOG_IF(WARNING, !result->query_failed && result->hosts.empty()) << "Failed to fetch any instances from topology";
+    result->hosts = VerifyWriter(result->hosts);
+    return result.value();
+}
+
+std::optional<TopologyUtil::TopologyAndIdentity> TopologyUtil::GetHostsAndIdentity(
+    SQLHDBC /*hdbc*/, const HostInfo& /*initial_host*/, const HostInfo& /*host_template*/)
+{
+    return std::nullopt;
+}
+
 std::vector<HostInfo> TopologyUtil::VerifyWriter(const std::vector<HostInfo>& all_hosts)
 {
     std::vector<HostInfo> hosts;
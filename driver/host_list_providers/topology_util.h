@@ -15,21 +15,37 @@
 #ifndef TOPOLOGY_UTILS_H_
 #define TOPOLOGY_UTILS_H_
 
-#include <vector>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "../dialect/dialect.h"
 
 #include "../host_info.h"
 #include "../util/odbc_helper.h"
 
+class MonitoringQuerySession;
+
 class TopologyUtil {
 public:
+    // Topology together with the id and role of the connected instance
+    struct TopologyAndIdentity {
+        std::vector<HostInfo> hosts{};
+        // Empty if the query returned no rows
+        std::string instance_id{};
+        HOST_ROLE role = UNKNOWN;
+        // The connection could not be queried, as opposed to a query without rows
+        bool query_failed = false;
+    };
+
     TopologyUtil() = default;
     TopologyUtil(const std::shared_ptr<OdbcHelper> &odbc_helper, const std::shared_ptr<Dialect> &dialect);
     virtual std::string GetWriterId(SQLHDBC hdbc);
     virtual std::string GetInstanceId(SQLHDBC hdbc);
     virtual std::vector<HostInfo> QueryTopology(SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template);
+    // Single round trip when the dialect provides a combined query, separate queries otherwise
+    virtual TopologyAndIdentity QueryTopologyAndIdentity(SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template);
     virtual std::vector<HostInfo> VerifyWriter(const std::vector<HostInfo>& all_hosts);
     virtual HOST_ROLE GetConnectionRole(SQLHDBC hdbc);
     virtual std::vector<HostInfo> GetHosts(SQLHDBC hdbc, const HostInfo &initial_host, const HostInfo &host_template) = 0;
@@ -38,6 +54,11 @@ public:
     static void LogTopology(const std::vector<HostInfo>& hosts);
 
 protected:
+    // Runs the dialect's combined query, std::nullopt if the dialect has none
+    virtual std::optional<TopologyAndIdentity> GetHostsAndIdentity(SQLHDBC hdbc, const HostInfo& initial_host, const HostInfo& host_template);
+    // First column of the first row, empty if the query failed or returned no rows
+    std::string QueryString(const std::shared_ptr<MonitoringQuerySession>& session, const std::string& query_str);
+
     std::shared_ptr<OdbcHelper> odbc_helper_;
     std::shared_ptr<Dialect> dialect_;
 
@@ -0,0 +1,126 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "host_registry.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "util/logger_wrapper.h"
+
+namespace {
+    constexpr char HOST_PORT_SEPARATOR = ':';
+    // Same as HostInfo::NO_PORT
+    constexpr int EMPTY_HOST_PORT = -1;
+
+    std::string ToHostPortPair(const std::string& host, const int port) {
+        return host + HOST_PORT_SEPARATOR + std::to_string(port);
+    }
+}
+
+HostRegistry::HostRegistry(const size_t max_chunks)
+    : capacity_(std::clamp<size_t>(max_chunks, 1, MAX_CHUNKS) * CHUNK_SIZE)
+{
+    chunks_[0].store(new Chunk(), std::memory_order_release);
+    const std::string host_port_pair = ToHostPortPair("", EMPTY_HOST_PORT);
+    (*chunks_[0].load(std::memory_order_relaxed))[EMPTY_HOST_ID] = HostMetadata{ "", EMPTY_HOST_PORT, "", host_port_pair };
+    ids_.emplace(host_port_pair, EMPTY_HOST_ID);
+    size_.store(1, std::memory_order_release);
+}
+
+HostRegistry::~HostRegistry() {
+    for (std::atomic<Chunk*>& chunk : chunks_) {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+HostRegistry& HostRegistry::Registry() {
+    // Never destroyed, HostInfo may still be used by threads outliving static destruction
+    static HostRegistry* registry = new HostRegistry();
+    return *registry;
+}
+
+HostId HostRegistry::Intern(const std::string& host, const int port) {
+    return Registry().InternHost(host, port);
+}
+
+const HostMetadata& HostRegistry::Get(const HostId id) {
+    return Registry().GetMetadata(id);
+}
+
+size_t HostRegistry::Size() {
+    return Registry().GetSize();
+}
+
+HostId HostRegistry::InternHost(const std::string& host, const int port) {
+    std::string host_port_pair = ToHostPortPair(host, port);
+    {
+        const std::shared_lock<std::shared_mutex> lock(lock_);
+        if (const auto itr = ids_.find(host_port_pair); itr != ids_.end()) {
+            return itr->second;
+        }
+    }
+
+    const std::unique_lock<std::shared_mutex> lock(lock_);
+    if (const auto itr = ids_.find(host_port_pair); itr != ids_.end()) {
+        return itr->second;
+    }
+
+    std::string host_id;
+    if (const size_t idx = host.find('.'); idx != std::string::npos) {
+        host_id = host.substr(0, idx);
+    }
+    HostMetadata metadata{ host, port, std::move(host_id), host_port_pair };
+
+    const size_t id = size_.load(std::memory_order_relaxed);
+    if (id >= capacity_) {
+        // Slower lookups rather than failing to create the HostInfo
+        LOG_IF(WARNING, overflow_.empty()) << "Host registry is full, further hosts are looked up under a lock";
+        overflow_.push_back(std::move(metadata));
+        const HostId overflow_id = static_cast<HostId>(capacity_ + overflow_.size() - 1);
+        ids_.emplace(std::move(host_port_pair), overflow_id);
+        return overflow_id;
+    }
+
+    const size_t chunk_idx = id / CHUNK_SIZE;
+    Chunk* chunk = chunks_[chunk_idx].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Chunk();
+        chunks_[chunk_idx].store(chunk, std::memory_order_release);
+    }
+    (*chunk)[id % CHUNK_SIZE] = std::move(metadata);
+    ids_.emplace(std::move(host_port_pair), static_cast<HostId>(id));
+    // Publishes the metadata to readers of the new id
+    size_.store(id + 1, std::memory_order_release);
+    return static_cast<HostId>(id);
+}
+
+const HostMetadata& HostRegistry::GetMetadata(const HostId id) {
+    // Ids are only handed out once published, the acquire pairs with the release in InternHost
+    if (id < size_.load(std::memory_order_acquire)) {
+        return (*chunks_[id / CHUNK_SIZE].load(std::memory_order_acquire))[id % CHUNK_SIZE];
+    }
+    if (id >= capacity_) {
+        const std::shared_lock<std::shared_mutex> lock(lock_);
+        if (const size_t idx = id - capacity_; idx < overflow_.size()) {
+            return overflow_[idx];
+        }
+    }
+    return (*chunks_[0].load(std::memory_order_acquire))[EMPTY_HOST_ID];
+}
+
+size_t HostRegistry::GetSize() {
+    const std::shared_lock<std::shared_mutex> lock(lock_);
+    return size_.load(std::memory_order_acquire) + overflow_.size();
+}
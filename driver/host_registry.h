@@ -0,0 +1,75 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HOST_REGISTRY_H_
+#define HOST_REGISTRY_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+using HostId = uint32_t;
+
+// Metadata of an interned host, never modified or freed once registered
+struct HostMetadata {
+    std::string host;
+    int port;
+    std::string host_id;
+    std::string host_port_pair;
+};
+
+// Process-wide registry interning each host and port pair into a small integer HostId.
+// Ids are stable for the lifetime of the process, so equal ids mean the same host and port.
+// Looking up the metadata of an id does not lock, except for hosts interned once the
+// chunks are full. These are kept in a locked overflow list instead of failing.
+class HostRegistry {
+public:
+    // Reserved for the empty host of a default constructed HostInfo
+    static constexpr HostId EMPTY_HOST_ID = 0;
+    static constexpr size_t CHUNK_SIZE = 1024;
+    static constexpr size_t MAX_CHUNKS = 1024;
+
+    static HostId Intern(const std::string& host, int port);
+    static const HostMetadata& Get(HostId id);
+    static size_t Size();
+
+    // The process-wide registry is used through the static functions, other instances are only used by tests
+    explicit HostRegistry(size_t max_chunks = MAX_CHUNKS);
+    ~HostRegistry();
+    HostId InternHost(const std::string& host, int port);
+    const HostMetadata& GetMetadata(HostId id);
+    size_t GetSize();
+
+private:
+    static HostRegistry& Registry();
+
+    using Chunk = std::array<HostMetadata, CHUNK_SIZE>;
+
+    // Ids from here on are in overflow_
+    const size_t capacity_;
+    std::shared_mutex lock_;
+    std::unordered_map<std::string, HostId> ids_;
+    // Chunks are only ever added, an id below size_ always points to published metadata
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{};
+    std::atomic<size_t> size_ = 0;
+    // Guarded by lock_, elements are never moved so their metadata can be read after unlocking
+    std::deque<HostMetadata> overflow_;
+};
+
+#endif // HOST_REGISTRY_H_
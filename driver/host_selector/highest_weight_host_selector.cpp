@@ -17,34 +17,19 @@
 #include <algorithm>
 #include <stdexcept>
 
-HostInfo HighestWeightHostSelector::GetHost(std::vector<HostInfo> hosts, bool is_writer, std::unordered_map<std::string, std::string> properties) {
-    std::vector<HostInfo> eligible_hosts;
-    eligible_hosts.reserve(hosts.size());
-
-    std::ranges::copy_if(hosts, std::back_inserter(eligible_hosts), [&is_writer](const HostInfo& host) {
-        return host.IsHostUp() && is_writer == host.IsHostWriter();
-    });
-
-    if (eligible_hosts.empty() && !is_writer) {
-        std::ranges::copy_if(hosts, std::back_inserter(eligible_hosts), [&is_writer](const HostInfo& host) {
-            return host.IsHostUp();
-        });
-    }
-
-    if (eligible_hosts.empty()) {
-        throw std::runtime_error("No eligible hosts found in list");
-    }
-
-    const auto highest_weight_host = std::ranges::max_element(
-        eligible_hosts,
-        [](const HostInfo &a, const HostInfo &b) {
-            return a.GetWeight() < b.GetWeight();
+HostInfo HighestWeightHostSelector::GetHost(const std::vector<HostInfo>& hosts, bool is_writer,
+    const std::unordered_map<std::string, std::string>& properties) {
+    // Only the selected host is copied
+    const HostInfo* highest_weight_host = nullptr;
+    for (const HostInfo* host : GetEligibleHosts(hosts, is_writer)) {
+        if (!highest_weight_host || highest_weight_host->GetWeight() < host->GetWeight()) {
+            highest_weight_host = host;
         }
-    );
+    }
 
-    if (highest_weight_host == eligible_hosts.end()) {
+    if (!highest_weight_host) {
         throw std::runtime_error("No eligible hosts found in list");
     }
 
-    return *highest_weight_host;
+    return AdmitSelected(*highest_weight_host);
 }
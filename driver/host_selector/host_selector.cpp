@@ -0,0 +1,68 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "host_selector.h"
+
+#include "../host_health_registry.h"
+
+void HostSelector::SetMaxReplicaLag(const std::chrono::milliseconds max_replica_lag_ms) {
+    max_replica_lag_ms_ = max_replica_lag_ms;
+}
+
+bool HostSelector::IsWithinReplicaLag(const HostInfo& host) const {
+    return max_replica_lag_ms_ <= std::chrono::milliseconds(0) || host.GetReplicaLag() <= max_replica_lag_ms_;
+}
+
+std::vector<const HostInfo*> HostSelector::GetEligibleHosts(const std::vector<HostInfo>& hosts, const bool is_writer) const {
+    std::vector<const HostInfo*> selection;
+    selection.reserve(hosts.size());
+    HostHealthRegistry& health_registry = HostHealthRegistry::Global();
+    const auto select = [&](const bool any_role, const bool within_lag, const bool healthy) {
+        for (const HostInfo& host : hosts) {
+            if (host.IsHostUp() && (any_role || host.IsHostWriter() == is_writer)
+                && (!within_lag || IsWithinReplicaLag(host))
+                && (!healthy || health_registry.IsAvailable(host.GetHost()))) {
+                selection.push_back(&host);
+            }
+        }
+    };
+    const auto select_by_preference = [&](const bool healthy) {
+        // The writer does not lag, it is preferred over lagging readers
+        select(false, true, healthy);
+        if (selection.empty() && !is_writer) {
+            select(true, true, healthy);
+        }
+        // Only lagging hosts are left
+        if (selection.empty() && max_replica_lag_ms_ > std::chrono::milliseconds(0)) {
+            select(false, false, healthy);
+            if (selection.empty() && !is_writer) {
+                select(true, false, healthy);
+            }
+        }
+    };
+
+    select_by_preference(true);
+    // Hosts with an open circuit are only selected when no other host is eligible
+    if (selection.empty()) {
+        select_by_preference(false);
+    }
+    return selection;
+}
+
+const HostInfo& HostSelector::AdmitSelected(const HostInfo& host) {
+    // A concurrent selection may have admitted its own probe first, the host is still returned
+    // as it was eligible and at worst receives two probes
+    HostHealthRegistry::Global().TryAdmitProbe(host.GetHost());
+    return host;
+}
@@ -15,6 +15,7 @@
 #ifndef HOST_SELECTOR_H_
 #define HOST_SELECTOR_H_
 
+#include <chrono>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -38,8 +39,8 @@ static std::unordered_map<std::string, HostSelectorStrategies> const host_select
 class HostSelector {
 public:
     virtual ~HostSelector() = default;
-    virtual HostInfo GetHost(std::vector<HostInfo> hosts, bool is_writer,
-        std::unordered_map<std::string, std::string> properties) = 0;
+    virtual HostInfo GetHost(const std::vector<HostInfo>& hosts, bool is_writer,
+        const std::unordered_map<std::string, std::string>& properties) = 0;
     static HostSelectorStrategies GetHostSelectorStrategy(const std::string &auth_type) {
         std::string local_str = auth_type;
         std::string local_str_upper = RDS_STR_UPPER(local_str);
@@ -48,6 +49,21 @@ public:
         }
         return HostSelectorStrategies::UNKNOWN_STRATEGY;
     }
+
+    // Readers lagging further behind the writer are only selected when no other host is available, 0 disables the limit
+    void SetMaxReplicaLag(std::chrono::milliseconds max_replica_lag_ms);
+    bool IsWithinReplicaLag(const HostInfo& host) const;
+
+protected:
+    // Up hosts of the requested role, falling back to any up host for readers.
+    // Hosts within the replica lag limit are preferred over the others, and
+    // hosts the HostHealthRegistry considers available over those with an open circuit.
+    std::vector<const HostInfo*> GetEligibleHosts(const std::vector<HostInfo>& hosts, bool is_writer) const;
+    // Admits the selected host as the probe of its circuit once its backoff has passed,
+    // only the returned host is admitted and not every eligible one.
+    static const HostInfo& AdmitSelected(const HostInfo& host);
+
+    std::chrono::milliseconds max_replica_lag_ms_{0};
 };
 
 #endif // HOST_SELECTOR_H_
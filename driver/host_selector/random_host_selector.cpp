@@ -18,22 +18,11 @@
 #include <random>
 #include <stdexcept>
 
-HostInfo RandomHostSelector::GetHost(std::vector<HostInfo> hosts, bool is_writer,
-    std::unordered_map<std::string, std::string> properties) {
-
-    std::vector<HostInfo> selection;
-    selection.reserve(hosts.size());
-
-    std::ranges::copy_if(hosts, std::back_inserter(selection), [&is_writer](const HostInfo& host) {
-        return host.IsHostUp() && host.IsHostWriter() == is_writer;
-    });
-
-    if (selection.empty() && !is_writer) {
-        std::ranges::copy_if(hosts, std::back_inserter(selection), [&is_writer](const HostInfo& host) {
-            return host.IsHostUp();
-        });
-    }
+HostInfo RandomHostSelector::GetHost(const std::vector<HostInfo>& hosts, bool is_writer,
+    const std::unordered_map<std::string, std::string>& properties) {
 
+    // Only the selected host is copied
+    const std::vector<const HostInfo*> selection = GetEligibleHosts(hosts, is_writer);
     if (selection.empty()) {
         throw std::runtime_error("No available hosts found in list");
     }
@@ -43,5 +32,5 @@ HostInfo RandomHostSelector::GetHost(std::vector<HostInfo> hosts, bool is_writer
     std::uniform_int_distribution<> dis(0, static_cast<int>(selection.size()) - 1);
 
     const int rand_idx = dis(gen);
-    return selection[rand_idx];
+    return AdmitSelected(*selection[rand_idx]);
 }
@@ -20,8 +20,8 @@
 
 class RandomHostSelector: public HostSelector {
 public:
-    HostInfo GetHost(std::vector<HostInfo> hosts, bool is_writer,
-        std::unordered_map<std::string, std::string> properties) override;
+    HostInfo GetHost(const std::vector<HostInfo>& hosts, bool is_writer,
+        const std::unordered_map<std::string, std::string>& properties) override;
 };
 
 #endif // RANDOM_HOST_SELECTOR_H_
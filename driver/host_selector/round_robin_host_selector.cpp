@@ -42,20 +42,12 @@ void RoundRobinHostSelector::ClearCache() {
     round_robin_cache.Clear();
 }
 
-HostInfo RoundRobinHostSelector::GetHost(std::vector<HostInfo> hosts, bool is_writer,
-    const std::unordered_map<std::string, std::string> properties) {
+HostInfo RoundRobinHostSelector::GetHost(const std::vector<HostInfo>& hosts, bool is_writer,
+    const std::unordered_map<std::string, std::string>& properties) {
 
     std::vector<HostInfo> selection;
-    selection.reserve(hosts.size());
-
-    std::ranges::copy_if(hosts, std::back_inserter(selection), [&is_writer](const HostInfo& host) {
-        return host.IsHostUp() && host.IsHostWriter() == is_writer;
-    });
-
-    if (selection.empty() && !is_writer) {
-        std::ranges::copy_if(hosts, std::back_inserter(selection), [&is_writer](const HostInfo& host) {
-            return host.IsHostUp();
-        });
+    for (const HostInfo* host : GetEligibleHosts(hosts, is_writer)) {
+        selection.push_back(*host);
     }
 
     if (selection.empty()) {
@@ -104,7 +96,7 @@ HostInfo RoundRobinHostSelector::GetHost(std::vector<HostInfo> hosts, bool is_wr
     cluster_info->weight_counter--;
     cluster_info->last_host = std::make_shared<HostInfo>(selection.at(target_host_idx));
 
-    return selection.at(target_host_idx);
+    return AdmitSelected(selection.at(target_host_idx));
 }
 
 /**
@@ -25,8 +25,8 @@
 
 class RoundRobinHostSelector: public HostSelector {
 public:
-    HostInfo GetHost(std::vector<HostInfo> hosts, bool is_writer,
-        std::unordered_map<std::string, std::string> properties) override;
+    HostInfo GetHost(const std::vector<HostInfo>& hosts, bool is_writer,
+        const std::unordered_map<std::string, std::string>& properties) override;
     static void SetRoundRobinWeight(const std::vector<HostInfo> &hosts,
         std::unordered_map<std::string, std::string>& properties);
     static void ClearCache();
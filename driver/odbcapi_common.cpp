@@ -266,11 +266,10 @@ SQLRETURN SQL_API SQLBindCol(
     }
     STMT* stmt = static_cast<STMT*>(StatementHandle);
     const DBC* dbc = stmt->dbc;
-    const ENV* env = dbc->env;
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -305,17 +304,16 @@ SQLRETURN SQL_API SQLBindCol(
             bindings.push_back(std::move(new_buffer));
 
             BoundColBuffer& ref = bindings.back();
-            const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLBindCol, RDS_STR_SQLBindCol,
-                stmt->wrapped_stmt, ColumnNumber, TargetType, ref.local_buf.data(),
-                BufferLength, ref.local_str_len.get()
+            const RdsLibResult res = RDS_BindCol(stmt, ColumnNumber,
+                ColBinding{TargetType, ref.local_buf.data(), BufferLength, ref.local_str_len.get()}
             );
             return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
         }
     }
     #endif
 
-    const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLBindCol, RDS_STR_SQLBindCol,
-        stmt->wrapped_stmt, ColumnNumber, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr
+    const RdsLibResult res = RDS_BindCol(stmt, ColumnNumber,
+        ColBinding{TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr}
     );
     return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
 }
@@ -338,11 +336,10 @@ SQLRETURN SQL_API SQLBindParameter(
     }
     STMT* stmt = static_cast<STMT*>(StatementHandle);
     const DBC* dbc = stmt->dbc;
-    const ENV* env = dbc->env;
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -401,11 +398,10 @@ SQLRETURN SQL_API SQLBindParameter(
                 *new_buffer.local_str_len = static_cast<SQLLEN>(str_len_bytes);
             } else if (!is_data_at_exec) {
                 // Pass null data to underlying if user did not pass data at exec
-                const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(
-                    env->driver_lib_loader, RDS_FP_SQLBindParameter, RDS_STR_SQLBindParameter, stmt->wrapped_stmt,
-                    ParameterNumber, InputOutputType, ValueType, ParameterType, ColumnSize,
+                const RdsLibResult res = RDS_BindParameter(stmt, ParameterNumber, ParamBinding{
+                    InputOutputType, ValueType, ParameterType, ColumnSize,
                     DecimalDigits, ParameterValuePtr, BufferLength, StrLen_or_IndPtr
-                );
+                });
                 return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
             }
 
@@ -424,19 +420,18 @@ SQLRETURN SQL_API SQLBindParameter(
                 ? StrLen_or_IndPtr
                 : ref.local_str_len.get();
 
-            const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(
-                env->driver_lib_loader, RDS_FP_SQLBindParameter, RDS_STR_SQLBindParameter, stmt->wrapped_stmt,
-                ParameterNumber, InputOutputType, ValueType, ParameterType, ColumnSize,
+            const RdsLibResult res = RDS_BindParameter(stmt, ParameterNumber, ParamBinding{
+                InputOutputType, ValueType, ParameterType, ColumnSize,
                 DecimalDigits, bind_ptr, bind_len, bind_itr
-            );
+            });
             return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
         }
     }
     #endif
 
-    const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLBindParameter, RDS_STR_SQLBindParameter,
-        stmt->wrapped_stmt, ParameterNumber, InputOutputType, ValueType, ParameterType, ColumnSize, DecimalDigits, ParameterValuePtr, BufferLength, StrLen_or_IndPtr
-    );
+    const RdsLibResult res = RDS_BindParameter(stmt, ParameterNumber, ParamBinding{
+        InputOutputType, ValueType, ParameterType, ColumnSize, DecimalDigits, ParameterValuePtr, BufferLength, StrLen_or_IndPtr
+    });
     return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
 }
 
@@ -682,7 +677,7 @@ SQLRETURN SQL_API SQLDescribeParam(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDescribeParam, RDS_STR_SQLDescribeParam,
@@ -732,6 +727,9 @@ SQLRETURN SQL_API SQLDisconnect(
     ret = RDS_ProcessLibRes(SQL_HANDLE_DBC, dbc, res);
     if (SQL_SUCCEEDED(ret)) {
         dbc->conn_status = CONN_NOT_CONNECTED;
+        dbc->connection_generation++;
+        // Settings made through SQL end with the session, connection attributes persist
+        dbc->session_state = SessionStateTracker();
     }
     return ret;
 }
@@ -763,7 +761,8 @@ SQLRETURN SQL_API SQLExecute(
         #if UNICODE && !defined(_WIN32)
             ConvertBoundParamBuffersBeforeExecute(stmt);
         #endif
-        rc = dbc->plugin_head->Execute(StatementHandle);
+        ExecutionContext context;
+        rc = dbc->plugin_head->Execute(StatementHandle, context);
     } else {
         LOG(ERROR) << "Cannot execute without an open connection";
         stmt->err = std::make_unique<ERR_INFO>("SQLExecute - Connection not open", ERR_CONNECTION_NOT_OPEN);
@@ -1073,7 +1072,7 @@ SQLRETURN SQL_API SQLGetStmtOption(
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLGetStmtOption, RDS_STR_SQLGetStmtOption,
@@ -1120,7 +1119,7 @@ SQLRETURN SQL_API SQLNumParams(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLNumParams, RDS_STR_SQLNumParams,
@@ -1144,7 +1143,7 @@ SQLRETURN SQL_API SQLNumResultCols(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLNumResultCols, RDS_STR_SQLNumResultCols,
@@ -1211,7 +1210,7 @@ SQLRETURN SQL_API SQLParamOptions(
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLParamOptions, RDS_STR_SQLParamOptions,
@@ -1360,7 +1359,7 @@ SQLRETURN SQL_API SQLSetParam(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetParam, RDS_STR_SQLSetParam,
@@ -1435,7 +1434,7 @@ SQLRETURN SQL_API SQLSetStmtOption(
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetStmtOption, RDS_STR_SQLSetStmtOption,
@@ -39,6 +39,7 @@
 #include "util/connection_string_keys.h"
 #include "util/logger_wrapper.h"
 #include "util/map_utils.h"
+#include "util/monitoring_query_session.h"
 #include "util/odbc_dsn_helper.h"
 #include "util/plugin_service.h"
 #include "util/rds_lib_loader.h"
@@ -227,6 +228,113 @@ SQLRETURN RDS_AllocStmt(
     return SQL_SUCCESS;
 }
 
+SQLRETURN RDS_RestoreStmt(
+    STMT *         stmt)
+{
+    const DBC* dbc = stmt->dbc;
+    const ENV* env = dbc->env;
+
+    if (!dbc->wrapped_dbc) {
+        LOG(ERROR) << "Unable to use STMT, underlying DBC nulled";
+        stmt->err = std::make_unique<ERR_INFO>("Unable to use STMT, underlying DBC nulled", ERR_UNDERLYING_HANDLE_NULL);
+        return SQL_ERROR;
+    }
+
+    RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLAllocHandle, RDS_STR_SQLAllocHandle,
+        SQL_HANDLE_STMT, dbc->wrapped_dbc, &stmt->wrapped_stmt
+    );
+    if (!stmt->wrapped_stmt) {
+        return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
+    }
+
+    // Set statement settings
+    for (auto const& [key, val] : stmt->attr_map) {
+        NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetStmtAttr, RDS_STR_SQLSetStmtAttr,
+            stmt->wrapped_stmt, key, val.first, val.second
+        );
+    }
+    // Cursor Name
+    const std::string cursor_name = stmt->cursor_name;
+#if UNICODE
+    const std::vector<uint16_t> cursor_name_vector = ConvertUTF8ToUTF16(cursor_name);
+    SQLTCHAR* cursor_name_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(cursor_name_vector.data()));
+    NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetCursorName, RDS_STR_SQLSetCursorName,
+        stmt->wrapped_stmt, cursor_name_sqltchar, cursor_name.length()
+    );
+#else
+    NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetCursorName, RDS_STR_SQLSetCursorName,
+        stmt->wrapped_stmt, AS_SQLTCHAR(cursor_name), cursor_name.length()
+    );
+#endif
+
+    // Re-prepare on first use so only the statements still in use pay for it
+    SQLRETURN ret = SQL_SUCCESS;
+    if (stmt->prepared_query.has_value()) {
+        res = dbc->plugin_service->GetOdbcHelper()->Prepare(&stmt->wrapped_stmt, stmt->prepared_query.value());
+        ret = RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
+        if (SQL_SUCCEEDED(ret)) {
+            LOG(INFO) << "Re-prepared statement on the current underlying connection";
+        } else {
+            LOG(WARNING) << "Unable to re-prepare statement on the current underlying connection";
+        }
+    }
+
+    // Bindings point at application or wrapper owned buffers that outlive the underlying statement
+    const std::map<SQLUSMALLINT, ParamBinding> param_bindings = stmt->param_bindings;
+    for (auto const& [number, binding] : param_bindings) {
+        RDS_BindParameter(stmt, number, binding);
+    }
+    const std::map<SQLUSMALLINT, ColBinding> col_bindings = stmt->col_bindings;
+    for (auto const& [number, binding] : col_bindings) {
+        RDS_BindCol(stmt, number, binding);
+    }
+    return ret;
+}
+
+bool RDS_EnsureWrappedStmt(
+    STMT *         stmt)
+{
+    if (!HasWrappedHandle(stmt) && stmt != nullptr && stmt->dbc->wrapped_dbc) {
+        RDS_RestoreStmt(stmt);
+    }
+    return HasWrappedHandle(stmt);
+}
+
+RdsLibResult RDS_BindParameter(
+    STMT *              stmt,
+    SQLUSMALLINT        ParameterNumber,
+    const ParamBinding& Binding)
+{
+    const ENV* env = stmt->dbc->env;
+    const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLBindParameter, RDS_STR_SQLBindParameter,
+        stmt->wrapped_stmt, ParameterNumber, Binding.input_output_type, Binding.value_type, Binding.param_type,
+        Binding.column_size, Binding.decimal_digits, Binding.value_ptr, Binding.buffer_length, Binding.str_len_or_ind_ptr
+    );
+    if (SQL_SUCCEEDED(res.fn_result)) {
+        stmt->param_bindings.insert_or_assign(ParameterNumber, Binding);
+    }
+    return res;
+}
+
+RdsLibResult RDS_BindCol(
+    STMT *              stmt,
+    SQLUSMALLINT        ColumnNumber,
+    const ColBinding&   Binding)
+{
+    const ENV* env = stmt->dbc->env;
+    const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLBindCol, RDS_STR_SQLBindCol,
+        stmt->wrapped_stmt, ColumnNumber, Binding.target_type, Binding.target_value_ptr, Binding.buffer_length, Binding.str_len_or_ind_ptr
+    );
+    if (SQL_SUCCEEDED(res.fn_result)) {
+        if (Binding.target_value_ptr) {
+            stmt->col_bindings.insert_or_assign(ColumnNumber, Binding);
+        } else {
+            stmt->col_bindings.erase(ColumnNumber);
+        }
+    }
+    return res;
+}
+
 SQLRETURN RDS_AllocDesc(
     SQLHDBC        ConnectionHandle,
     SQLHANDLE *    DescriptorHandlePointer)
@@ -398,6 +506,8 @@ SQLRETURN RDS_FreeConnect(
     }
     dbc->desc_list.clear();
 
+    MonitoringQuerySession::Release(dbc);
+
     // Clean up wrapped DBC
     if (dbc->wrapped_dbc) {
         const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLFreeHandle, RDS_STR_SQLFreeHandle,
@@ -459,6 +569,9 @@ SQLRETURN RDS_FreeEnv(
     }
     env->dbc_list.clear();
 
+    // Pooled connections were allocated under the underlying Env
+    PluginService::GetConnectionPool()->Clear(env);
+
     if (env->driver_lib_loader) {
         // Clean underlying Env
         if (env->wrapped_env) {
@@ -504,10 +617,12 @@ SQLRETURN RDS_FreeStmt(
                 // Let underlying driver cleanup before we remove any of our data
                 if (Option == SQL_UNBIND) {
                     stmt->bound_col_buffers.clear();
+                    stmt->col_bindings.clear();
                 }
                 if (Option == SQL_RESET_PARAMS) {
                     stmt->put_data_char_conversion = false;
                     stmt->bound_param_buffers.clear();
+                    stmt->param_bindings.clear();
                 }
 
                 return ret;
@@ -619,36 +734,48 @@ SQLRETURN RDS_SQLSetConnectAttr(
     const ENV* env = dbc->env;
 
     SQLRETURN ret = SQL_SUCCESS;
+    bool notify_plugins = false;
 
-    const std::lock_guard<std::recursive_mutex> lock_guard(dbc->lock);
-    ClearError(dbc);
+    {
+        const std::lock_guard<std::recursive_mutex> lock_guard(dbc->lock);
+        ClearError(dbc);
 
-    // If already connected, apply value to underlying DBC, otherwise track and apply on connect
-    if (dbc->wrapped_dbc) {
+        // If already connected, apply value to underlying DBC, otherwise track and apply on connect
+        if (dbc->wrapped_dbc) {
 #if UNICODE
-        const auto odbc_helper = dbc->plugin_service->GetOdbcHelper();
-        if (odbc_helper->NeedsConversion() && ValuePtr
-            && OdbcHelper::IsStringConnectAttr(Attribute)
-            && (StringLength == SQL_NTS || StringLength > 0)) {
-            auto value_converted = odbc_helper->ConvertInput(static_cast<SQLTCHAR*>(ValuePtr), StringLength);
-            const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
-                dbc->wrapped_dbc, Attribute, value_converted.tchar_ptr, StringLength
-            );
-            ret = RDS_ProcessLibRes(SQL_HANDLE_DBC, dbc, res);
-        } else
+            const auto odbc_helper = dbc->plugin_service->GetOdbcHelper();
+            if (odbc_helper->NeedsConversion() && ValuePtr
+                && OdbcHelper::IsStringConnectAttr(Attribute)
+                && (StringLength == SQL_NTS || StringLength > 0)) {
+                auto value_converted = odbc_helper->ConvertInput(static_cast<SQLTCHAR*>(ValuePtr), StringLength);
+                const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
+                    dbc->wrapped_dbc, Attribute, value_converted.tchar_ptr, StringLength
+                );
+                ret = RDS_ProcessLibRes(SQL_HANDLE_DBC, dbc, res);
+            } else
 #endif
-        {
-            const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
-                dbc->wrapped_dbc, Attribute, ValuePtr, StringLength
-            );
-            ret = RDS_ProcessLibRes(SQL_HANDLE_DBC, dbc, res);
+            {
+                const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
+                    dbc->wrapped_dbc, Attribute, ValuePtr, StringLength
+                );
+                ret = RDS_ProcessLibRes(SQL_HANDLE_DBC, dbc, res);
+            }
+            if (SQL_SUCCEEDED(ret)) {
+                dbc->session_state.TrackAttribute(Attribute, ValuePtr, StringLength);
+            }
         }
+        dbc->attr_map.insert_or_assign(Attribute, std::make_pair(ValuePtr, StringLength));
+
+        if (SQL_ATTR_AUTOCOMMIT == Attribute) {
+            dbc->auto_commit = reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_ON) == ValuePtr;
+            dbc->transaction_status = dbc->auto_commit ? TRANSACTION_CLOSED : TRANSACTION_OPEN;
+        }
+        notify_plugins = SQL_SUCCEEDED(ret) && dbc->wrapped_dbc && dbc->plugin_head;
     }
-    dbc->attr_map.insert_or_assign(Attribute, std::make_pair(ValuePtr, StringLength));
 
-    if (SQL_ATTR_AUTOCOMMIT == Attribute) {
-        dbc->auto_commit = reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_ON) == ValuePtr;
-        dbc->transaction_status = dbc->auto_commit ? TRANSACTION_CLOSED : TRANSACTION_OPEN;
+    // Outside of the connection lock, plugins take their own locks before the connection's
+    if (notify_plugins) {
+        dbc->plugin_head->NotifyConnectAttr(dbc, Attribute, ValuePtr);
     }
 
     return ret;
@@ -693,7 +820,7 @@ SQLRETURN RDS_SQLColAttribute(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 #if UNICODE
@@ -737,7 +864,7 @@ SQLRETURN RDS_SQLColAttributes(
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 #if UNICODE
@@ -786,7 +913,7 @@ SQLRETURN RDS_SQLColumnPrivileges(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -831,7 +958,7 @@ SQLRETURN RDS_SQLColumns(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -994,7 +1121,7 @@ SQLRETURN RDS_SQLDescribeCol(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 #if UNICODE
@@ -1225,17 +1352,21 @@ SQLRETURN RDS_SQLExecDirect(
 #if UNICODE
     const auto odbc_helper = dbc->plugin_service->GetOdbcHelper();
     std::vector<uint16_t> stmt_utf16;
+    std::string utf8;
     if (StatementText) {
-        const std::string utf8 = ConvertUserAppToUTF8(
+        utf8 = ConvertUserAppToUTF8(
             odbc_helper->GetUse4BytesUserApp(), StatementText, TextLength);
         // Plugin chain expects UTF16
         stmt_utf16 = ConvertUTF8ToUTF16(utf8);
         stmt_text = reinterpret_cast<SQLTCHAR*>(stmt_utf16.data());
     }
+    ExecutionContext context(stmt_text, TextLength, std::move(utf8));
+#else
+    ExecutionContext context(stmt_text, TextLength);
 #endif
 
     if (dbc->plugin_head) {
-        return dbc->plugin_head->Execute(StatementHandle, stmt_text, TextLength);
+        return dbc->plugin_head->Execute(StatementHandle, context);
     }
 
     LOG(ERROR) << "Cannot execute without an open connection";
@@ -1268,7 +1399,7 @@ SQLRETURN RDS_SQLForeignKeys(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2217,7 +2348,7 @@ SQLRETURN RDS_SQLGetStmtAttr(
             break;
     }
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLGetStmtAttr, RDS_STR_SQLGetStmtAttr,
@@ -2240,7 +2371,7 @@ SQLRETURN RDS_SQLGetTypeInfo(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLGetTypeInfo, RDS_STR_SQLGetTypeInfo,
@@ -2317,7 +2448,9 @@ SQLRETURN RDS_SQLPrepare(
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
-    if (!HasWrappedHandle(stmt)) {
+    // Replaces any earlier prepared statement, which is not restored first
+    stmt->prepared_query.reset();
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2329,7 +2462,18 @@ SQLRETURN RDS_SQLPrepare(
             stmt_converted.tchar_ptr,
             TextLength
     );
-    return RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
+    const SQLRETURN ret = RDS_ProcessLibRes(SQL_HANDLE_STMT, stmt, res);
+    if (SQL_SUCCEEDED(ret) && StatementText) {
+        // Kept to re-prepare on a new underlying connection
+#if UNICODE
+        stmt->prepared_query = ConvertUserAppToUTF8(odbc_helper->GetUse4BytesUserApp(), StatementText, TextLength);
+#else
+        stmt->prepared_query = TextLength == SQL_NTS
+            ? std::string(AS_UTF8_CSTR(StatementText))
+            : std::string(AS_UTF8_CSTR(StatementText), TextLength);
+#endif
+    }
+    return ret;
 }
 
 SQLRETURN RDS_SQLPrimaryKeys(
@@ -2350,7 +2494,7 @@ SQLRETURN RDS_SQLPrimaryKeys(
 
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2392,7 +2536,7 @@ SQLRETURN RDS_SQLProcedureColumns(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2435,7 +2579,7 @@ SQLRETURN RDS_SQLProcedures(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2609,7 +2753,7 @@ SQLRETURN RDS_SQLSpecialColumns(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2654,7 +2798,7 @@ SQLRETURN RDS_SQLStatistics(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2696,7 +2840,7 @@ SQLRETURN RDS_SQLTablePrivileges(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -2738,7 +2882,7 @@ SQLRETURN RDS_SQLTables(
     const std::lock_guard<std::recursive_mutex> lock_guard(stmt->lock);
     ClearError(stmt);
 
-    if (!HasWrappedHandle(stmt)) {
+    if (!RDS_EnsureWrappedStmt(stmt)) {
         return SQL_INVALID_HANDLE;
     }
 
@@ -61,6 +61,27 @@ SQLRETURN RDS_FreeStmt(
     SQLHSTMT       StatementHandle,
     SQLUSMALLINT   Option);
 
+// Allocates a statement's underlying handle on the current underlying connection after it was
+// released by failover or a read/write splitting switch. Statement attributes, the cursor name,
+// the prepared statement and bindings are restored, returns the result of re-preparing.
+SQLRETURN RDS_RestoreStmt(
+    STMT *         stmt);
+
+// Restores the statement's underlying handle if it was released, returns whether it has one
+bool RDS_EnsureWrappedStmt(
+    STMT *         stmt);
+
+// Binds on the underlying statement and records the binding for RDS_RestoreStmt
+RdsLibResult RDS_BindParameter(
+    STMT *              stmt,
+    SQLUSMALLINT        ParameterNumber,
+    const ParamBinding& Binding);
+
+RdsLibResult RDS_BindCol(
+    STMT *              stmt,
+    SQLUSMALLINT        ColumnNumber,
+    const ColBinding&   Binding);
+
 SQLRETURN RDS_GetConnectAttr(
     SQLHDBC        ConnectionHandle,
     SQLINTEGER     Attribute,
@@ -48,16 +48,26 @@ SQLRETURN BasePlugin::Connect(
 
 // codechecker_suppress [misc-no-recursion]
 SQLRETURN BasePlugin::Execute(
-    SQLHSTMT       StatementHandle,
-    SQLTCHAR *     StatementText,
-    SQLINTEGER     TextLength)
+    SQLHSTMT           StatementHandle,
+    ExecutionContext & Context)
 {
     if (next_plugin) {
-        return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+        return next_plugin->Execute(StatementHandle, Context);
     }
     return SQL_ERROR;
 }
 
+// codechecker_suppress [misc-no-recursion]
+void BasePlugin::NotifyConnectAttr(
+    SQLHDBC        ConnectionHandle,
+    SQLINTEGER     Attribute,
+    SQLPOINTER     ValuePtr)
+{
+    if (next_plugin) {
+        next_plugin->NotifyConnectAttr(ConnectionHandle, Attribute, ValuePtr);
+    }
+}
+
 // codechecker_suppress [misc-no-recursion]
 void BasePlugin::ReleaseResources() {
     if (next_plugin && next_plugin.get() != this) {
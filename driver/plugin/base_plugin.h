@@ -17,6 +17,7 @@
 
 #include "../driver.h"
 #include "../error.h"
+#include "execution_context.h"
 
 #include <memory>
 
@@ -39,9 +40,14 @@ public:
         SQLUSMALLINT   DriverCompletion);
 
     virtual SQLRETURN Execute(
-        SQLHSTMT       StatementHandle,
-        SQLTCHAR *     StatementText = 0,
-        SQLINTEGER     TextLength = -1);
+        SQLHSTMT           StatementHandle,
+        ExecutionContext & Context);
+
+    // Called after the application successfully set a connection attribute
+    virtual void NotifyConnectAttr(
+        SQLHDBC        ConnectionHandle,
+        SQLINTEGER     Attribute,
+        SQLPOINTER     ValuePtr);
 
     virtual void ReleaseResources();
 
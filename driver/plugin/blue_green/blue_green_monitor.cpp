@@ -74,9 +74,9 @@ BlueGreenMonitor::~BlueGreenMonitor() {
         this->Stop();
     }
 
-    if (monitoring_thread_ && monitoring_thread_->joinable()) {
-        monitoring_thread_->join();
-        monitoring_thread_ = nullptr;
+    if (task_id_.has_value()) {
+        scheduler_->Cancel(task_id_.value());
+        task_id_.reset();
     }
 
     odbc_helper_->DisconnectAndFree(&hdbc_);
@@ -89,10 +89,11 @@ void BlueGreenMonitor::StartMonitoring() {
     bool expected = false;
     const std::lock_guard<std::mutex> thread_lock(monitor_mutex_);
     if (thread_running_.compare_exchange_strong(expected, true)) {
-        if (!this->monitoring_thread_) {
+        if (!this->task_id_.has_value()) {
             class_running_.store(true);
             plugin_head_ = this->plugin_service_->GetPluginChain();
-            this->monitoring_thread_ = std::make_shared<std::thread>(&BlueGreenMonitor::Run, this);
+            this->scheduler_ = PluginService::GetMonitoringScheduler();
+            this->task_id_ = this->scheduler_->Schedule([this] { return this->Run(); });
         }
     }
 }
@@ -139,83 +140,68 @@ bool BlueGreenMonitor::IsStop() {
     return !(class_running_ || thread_running_);
 }
 
-void BlueGreenMonitor::Run() {
-    while (class_running_.load()) {
-        const std::lock_guard<std::mutex> lock_guard(hdbc_mutex_);
-        if (!class_running_.load()) {
-            // Exit early on monitor reset
-            break;
-        }
+std::optional<std::chrono::milliseconds> BlueGreenMonitor::Run() {
+    const std::lock_guard<std::mutex> lock_guard(hdbc_mutex_);
+    if (!class_running_.load()) {
+        // Exit early on monitor reset
+        FinishRun();
+        return std::nullopt;
+    }
 
-        const BlueGreenPhase old_phase = this->current_phase_;
-        this->OpenConnection();
-        this->CollectStatus();
-        this->CollectTopology();
-        this->CollectHostIp();
-        this->UpdateIpAddressFlags();
-
-        BlueGreenPhase current_phase = this->current_phase_;
-        if (current_phase != BlueGreenPhase::UNKNOWN
-            && (old_phase.GetPhase() == BlueGreenPhase::UNKNOWN || old_phase.GetPhase() != current_phase.GetPhase())
-        ) {
-            LOG(INFO) << "Status changed to: " << current_phase.ToString();
-        }
+    const BlueGreenPhase old_phase = this->current_phase_;
+    this->OpenConnection();
+    this->CollectStatus();
+    this->CollectTopology();
+    this->CollectHostIp();
+    this->UpdateIpAddressFlags();
 
-        if (this->on_status_change_function_) {
-            BlueGreenInterimStatus interim_status;
-            {
-                const std::lock_guard<std::mutex> init_ip_lock(initial_ip_host_map_mutex_);
-                const std::lock_guard<std::mutex> init_topology_lock(initial_topology_mutex_);
-                const std::lock_guard<std::mutex> host_name_lock(host_names_mutex_);
-                interim_status = BlueGreenInterimStatus(
-                    this->current_phase_,
-                    this->current_version_,
-                    this->current_port_,
-                    this->initial_topology_,
-                    this->current_topology_,
-                    this->initial_ip_host_map_,
-                    this->current_ip_host_map_,
-                    this->host_names_,
-                    this->all_start_topology_ip_changed_,
-                    this->all_start_topology_endpoints_removed_,
-                    this->all_topology_changed_
-                );
-            }
-            this->on_status_change_function_(
-                this->current_role_,
-                interim_status
+    BlueGreenPhase current_phase = this->current_phase_;
+    if (current_phase != BlueGreenPhase::UNKNOWN
+        && (old_phase.GetPhase() == BlueGreenPhase::UNKNOWN || old_phase.GetPhase() != current_phase.GetPhase())
+    ) {
+        LOG(INFO) << "Status changed to: " << current_phase.ToString();
+    }
+
+    if (this->on_status_change_function_) {
+        BlueGreenInterimStatus interim_status;
+        {
+            const std::lock_guard<std::mutex> init_ip_lock(initial_ip_host_map_mutex_);
+            const std::lock_guard<std::mutex> init_topology_lock(initial_topology_mutex_);
+            const std::lock_guard<std::mutex> host_name_lock(host_names_mutex_);
+            interim_status = BlueGreenInterimStatus(
+                this->current_phase_,
+                this->current_version_,
+                this->current_port_,
+                this->initial_topology_,
+                this->current_topology_,
+                this->initial_ip_host_map_,
+                this->current_ip_host_map_,
+                this->host_names_,
+                this->all_start_topology_ip_changed_,
+                this->all_start_topology_endpoints_removed_,
+                this->all_topology_changed_
             );
         }
+        this->on_status_change_function_(
+            this->current_role_,
+            interim_status
+        );
+    }
 
-        const BlueGreenIntervalRate rate = this->in_panic_mode_ ? BlueGreenIntervalRate::HIGH : this->interval_rate_.load();
-        const std::chrono::milliseconds delay_ms = check_interval_map_.contains(rate) ?
-            check_interval_map_.at(rate) : DEFAULT_INTERVAL_MS;
-        this->Delay(delay_ms);
+    if (!class_running_.load()) {
+        FinishRun();
+        return std::nullopt;
     }
+    // Setting a new interval rate or stopping the monitor wakes it up early
+    const BlueGreenIntervalRate rate = this->in_panic_mode_ ? BlueGreenIntervalRate::HIGH : this->interval_rate_.load();
+    return check_interval_map_.contains(rate) ? check_interval_map_.at(rate) : DEFAULT_INTERVAL_MS;
+}
 
+void BlueGreenMonitor::FinishRun() {
     thread_running_.store(false);
     finish_cv_.notify_one();
 }
 
-void BlueGreenMonitor::Delay(std::chrono::milliseconds delay_ms) {
-    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
-    const std::chrono::steady_clock::time_point end_time = start_time + delay_ms;
-    const std::chrono::milliseconds minimum_delay = delay_ms < MINIMUM_DELAY_MS ? delay_ms : MINIMUM_DELAY_MS;
-
-    const BlueGreenIntervalRate current_interval_rate = this->interval_rate_;
-    const bool current_panic = this->in_panic_mode_;
-
-    std::unique_lock<std::mutex> lock_guard(this->sleep_mutex_);
-    do {
-        this->sleep_cv_.wait_for(lock_guard, minimum_delay);
-    } while (
-        this->interval_rate_ == current_interval_rate
-        && std::chrono::steady_clock::now() < end_time
-        && this->class_running_
-        && current_panic == this->in_panic_mode_
-    );
-}
-
 void BlueGreenMonitor::CollectHostIp() {
     this->current_ip_host_map_.clear();
 
@@ -566,8 +552,10 @@ void BlueGreenMonitor::OpenConnection() {
 }
 
 void BlueGreenMonitor::NotifyChanges() {
-    const std::lock_guard<std::mutex> lock_guard(sleep_mutex_);
-    sleep_cv_.notify_all();
+    const std::lock_guard<std::mutex> thread_lock(monitor_mutex_);
+    if (this->task_id_.has_value()) {
+        this->scheduler_->Wake(this->task_id_.value());
+    }
 }
 
 void BlueGreenMonitor::InitHostListProvider() {
@@ -29,6 +29,7 @@
 #include "../../plugin/base_plugin.h"
 
 #include "../../util/concurrent_map.h"
+#include "../../util/monitoring_scheduler.h"
 #include "../../util/odbc_helper.h"
 #include "../../util/plugin_service.h"
 
@@ -71,8 +72,9 @@ public:
     bool IsStop();
 
 protected:
-    void Run();
-    void Delay(std::chrono::milliseconds delay_ms);
+    // Collects the status once, returning the delay until the next collection
+    std::optional<std::chrono::milliseconds> Run();
+    void FinishRun();
     void CollectHostIp();
     void UpdateIpAddressFlags();
     static std::optional<std::string> GetIpAddress(std::string host);
@@ -137,11 +139,10 @@ private:
     std::condition_variable finish_cv_;
     std::atomic<bool> class_running_ = false;
     std::atomic<bool> thread_running_ = false;
-    std::condition_variable sleep_cv_;
-    std::mutex sleep_mutex_;
     std::shared_ptr<HostListProvider> host_list_provider_;
     DBC* monitor_dbc_ = nullptr;
-    std::shared_ptr<std::thread> monitoring_thread_;
+    std::shared_ptr<MonitoringScheduler> scheduler_;
+    std::optional<MonitoringScheduler::TaskId> task_id_;
     SQLHENV henv_ = SQL_NULL_HENV;
     std::mutex hdbc_mutex_;
     SQLHDBC hdbc_ = SQL_NULL_HDBC;
@@ -151,8 +152,6 @@ private:
     static constexpr int BUFFER_SIZE = 1024;
     static inline const std::string BG_CLUSTER_ID =
         "ae86f030-a260-40e5-a5cb-92c95d55f333";
-    static constexpr std::chrono::milliseconds MINIMUM_DELAY_MS =
-        std::chrono::milliseconds(50);
     static inline const std::chrono::milliseconds DEFAULT_INTERVAL_MS =
         std::chrono::minutes(5);
 };
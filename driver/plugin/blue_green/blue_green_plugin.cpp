@@ -172,9 +172,8 @@ SQLRETURN BlueGreenPlugin::Connect(
 }
 
 SQLRETURN BlueGreenPlugin::Execute(
-    SQLHSTMT       StatementHandle,
-    SQLTCHAR *     StatementText,
-    SQLINTEGER     TextLength)
+    SQLHSTMT           StatementHandle,
+    ExecutionContext & Context)
 {
     LOG(INFO) << "Entering Execute";
     STMT* stmt = static_cast<STMT*>(StatementHandle);
@@ -184,20 +183,20 @@ SQLRETURN BlueGreenPlugin::Execute(
     this->blue_green_status_ = status_map_->Get(this->blue_green_id_);
     if (this->blue_green_status_.GetCurrentPhase().GetPhase() == BlueGreenPhase::UNKNOWN) {
         LOG(INFO) << "Default execution, no status found: " << this->blue_green_id_;
-        return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+        return next_plugin->Execute(StatementHandle, Context);
     }
 
     std::string conn_host = stmt->dbc->conn_attr.at(KEY_SERVER);
     BlueGreenRole host_role = this->blue_green_status_.GetRole(conn_host);
     if (host_role.GetRole() == BlueGreenRole::UNKNOWN) {
         LOG(INFO) << "Default execution, unexpected role: UNKNOWN, host: " << conn_host;
-        return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+        return next_plugin->Execute(StatementHandle, Context);
     }
 
     std::vector<std::shared_ptr<BaseExecuteRouting>> execute_routes = this->blue_green_status_.GetExecuteRoutes();
     if (execute_routes.empty()) {
         LOG(INFO) << "Default execution, no routes found for: " << conn_host;
-        return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+        return next_plugin->Execute(StatementHandle, Context);
     }
 
     auto route_itr = std::find_if(execute_routes.begin(), execute_routes.end(),
@@ -207,7 +206,7 @@ SQLRETURN BlueGreenPlugin::Execute(
 
     if (route_itr == execute_routes.end()) {
         LOG(INFO) << "Default execution, no routes matched for role: " << host_role.ToString() << ", host: " << conn_host;
-        return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+        return next_plugin->Execute(StatementHandle, Context);
     }
 
     SQLRETURN rc = SQL_ERROR;
@@ -223,7 +222,7 @@ SQLRETURN BlueGreenPlugin::Execute(
                 if (this->blue_green_status_.GetCurrentPhase().GetPhase() == BlueGreenPhase::UNKNOWN) {
                     this->end_time_ = std::chrono::steady_clock::now();
                     LOG(WARNING) << "Default execution, statuses reset, routes cleared for role: " << host_role.ToString() << ", host: " << conn_host;
-                    return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+                    return next_plugin->Execute(StatementHandle, Context);
                 }
 
                 execute_routes = this->blue_green_status_.GetExecuteRoutes();
@@ -244,7 +243,7 @@ SQLRETURN BlueGreenPlugin::Execute(
         }
 
         LOG(WARNING) << "Default execution, out of routes: " << host_role.ToString() << ", host: " << conn_host;
-        rc = next_plugin->Execute(StatementHandle, StatementText, TextLength);
+        rc = next_plugin->Execute(StatementHandle, Context);
     } catch (const std::exception& ex) {
         ClearError(stmt);
         std::string error_message("Blue/Green Execute route failed: ");
@@ -41,9 +41,8 @@ public:
         SQLUSMALLINT   DriverCompletion) override;
 
     SQLRETURN Execute(
-        SQLHSTMT       StatementHandle,
-        SQLTCHAR *     StatementText,
-        SQLINTEGER     TextLength) override;
+        SQLHSTMT           StatementHandle,
+        ExecutionContext & Context) override;
 
     int64_t GetHoldTime();
     void ResetRoutingTiming();
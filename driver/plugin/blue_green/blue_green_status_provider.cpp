@@ -22,6 +22,8 @@
 #include "routing/connect/suspend_until_node_found_connect_routing.h"
 #include "routing/execute/suspend_execute_routing.h"
 
+#include "../../host_list_providers/rds_host_list_provider.h"
+
 #include "../../util/map_utils.h"
 #include "../../util/rds_utils.h"
 
@@ -190,6 +192,12 @@ void BlueGreenStatusProvider::UpdateStatusCache() {
     LOG(INFO) << "Updating status cache for: " << this->blue_green_id_ << ", to: " << this->summary_status_.ToString();
     this->status_cache_->InsertOrAssign(this->blue_green_id_, this->summary_status_);
     this->StorePhaseTime(this->summary_status_.GetCurrentPhase());
+
+    // The switchover replaces the instances of the cluster
+    const BlueGreenPhase::Phase phase = this->summary_status_.GetCurrentPhase().GetPhase();
+    if (phase == BlueGreenPhase::PREPARATION || phase == BlueGreenPhase::IN_PROGRESS || phase == BlueGreenPhase::POST) {
+        RdsHostListProvider::HintTopologyChange(this->cluster_id_, TOPOLOGY_CHANGE_HINT_MS);
+    }
 }
 
 void BlueGreenStatusProvider::UpdateCorrespondingNodes() {
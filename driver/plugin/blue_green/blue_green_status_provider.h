@@ -137,6 +137,8 @@ private:
     static constexpr std::chrono::milliseconds HIGH_MS = std::chrono::milliseconds(100);
     static constexpr std::chrono::milliseconds SWITCHOVER_TIMEOUT_MS = std::chrono::minutes(3);
     static constexpr std::chrono::milliseconds RESET_CHECK_RATE = std::chrono::milliseconds(100);
+    // Cluster topology refreshes stay at their minimum rate while the switchover is ongoing and for this long after
+    static constexpr std::chrono::milliseconds TOPOLOGY_CHANGE_HINT_MS = std::chrono::minutes(1);
 };
 
 #endif // BLUE_GREEN_STATUS_PROVIDER_H_
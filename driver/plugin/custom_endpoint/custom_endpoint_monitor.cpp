@@ -49,99 +49,101 @@ CustomEndpointMonitor::CustomEndpointMonitor(
 {
     AwsSdkHelper::EnsureInitialized();
     is_running_.store(true);
-    this->monitoring_thread_ = std::make_shared<std::thread>(&CustomEndpointMonitor::Run, this);
+    this->scheduler_ = PluginService::GetMonitoringScheduler();
+    this->task_id_ = this->scheduler_->Schedule([this] { return this->Refresh(); });
 }
 
 CustomEndpointMonitor::~CustomEndpointMonitor() {
     is_running_.store(false);
-    if (monitoring_thread_ && monitoring_thread_->joinable()) {
-        monitoring_thread_->join();
+    if (scheduler_) {
+        scheduler_->Cancel(task_id_);
     }
-    monitoring_thread_ = nullptr;
 }
 
-void CustomEndpointMonitor::Run() {
+std::optional<std::chrono::milliseconds> CustomEndpointMonitor::Refresh() {
+    if (!is_running_.load()) {
+        return std::nullopt;
+    }
+
     try {
-        Aws::RDS::RDSClientConfiguration client_config;
-        if (!region_.empty()) {
-            client_config.region = region_;
-        }
-        Aws::Auth::AWSCredentials credentials;
-        if (profile_.empty()) {
-            credentials = Aws::Auth::DefaultAWSCredentialsProviderChain().GetAWSCredentials();
-        } else {
-            // Resolve credentials for profile from static access keys, AWS IAM Identity Center (SSO),
-            // assume-role (source_profile/role_arn), and credential_process.
-            Aws::Client::ClientConfiguration::CredentialProviderConfiguration credential_config;
-            credential_config.profile = profile_;
-            credentials = Aws::Auth::DefaultAWSCredentialsProviderChain(credential_config).GetAWSCredentials();
+        if (!rds_client_) {
+            Aws::RDS::RDSClientConfiguration client_config;
+            if (!region_.empty()) {
+                client_config.region = region_;
+            }
+            Aws::Auth::AWSCredentials credentials;
+            if (profile_.empty()) {
+                credentials = Aws::Auth::DefaultAWSCredentialsProviderChain().GetAWSCredentials();
+            } else {
+                // Resolve credentials for profile from static access keys, AWS IAM Identity Center (SSO),
+                // assume-role (source_profile/role_arn), and credential_process.
+                Aws::Client::ClientConfiguration::CredentialProviderConfiguration credential_config;
+                credential_config.profile = profile_;
+                credentials = Aws::Auth::DefaultAWSCredentialsProviderChain(credential_config).GetAWSCredentials();
+            }
+            rds_client_ = std::make_shared<Aws::RDS::RDSClient>(
+                credentials,
+                client_config
+            );
         }
-        const Aws::RDS::RDSClient rds_client(
-            credentials,
-            client_config
-        );
 
         Aws::RDS::Model::DescribeDBClusterEndpointsRequest request;
         request.SetDBClusterEndpointIdentifier(this->endpoint_identifier_);
 
-        while (is_running_.load()) {
-            const std::chrono::time_point start = std::chrono::steady_clock::now();
-            const auto response = rds_client.DescribeDBClusterEndpoints(request);
-            if (response.IsSuccess()) {
-                const auto custom_endpoints = response.GetResult().GetDBClusterEndpoints();
-                if (custom_endpoints.size() != 1) {
-                    LOG(WARNING)  << "Unexpected number of custom endpoints with endpoint identifier " << endpoint_identifier_
-                        << " in region " << region_ << ". Expected 1 custom endpoint, but found " << custom_endpoints.size();
-                    std::this_thread::sleep_for(refresh_rate_ms_);
-                    continue;
-                }
-                const auto& endpoint_info = custom_endpoints.front();
-                HostFilter filter;
-                // Both static and excluded flag can be set to true
-                // at the same time despite only able to set one group
-                if (endpoint_info.StaticMembersHasBeenSet()) {
-                    for (const auto& host : endpoint_info.GetStaticMembers()) {
-                        filter.allowed_host_ids.insert(host);
-                    }
-                }
-                if (endpoint_info.ExcludedMembersHasBeenSet()) {
-                    for (const auto& host : endpoint_info.GetExcludedMembers()) {
-                        filter.blocked_host_ids.insert(host);
-                    }
-                }
-                filter.endpoint_type = endpoint_info.GetEndpointType();
-
-                const HostFilter cached_filter = endpoint_cache.Get(endpoint_identifier_);
-                if (cached_filter != filter) {
-                    LOG(INFO) << "Detected change in custom endpoint info for " << endpoint_identifier_;
-                    if (const std::shared_ptr<PluginService> service = this->plugin_service_.lock()) {
-                        service->SetHostFilter(filter);
-                    }
-                    endpoint_cache.Put(this->endpoint_identifier_, filter);
-                    DecreaseDelay();
+        const std::chrono::time_point start = std::chrono::steady_clock::now();
+        const auto response = rds_client_->DescribeDBClusterEndpoints(request);
+        if (response.IsSuccess()) {
+            const auto custom_endpoints = response.GetResult().GetDBClusterEndpoints();
+            if (custom_endpoints.size() != 1) {
+                LOG(WARNING)  << "Unexpected number of custom endpoints with endpoint identifier " << endpoint_identifier_
+                    << " in region " << region_ << ". Expected 1 custom endpoint, but found " << custom_endpoints.size();
+                return refresh_rate_ms_;
+            }
+            const auto& endpoint_info = custom_endpoints.front();
+            HostFilter filter;
+            // Both static and excluded flag can be set to true
+            // at the same time despite only able to set one group
+            if (endpoint_info.StaticMembersHasBeenSet()) {
+                for (const auto& host : endpoint_info.GetStaticMembers()) {
+                    filter.allowed_host_ids.insert(host);
                 }
-            } else {
-                const Aws::RDS::RDSError& err = response.GetError();
-                LOG(ERROR) << "Custom Endpoint Monitor encountered error with RDS Client Describe DB Endpoints: " << err.GetMessage();
-                if (err.ShouldThrottle()) {
-                    IncreaseDelay();
-                } else if (const auto& http_code = err.GetResponseCode();
-                    http_code == Aws::Http::HttpResponseCode::UNAUTHORIZED
-                    || http_code == Aws::Http::HttpResponseCode::FORBIDDEN)
-                {
-                    refresh_rate_ms_ = UNAUTHORIZED_SLEEP_DIR;
+            }
+            if (endpoint_info.ExcludedMembersHasBeenSet()) {
+                for (const auto& host : endpoint_info.GetExcludedMembers()) {
+                    filter.blocked_host_ids.insert(host);
                 }
             }
+            filter.endpoint_type = endpoint_info.GetEndpointType();
 
-            const auto elapsed_time = std::chrono::steady_clock::now() - start;
-            const auto sleep_dir = (refresh_rate_ms_ - elapsed_time).count() > 0 ?
-                (refresh_rate_ms_ - elapsed_time).count() : 0;
-            std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_dir));
+            const HostFilter cached_filter = endpoint_cache.Get(endpoint_identifier_);
+            if (cached_filter != filter) {
+                LOG(INFO) << "Detected change in custom endpoint info for " << endpoint_identifier_;
+                if (const std::shared_ptr<PluginService> service = this->plugin_service_.lock()) {
+                    service->SetHostFilter(filter);
+                }
+                endpoint_cache.Put(this->endpoint_identifier_, filter);
+                DecreaseDelay();
+            }
+        } else {
+            const Aws::RDS::RDSError& err = response.GetError();
+            LOG(ERROR) << "Custom Endpoint Monitor encountered error with RDS Client Describe DB Endpoints: " << err.GetMessage();
+            if (err.ShouldThrottle()) {
+                IncreaseDelay();
+            } else if (const auto& http_code = err.GetResponseCode();
+                http_code == Aws::Http::HttpResponseCode::UNAUTHORIZED
+                || http_code == Aws::Http::HttpResponseCode::FORBIDDEN)
+            {
+                refresh_rate_ms_ = UNAUTHORIZED_SLEEP_DIR;
+            }
         }
+
+        const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        return refresh_rate_ms_ > elapsed_time ? refresh_rate_ms_ - elapsed_time : std::chrono::milliseconds(0);
     } catch (const std::exception& ex) {
         LOG(ERROR) << "Custom Endpoint Monitor encountered error: " << ex.what();
     }
     is_running_.store(false);
+    return std::nullopt;
 }
 
 bool CustomEndpointMonitor::HasInfo() {
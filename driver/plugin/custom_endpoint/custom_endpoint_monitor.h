@@ -15,11 +15,19 @@
 #ifndef CUSTOM_ENDPOINT_MONITOR_H_
 #define CUSTOM_ENDPOINT_MONITOR_H_
 
+#include "../../util/monitoring_scheduler.h"
 #include "../../util/plugin_service.h"
 #include "../../util/sliding_cache_map.h"
 
-#include <thread>
 #include <memory>
+#include <optional>
+
+// Forward Declarations
+namespace Aws {
+    namespace RDS {
+        class RDSClient;
+    }
+}
 
 class CustomEndpointMonitor {
 public:
@@ -31,23 +39,28 @@ public:
         std::chrono::milliseconds refresh_rate_ms,
         std::chrono::milliseconds max_refresh_rate_ms,
         int exponential_backoff_rate);
-    ~CustomEndpointMonitor();
+    virtual ~CustomEndpointMonitor();
 
-    virtual void Run();
     virtual bool HasInfo();
 
 protected:
-    // For unit testing & mocks. Does not initialize the AWS SDK or start the monitoring thread.
+    // For unit testing & mocks. Does not initialize the AWS SDK or schedule the monitoring task.
     CustomEndpointMonitor() : is_running_(false) {}
 
+    // Refreshes the custom endpoint info once, returning the delay until the next refresh
+    std::optional<std::chrono::milliseconds> Refresh();
+
 private:
     void IncreaseDelay();
     void DecreaseDelay();
 
     static SlidingCacheMap<std::string, HostFilter> endpoint_cache;
 
-    std::shared_ptr<std::thread> monitoring_thread_;
+    std::shared_ptr<MonitoringScheduler> scheduler_;
+    MonitoringScheduler::TaskId task_id_ = 0;
     std::atomic<bool> is_running_;
+    // Created by the first refresh
+    std::shared_ptr<Aws::RDS::RDSClient> rds_client_;
 
     std::weak_ptr<PluginService> plugin_service_;
     std::string endpoint_;
@@ -131,15 +131,14 @@ SQLRETURN CustomEndpointPlugin::Connect(
 }
 
 SQLRETURN CustomEndpointPlugin::Execute(
-    SQLHSTMT       StatementHandle,
-    SQLTCHAR *     StatementText,
-    SQLINTEGER     TextLength)
+    SQLHSTMT           StatementHandle,
+    ExecutionContext & Context)
 {
     LOG(INFO) << "Entering Execute";
     if (this->wait_for_info_) {
         WaitForInfo();
     }
-    return next_plugin->Execute(StatementHandle, StatementText, TextLength);
+    return next_plugin->Execute(StatementHandle, Context);
 }
 
 std::shared_ptr<CustomEndpointMonitor> CustomEndpointPlugin::InitEndpointMonitor() {
@@ -47,9 +47,8 @@ public:
         SQLUSMALLINT   DriverCompletion) override;
 
     SQLRETURN Execute(
-        SQLHSTMT       StatementHandle,
-        SQLTCHAR *     StatementText,
-        SQLINTEGER     TextLength) override;
+        SQLHSTMT           StatementHandle,
+        ExecutionContext & Context) override;
 
     static inline const std::chrono::milliseconds WAIT_FOR_INFO_SLEEP_DIR_MS = std::chrono::milliseconds(100);
     static inline const std::chrono::milliseconds DEFAULT_MONITORING_INTERVAL_MS = std::chrono::seconds(30);
@@ -15,9 +15,12 @@
 #include "default_plugin.h"
 
 #include "../driver.h"
+#include "../host_health_registry.h"
 #include "../odbcapi.h"
+#include "../odbcapi_rds_helper.h"
 #include "../util/connection_string_helper.h"
 #include "../util/logger_wrapper.h"
+#include "../util/map_utils.h"
 #include "../util/odbc_helper.h"
 #include "../util/plugin_service.h"
 #include "../util/rds_lib_loader.h"
@@ -39,91 +42,153 @@ SQLRETURN DefaultPlugin::Connect(
 {
     LOG(INFO) << "Entering Connect";
     SQLRETURN ret = SQL_ERROR;
-    bool has_conn_attr_errors = false;
     DBC* dbc = static_cast<DBC*>(ConnectionHandle);
     const ENV* env = dbc->env;
 
     // TODO - Should a new connect use a new underlying DBC?
-    // Create Wrapped DBC if not already allocated
     RdsLibResult res;
-    if (!dbc->wrapped_dbc) {
-        res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLAllocHandle, RDS_STR_SQLAllocHandle,
-            SQL_HANDLE_DBC, env->wrapped_env, &dbc->wrapped_dbc
-        );
+
+    // Reuse an idle connection opened with the same connection string if pooling is enabled.
+    // Only reconnects made by the plugins qualify, and only if the dialect can reset the session.
+    bool reused_connection = false;
+    dbc->pool_key.clear();
+    if (ConnectionPoolConfig::FromConnAttr(dbc->conn_attr).enabled) {
+        const std::shared_ptr<Dialect> dialect = dbc->plugin_service->GetDialect();
+        if (dialect && !dialect->GetResetSessionQuery().empty()) {
+            dbc->pool_key = UnderlyingConnectionPool::BuildPoolKey(env, dbc->conn_attr);
+        }
+    }
+    if (!dbc->wrapped_dbc && dbc->internal_reconnect && !dbc->pool_key.empty()) {
+        dbc->wrapped_dbc = PluginService::GetConnectionPool()->Borrow(dbc->pool_key);
+        reused_connection = dbc->wrapped_dbc != SQL_NULL_HDBC;
     }
 
-    // Apply pre-connect attributes to the wrapped DBC before SQLDriverConnect.
-    // Attributes like SQL_ATTR_LOGIN_TIMEOUT must be set before connecting to take effect.
-    for (auto const& [key, val] : dbc->attr_map) {
-        if (key == SQL_ATTR_LOGIN_TIMEOUT || key == SQL_ATTR_CONNECTION_TIMEOUT) {
-            NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
-                dbc->wrapped_dbc, key, val.first, val.second
+    if (reused_connection) {
+        LOG(INFO) << "Reusing a pooled connection to: " << MapUtils::GetStringValue(dbc->conn_attr, KEY_SERVER, "");
+        ret = SQL_SUCCESS;
+    } else {
+        // Create Wrapped DBC if not already allocated
+        if (!dbc->wrapped_dbc) {
+            res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLAllocHandle, RDS_STR_SQLAllocHandle,
+                SQL_HANDLE_DBC, env->wrapped_env, &dbc->wrapped_dbc
             );
         }
-    }
 
-    // DSN should be read from the original input
-    // and a new connection string should be built without DSN & Driver
-    const std::string conn_in = ConnectionStringHelper::BuildMinimumConnectionString(dbc->conn_attr);
-    DLOG(INFO) << "Built minimum connection string for underlying driver: " << ConnectionStringHelper::MaskSensitiveInformation(conn_in);
-    SQLTCHAR *conn_in_sqltchar;
+        // Apply pre-connect attributes to the wrapped DBC before SQLDriverConnect.
+        // Attributes like SQL_ATTR_LOGIN_TIMEOUT must be set before connecting to take effect.
+        for (auto const& [key, val] : dbc->attr_map) {
+            if (key == SQL_ATTR_LOGIN_TIMEOUT || key == SQL_ATTR_CONNECTION_TIMEOUT) {
+                NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
+                    dbc->wrapped_dbc, key, val.first, val.second
+                );
+            }
+        }
+
+        // DSN should be read from the original input
+        // and a new connection string should be built without DSN & Driver
+        const std::string conn_in = ConnectionStringHelper::BuildMinimumConnectionString(dbc->conn_attr);
+        DLOG(INFO) << "Built minimum connection string for underlying driver: " << ConnectionStringHelper::MaskSensitiveInformation(conn_in);
+        SQLTCHAR *conn_in_sqltchar;
 #if UNICODE
-    const std::vector<uint16_t> conn_in_vec = ConvertUTF8ToUTF16(conn_in);
-    const uint16_t* conn_in_ushort = conn_in_vec.data();
+        const std::vector<uint16_t> conn_in_vec = ConvertUTF8ToUTF16(conn_in);
+        const uint16_t* conn_in_ushort = conn_in_vec.data();
 
-    conn_in_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(conn_in_ushort));
+        conn_in_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(conn_in_ushort));
 #else
-    conn_in_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(conn_in.c_str()));
+        conn_in_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(conn_in.c_str()));
 #endif
-    res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDriverConnect, RDS_STR_SQLDriverConnect,
-        dbc->wrapped_dbc, WindowHandle, conn_in_sqltchar, SQL_NTS, OutConnectionString, BufferLength, StringLengthPtr, DriverCompletion
-    );
+        // Outcomes of every connection, including internal ones, feed the host health used by the host selectors
+        const std::string server = MapUtils::GetStringValue(dbc->conn_attr, KEY_SERVER, "");
+        const auto connect_start = std::chrono::steady_clock::now();
+        res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDriverConnect, RDS_STR_SQLDriverConnect,
+            dbc->wrapped_dbc, WindowHandle, conn_in_sqltchar, SQL_NTS, OutConnectionString, BufferLength, StringLengthPtr, DriverCompletion
+        );
 
-    if (res.fn_load_success) {
-        ret = res.fn_result;
-        if (!SQL_SUCCEEDED(ret)) {
+        if (res.fn_load_success) {
+            ret = res.fn_result;
+            if (!SQL_SUCCEEDED(ret)) {
 #if UNICODE
-            if (dbc->wrapped_dbc) {
-                SQLINTEGER native_error;
-                SQLTCHAR state[MAX_SQL_STATE_LEN * 2] = {0};
-                SQLTCHAR text[MAX_MSG_LEN * 2] = {0};
-                SQLSMALLINT len;
-
-                NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLGetDiagRec, RDS_STR_SQLGetDiagRec,
-                    SQL_HANDLE_DBC, dbc->wrapped_dbc, 1, state, &native_error, text, MAX_MSG_LEN, &len
-                );
+                if (dbc->wrapped_dbc) {
+                    SQLINTEGER native_error;
+                    SQLTCHAR state[MAX_SQL_STATE_LEN * 2] = {0};
+                    SQLTCHAR text[MAX_MSG_LEN * 2] = {0};
+                    SQLSMALLINT len;
 
-                for (int i = MAX_SQL_STATE_LEN; i < MAX_SQL_STATE_LEN * 2; i++) {
-                    if (state[i] != '\0') {
-                        this->odbc_helper_->SetUse4BytesBaseDriver(true);
+                    NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLGetDiagRec, RDS_STR_SQLGetDiagRec,
+                        SQL_HANDLE_DBC, dbc->wrapped_dbc, 1, state, &native_error, text, MAX_MSG_LEN, &len
+                    );
+
+                    for (int i = MAX_SQL_STATE_LEN; i < MAX_SQL_STATE_LEN * 2; i++) {
+                        if (state[i] != '\0') {
+                            this->odbc_helper_->SetUse4BytesBaseDriver(true);
+                        }
                     }
-                }
 
-                if (this->odbc_helper_->GetUse4BytesBaseDriver()) {
-                    // Try connecting again with 4-byte characters
-                    const std::wstring wide_conn = ConvertUTF8ToWString(conn_in);
-                    conn_in_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(wide_conn.c_str()));
-                    res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDriverConnect, RDS_STR_SQLDriverConnect,
-                        dbc->wrapped_dbc, WindowHandle, conn_in_sqltchar, SQL_NTS, OutConnectionString, BufferLength, StringLengthPtr, DriverCompletion
-                    );
-                    ret = res.fn_result;
+                    if (this->odbc_helper_->GetUse4BytesBaseDriver()) {
+                        // Try connecting again with 4-byte characters
+                        const std::wstring wide_conn = ConvertUTF8ToWString(conn_in);
+                        conn_in_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(wide_conn.c_str()));
+                        res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDriverConnect, RDS_STR_SQLDriverConnect,
+                            dbc->wrapped_dbc, WindowHandle, conn_in_sqltchar, SQL_NTS, OutConnectionString, BufferLength, StringLengthPtr, DriverCompletion
+                        );
+                        ret = res.fn_result;
+                    }
+                }
+                if (!SQL_SUCCEEDED(ret)) {
+                    RecordConnectFailure(dbc, server);
+                    return ret;
                 }
-            }
-            if (!SQL_SUCCEEDED(ret)) {
-                return ret;
-            }
 #else
-            return ret;
+                RecordConnectFailure(dbc, server);
+                return ret;
 #endif
+            }
+            HostHealthRegistry::Global().RecordSuccess(server, std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - connect_start));
         }
     }
 
+    // TODO - Error Handling for ConnAttr, IsConnected
+    if (!SQL_SUCCEEDED(ret)) {
+        return ret;
+    }
+    // Successful Connection, but bad environment and/or connection attribute setting
+    return SQL_SUCCESS_WITH_INFO == InitializeConnectedDbc(dbc) ? SQL_SUCCESS_WITH_INFO : ret;
+}
+
+void DefaultPlugin::RecordConnectFailure(const DBC* dbc, const std::string& server) const
+{
+    // Only communication failures tell about the host, not e.g. rejected credentials
+    const std::shared_ptr<Dialect> dialect = dbc->plugin_service->GetDialect();
+    if (!dialect || !dbc->wrapped_dbc) {
+        return;
+    }
+    SQLINTEGER native_error = 0;
+    SQLTCHAR state[MAX_SQL_STATE_LEN * 2] = {0};
+    SQLTCHAR text[MAX_MSG_LEN * 2] = {0};
+    SQLSMALLINT len = 0;
+    NULL_CHECK_CALL_LIB_FUNC(dbc->env->driver_lib_loader, RDS_FP_SQLGetDiagRec, RDS_STR_SQLGetDiagRec,
+        SQL_HANDLE_DBC, dbc->wrapped_dbc, 1, state, &native_error, text, MAX_MSG_LEN, &len
+    );
+#if UNICODE
+    Convert4To2ByteString(this->odbc_helper_->GetUse4BytesBaseDriver(), state, nullptr, MAX_SQL_STATE_LEN);
+#endif
+    if (dialect->IsSqlStateNetworkError(AS_UTF8_CSTR(state))) {
+        HostHealthRegistry::Global().RecordFailure(server);
+    }
+}
+
+SQLRETURN DefaultPlugin::InitializeConnectedDbc(DBC* dbc)
+{
+    const ENV* env = dbc->env;
+    bool has_conn_attr_errors = false;
+
     // Apply Tracked Connection Attributes
     for (auto const& [key, val] : dbc->attr_map) {
         if (key == SQL_ATTR_LOGIN_TIMEOUT || key == SQL_ATTR_CONNECTION_TIMEOUT) {
             continue;
         }
-        res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
+        const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
             dbc->wrapped_dbc, key, val.first, val.second
         );
         if (!SQL_SUCCEEDED(res.fn_result)) {
@@ -131,65 +196,45 @@ SQLRETURN DefaultPlugin::Connect(
             has_conn_attr_errors  = true;
         }
     }
+    dbc->session_state.MarkConnected(dbc->attr_map);
+    dbc->connection_generation++;
     dbc->transaction_status = dbc->auto_commit ? TRANSACTION_CLOSED : TRANSACTION_OPEN;
 
-    // TODO - Error Handling for ConnAttr, IsConnected
-    // Successful Connection, but bad environment and/or connection attribute setting
-    if (SQL_SUCCEEDED(ret)) {
-        dbc->conn_status = CONN_CONNECTED;
-        if (has_conn_attr_errors) {
-            ret = SQL_SUCCESS_WITH_INFO;
-        }
+    dbc->conn_status = CONN_CONNECTED;
+    dbc->validation_freshness = MapUtils::GetMillisecondsValue(
+        dbc->conn_attr, KEY_VALIDATION_FRESHNESS_MS, OdbcHelper::DEFAULT_VALIDATION_FRESHNESS_MS);
+    OdbcHelper::MarkActive(dbc);
 
-        if (!dbc->conn_attr.contains(KEY_MONITORING_CONN_UUID)) {
-            dbc->plugin_service->UpdateDialect(dbc);
-        }
+    if (!dbc->conn_attr.contains(KEY_MONITORING_CONN_UUID)) {
+        dbc->plugin_service->UpdateDialect(dbc);
+        // Reconnecting, i.e. during failover, restores what the application set through SQL
+        SessionStateTracker::Sync(dbc);
     }
-    return ret;
+    return has_conn_attr_errors ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
 }
 
 SQLRETURN DefaultPlugin::Execute(
-    SQLHSTMT       StatementHandle,
-    SQLTCHAR *     StatementText,
-    SQLINTEGER     TextLength)
+    SQLHSTMT           StatementHandle,
+    ExecutionContext & Context)
 {
     LOG(INFO) << "Entering Execute";
     RdsLibResult res;
     STMT* stmt = static_cast<STMT*>(StatementHandle);
     DBC* dbc = stmt->dbc;
     const ENV* env = dbc->env;
-    const std::string query = StatementText ? AS_UTF8_CSTR(StatementText) : "";
+    const std::string& query = Context.GetQuery();
+
+    // Executing directly replaces the prepared statement
+    if (!query.empty()) {
+        stmt->prepared_query.reset();
+    }
 
-    // Allocate wrapped handle if NULL
+    // Allocate wrapped handle if NULL, i.e. after the underlying connection changed
     if (!stmt->wrapped_stmt) {
-        if (dbc->wrapped_dbc) {
-            res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLAllocHandle, RDS_STR_SQLAllocHandle,
-                SQL_HANDLE_STMT, dbc->wrapped_dbc, &stmt->wrapped_stmt
-            );
-        } else {
-            LOG(ERROR) << "Unable to use STMT, underlying DBC nulled";
-            stmt->err = std::make_unique<ERR_INFO>("Unable to use STMT, underlying DBC nulled", ERR_UNDERLYING_HANDLE_NULL);
-            return SQL_ERROR;
-        }
-        // Set statement settings
-        for (auto const& [key, val] : stmt->attr_map) {
-            res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetStmtAttr, RDS_STR_SQLSetStmtAttr,
-                stmt->wrapped_stmt, key, val.first, val.second
-            );
+        const SQLRETURN restore_ret = RDS_RestoreStmt(stmt);
+        if (!stmt->wrapped_stmt || !SQL_SUCCEEDED(restore_ret)) {
+            return restore_ret;
         }
-        // Cursor Name
-        const std::string cursor_name = stmt->cursor_name;
-#if UNICODE
-        const std::vector<uint16_t> cursor_name_vector = ConvertUTF8ToUTF16(cursor_name);
-        SQLTCHAR* cursor_name_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(cursor_name_vector.data()));
-        res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetCursorName, RDS_STR_SQLSetCursorName,
-            stmt->wrapped_stmt, cursor_name_sqltchar, cursor_name.length()
-        );
-#else
-        res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetCursorName, RDS_STR_SQLSetCursorName,
-            stmt->wrapped_stmt, AS_SQLTCHAR(cursor_name), cursor_name.length()
-        );
-#endif
     }
 
     if (query.empty()) {
@@ -200,22 +245,35 @@ SQLRETURN DefaultPlugin::Execute(
         res = this->odbc_helper_->ExecDirect(&stmt->wrapped_stmt, query);
     }
 
+    // A failed call may have been caused by a broken connection
+    if (SQL_SUCCEEDED(res.fn_result) || res.fn_result == SQL_NO_DATA) {
+        OdbcHelper::MarkActive(dbc);
+    } else if (res.fn_result == SQL_ERROR) {
+        OdbcHelper::MarkUnverified(dbc);
+    }
+
     // Supports checking for transaction changes only if it was a direct execute
     if (SQL_SUCCEEDED(res.fn_result) && !query.empty()) {
-        if (SqlQueryAnalyzer::DoesOpenTransaction(query)) {
+        // Lexed with the dialect's quoting rules, e.g. backslash escapes on MySQL
+        const std::shared_ptr<Dialect> dialect = dbc->plugin_service->GetDialect();
+        const SqlClassification classification = Context.GetClassification(dialect);
+        if (classification.DoesOpenTransaction()) {
             dbc->transaction_status = TRANSACTION_OPEN;
-        } else if (SqlQueryAnalyzer::DoesCloseTransaction(dbc, query)
-            || SqlQueryAnalyzer::DoesSwitchAutoCommitFalseTrue(dbc, query)
-        ) {
+        } else if (classification.DoesCloseTransaction(dbc->auto_commit)) {
             dbc->transaction_status = TRANSACTION_CLOSED;
         }
 
-        if (SqlQueryAnalyzer::IsStatementSettingAutoCommit(query)) {
-            dbc->auto_commit = SqlQueryAnalyzer::GetAutoCommitValueFromSqlStatement(query);
+        if (classification.IsSettingAutoCommit()) {
+            dbc->auto_commit = classification.GetAutoCommitValue();
             NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
                 dbc->wrapped_dbc, SQL_ATTR_AUTOCOMMIT, reinterpret_cast<SQLPOINTER>(dbc->auto_commit), 0
             );
             dbc->attr_map.insert_or_assign(SQL_ATTR_AUTOCOMMIT, std::make_pair(reinterpret_cast<SQLPOINTER>(dbc->auto_commit), 0));
+            dbc->session_state.TrackAttribute(SQL_ATTR_AUTOCOMMIT, reinterpret_cast<SQLPOINTER>(dbc->auto_commit), 0);
+        }
+
+        if (classification.MayChangeSessionState() && MapUtils::GetBooleanValue(dbc->conn_attr, KEY_ENABLE_SESSION_STATE_TRACKING, true)) {
+            dbc->session_state.TrackStatement(query, dialect->GetIsolationLevelVariable(), dialect->UsesBackslashEscapes());
         }
     }
     return res.fn_result;
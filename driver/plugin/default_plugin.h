@@ -35,13 +35,20 @@ public:
         SQLUSMALLINT   DriverCompletion);
 
     virtual SQLRETURN Execute(
-        SQLHSTMT       StatementHandle,
-        SQLTCHAR *     StatementText = 0,
-        SQLINTEGER     TextLength = -1);
+        SQLHSTMT           StatementHandle,
+        ExecutionContext & Context);
+
+    // Applies the connection's tracked attributes and session state to a newly connected
+    // underlying connection and marks the connection as connected.
+    // Returns SQL_SUCCESS_WITH_INFO if an attribute could not be applied.
+    static SQLRETURN InitializeConnectedDbc(DBC* dbc);
 
 protected:
     std::string plugin_name;
 private:
+    // Counts a failed connect against the host when the underlying driver reports a network error
+    void RecordConnectFailure(const DBC* dbc, const std::string& server) const;
+
     std::shared_ptr<OdbcHelper>odbc_helper_;
 };
 
@@ -0,0 +1,46 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "execution_context.h"
+
+#include "../util/rds_strings.h"
+
+ExecutionContext::ExecutionContext() : ExecutionContext(nullptr, -1) {}
+
+ExecutionContext::ExecutionContext(SQLTCHAR* statement_text, SQLINTEGER text_length) :
+    statement_text_(statement_text),
+    text_length_(text_length) {}
+
+ExecutionContext::ExecutionContext(SQLTCHAR* statement_text, SQLINTEGER text_length, std::string query) :
+    statement_text_(statement_text),
+    text_length_(text_length),
+    query_(std::move(query)) {}
+
+const std::string& ExecutionContext::GetQuery() {
+    if (!query_.has_value()) {
+        query_ = statement_text_ ? AS_UTF8_CSTR(statement_text_) : "";
+    }
+    return query_.value();
+}
+
+SqlClassification ExecutionContext::GetClassification(const std::shared_ptr<Dialect>& dialect) {
+    if (!IsDirectExecute()) {
+        return {};
+    }
+    if (!classification_.has_value() || (dialect && !classified_with_dialect_)) {
+        classification_ = SqlQueryAnalyzer::Classify(GetQuery(), dialect);
+        classified_with_dialect_ = dialect != nullptr;
+    }
+    return classification_.value();
+}
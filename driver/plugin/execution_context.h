@@ -0,0 +1,55 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXECUTION_CONTEXT_H_
+#define EXECUTION_CONTEXT_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "../util/sql_query_analyzer.h"
+
+class Dialect;
+
+// State of a single SQLExecDirect / SQLExecute call, created once in the API layer
+// and passed down the plugin chain so each plugin does not re-derive the same facts.
+class ExecutionContext {
+public:
+    // Execution of a previously prepared statement, no text
+    ExecutionContext();
+    ExecutionContext(SQLTCHAR* statement_text, SQLINTEGER text_length);
+    // UTF-8 copy of the text when the caller already converted it
+    ExecutionContext(SQLTCHAR* statement_text, SQLINTEGER text_length, std::string query);
+
+    SQLTCHAR* GetStatementText() const { return statement_text_; }
+    SQLINTEGER GetTextLength() const { return text_length_; }
+    bool IsDirectExecute() const { return statement_text_ != nullptr; }
+
+    // UTF-8 text, converted on first use
+    const std::string& GetQuery();
+
+    // Classification is computed on first use and reused by later plugins.
+    // Read-only detection needs the dialect, asking with one after a call without re-classifies once.
+    SqlClassification GetClassification(const std::shared_ptr<Dialect>& dialect = nullptr);
+
+private:
+    SQLTCHAR* statement_text_ = nullptr;
+    SQLINTEGER text_length_ = -1;
+    std::optional<std::string> query_;
+    std::optional<SqlClassification> classification_;
+    bool classified_with_dialect_ = false;
+};
+
+#endif // EXECUTION_CONTEXT_H_
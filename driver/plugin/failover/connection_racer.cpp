@@ -0,0 +1,135 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connection_racer.h"
+
+#include <algorithm>
+#include <condition_variable>
+
+#include "../../util/connection_string_keys.h"
+#include "../../util/logger_wrapper.h"
+#include "../../util/map_utils.h"
+
+ConnectionRaceConfig ConnectionRaceConfig::FromConnAttr(const std::map<std::string, std::string>& conn_attr) {
+    ConnectionRaceConfig config;
+    config.enabled = MapUtils::GetBooleanValue(conn_attr, KEY_ENABLE_PARALLEL_READER_FAILOVER, false);
+    config.stagger_ms = MapUtils::GetMillisecondsValue(conn_attr, KEY_READER_FAILOVER_STAGGER, DEFAULT_STAGGER_MS);
+    const int max_parallel = MapUtils::GetIntValue(conn_attr, KEY_READER_FAILOVER_MAX_PARALLEL, DEFAULT_MAX_PARALLEL);
+    config.max_parallel = max_parallel > 0 ? static_cast<size_t>(max_parallel) : 1;
+    return config;
+}
+
+struct ConnectionRacer::RaceState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::optional<Winner> winner;
+    size_t finished_attempts = 0;
+    std::atomic<bool> decided = false;
+};
+
+ConnectionRacer::ConnectionRacer(ConnectFunc connect, CloseFunc close)
+    : connect_(std::move(connect)), close_(std::move(close)) {}
+
+ConnectionRacer::~ConnectionRacer() {
+    for (Worker& worker : workers_) {
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+    }
+    workers_.clear();
+}
+
+std::optional<ConnectionRacer::Winner> ConnectionRacer::Race(
+    const std::vector<HostInfo>& candidates,
+    const ConnectionRaceConfig& config,
+    const std::chrono::steady_clock::time_point deadline)
+{
+    JoinFinished();
+    const size_t max_parallel = std::max<size_t>(config.max_parallel, 1);
+    const std::shared_ptr<RaceState> state = std::make_shared<RaceState>();
+
+    size_t launched = 0;
+    std::chrono::steady_clock::time_point next_launch = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (std::chrono::steady_clock::now() < deadline) {
+        const bool can_launch = launched < candidates.size() && launched - state->finished_attempts < max_parallel;
+        if (can_launch && std::chrono::steady_clock::now() >= next_launch) {
+            LOG(INFO) << "Racing connection attempt to: " << candidates[launched].GetHost();
+            Launch(candidates[launched], state);
+            launched++;
+            next_launch = std::chrono::steady_clock::now() + config.stagger_ms;
+        }
+        if (launched == candidates.size() && state->finished_attempts == launched) {
+            // Every attempt failed
+            break;
+        }
+
+        const size_t finished_before = state->finished_attempts;
+        const bool waiting_to_launch = launched < candidates.size() && launched - finished_before < max_parallel;
+        state->cv.wait_until(lock, waiting_to_launch ? std::min(deadline, next_launch) : deadline,
+            [&state, finished_before] { return state->winner.has_value() || state->finished_attempts != finished_before; });
+        if (state->winner) {
+            state->decided = true;
+            return state->winner;
+        }
+        if (state->finished_attempts != finished_before) {
+            // A failed attempt frees its slot, start the next one right away
+            next_launch = std::chrono::steady_clock::now();
+        }
+    }
+    // An attempt may have won just as the deadline passed, it is still usable
+    state->decided = true;
+    return state->winner;
+}
+
+void ConnectionRacer::Launch(const HostInfo& host_info, const std::shared_ptr<RaceState>& state) {
+    const std::shared_ptr<std::atomic<bool>> finished = std::make_shared<std::atomic<bool>>(false);
+    workers_.push_back(Worker{.thread = std::thread([connect = connect_, close = close_, host_info, state, finished] {
+        SQLHDBC hdbc = SQL_NULL_HDBC;
+        try {
+            hdbc = connect(host_info, state->decided);
+        } catch (const std::exception& ex) {
+            LOG(ERROR) << "Exception while racing a connection to: " << host_info.GetHost() << ", " << ex.what();
+        }
+
+        bool won = false;
+        {
+            const std::lock_guard<std::mutex> lock_guard(state->mutex);
+            if (hdbc != SQL_NULL_HDBC && !state->decided && !state->winner) {
+                state->winner = Winner{.host_info = host_info, .hdbc = hdbc};
+                won = true;
+            } else {
+                state->finished_attempts++;
+            }
+        }
+        state->cv.notify_all();
+
+        if (hdbc != SQL_NULL_HDBC && !won) {
+            LOG(INFO) << "Closing connection that lost the race: " << host_info.GetHost();
+            close(hdbc);
+        }
+        *finished = true;
+    }), .finished = finished});
+}
+
+void ConnectionRacer::JoinFinished() {
+    for (auto it = workers_.begin(); it != workers_.end();) {
+        if (*it->finished) {
+            it->thread.join();
+            it = workers_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
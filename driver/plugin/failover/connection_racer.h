@@ -0,0 +1,86 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONNECTION_RACER_H_
+#define CONNECTION_RACER_H_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../odbcapi.h"
+#include "../../host_info.h"
+
+struct ConnectionRaceConfig {
+    static inline const std::chrono::milliseconds DEFAULT_STAGGER_MS = std::chrono::milliseconds(250);
+    static constexpr int DEFAULT_MAX_PARALLEL = 3;
+
+    bool enabled = false;
+    std::chrono::milliseconds stagger_ms = DEFAULT_STAGGER_MS;
+    size_t max_parallel = DEFAULT_MAX_PARALLEL;
+
+    static ConnectionRaceConfig FromConnAttr(const std::map<std::string, std::string>& conn_attr);
+};
+
+// Happy eyeballs style connection establishment.
+// Attempts are started in candidate order on worker threads, the next one
+// after the stagger delay or as soon as an earlier attempt fails, with at most
+// max_parallel attempts in flight. The first verified connection wins.
+// Attempts that finish after the race is decided close their connection.
+class ConnectionRacer {
+public:
+    // Connects to the host and verifies it, returning SQL_NULL_HDBC on failure.
+    // Attempts that wait on the host, such as polling its role, should give up once the race is decided.
+    using ConnectFunc = std::function<SQLHDBC(const HostInfo& host_info, const std::atomic<bool>& race_decided)>;
+    using CloseFunc = std::function<void(SQLHDBC)>;
+
+    struct Winner {
+        HostInfo host_info;
+        SQLHDBC hdbc;
+    };
+
+    ConnectionRacer(ConnectFunc connect, CloseFunc close);
+    // Waits for attempts still in flight from earlier races
+    ~ConnectionRacer();
+
+    std::optional<Winner> Race(
+        const std::vector<HostInfo>& candidates,
+        const ConnectionRaceConfig& config,
+        std::chrono::steady_clock::time_point deadline);
+
+private:
+    struct RaceState;
+
+    void Launch(const HostInfo& host_info, const std::shared_ptr<RaceState>& state);
+    void JoinFinished();
+
+    ConnectFunc connect_;
+    CloseFunc close_;
+
+    struct Worker {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> finished;
+    };
+    std::list<Worker> workers_;
+};
+
+#endif // CONNECTION_RACER_H_
@@ -14,9 +14,11 @@
 
 #include "failover_plugin.h"
 
+#include "../../host_health_registry.h"
 #include "../../odbcapi.h"
 #include "../../odbcapi_rds_helper.h"
 #include "../base_plugin.h"
+#include "../default_plugin.h"
 
 #include "../../host_selector/host_selector.h"
 #include "../../host_selector/round_robin_host_selector.h"
@@ -47,6 +49,10 @@ FailoverPlugin::FailoverPlugin(
         std::chrono::milliseconds(std::strtol(conn_info.at(KEY_FAILOVER_TIMEOUT).c_str(), nullptr, 0))
         : DEFAULT_FAILOVER_TIMEOUT_MS;
     this->failover_mode_ = InitFailoverMode(conn_info);
+    this->standby_config_ = StandbyConnectionConfig::FromConnAttr(conn_info);
+    this->race_config_ = ConnectionRaceConfig::FromConnAttr(conn_info);
+    this->writer_probing_enabled_ = MapUtils::GetBooleanValue(conn_info, KEY_ENABLE_WRITER_FAILOVER_PROBING, false);
+    this->writer_probe_interval_ms_ = MapUtils::GetMillisecondsValue(conn_info, KEY_WRITER_FAILOVER_PROBE_INTERVAL, DEFAULT_WRITER_PROBE_INTERVAL_MS);
 }
 
 SQLRETURN FailoverPlugin::Connect(
@@ -58,7 +64,7 @@ SQLRETURN FailoverPlugin::Connect(
     SQLUSMALLINT   DriverCompletion)
 {
     LOG(INFO) << "Entering Connect";
-    return next_plugin->Connect(
+    const SQLRETURN ret = next_plugin->Connect(
         ConnectionHandle,
         WindowHandle,
         OutConnectionString,
@@ -66,17 +72,103 @@ SQLRETURN FailoverPlugin::Connect(
         StringLengthPtr,
         DriverCompletion
     );
+
+    if (SQL_SUCCEEDED(ret)) {
+        InitFailoverConnections(static_cast<DBC*>(ConnectionHandle));
+    }
+    return ret;
+}
+
+// Sets up the connections failover opens outside of the application's connection,
+// standby connections kept warm in the background, racing reader connections and writer probes.
+void FailoverPlugin::InitFailoverConnections(DBC* dbc)
+{
+    const std::shared_ptr<PluginService> service = plugin_service_.lock();
+    if (!service || dbc->conn_attr.contains(KEY_MONITORING_CONN_UUID)
+        || (!standby_config_.enabled && !race_config_.enabled && !writer_probing_enabled_))
+    {
+        return;
+    }
+    if (!connection_factory_) {
+        connection_factory_ = std::make_shared<HostConnectionFactory>(service, odbc_helper_, dbc->env);
+    }
+
+    if (standby_config_.enabled && !standby_pool_) {
+        standby_pool_ = std::make_shared<StandbyConnectionPool>(service, connection_factory_, standby_config_);
+        standby_pool_->StartMonitor();
+    }
+
+    if (race_config_.enabled && !reader_racer_) {
+        // Attempts can outlive a race, so they only hold what they need by value
+        const std::shared_ptr<HostConnectionFactory> factory = connection_factory_;
+        const std::shared_ptr<Dialect> dialect = dialect_;
+        const std::shared_ptr<OdbcHelper> odbc_helper = odbc_helper_;
+        const std::weak_ptr<PluginService> weak_service = plugin_service_;
+        const bool strict_reader = failover_mode_ == STRICT_READER;
+        reader_racer_ = std::make_unique<ConnectionRacer>(
+            [factory, dialect, odbc_helper, weak_service, strict_reader](const HostInfo& host, const std::atomic<bool>&) -> SQLHDBC {
+                const SQLHDBC hdbc = factory->Open(host);
+                if (hdbc == SQL_NULL_HDBC) {
+                    return SQL_NULL_HDBC;
+                }
+                if (const std::shared_ptr<PluginService> service = weak_service.lock();
+                    service != nullptr && !GetNodeId(hdbc, dialect, odbc_helper).empty()
+                    && (!strict_reader || service->GetHostListProvider()->GetConnectionRole(hdbc) == READER))
+                {
+                    return hdbc;
+                }
+                LOG(INFO) << "Discarding reader connection that failed verification: " << host.GetHost();
+                factory->Close(hdbc);
+                return SQL_NULL_HDBC;
+            },
+            [factory](SQLHDBC hdbc) { factory->Close(hdbc); });
+    }
+
+    if (writer_probing_enabled_ && !writer_racer_) {
+        const std::shared_ptr<HostConnectionFactory> factory = connection_factory_;
+        const std::shared_ptr<Dialect> dialect = dialect_;
+        const std::shared_ptr<OdbcHelper> odbc_helper = odbc_helper_;
+        const std::weak_ptr<PluginService> weak_service = plugin_service_;
+        const std::chrono::milliseconds probe_interval = writer_probe_interval_ms_;
+        writer_racer_ = std::make_unique<ConnectionRacer>(
+            [factory, dialect, odbc_helper, weak_service, probe_interval](const HostInfo& host, const std::atomic<bool>& race_decided) -> SQLHDBC {
+                const SQLHDBC hdbc = factory->Open(host);
+                if (hdbc == SQL_NULL_HDBC) {
+                    return SQL_NULL_HDBC;
+                }
+                // Keeps the connection open and polls its role,
+                // so a reader is picked up as soon as it is promoted
+                while (!race_decided) {
+                    if (factory->IsClosed(hdbc)) {
+                        break;
+                    }
+                    const std::shared_ptr<PluginService> service = weak_service.lock();
+                    if (!service) {
+                        break;
+                    }
+                    // A failed role query reports a writer, the node id confirms the connection still works
+                    if (service->GetHostListProvider()->GetConnectionRole(hdbc) == WRITER
+                        && !GetNodeId(hdbc, dialect, odbc_helper).empty())
+                    {
+                        return hdbc;
+                    }
+                    std::this_thread::sleep_for(probe_interval);
+                }
+                factory->Close(hdbc);
+                return SQL_NULL_HDBC;
+            },
+            [factory](SQLHDBC hdbc) { factory->Close(hdbc); });
+    }
 }
 
 SQLRETURN FailoverPlugin::Execute(
-    SQLHSTMT       StatementHandle,
-    SQLTCHAR *     StatementText,
-    SQLINTEGER     TextLength)
+    SQLHSTMT           StatementHandle,
+    ExecutionContext & Context)
 {
     LOG(INFO) << "Entering Execute";
     STMT* stmt = static_cast<STMT*>(StatementHandle);
     DBC* dbc = stmt->dbc;
-    const SQLRETURN ret = next_plugin->Execute(StatementHandle, StatementText, TextLength);
+    const SQLRETURN ret = next_plugin->Execute(StatementHandle, Context);
 
     if (SQL_SUCCEEDED(ret)) {
         return ret;
@@ -90,6 +182,10 @@ SQLRETURN FailoverPlugin::Execute(
     if (!CheckShouldFailover(AS_UTF8_CSTR(sql_state))) {
         return ret;
     }
+    if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
+        // The connection to the host was lost, connects are turned away until it is probed again
+        HostHealthRegistry::Global().OpenCircuit(service->GetCurrentHostInfo().GetHost());
+    }
 
     {
         const std::lock_guard<std::recursive_mutex> lock_guard_dbc(dbc->lock);
@@ -112,7 +208,7 @@ SQLRETURN FailoverPlugin::Execute(
     bool failover_result = false;
     const TRANSACTION_STATUS original_transaction_status = dbc->transaction_status;
     if (failover_mode_ == STRICT_WRITER) {
-        failover_result = FailoverWriter(dbc);
+        failover_result = writer_racer_ ? ProbeWriters(dbc) : FailoverWriter(dbc);
     } else {
         failover_result = FailoverReader(dbc);
     }
@@ -142,6 +238,16 @@ SQLRETURN FailoverPlugin::Execute(
     return ret;
 }
 
+void FailoverPlugin::ReleaseResources()
+{
+    // Stops the background threads and closes their connections
+    standby_pool_ = nullptr;
+    reader_racer_ = nullptr;
+    writer_racer_ = nullptr;
+    connection_factory_ = nullptr;
+    BasePlugin::ReleaseResources();
+}
+
 bool FailoverPlugin::CheckShouldFailover(const char* sql_state)
 {
     // Check if the SQL State is related to a communication error
@@ -163,14 +269,14 @@ bool FailoverPlugin::FailoverReader(DBC* dbc)
 
     LOG(INFO) << "Starting reader failover procedure";
     // The roles in this list might not be accurate, depending on whether the new topology has become available yet.
-    std::vector<HostInfo> hosts;
+    std::shared_ptr<const TopologySnapshot> topology = PluginService::EMPTY_TOPOLOGY;
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
         // When we pass a timeout of 0, we inform the plugin service that it should update its topology without waiting
         // for it to get updated, since we do not need updated topology to establish a reader connection.
         service->ForceRefreshHosts(false, std::chrono::milliseconds(0));
-        hosts = service->GetFilteredHosts();
+        topology = service->GetFilteredTopologySnapshot();
     }
-    if (hosts.empty()) {
+    if (topology->hosts.empty()) {
         LOG(INFO) << "No topology available";
         return false;
     }
@@ -178,7 +284,7 @@ bool FailoverPlugin::FailoverReader(DBC* dbc)
     std::vector<HostInfo> reader_candidates;
     HostInfo original_writer;
 
-    for (const auto& host : hosts) {
+    for (const auto& host : topology->hosts) {
         if (host.IsHostWriter()) {
             original_writer = host;
         } else {
@@ -193,6 +299,13 @@ bool FailoverPlugin::FailoverReader(DBC* dbc)
     bool is_original_writer_still_writer = false;
     do {
         std::vector<HostInfo> remaining_readers(reader_candidates);
+        if (reader_racer_ && !remaining_readers.empty()) {
+            if (RaceReaders(dbc, remaining_readers, properties, end)) {
+                return true;
+            }
+            // Every reader has been tried, fall back to the original writer
+            remaining_readers.clear();
+        }
         while (!remaining_readers.empty() && (curr_time = std::chrono::steady_clock::now()) < end) {
             LOG(INFO) << "Failover for ClusterId: " << cluster_id_ << ". Remaining Hosts: " << remaining_readers.size();
             HostInfo host;
@@ -204,7 +317,7 @@ bool FailoverPlugin::FailoverReader(DBC* dbc)
                 LOG(INFO) << "No hosts in topology for: " << cluster_id_;
                 return false;
             }
-            const bool is_connected = ConnectToHost(dbc, host_string, odbc_helper_);
+            const bool is_connected = AdoptStandbyConnection(dbc, host_string) || ConnectToHost(dbc, host_string, odbc_helper_);
             if (!is_connected) {
                 LOG(INFO) << "Unable to connect to: " << host_string;
                 RemoveHostCandidate(host_string, remaining_readers);
@@ -247,7 +360,7 @@ bool FailoverPlugin::FailoverReader(DBC* dbc)
 
         // Try the original writer, which may have been demoted to a reader.
         host_string = original_writer.GetHost();
-        const bool is_connected = ConnectToHost(dbc, host_string, odbc_helper_);
+        const bool is_connected = AdoptStandbyConnection(dbc, host_string) || ConnectToHost(dbc, host_string, odbc_helper_);
         if (is_connected) {
             if (GetNodeId(dbc, dialect_, odbc_helper_).empty()) {
                 odbc_helper_->Disconnect(dbc);
@@ -279,11 +392,12 @@ bool FailoverPlugin::FailoverReader(DBC* dbc)
 
 bool FailoverPlugin::FailoverWriter(DBC *dbc)
 {
-    std::vector<HostInfo> hosts;
+    std::shared_ptr<const TopologySnapshot> topology = PluginService::EMPTY_TOPOLOGY;
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
         service->ForceRefreshHosts(true, failover_timeout_ms_);
-        hosts = service->GetFilteredHosts();
+        topology = service->GetFilteredTopologySnapshot();
     }
+    const std::vector<HostInfo>& hosts = topology->hosts;
 
     // Try connecting to a writer
     std::unordered_map<std::string, std::string> properties;
@@ -298,7 +412,7 @@ bool FailoverPlugin::FailoverWriter(DBC *dbc)
     const std::string host_string = host.GetHost();
     LOG(INFO) << "Writer failover connection to a new writer: " << host_string;
 
-    const bool is_connected = ConnectToHost(dbc, host_string, odbc_helper_);
+    const bool is_connected = AdoptStandbyConnection(dbc, host_string) || ConnectToHost(dbc, host_string, odbc_helper_);
     if (!is_connected) {
         LOG(INFO) << "Writer failover unable to connect to any instance for: " << cluster_id_;
         return false;
@@ -343,7 +457,133 @@ bool FailoverPlugin::ConnectToHost(DBC* dbc, const std::string& host_string, con
         }
     }
 
-    return SQL_SUCCEEDED(dbc->plugin_head->Connect(dbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT));
+    dbc->internal_reconnect = true;
+    const SQLRETURN ret = dbc->plugin_head->Connect(dbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
+    dbc->internal_reconnect = false;
+    return SQL_SUCCEEDED(ret);
+}
+
+// Moves a standby connection to the host onto the application's connection.
+// The caller verifies the role of the connection the same way it does for a new one.
+bool FailoverPlugin::AdoptStandbyConnection(DBC* dbc, const std::string& host_string)
+{
+    if (!standby_pool_) {
+        return false;
+    }
+    const SQLHDBC wrapped_dbc = standby_pool_->TakeUnderlyingConnection(host_string);
+    if (wrapped_dbc == SQL_NULL_HDBC) {
+        return false;
+    }
+    LOG(INFO) << "Using standby connection to host: " << host_string;
+    AttachUnderlyingConnection(dbc, host_string, wrapped_dbc);
+    return true;
+}
+
+// Replaces the application's underlying connection with one opened outside of it
+void FailoverPlugin::AttachUnderlyingConnection(DBC* dbc, const std::string& host_string, SQLHDBC wrapped_dbc)
+{
+    odbc_helper_->Disconnect(dbc);
+
+    const std::lock_guard<std::recursive_mutex> lock_guard(dbc->lock);
+    dbc->conn_attr.insert_or_assign(KEY_SERVER, host_string);
+    if (const std::shared_ptr<PluginService> service = dbc->plugin_service) {
+        const int port = service->GetTemplateHostInfo().GetPort();
+        if (port != HostInfo::NO_PORT) {
+            dbc->conn_attr.insert_or_assign(KEY_PORT, std::to_string(port));
+        }
+    }
+    dbc->wrapped_dbc = wrapped_dbc;
+    // Opened with connection attributes of its own, it is not pooled once released
+    dbc->pool_key.clear();
+
+    // The connection was opened without the application's connection attributes or session settings
+    DefaultPlugin::InitializeConnectedDbc(dbc);
+}
+
+// Connects to several readers at once instead of waiting for each dead reader's login timeout.
+// Attempts are started in the host selector's order of preference.
+bool FailoverPlugin::RaceReaders(DBC* dbc, std::vector<HostInfo> candidates, std::unordered_map<std::string, std::string>& properties,
+    const std::chrono::steady_clock::time_point end)
+{
+    std::vector<HostInfo> ordered;
+    while (!candidates.empty()) {
+        HostInfo host;
+        try {
+            host = host_selector_->GetHost(candidates, false, properties);
+        } catch (const std::exception& e) {
+            break;
+        }
+        const size_t remaining = candidates.size();
+        RemoveHostCandidate(host.GetHost(), candidates);
+        if (candidates.size() == remaining) {
+            break;
+        }
+        ordered.push_back(host);
+    }
+    ordered.insert(ordered.end(), candidates.begin(), candidates.end());
+
+    LOG(INFO) << "Racing reader failover for ClusterId: " << cluster_id_ << ". Hosts: " << ordered.size();
+    const std::optional<ConnectionRacer::Winner> winner = reader_racer_->Race(ordered, race_config_, end);
+    if (!winner) {
+        LOG(INFO) << "Unable to connect to any reader for: " << cluster_id_;
+        return false;
+    }
+
+    const std::string host_string = winner->host_info.GetHost();
+    AttachUnderlyingConnection(dbc, host_string, HostConnectionFactory::DetachUnderlyingConnection(winner->hdbc));
+    LOG(INFO) << "Connected to a new reader for: " << host_string;
+    if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
+        service->SetCurrentHostInfo(winner->host_info);
+    }
+    return true;
+}
+
+// Probes every host for the writer role at once instead of waiting for the topology monitor
+// to report the new writer. Probes keep their connection and poll its role until a host is
+// promoted, the first confirmed writer connection is moved onto the application's connection.
+bool FailoverPlugin::ProbeWriters(DBC* dbc)
+{
+    const auto end = std::chrono::steady_clock::now() + failover_timeout_ms_;
+
+    LOG(INFO) << "Starting writer failover probing";
+    std::vector<HostInfo> hosts;
+    if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
+        // The monitor refreshes topology alongside the probes
+        service->ForceRefreshHosts(false, std::chrono::milliseconds(0));
+        hosts = service->GetFilteredHosts();
+    }
+    if (hosts.empty()) {
+        LOG(INFO) << "No topology available";
+        return false;
+    }
+    // The writer reported by the monitor is the most likely candidate, probe it first
+    std::ranges::stable_partition(hosts, [](const HostInfo& host) { return host.IsHostWriter(); });
+
+    ConnectionRaceConfig config;
+    config.enabled = true;
+    config.stagger_ms = std::chrono::milliseconds(0);
+    config.max_parallel = hosts.size();
+    const std::optional<ConnectionRacer::Winner> winner = writer_racer_->Race(hosts, config, end);
+    if (!winner) {
+        LOG(INFO) << "Writer failover probing did not find a writer for: " << cluster_id_;
+        odbc_helper_->Disconnect(dbc);
+        return false;
+    }
+
+    const std::string host_string = winner->host_info.GetHost();
+    AttachUnderlyingConnection(dbc, host_string, HostConnectionFactory::DetachUnderlyingConnection(winner->hdbc));
+    LOG(INFO) << "Writer failover probing connected to a new writer for: " << host_string;
+
+    HostInfo writer = winner->host_info;
+    writer.SetHostRole(WRITER);
+    if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
+        // The probe confirmed the promotion before the monitor, have it catch up
+        if (!winner->host_info.IsHostWriter()) {
+            service->ForceRefreshHosts(false, std::chrono::milliseconds(0));
+        }
+        service->SetCurrentHostInfo(writer);
+    }
+    return true;
 }
 
 FailoverMode FailoverPlugin::InitFailoverMode(std::map<std::string, std::string>& conn_info)
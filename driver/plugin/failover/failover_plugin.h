@@ -15,6 +15,10 @@
 #ifndef FAILOVER_PLUGIN_H_
 #define FAILOVER_PLUGIN_H_
 
+#include "connection_racer.h"
+#include "host_connection_factory.h"
+#include "standby_connection_pool.h"
+
 #include "../base_plugin.h"
 #include "../../driver.h"
 #include "../../dialect/dialect.h"
@@ -53,18 +57,27 @@ public:
         SQLUSMALLINT   DriverCompletion) override;
 
     SQLRETURN Execute(
-        SQLHSTMT       StatementHandle,
-        SQLTCHAR *     StatementText,
-        SQLINTEGER     TextLength) override;
+        SQLHSTMT           StatementHandle,
+        ExecutionContext & Context) override;
+
+    void ReleaseResources() override;
 private:
     static inline const std::chrono::milliseconds
         DEFAULT_FAILOVER_TIMEOUT_MS = std::chrono::seconds(30);
+    static inline const std::chrono::milliseconds
+        DEFAULT_WRITER_PROBE_INTERVAL_MS = std::chrono::milliseconds(100);
 
     bool CheckShouldFailover(const char* sql_state);
     static void RemoveHostCandidate(const std::string& host, std::vector<HostInfo>& candidates);
     bool FailoverReader(DBC* hdbc);
     bool FailoverWriter(DBC* hdbc);
     static bool ConnectToHost(DBC* hdbc, const std::string& host_string, const std::shared_ptr<OdbcHelper> &odbc_helper);
+    bool AdoptStandbyConnection(DBC* dbc, const std::string& host_string);
+    void AttachUnderlyingConnection(DBC* dbc, const std::string& host_string, SQLHDBC wrapped_dbc);
+    bool RaceReaders(DBC* dbc, std::vector<HostInfo> candidates, std::unordered_map<std::string, std::string>& properties,
+        std::chrono::steady_clock::time_point end);
+    bool ProbeWriters(DBC* dbc);
+    void InitFailoverConnections(DBC* dbc);
 
     static FailoverMode InitFailoverMode(std::map<std::string, std::string>& conn_info);
 
@@ -75,6 +88,14 @@ private:
     FailoverMode failover_mode_ = UNKNOWN_FAILOVER_MODE;
     std::shared_ptr<OdbcHelper> odbc_helper_;
     std::weak_ptr<PluginService> plugin_service_;
+    StandbyConnectionConfig standby_config_;
+    ConnectionRaceConfig race_config_;
+    bool writer_probing_enabled_ = false;
+    std::chrono::milliseconds writer_probe_interval_ms_ = DEFAULT_WRITER_PROBE_INTERVAL_MS;
+    std::shared_ptr<HostConnectionFactory> connection_factory_;
+    std::shared_ptr<StandbyConnectionPool> standby_pool_;
+    std::unique_ptr<ConnectionRacer> reader_racer_;
+    std::unique_ptr<ConnectionRacer> writer_racer_;
 };
 
 #endif // FAILOVER_PLUGIN_H_
@@ -0,0 +1,109 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "host_connection_factory.h"
+
+#include "../../driver.h"
+#include "../base_plugin.h"
+
+#include "../../util/connection_string_keys.h"
+#include "../../util/map_utils.h"
+#include "../../util/odbc_helper.h"
+#include "../../util/plugin_chain_builder.h"
+#include "../../util/plugin_service.h"
+
+HostConnectionFactory::HostConnectionFactory(
+    const std::shared_ptr<PluginService>& plugin_service,
+    const std::shared_ptr<OdbcHelper>& odbc_helper,
+    ENV* env)
+    : HostConnectionFactory(plugin_service->GetOriginalConnAttr(), nullptr, nullptr, odbc_helper, env)
+{
+    // Only authentication is needed, build a monitoring chain the same way
+    // the host list provider does for its topology connections.
+    std::map<std::string, std::string> chain_map = connection_attributes_;
+    const std::string chain_cluster_id = MapUtils::GetStringValue(chain_map, KEY_CLUSTER_ID, "<empty>") + "-failover";
+    chain_map.insert_or_assign(KEY_CLUSTER_ID, chain_cluster_id);
+
+    chain_dbc_ = new DBC();
+    chain_dbc_->conn_attr = chain_map;
+    connect_plugin_service_ = std::make_shared<PluginService>(odbc_helper_->GetLibLoader(), chain_map);
+    plugin_head_ = PluginChainBuilder::MonitoringBuild(chain_dbc_, connect_plugin_service_);
+    connect_plugin_service_->SetPluginChain(plugin_head_);
+}
+
+HostConnectionFactory::HostConnectionFactory(
+    const std::map<std::string, std::string>& conn_attr,
+    const std::shared_ptr<PluginService>& connect_plugin_service,
+    const std::shared_ptr<BasePlugin>& plugin_head,
+    const std::shared_ptr<OdbcHelper>& odbc_helper,
+    ENV* env)
+    : connection_attributes_(conn_attr),
+      connect_plugin_service_(connect_plugin_service),
+      plugin_head_(plugin_head),
+      odbc_helper_(odbc_helper),
+      henv_(env)
+{
+    // Skips routing plugins and the dialect update, like other internal connections
+    connection_attributes_.insert_or_assign(KEY_MONITORING_CONN_UUID, VALUE_BOOL_TRUE);
+}
+
+HostConnectionFactory::~HostConnectionFactory() {
+    plugin_head_ = nullptr;
+    connect_plugin_service_ = nullptr;
+    delete chain_dbc_;
+    chain_dbc_ = nullptr;
+}
+
+SQLHDBC HostConnectionFactory::Open(const HostInfo& host_info) {
+    SQLHDBC hdbc = SQL_NULL_HDBC;
+    if (!SQL_SUCCEEDED(odbc_helper_->AllocDbc(henv_, hdbc)) || hdbc == SQL_NULL_HDBC) {
+        return SQL_NULL_HDBC;
+    }
+    DBC* dbc = static_cast<DBC*>(hdbc);
+    dbc->conn_attr = connection_attributes_;
+    dbc->conn_attr.insert_or_assign(KEY_SERVER, host_info.GetHost());
+    if (host_info.GetPort() != HostInfo::NO_PORT) {
+        dbc->conn_attr.insert_or_assign(KEY_PORT, std::to_string(host_info.GetPort()));
+    }
+    dbc->plugin_service = connect_plugin_service_;
+    dbc->attr_map.insert_or_assign(SQL_ATTR_LOGIN_TIMEOUT, std::make_pair(reinterpret_cast<SQLPOINTER>(static_cast<intptr_t>(DEFAULT_TIMEOUT_SECONDS)), 0));
+    dbc->attr_map.insert_or_assign(SQL_ATTR_CONNECTION_TIMEOUT, std::make_pair(reinterpret_cast<SQLPOINTER>(static_cast<intptr_t>(DEFAULT_TIMEOUT_SECONDS)), 0));
+
+    if (!SQL_SUCCEEDED(plugin_head_->Connect(hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT))) {
+        Close(hdbc);
+        return SQL_NULL_HDBC;
+    }
+    // Owned by the caller, not the application
+    {
+        const std::lock_guard<std::recursive_mutex> lock_guard(dbc->env->lock);
+        dbc->env->dbc_list.remove(dbc);
+    }
+    return hdbc;
+}
+
+SQLHDBC HostConnectionFactory::DetachUnderlyingConnection(SQLHDBC hdbc) {
+    DBC* dbc = static_cast<DBC*>(hdbc);
+    const SQLHDBC wrapped_dbc = dbc->wrapped_dbc;
+    dbc->wrapped_dbc = SQL_NULL_HDBC;
+    delete dbc;
+    return wrapped_dbc;
+}
+
+void HostConnectionFactory::Close(SQLHDBC hdbc) {
+    odbc_helper_->DisconnectAndFree(&hdbc);
+}
+
+bool HostConnectionFactory::IsClosed(SQLHDBC hdbc) {
+    return odbc_helper_->IsClosed(hdbc);
+}
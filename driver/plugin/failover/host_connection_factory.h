@@ -0,0 +1,71 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HOST_CONNECTION_FACTORY_H_
+#define HOST_CONNECTION_FACTORY_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "../../odbcapi.h"
+#include "../../host_info.h"
+
+struct DBC;
+struct ENV;
+class BasePlugin;
+class OdbcHelper;
+class PluginService;
+
+// Opens connections to specific cluster instances on behalf of the failover plugin.
+// Connections go through an authentication only plugin chain, the same way the
+// topology monitor opens its connections, but are allocated under the
+// application's environment so their underlying handles can be moved onto the
+// application's connection. Safe to use from multiple threads.
+class HostConnectionFactory {
+public:
+    HostConnectionFactory(
+        const std::shared_ptr<PluginService>& plugin_service,
+        const std::shared_ptr<OdbcHelper>& odbc_helper,
+        ENV* env);
+    HostConnectionFactory(
+        const std::map<std::string, std::string>& conn_attr,
+        const std::shared_ptr<PluginService>& connect_plugin_service,
+        const std::shared_ptr<BasePlugin>& plugin_head,
+        const std::shared_ptr<OdbcHelper>& odbc_helper,
+        ENV* env);
+    ~HostConnectionFactory();
+
+    // Returns a connected wrapper handle owned by the caller, or SQL_NULL_HDBC
+    SQLHDBC Open(const HostInfo& host_info);
+
+    // Frees the wrapper handle and returns the underlying base driver connection
+    static SQLHDBC DetachUnderlyingConnection(SQLHDBC hdbc);
+
+    void Close(SQLHDBC hdbc);
+
+    bool IsClosed(SQLHDBC hdbc);
+
+private:
+    std::map<std::string, std::string> connection_attributes_;
+    std::shared_ptr<PluginService> connect_plugin_service_;
+    std::shared_ptr<BasePlugin> plugin_head_;
+    std::shared_ptr<OdbcHelper> odbc_helper_;
+    SQLHENV henv_;
+    DBC* chain_dbc_ = nullptr;
+
+    static constexpr int DEFAULT_TIMEOUT_SECONDS = 10;
+};
+
+#endif // HOST_CONNECTION_FACTORY_H_
@@ -0,0 +1,229 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "standby_connection_pool.h"
+
+#include <algorithm>
+
+#include "../../util/connection_string_keys.h"
+#include "../../util/logger_wrapper.h"
+#include "../../util/map_utils.h"
+#include "../../util/plugin_service.h"
+
+StandbyConnectionConfig StandbyConnectionConfig::FromConnAttr(const std::map<std::string, std::string>& conn_attr) {
+    StandbyConnectionConfig config;
+    config.enabled = MapUtils::GetBooleanValue(conn_attr, KEY_ENABLE_FAILOVER_STANDBY, false);
+    const int standby_count = MapUtils::GetIntValue(conn_attr, KEY_FAILOVER_STANDBY_COUNT, DEFAULT_STANDBY_COUNT);
+    config.standby_count = standby_count > 0 ? static_cast<size_t>(standby_count) : 0;
+    config.refresh_ms = MapUtils::GetMillisecondsValue(conn_attr, KEY_FAILOVER_STANDBY_REFRESH, DEFAULT_REFRESH_MS);
+    return config;
+}
+
+StandbyConnectionPool::StandbyConnectionPool(
+    const std::shared_ptr<PluginService>& plugin_service,
+    const std::shared_ptr<HostConnectionFactory>& connection_factory,
+    const StandbyConnectionConfig& config)
+    : plugin_service_(plugin_service),
+      connection_factory_(connection_factory),
+      config_(config) {}
+
+StandbyConnectionPool::~StandbyConnectionPool() {
+    stop_requested_ = true;
+    // Waits for a refresh in progress, it stops opening connections once stop is requested
+    if (const MonitoringScheduler::TaskId task_id = task_id_->exchange(0); task_id != 0) {
+        scheduler_->Cancel(task_id);
+    }
+
+    std::vector<StandbyConnection> standbys;
+    {
+        const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+        standbys.swap(standbys_);
+    }
+    for (const StandbyConnection& standby : standbys) {
+        connection_factory_->Close(standby.hdbc);
+    }
+}
+
+void StandbyConnectionPool::StartMonitor() {
+    if (config_.standby_count == 0 || task_id_->load() != 0) {
+        return;
+    }
+    LOG(INFO) << "Standby connection monitor started";
+    scheduler_ = PluginService::GetMonitoringScheduler();
+    task_id_->store(scheduler_->Schedule([this] { return this->Run(); }));
+}
+
+std::optional<std::chrono::milliseconds> StandbyConnectionPool::Run() {
+    if (stop_requested_) {
+        return std::nullopt;
+    }
+    try {
+        DrainTopologyEvents();
+        RefreshStandbys();
+    } catch (const std::exception& ex) {
+        LOG(ERROR) << "Exception while refreshing standby connections: " << ex.what();
+    }
+    return config_.refresh_ms;
+}
+
+void StandbyConnectionPool::DrainTopologyEvents() {
+    if (!topology_subscription_) {
+        const std::shared_ptr<PluginService> service = plugin_service_.lock();
+        const std::shared_ptr<HostListProvider> provider = service ? service->GetHostListProvider() : nullptr;
+        if (!provider) {
+            return;
+        }
+        // Called by the topology monitor, must not capture the pool which may be destroyed while it publishes
+        const std::weak_ptr<MonitoringScheduler> weak_scheduler = scheduler_;
+        topology_subscription_ = provider->Subscribe([weak_scheduler, task_id = task_id_] {
+            const std::shared_ptr<MonitoringScheduler> scheduler = weak_scheduler.lock();
+            if (const MonitoringScheduler::TaskId id = task_id->load(); scheduler && id != 0) {
+                scheduler->Wake(id);
+            }
+        });
+        if (!topology_subscription_) {
+            return;
+        }
+    }
+
+    // The hosts are already updated when the events arrive, the refresh drops standbys no longer in the topology
+    TopologyEvent event;
+    while (topology_subscription_->Poll(event)) {
+        if (event.type == TopologyEvent::Type::HOST_REMOVED) {
+            LOG(INFO) << "Host removed from the topology: " << event.host.GetHost();
+        }
+    }
+    topology_subscription_->TakeOverflow();
+}
+
+void StandbyConnectionPool::RefreshStandbys() {
+    const std::shared_ptr<PluginService> service = plugin_service_.lock();
+    if (!service) {
+        return;
+    }
+    const std::vector<HostInfo> hosts = service->GetHosts();
+    const std::string current_host = service->GetCurrentHostInfo().GetHost();
+    const auto in_topology = [&hosts](const std::string& host) {
+        return std::ranges::any_of(hosts, [&host](const HostInfo& h) { return h.GetHost() == host; });
+    };
+
+    // Drop standbys that failover could not use
+    std::vector<SQLHDBC> to_close;
+    std::vector<SQLHDBC> to_validate;
+    {
+        const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+        for (auto it = standbys_.begin(); it != standbys_.end();) {
+            const std::string host = it->host_info.GetHost();
+            if (host == current_host || !in_topology(host)) {
+                LOG(INFO) << "Dropping standby connection to: " << host;
+                to_close.push_back(it->hdbc);
+                it = standbys_.erase(it);
+            } else {
+                to_validate.push_back(it->hdbc);
+                ++it;
+            }
+        }
+    }
+    for (SQLHDBC hdbc : to_close) {
+        connection_factory_->Close(hdbc);
+    }
+
+    // Validated the same way as the application's connections, with a query if the base driver cannot report a dead connection.
+    // Validate outside the lock like the connects below, one standby at a time is taken out of the pool meanwhile
+    // so failover neither waits for the validation nor takes a connection still in use.
+    for (SQLHDBC hdbc : to_validate) {
+        std::optional<StandbyConnection> standby;
+        {
+            const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+            const auto it = std::ranges::find_if(standbys_, [hdbc](const StandbyConnection& s) { return s.hdbc == hdbc; });
+            // Already taken by failover
+            if (it == standbys_.end()) {
+                continue;
+            }
+            standby = std::move(*it);
+            standbys_.erase(it);
+        }
+        if (connection_factory_->IsClosed(standby->hdbc)) {
+            LOG(INFO) << "Dropping standby connection to: " << standby->host_info.GetHost();
+            connection_factory_->Close(standby->hdbc);
+        } else {
+            const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+            standbys_.push_back(std::move(*standby));
+        }
+    }
+
+    std::vector<std::string> standby_hosts;
+    {
+        const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+        for (const StandbyConnection& standby : standbys_) {
+            standby_hosts.push_back(standby.host_info.GetHost());
+        }
+    }
+
+    if (standby_hosts.size() >= config_.standby_count) {
+        return;
+    }
+
+    // Readers first, they are the candidates for reader failover and the new writer
+    // is promoted from them during writer failover.
+    std::vector<HostInfo> candidates;
+    for (const HostInfo& host : hosts) {
+        if (host.GetHost() != current_host && std::ranges::find(standby_hosts, host.GetHost()) == standby_hosts.end()) {
+            candidates.push_back(host);
+        }
+    }
+    std::ranges::stable_partition(candidates, [](const HostInfo& h) { return !h.IsHostWriter(); });
+
+    size_t missing = config_.standby_count - standby_hosts.size();
+    for (const HostInfo& host : candidates) {
+        if (missing == 0 || stop_requested_) {
+            break;
+        }
+        // Connect outside the lock so failover can still take the existing standbys
+        const SQLHDBC hdbc = connection_factory_->Open(host);
+        if (hdbc == SQL_NULL_HDBC) {
+            LOG(INFO) << "Unable to open a standby connection to: " << host.GetHost();
+            continue;
+        }
+        LOG(INFO) << "Opened a standby connection to: " << host.GetHost();
+        const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+        standbys_.push_back(StandbyConnection{.host_info = host, .hdbc = hdbc});
+        missing--;
+    }
+}
+
+SQLHDBC StandbyConnectionPool::TakeUnderlyingConnection(const std::string& host) {
+    SQLHDBC hdbc = SQL_NULL_HDBC;
+    {
+        const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+        const auto it = std::ranges::find_if(standbys_, [&host](const StandbyConnection& s) { return s.host_info.GetHost() == host; });
+        if (it == standbys_.end()) {
+            return SQL_NULL_HDBC;
+        }
+        hdbc = it->hdbc;
+        standbys_.erase(it);
+    }
+
+    if (connection_factory_->IsClosed(hdbc)) {
+        LOG(INFO) << "Standby connection to " << host << " is no longer alive";
+        connection_factory_->Close(hdbc);
+        return SQL_NULL_HDBC;
+    }
+    return HostConnectionFactory::DetachUnderlyingConnection(hdbc);
+}
+
+size_t StandbyConnectionPool::GetStandbyCount() {
+    const std::lock_guard<std::mutex> lock_guard(standbys_mutex_);
+    return standbys_.size();
+}
@@ -0,0 +1,99 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STANDBY_CONNECTION_POOL_H_
+#define STANDBY_CONNECTION_POOL_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "host_connection_factory.h"
+
+#include "../../odbcapi.h"
+#include "../../host_info.h"
+#include "../../host_list_providers/topology_event_publisher.h"
+#include "../../util/monitoring_scheduler.h"
+
+class PluginService;
+
+struct StandbyConnectionConfig {
+    static constexpr int DEFAULT_STANDBY_COUNT = 1;
+    static inline const std::chrono::milliseconds DEFAULT_REFRESH_MS = std::chrono::seconds(5);
+
+    bool enabled = false;
+    size_t standby_count = DEFAULT_STANDBY_COUNT;
+    std::chrono::milliseconds refresh_ms = DEFAULT_REFRESH_MS;
+
+    static StandbyConnectionConfig FromConnAttr(const std::map<std::string, std::string>& conn_attr);
+};
+
+// Keeps a small number of connected, periodically validated connections to
+// other members of the cluster topology so failover can adopt one instead of
+// opening a new connection while the application is blocked.
+class StandbyConnectionPool {
+public:
+    StandbyConnectionPool(
+        const std::shared_ptr<PluginService>& plugin_service,
+        const std::shared_ptr<HostConnectionFactory>& connection_factory,
+        const StandbyConnectionConfig& config);
+    ~StandbyConnectionPool();
+
+    // Starts maintaining standby connections on the monitoring scheduler
+    void StartMonitor();
+
+    // Drops standby connections that are dead or no longer in the topology
+    // and opens new ones until the configured count is reached.
+    // Called periodically on the monitoring scheduler.
+    void RefreshStandbys();
+
+    // Removes a live standby connection to the host and returns its underlying
+    // base driver handle, or SQL_NULL_HDBC if there is none.
+    // The caller takes ownership of the handle and must verify its role.
+    SQLHDBC TakeUnderlyingConnection(const std::string& host);
+
+    size_t GetStandbyCount();
+
+private:
+    struct StandbyConnection {
+        HostInfo host_info;
+        SQLHDBC hdbc;
+    };
+
+    std::optional<std::chrono::milliseconds> Run();
+    // Subscribes on first use, topology changes wake the monitor so standbys to removed hosts are dropped right away
+    void DrainTopologyEvents();
+
+    std::weak_ptr<PluginService> plugin_service_;
+    std::shared_ptr<HostConnectionFactory> connection_factory_;
+    StandbyConnectionConfig config_;
+
+    std::mutex standbys_mutex_;
+    std::vector<StandbyConnection> standbys_;
+
+    std::shared_ptr<MonitoringScheduler> scheduler_;
+    // Shared with the topology subscription, which may be called before the first run returns
+    const std::shared_ptr<std::atomic<MonitoringScheduler::TaskId>> task_id_ =
+        std::make_shared<std::atomic<MonitoringScheduler::TaskId>>(0);
+    std::atomic<bool> stop_requested_{false};
+    // Only used by the monitoring task
+    std::shared_ptr<TopologySubscription> topology_subscription_;
+};
+
+#endif // STANDBY_CONNECTION_POOL_H_
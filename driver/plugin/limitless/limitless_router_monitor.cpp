@@ -28,6 +28,7 @@
 #include "../../util/cluster_helper.h"
 #include "../../util/connection_string_helper.h"
 #include "../../util/logger_wrapper.h"
+#include "../../util/plugin_service.h"
 #include "limitless_query_helper.h"
 
 LimitlessRouterMonitor::LimitlessRouterMonitor(
@@ -93,8 +94,14 @@ void LimitlessRouterMonitor::Open(
         }
     }
 
-    // Start monitoring thread; if block_and_query_immediately is false, then local_hdbc is SQL_NULL_HANDLE, and the thread will connect after the monitor interval has passed.
-    this->monitor_thread_ = std::make_shared<std::thread>(&LimitlessRouterMonitor::Run, this, henv, local_hdbc, dbc->conn_attr, host_port);
+    // Schedule monitoring; if block_and_query_immediately is false, then local_hdbc is SQL_NULL_HANDLE, and the task will connect after the monitor interval has passed.
+    this->henv_ = henv;
+    this->hdbc_ = local_hdbc;
+    this->conn_attr_ = dbc->conn_attr;
+    this->host_port_ = host_port;
+    this->scheduler_ = PluginService::GetMonitoringScheduler();
+    this->task_id_ = this->scheduler_->Schedule([this] { return this->Run(); }, std::chrono::milliseconds(this->interval_ms_));
+    this->scheduled_ = true;
 }
 
 bool LimitlessRouterMonitor::IsStopped() {
@@ -107,67 +114,62 @@ void LimitlessRouterMonitor::Close() {
     }
 
     this->stopped_ = true;
-    this->monitor_loop_cv_.notify_all();
 
-    if (this->monitor_thread_ != nullptr) {
-        this->monitor_thread_->join();
-        this->monitor_thread_ = nullptr;
+    if (!this->scheduled_) {
+        return;
+    }
+    this->scheduler_->Cancel(this->task_id_);
+    this->scheduled_ = false;
+
+    if (this->hdbc_ != SQL_NULL_HANDLE) {
+        odbc_helper_->DisconnectAndFree(&this->hdbc_);
+        this->hdbc_ = SQL_NULL_HANDLE;
     }
+    odbc_helper_->FreeEnv(&this->henv_);
 }
 
-void LimitlessRouterMonitor::Run(SQLHENV henv, SQLHDBC conn, const std::map<std::string, std::string>& conn_attr, int host_port) {
-    DBC* dbc = static_cast<DBC*>(conn);
-    do {
-        std::unique_lock lock(monitor_loop_mutex_);
-        monitor_loop_cv_.wait_for(lock, std::chrono::milliseconds(this->interval_ms_));
+std::optional<std::chrono::milliseconds> LimitlessRouterMonitor::Run() {
+    if (this->stopped_) {
+        return std::nullopt;
+    }
+    const std::chrono::milliseconds interval(this->interval_ms_);
 
-        // If monitor_loop_cv_ has been notified, skip the rest of the loop.
-        if (this->stopped_) {
-            break;
+    if (this->hdbc_ == SQL_NULL_HANDLE || GetNodeId(this->hdbc_, dialect_, odbc_helper_).empty()) {
+        if (this->hdbc_) {
+            odbc_helper_->DisconnectAndFree(&this->hdbc_);
+            this->hdbc_ = SQL_NULL_HANDLE;
         }
 
-        if (conn == SQL_NULL_HANDLE || GetNodeId(conn, dialect_, odbc_helper_).empty()) {
-            if (conn) {
-                odbc_helper_->DisconnectAndFree(&conn);
-                conn = SQL_NULL_HANDLE;
-            }
-
-            odbc_helper_->AllocDbc(henv, conn);
-            dbc = static_cast<DBC*>(conn);
-            dbc->conn_attr = conn_attr;
-            dbc->conn_attr.insert_or_assign(KEY_MONITORING_CONN_UUID, VALUE_BOOL_TRUE);
-
-            const SQLRETURN rc = plugin_head_->Connect(
-                conn,
-                nullptr,
-                nullptr,
-                0,
-                nullptr,
-                SQL_DRIVER_NOPROMPT);
-            if (!SQL_SUCCEEDED(rc)) {
-                odbc_helper_->DisconnectAndFree(&conn);
-                conn = SQL_NULL_HANDLE;
-
-                // wait the full interval and then try to reconnect
-                LOG(WARNING) << "Limitless Monitor failed to connect to an instance";
-                continue;
-            } // else, connection was successful, proceed below
-        }
+        odbc_helper_->AllocDbc(this->henv_, this->hdbc_);
+        DBC* dbc = static_cast<DBC*>(this->hdbc_);
+        dbc->conn_attr = this->conn_attr_;
+        dbc->conn_attr.insert_or_assign(KEY_MONITORING_CONN_UUID, VALUE_BOOL_TRUE);
 
-        const std::vector<HostInfo> new_limitless_routers = this->limitless_query_helper_->QueryForLimitlessRouters(conn, host_port, dialect_);
-        // LimitlessQueryHelper::QueryForLimitlessRouters will return an empty vector on an error
-        // if it was a connection error, then the next loop will catch it and attempt to reconnect
-        if (new_limitless_routers.empty()) {
-            LOG(WARNING) << "Limitless Monitor failed to query any routers";
-        } else {
-            const std::lock_guard<std::mutex> guard(this->limitless_routers_mutex_);
-            *(this->limitless_routers_) = new_limitless_routers;
-        }
-    } while (!this->stopped_);
+        const SQLRETURN rc = plugin_head_->Connect(
+            this->hdbc_,
+            nullptr,
+            nullptr,
+            0,
+            nullptr,
+            SQL_DRIVER_NOPROMPT);
+        if (!SQL_SUCCEEDED(rc)) {
+            odbc_helper_->DisconnectAndFree(&this->hdbc_);
+            this->hdbc_ = SQL_NULL_HANDLE;
+
+            // wait the full interval and then try to reconnect
+            LOG(WARNING) << "Limitless Monitor failed to connect to an instance";
+            return interval;
+        } // else, connection was successful, proceed below
+    }
 
-    if (conn != SQL_NULL_HANDLE) {
-        odbc_helper_->DisconnectAndFree(&conn);
-        conn = SQL_NULL_HANDLE;
+    const std::vector<HostInfo> new_limitless_routers = this->limitless_query_helper_->QueryForLimitlessRouters(this->hdbc_, this->host_port_, dialect_);
+    // LimitlessQueryHelper::QueryForLimitlessRouters will return an empty vector on an error
+    // if it was a connection error, then the next run will catch it and attempt to reconnect
+    if (new_limitless_routers.empty()) {
+        LOG(WARNING) << "Limitless Monitor failed to query any routers";
+    } else {
+        const std::lock_guard<std::mutex> guard(this->limitless_routers_mutex_);
+        *(this->limitless_routers_) = new_limitless_routers;
     }
-    odbc_helper_->FreeEnv(&henv);
+    return interval;
 }
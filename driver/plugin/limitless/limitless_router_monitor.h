@@ -21,13 +21,15 @@
 #endif
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <map>
 #include <mutex>
-#include <thread>
+#include <optional>
 #include <vector>
 
 #include "../../host_info.h"
 #include "../../dialect/dialect.h"
+#include "../../util/monitoring_scheduler.h"
 #include "../../util/odbc_helper.h"
 #include "../../util/rds_strings.h"
 #include "../base_plugin.h"
@@ -54,18 +56,27 @@ public:
     std::mutex limitless_routers_mutex_;
     std::shared_ptr<RdsLibLoader> lib_loader_;
     std::shared_ptr<BasePlugin> plugin_head_;
-    std::condition_variable monitor_loop_cv_;
-    std::mutex monitor_loop_mutex_;
 
 protected:
     std::atomic_bool stopped_ = false;
     unsigned int interval_ms_;
-    std::shared_ptr<std::thread> monitor_thread_ = nullptr;
     std::shared_ptr<DialectLimitless> dialect_;
     std::shared_ptr<OdbcHelper> odbc_helper_;
     std::shared_ptr<LimitlessQueryHelper> limitless_query_helper_;
 
-    void Run(SQLHENV henv, SQLHDBC conn, const std::map<std::string, std::string>& conn_attr, int host_port);
+    // Queries the routers once, returning the delay until the next query
+    std::optional<std::chrono::milliseconds> Run();
+
+private:
+    std::shared_ptr<MonitoringScheduler> scheduler_;
+    MonitoringScheduler::TaskId task_id_ = 0;
+    bool scheduled_ = false;
+
+    // Only used by the monitoring task
+    SQLHENV henv_ = SQL_NULL_HANDLE;
+    SQLHDBC hdbc_ = SQL_NULL_HANDLE;
+    std::map<std::string, std::string> conn_attr_;
+    int host_port_ = 0;
 };
 
 #endif // LIMITLESS_ROUTER_MONITOR_H_
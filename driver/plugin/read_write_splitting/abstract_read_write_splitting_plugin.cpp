@@ -13,10 +13,15 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <utility>
 
 #include "abstract_read_write_splitting_plugin.h"
 
 #include "../../odbcapi_rds_helper.h"
+#include "../../host_list_providers/host_list_provider.h"
+#include "../../host_list_providers/topology_event_publisher.h"
+#include "../../util/connection_string_keys.h"
+#include "../../util/map_utils.h"
 #include "../../util/plugin_service.h"
 #include "../../util/sql_query_analyzer.h"
 
@@ -35,12 +40,14 @@ AbstractReadWriteSplittingPlugin::AbstractReadWriteSplittingPlugin(DBC *dbc, std
     }
     this->next_plugin = next_plugin;
     this->dbc_ = dbc;
+    this->speculative_reader_enabled_ = MapUtils::GetBooleanValue(dbc->conn_attr, KEY_RW_SPECULATIVE_READER_CONNECT, false);
 
     henv_ = dbc_->env;
 }
 
 AbstractReadWriteSplittingPlugin::~AbstractReadWriteSplittingPlugin() {
     const std::lock_guard<std::recursive_mutex> lock_guard(lock_);
+    DiscardSpeculativeReader();
 
     if (DBC* reader_conn = this->reader_cache_item_.value; reader_conn && reader_conn != dbc_) {
         reader_conn->wrapped_dbc = nullptr;
@@ -57,6 +64,7 @@ AbstractReadWriteSplittingPlugin::~AbstractReadWriteSplittingPlugin() {
 
 void AbstractReadWriteSplittingPlugin::ReleaseResources() {
     const std::lock_guard<std::recursive_mutex> lock_guard(lock_);
+    DiscardSpeculativeReader();
 
     DBC* reader_conn = this->reader_cache_item_.value;
     if (reader_conn && reader_conn != dbc_) {
@@ -80,19 +88,48 @@ void AbstractReadWriteSplittingPlugin::ReleaseResources() {
     }
     this->writer_connection_ = nullptr;
     this->writer_host_info_ = HostInfo{};
+    // The host list provider is released with the connection
+    this->topology_subscription_.reset();
 
     this->next_plugin->ReleaseResources();
 }
 
-SQLRETURN AbstractReadWriteSplittingPlugin::Execute(SQLHSTMT StatementHandle, SQLTCHAR *StatementText, SQLINTEGER TextLength) {
+SQLRETURN AbstractReadWriteSplittingPlugin::Connect(
+    SQLHDBC        ConnectionHandle,
+    SQLHWND        WindowHandle,
+    SQLTCHAR *     OutConnectionString,
+    SQLSMALLINT    BufferLength,
+    SQLSMALLINT *  StringLengthPtr,
+    SQLUSMALLINT   DriverCompletion)
+{
+    TrackPluginHead(ConnectionHandle);
+    return next_plugin->Connect(ConnectionHandle, WindowHandle, OutConnectionString, BufferLength, StringLengthPtr, DriverCompletion);
+}
+
+void AbstractReadWriteSplittingPlugin::TrackPluginHead(const SQLHDBC ConnectionHandle) {
+    // Internal connections have no chain of their own
+    if (!this->plugin_head_ && ConnectionHandle == dbc_) {
+        this->plugin_head_ = dbc_->plugin_head;
+    }
+}
+
+SQLRETURN AbstractReadWriteSplittingPlugin::Execute(SQLHSTMT StatementHandle, ExecutionContext &Context) {
     LOG(INFO) << "Entering Execute";
-    const std::string query = StatementText ? AS_UTF8_CSTR(StatementText) : "";
+    const std::string& query = Context.GetQuery();
     std::optional<bool> read_only;
     HostInfo curr_host;
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
-        read_only = SqlQueryAnalyzer::DoesSetReadOnly(query, service->GetDialect());
+        read_only = Context.GetClassification(service->GetDialect()).DoesSetReadOnly();
         curr_host = service->GetCurrentHostInfo();
     }
+    {
+        // A statement setting the session read only or read write takes precedence over the access mode
+        const std::lock_guard<std::mutex> lock_guard(intent_lock_);
+        if (!read_only.has_value()) {
+            read_only = pending_read_only_;
+        }
+        pending_read_only_.reset();
+    }
 
     const STMT* stmt = static_cast<STMT*>(StatementHandle);
     const DBC* dbc = stmt->dbc;
@@ -102,19 +139,22 @@ SQLRETURN AbstractReadWriteSplittingPlugin::Execute(SQLHSTMT StatementHandle, SQ
     }
     this->current_connection_ = dbc->wrapped_dbc;
 
+    {
+        const std::lock_guard<std::recursive_mutex> lock_guard(lock_);
+        HandleTopologyEvents();
+    }
+
     SQLRETURN ret = SQL_SUCCESS;
     if (read_only.has_value()) {
-        {
-            const std::lock_guard<std::recursive_mutex> lock_guard(lock_);
-            ret = SwitchConnectionIfRequired(read_only.value(), curr_host);
-        }
+        const std::lock_guard<std::recursive_mutex> lock_guard(lock_);
+        ret = SwitchConnectionIfRequired(read_only.value(), curr_host);
     }
 
     if (!SQL_SUCCEEDED(ret)) {
         return ret;
     }
 
-    ret = next_plugin->Execute(StatementHandle, StatementText, TextLength);
+    ret = next_plugin->Execute(StatementHandle, Context);
 
     if (SQL_SUCCEEDED(ret)) {
         return ret;
@@ -138,6 +178,115 @@ SQLRETURN AbstractReadWriteSplittingPlugin::Execute(SQLHSTMT StatementHandle, SQ
     return ret;
 }
 
+void AbstractReadWriteSplittingPlugin::NotifyConnectAttr(
+    SQLHDBC        ConnectionHandle,
+    SQLINTEGER     Attribute,
+    SQLPOINTER     ValuePtr)
+{
+    if (Attribute == SQL_ATTR_ACCESS_MODE && ConnectionHandle == dbc_) {
+        const bool read_only = reinterpret_cast<SQLULEN>(ValuePtr) == SQL_MODE_READ_ONLY;
+        HostInfo current_host;
+        if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
+            current_host = service->GetCurrentHostInfo();
+        }
+        // Connecting now overlaps the reader's connect latency with the application's own work.
+        // Nothing is started before the plugin chain is known, the connect would have nothing to run.
+        const bool switch_expected = read_only && speculative_reader_enabled_ && plugin_head_
+            && current_host.GetHostRole() != READER && dbc_->transaction_status != TRANSACTION_OPEN;
+        const HostInfo reader_host = switch_expected ? GetSpeculativeReaderHost() : HostInfo{};
+
+        const std::lock_guard<std::mutex> lock_guard(intent_lock_);
+        pending_read_only_ = read_only;
+        if (!reader_host.GetHost().empty()) {
+            StartSpeculativeReader(reader_host);
+        }
+    }
+    BasePlugin::NotifyConnectAttr(ConnectionHandle, Attribute, ValuePtr);
+}
+
+// Caller holds intent_lock_
+void AbstractReadWriteSplittingPlugin::StartSpeculativeReader(const HostInfo& host) {
+    if (speculative_reader_.valid()) {
+        // Already connecting, or connected and waiting to be used
+        return;
+    }
+
+    LOG(INFO) << "Connecting to reader host '" << host.GetHost() << "' ahead of switching to it";
+    speculative_host_ = host;
+    speculative_reader_ = std::async(std::launch::async, [this, host] {
+        SQLRETURN ret = SQL_ERROR;
+        return OpenInternalConnection(host.GetHost(), ret);
+    }).share();
+}
+
+DBC* AbstractReadWriteSplittingPlugin::TakeSpeculativeReader(HostInfo& host) {
+    std::shared_future<DBC*> speculative_reader;
+    {
+        const std::lock_guard<std::mutex> lock_guard(intent_lock_);
+        speculative_reader = speculative_reader_;
+        host = speculative_host_;
+    }
+    if (!speculative_reader.valid()) {
+        return nullptr;
+    }
+    // Waited on without intent_lock_, a new one is only started once this one is taken
+    if (speculative_reader.wait_for(SPECULATIVE_READER_WAIT_MS) != std::future_status::ready) {
+        LOG(INFO) << "Still connecting to reader host '" << host.GetHost() << "' ahead of switching to it, opening a new connection instead";
+        return nullptr;
+    }
+    DBC* conn = speculative_reader.get();
+    {
+        const std::lock_guard<std::mutex> lock_guard(intent_lock_);
+        speculative_reader_ = std::shared_future<DBC*>();
+    }
+
+    if (conn == nullptr) {
+        LOG(INFO) << "Failed to connect to reader host '" << host.GetHost() << "' ahead of switching to it";
+        return nullptr;
+    }
+    if (odbc_helper_->IsClosed(conn)) {
+        DisconnectAndFreeDBC(conn);
+        return nullptr;
+    }
+    return conn;
+}
+
+void AbstractReadWriteSplittingPlugin::DiscardSpeculativeReader() {
+    std::shared_future<DBC*> speculative_reader;
+    {
+        const std::lock_guard<std::mutex> lock_guard(intent_lock_);
+        speculative_reader = std::exchange(speculative_reader_, std::shared_future<DBC*>());
+    }
+    if (!speculative_reader.valid()) {
+        return;
+    }
+    if (DBC* conn = speculative_reader.get()) {
+        DisconnectAndFreeDBC(conn);
+    }
+}
+
+DBC* AbstractReadWriteSplittingPlugin::OpenInternalConnection(const std::string& host, SQLRETURN& ret) {
+    SQLHDBC local_hdbc = SQL_NULL_HDBC;
+    this->odbc_helper_->AllocDbc(henv_, local_hdbc);
+    DBC* conn = static_cast<DBC*>(local_hdbc);
+    conn->conn_attr = connection_attributes_;
+    conn->conn_attr.insert_or_assign(KEY_SERVER, host);
+    conn->conn_attr.insert_or_assign(KEY_SRW_SKIP, VALUE_BOOL_TRUE); // Skip the simple read/write splitting plugin.
+    conn->plugin_service = dbc_->plugin_service;
+    conn->internal_reconnect = true;
+    ret = plugin_head_->Connect(local_hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
+    if (!SQL_SUCCEEDED(ret)) {
+        odbc_helper_->DisconnectAndFree(&local_hdbc);
+        return nullptr;
+    }
+    conn->conn_attr.erase(KEY_SRW_SKIP);
+    {
+        const std::lock_guard<std::recursive_mutex> lock_guard(dbc_->env->lock);
+        dbc_->env->dbc_list.remove(conn);
+    }
+    return conn;
+}
+
 void AbstractReadWriteSplittingPlugin::UpdateInternalConnectionInfo() {
     HostInfo current_host;
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
@@ -158,6 +307,8 @@ void AbstractReadWriteSplittingPlugin::UpdateInternalConnectionInfo() {
     DBC* dbc = new DBC();
     dbc->env = dbc_->env;
     dbc->wrapped_dbc = dbc_->wrapped_dbc;
+    dbc->last_activity = dbc_->last_activity.load();
+    dbc->validation_freshness = dbc_->validation_freshness;
     {
         const std::lock_guard<std::recursive_mutex> lock_guard(dbc_->env->lock);
         dbc_->env->dbc_list.emplace_back(dbc);
@@ -295,16 +446,18 @@ void AbstractReadWriteSplittingPlugin::SwitchCurrentConnectionTo(DBC* new_conn,
             }
         }
 
-        // Free the current underlying connection. If reader_cache_item_ or writer_connection_ had the same underlying
-        // connection, delete them.
+        // Release the current underlying connection to the pool, or free it if pooling is disabled.
+        // If reader_cache_item_ or writer_connection_ had the same underlying connection, delete them.
         DBC* reader_conn = GetCurrentReaderConn();
         DBC* writer_conn = writer_connection_;
-        const ENV* env = dbc_->env;
         if (const SQLHDBC old_wrapped = dbc_->wrapped_dbc) {
-            const RdsLibResult disconnect_res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDisconnect, RDS_STR_SQLDisconnect, old_wrapped);
-            if (SQL_SUCCEEDED(disconnect_res.fn_result)) {
-                NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLFreeHandle, RDS_STR_SQLFreeHandle, SQL_HANDLE_DBC, old_wrapped);
+            // What the outgoing connection has applied of the session state stays with it
+            if (writer_conn && writer_conn->wrapped_dbc == old_wrapped) {
+                writer_conn->session_state.RestoreApplied(dbc_->session_state.TakeApplied());
+            } else if (reader_conn && reader_conn->wrapped_dbc == old_wrapped) {
+                reader_conn->session_state.RestoreApplied(dbc_->session_state.TakeApplied());
             }
+            ReleaseUnderlyingConnection(old_wrapped);
             dbc_->wrapped_dbc = nullptr;
 
             if (writer_conn && writer_conn->wrapped_dbc == old_wrapped) {
@@ -330,12 +483,40 @@ void AbstractReadWriteSplittingPlugin::SwitchCurrentConnectionTo(DBC* new_conn,
 
     this->current_connection_ = new_conn_wrapped;
     this->dbc_->wrapped_dbc = new_conn_wrapped;
+    this->dbc_->connection_generation++;
+    this->dbc_->pool_key = new_conn->pool_key;
+    this->dbc_->last_activity = new_conn->last_activity.load();
+    // Only the session state the new connection is missing is replayed, what it has applied is kept
+    // with the connection since it was opened or last current
+    this->dbc_->session_state.RestoreApplied(new_conn->session_state.TakeApplied());
+    SessionStateTracker::Sync(this->dbc_);
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
         service->SetCurrentHostInfo(new_host);
     }
     LOG(INFO) << "Switched underlying connection.";
 }
 
+void AbstractReadWriteSplittingPlugin::ReleaseUnderlyingConnection(SQLHDBC wrapped_dbc) {
+    const ConnectionPoolConfig pool_config = ConnectionPoolConfig::FromConnAttr(dbc_->conn_attr);
+    const std::shared_ptr<PluginService> service = plugin_service_.lock();
+    if (!pool_config.enabled || !service || dbc_->pool_key.empty()) {
+        const ENV* env = dbc_->env;
+        const RdsLibResult disconnect_res = NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLDisconnect, RDS_STR_SQLDisconnect, wrapped_dbc);
+        if (SQL_SUCCEEDED(disconnect_res.fn_result)) {
+            NULL_CHECK_CALL_LIB_FUNC(env->driver_lib_loader, RDS_FP_SQLFreeHandle, RDS_STR_SQLFreeHandle, SQL_HANDLE_DBC, wrapped_dbc);
+        }
+        return;
+    }
+
+    // Keyed by the connection attributes it was opened with, see DefaultPlugin::Connect
+    if (PluginService::GetConnectionPool()->Return(
+        dbc_->pool_key, wrapped_dbc, dbc_->env, odbc_helper_, pool_config, service->GetDialect()->GetResetSessionQuery(),
+        service->GetHostListProvider()))
+    {
+        LOG(INFO) << "Returned the connection to '" << service->GetCurrentHostInfo().GetHost() << "' to the pool.";
+    }
+}
+
 SQLRETURN AbstractReadWriteSplittingPlugin::SwitchToReaderConnection(const HostInfo &current_host) {
     if (current_host.GetHostRole() == READER && !odbc_helper_->IsClosed(dbc_)) {
         // Already connected to reader.
@@ -428,6 +609,47 @@ void AbstractReadWriteSplittingPlugin::CloseReaderIfExpired() {
     }
 }
 
+void AbstractReadWriteSplittingPlugin::HandleTopologyEvents() {
+    if (!topology_subscription_) {
+        const std::shared_ptr<PluginService> service = plugin_service_.lock();
+        const std::shared_ptr<HostListProvider> provider = service ? service->GetHostListProvider() : nullptr;
+        if (!provider) {
+            return;
+        }
+        topology_subscription_ = provider->Subscribe(nullptr);
+        if (!topology_subscription_) {
+            return;
+        }
+    }
+
+    TopologyEvent event;
+    while (topology_subscription_->Poll(event)) {
+        switch (event.type) {
+            case TopologyEvent::Type::WRITER_CHANGED:
+                if (writer_connection_ && !event.previous_host.GetHost().empty()
+                    && writer_host_info_.IsSameHost(event.previous_host)) {
+                    LOG(INFO) << "Writer changed from " << event.previous_host.GetHost() << " to " << event.host.GetHost();
+                    CloseWriterConnectionIfIdle();
+                }
+                break;
+            case TopologyEvent::Type::HOST_REMOVED:
+            case TopologyEvent::Type::HOST_STATE_CHANGED:
+                if (reader_cache_item_.value && reader_host_info_.IsSameHost(event.host)
+                    && (event.type == TopologyEvent::Type::HOST_REMOVED || !event.host.IsHostUp())) {
+                    LOG(INFO) << "Reader " << event.host.GetHost() << " is no longer available";
+                    CloseReaderConnectionIfIdle();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (topology_subscription_->TakeOverflow()) {
+        // Changes were missed, internal connections are reopened on demand
+        CloseIdleConnections();
+    }
+}
+
 DBC* AbstractReadWriteSplittingPlugin::GetCurrentReaderConn() {
     CloseReaderIfExpired();
     return reader_cache_item_.value;
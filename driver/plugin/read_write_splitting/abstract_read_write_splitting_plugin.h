@@ -15,21 +15,45 @@
 #ifndef ABSTRACT_READ_WRITE_SPLITTING_PLUGIN_H
 #define ABSTRACT_READ_WRITE_SPLITTING_PLUGIN_H
 
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <optional>
+
 #include "../../host_info.h"
 #include "../../util/odbc_helper.h"
 #include "../../util/sliding_cache_map.h"
 #include "../base_plugin.h"
 
+class TopologySubscription;
+
 class AbstractReadWriteSplittingPlugin : public BasePlugin {
 public:
+    // How long a switch waits for the reader connection started in the background before opening its own
+    static constexpr std::chrono::milliseconds SPECULATIVE_READER_WAIT_MS = std::chrono::milliseconds(1000);
+
     AbstractReadWriteSplittingPlugin(DBC* dbc);
     AbstractReadWriteSplittingPlugin(DBC* dbc, std::shared_ptr<BasePlugin> next_plugin);
     ~AbstractReadWriteSplittingPlugin();
 
+    SQLRETURN Connect(
+        SQLHDBC        ConnectionHandle,
+        SQLHWND        WindowHandle,
+        SQLTCHAR *     OutConnectionString,
+        SQLSMALLINT    BufferLength,
+        SQLSMALLINT *  StringLengthPtr,
+        SQLUSMALLINT   DriverCompletion) override;
+
     SQLRETURN Execute(
-        SQLHSTMT       StatementHandle,
-        SQLTCHAR *     StatementText = 0,
-        SQLINTEGER     TextLength = -1) override;
+        SQLHSTMT           StatementHandle,
+        ExecutionContext & Context) override;
+
+    // SQL_ATTR_ACCESS_MODE routes the next statement like a statement setting the session read only.
+    // Setting it to read only also starts connecting to a reader in the background.
+    void NotifyConnectAttr(
+        SQLHDBC        ConnectionHandle,
+        SQLINTEGER     Attribute,
+        SQLPOINTER     ValuePtr) override;
 
     void ReleaseResources() override;
 
@@ -43,6 +67,8 @@ public:
 
     void SwitchCurrentConnectionTo(DBC *new_conn, const HostInfo &new_host);
 
+    void ReleaseUnderlyingConnection(SQLHDBC wrapped_dbc);
+
     SQLRETURN SwitchToWriterConnection(const HostInfo &current_host);
 
     SQLRETURN SwitchToReaderConnection(const HostInfo &current_host);
@@ -60,6 +86,9 @@ public:
 
     void CloseReaderIfExpired();
 
+    // Closes idle connections to a demoted writer or to a reader that left the cluster
+    void HandleTopologyEvents();
+
     DBC *GetCurrentReaderConn();
 
     void SetStmtError(const std::string &msg, SQL_STATE_CODE state);
@@ -76,7 +105,21 @@ public:
 
     virtual SQLRETURN InitializeReaderConnection() = 0;
 
+    // The reader to connect to ahead of a switch, an empty host if there is none
+    virtual HostInfo GetSpeculativeReaderHost() { return HostInfo{}; }
+
+    // Opens one of this connection's internal connections to the host through the plugin chain.
+    // Returns nullptr if it could not connect, ret holds the result of the connect.
+    DBC* OpenInternalConnection(const std::string& host, SQLRETURN& ret);
+
+    // Waits up to SPECULATIVE_READER_WAIT_MS for the reader connection started in the background.
+    // Returns nullptr if none was started, it failed or it is still connecting, otherwise the caller owns the connection.
+    DBC* TakeSpeculativeReader(HostInfo& host);
+
 protected:
+    // The chain is assigned to the DBC once all plugins are constructed, it is picked up on the first connect
+    void TrackPluginHead(SQLHDBC ConnectionHandle);
+
     std::shared_ptr<OdbcHelper> odbc_helper_;
     BasePlugin* plugin_head_ = nullptr;
     DBC* writer_connection_ = nullptr;
@@ -90,8 +133,21 @@ protected:
     DBC* dbc_ = nullptr;
 
 private:
+    void StartSpeculativeReader(const HostInfo& host);
+    void DiscardSpeculativeReader();
+
     const std::chrono::milliseconds default_keep_alive_timeout_ = std::chrono::milliseconds(0);
     std::recursive_mutex lock_;
+
+    // Guards the read only intent and the background reader connection, may be taken while holding lock_ but not the reverse
+    std::mutex intent_lock_;
+    std::optional<bool> pending_read_only_;
+    bool speculative_reader_enabled_ = true;
+    // Guarded by lock_, taken on the first statement
+    std::shared_ptr<TopologySubscription> topology_subscription_;
+    // Still connecting or waiting to be used, a reader still connecting when it is needed is left for a later switch
+    std::shared_future<DBC*> speculative_reader_;
+    HostInfo speculative_host_;
 };
 
 #endif // ABSTRACT_READ_WRITE_SPLITTING_PLUGIN_H
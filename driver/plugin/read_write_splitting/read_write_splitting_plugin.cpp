@@ -14,6 +14,8 @@
 
 #include "read_write_splitting_plugin.h"
 
+#include <algorithm>
+
 #include "../../host_selector/highest_weight_host_selector.h"
 #include "../../host_selector/random_host_selector.h"
 #include "../../host_selector/round_robin_host_selector.h"
@@ -28,16 +30,22 @@ ReadWriteSplittingPlugin::ReadWriteSplittingPlugin(DBC *dbc, std::shared_ptr<Bas
 
 std::shared_ptr<HostSelector> ReadWriteSplittingPlugin::InitRwHostSelector(
     const std::map<std::string, std::string>& conn_info) {
+    std::shared_ptr<HostSelector> host_selector;
     switch (HostSelector::GetHostSelectorStrategy(MapUtils::GetStringValue(conn_info, KEY_RW_HOST_SELECTOR_STRATEGY, VALUE_RANDOM_HOST_SELECTOR))) {
         case ROUND_ROBIN:
-            return std::make_shared<RoundRobinHostSelector>();
+            host_selector = std::make_shared<RoundRobinHostSelector>();
+            break;
         case HIGHEST_WEIGHT:
-            return std::make_shared<HighestWeightHostSelector>();
+            host_selector = std::make_shared<HighestWeightHostSelector>();
+            break;
         case RANDOM_HOST:
         case UNKNOWN_STRATEGY:
         default:
-            return std::make_shared<RandomHostSelector>();
+            host_selector = std::make_shared<RandomHostSelector>();
+            break;
     }
+    host_selector->SetMaxReplicaLag(MapUtils::GetMillisecondsValue(conn_info, KEY_MAX_REPLICA_LAG, std::chrono::milliseconds(0)));
+    return host_selector;
 }
 
 SQLRETURN ReadWriteSplittingPlugin::RefreshAndStoreTopology() {
@@ -46,57 +54,46 @@ SQLRETURN ReadWriteSplittingPlugin::RefreshAndStoreTopology() {
             service->RefreshHosts();
         }
 
-        this->hosts_ = service->GetHosts();
-        if (this->hosts_.empty()) {
+        this->topology_ = service->GetTopologySnapshot();
+        if (this->topology_->hosts.empty()) {
             service->ForceRefreshHosts(false, DEFAULT_TOPOLOGY_REFRESH_TIMEOUT_MS);
-            this->hosts_ = service->GetHosts();
+            this->topology_ = service->GetTopologySnapshot();
         }
-        if (this->hosts_.empty() && !odbc_helper_->IsClosed(dbc_)) {
+        if (this->topology_->hosts.empty() && !odbc_helper_->IsClosed(dbc_)) {
             const std::vector<HostInfo> hosts = service->GetTopologyUtil()->QueryTopology(
                 dbc_, service->GetInitialHostInfo(), service->GetTemplateHostInfo());
             if (!hosts.empty()) {
                 service->SetHosts(hosts);
-                this->hosts_ = hosts;
+                this->topology_ = service->GetTopologySnapshot();
             }
         }
-        if (this->hosts_.empty()) {
+        if (this->topology_->hosts.empty()) {
             SetStmtError("Host list is empty.", ERR_RW_SWITCH_FAILED);
             return SQL_ERROR;
         }
-        this->writer_host_info_ = service->GetTopologyUtil()->GetWriter(this->hosts_);
+        this->writer_host_info_ = service->GetTopologyUtil()->GetWriter(this->topology_->hosts);
     }
 
     return SQL_SUCCESS;
 }
 
 SQLRETURN ReadWriteSplittingPlugin::InitializeWriterConnection() {
-    SQLHDBC local_hdbc;
-    // Open a new connection
-    this->odbc_helper_->AllocDbc(henv_, local_hdbc);
-    DBC *conn = static_cast<DBC*>(local_hdbc);
-    conn->conn_attr = connection_attributes_;
     const std::unordered_map<std::string, std::string> properties;
-    std::vector<HostInfo> hosts;
+    std::shared_ptr<const TopologySnapshot> topology = PluginService::EMPTY_TOPOLOGY;
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
-        hosts = service->GetHosts();
-        if (hosts.empty()) {
+        topology = service->GetTopologySnapshot();
+        if (topology->hosts.empty()) {
             service->ForceRefreshHosts(false, std::chrono::milliseconds(0));
-            hosts = service->GetHosts();
+            topology = service->GetTopologySnapshot();
         }
     }
-    const HostInfo host_info = this->host_selector_->GetHost(hosts, true, properties);
-    conn->conn_attr.insert_or_assign(KEY_SERVER, host_info.GetHost());
-    conn->plugin_service = dbc_->plugin_service;
-    const SQLRETURN ret = plugin_head_->Connect(local_hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
-    if (!SQL_SUCCEEDED(ret)) {
-        odbc_helper_->DisconnectAndFree(&local_hdbc);
+    const HostInfo host_info = this->host_selector_->GetHost(topology->hosts, true, properties);
+    SQLRETURN ret = SQL_ERROR;
+    DBC* conn = OpenInternalConnection(host_info.GetHost(), ret);
+    if (conn == nullptr) {
         SetStmtError("The plugin was unable to establish a writer connection.", ERR_RW_WRITER_SWITCH_FAILED);
         return ret;
     }
-    {
-        const std::lock_guard<std::recursive_mutex> lock_guard(dbc_->env->lock);
-        dbc_->env->dbc_list.remove(conn);
-    }
 
     SetWriterConnection(conn, host_info);
     SwitchCurrentConnectionTo(conn, host_info);
@@ -104,7 +101,7 @@ SQLRETURN ReadWriteSplittingPlugin::InitializeWriterConnection() {
 }
 
 SQLRETURN ReadWriteSplittingPlugin::InitializeReaderConnection() {
-    if (this->hosts_.size() == 1) {
+    if (this->topology_ && this->topology_->hosts.size() == 1) {
         LOG(WARNING) << "A reader instance was requested, but there are no readers in the host list. The current writer will be used as a fallback: '" << writer_host_info_.GetHost() << "'";
         if (this->writer_connection_ && odbc_helper_->IsClosed(this->writer_connection_)) {
             return InitializeWriterConnection();
@@ -118,37 +115,50 @@ SQLRETURN ReadWriteSplittingPlugin::InitializeReaderConnection() {
 
 SQLRETURN ReadWriteSplittingPlugin::OpenNewReaderConnection() {
     DBC* conn = nullptr;
-    std::vector<HostInfo> host_candidates;
+    std::shared_ptr<const TopologySnapshot> topology = PluginService::EMPTY_TOPOLOGY;
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
-        host_candidates = service->GetHosts();
-        if (host_candidates.empty()) {
+        topology = service->GetTopologySnapshot();
+        if (topology->hosts.empty()) {
             service->ForceRefreshHosts(false, std::chrono::milliseconds(0));
-            host_candidates = service->GetHosts();
+            topology = service->GetTopologySnapshot();
         }
     }
+    const std::vector<HostInfo>& host_candidates = topology->hosts;
     const size_t conn_attempts = host_candidates.size() * 2;
     const std::unordered_map<std::string, std::string> properties;
     SQLRETURN ret = SQL_ERROR;
     HostInfo host_info;
 
+    // Use the reader connected to in the background if it is still a reader
+    if (DBC* speculative_conn = TakeSpeculativeReader(host_info)) {
+        if (std::ranges::any_of(host_candidates, [&host_info](const HostInfo& host) {
+            return host.GetHost() == host_info.GetHost() && !host.IsHostWriter();
+        })) {
+            LOG(INFO) << "Using the reader connection opened ahead of the switch: '" << host_info.GetHost() << "'";
+            SetReaderConnection(speculative_conn, host_info);
+            SwitchCurrentConnectionTo(speculative_conn, host_info);
+            return SQL_SUCCESS;
+        }
+        DisconnectAndFreeDBC(speculative_conn);
+    }
+
+    // With pooling and no keep-alive timeout, go back to the previous reader first so its idle connection is reused
+    const bool prefer_previous_reader = !reader_host_info_.GetHost().empty()
+        && GetKeepAliveTimeout().second == std::chrono::milliseconds(0)
+        && ConnectionPoolConfig::FromConnAttr(connection_attributes_).enabled
+        && std::ranges::any_of(host_candidates, [this](const HostInfo& host) {
+            // Not once it lags behind the writer
+            return host.GetHost() == reader_host_info_.GetHost() && this->host_selector_->IsWithinReplicaLag(host);
+        });
+
     for (int i = 0; i < conn_attempts; i++) {
-        host_info = this->host_selector_->GetHost(host_candidates, false, properties);
-        SQLHDBC local_hdbc = SQL_NULL_HANDLE;
-        // Open a new connection
-        this->odbc_helper_->AllocDbc(henv_, local_hdbc);
-        conn = static_cast<DBC*>(local_hdbc);
-        conn->conn_attr = connection_attributes_;
-        conn->conn_attr.insert_or_assign(KEY_SERVER, host_info.GetHost());
-        conn->plugin_service = dbc_->plugin_service;
-        ret = plugin_head_->Connect(local_hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
-        if (!SQL_SUCCEEDED(ret)) {
+        host_info = (i == 0 && prefer_previous_reader)
+            ? reader_host_info_
+            : this->host_selector_->GetHost(host_candidates, false, properties);
+        conn = OpenInternalConnection(host_info.GetHost(), ret);
+        if (conn == nullptr) {
             LOG(INFO) << "Failed to connect to reader host: '" << host_info.GetHost() << "'";
-            odbc_helper_->DisconnectAndFree(&local_hdbc);
         } else {
-            {
-                const std::lock_guard<std::recursive_mutex> lock_guard(dbc_->env->lock);
-                dbc_->env->dbc_list.remove(conn);
-            }
             break;
         }
     }
@@ -164,6 +174,24 @@ SQLRETURN ReadWriteSplittingPlugin::OpenNewReaderConnection() {
     return ret;
 }
 
+HostInfo ReadWriteSplittingPlugin::GetSpeculativeReaderHost() {
+    std::shared_ptr<const TopologySnapshot> topology = PluginService::EMPTY_TOPOLOGY;
+    if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
+        topology = service->GetTopologySnapshot();
+    }
+    const std::vector<HostInfo>& hosts = topology->hosts;
+    // With only a writer there is nothing to switch to
+    if (std::ranges::none_of(hosts, [](const HostInfo& host) { return host.IsHostUp() && !host.IsHostWriter(); })) {
+        return HostInfo{};
+    }
+    try {
+        return this->host_selector_->GetHost(hosts, false, {});
+    } catch (const std::exception& ex) {
+        LOG(WARNING) << "Unable to select a reader to connect to ahead of switching: " << ex.what();
+        return HostInfo{};
+    }
+}
+
 void ReadWriteSplittingPlugin::CloseReaderIfNecessary() {
     if (!reader_host_info_.GetHost().empty()) {
         CloseReaderConnectionIfIdle();
@@ -16,6 +16,7 @@
 #define READ_WRITE_SPLITTING_PLUGIN_H
 
 #include "../../host_selector/host_selector.h"
+#include "../../util/plugin_service.h"
 #include "abstract_read_write_splitting_plugin.h"
 
 class ReadWriteSplittingPlugin : public AbstractReadWriteSplittingPlugin {
@@ -29,13 +30,14 @@ public:
     bool ShouldUpdateReaderConnection(const HostInfo &current_host) override;
     SQLRETURN RefreshAndStoreTopology() override;
     void CloseReaderIfNecessary() override;
+    HostInfo GetSpeculativeReaderHost() override;
     SQLRETURN OpenNewReaderConnection();
 
     static std::shared_ptr<HostSelector> InitRwHostSelector(
         const std::map<std::string, std::string>& conn_info);
 
 private:
-    std::vector<HostInfo> hosts_;
+    std::shared_ptr<const TopologySnapshot> topology_;
     std::shared_ptr<HostSelector> host_selector_;
 
     static inline const std::chrono::milliseconds DEFAULT_TOPOLOGY_REFRESH_TIMEOUT_MS = std::chrono::milliseconds(30000);
@@ -46,6 +46,7 @@ SQLRETURN SimpleReadWriteSplittingPlugin::Connect(
         SQLSMALLINT    BufferLength,
         SQLSMALLINT *  StringLengthPtr,
         SQLUSMALLINT   DriverCompletion) {
+    TrackPluginHead(ConnectionHandle);
     DBC* dbc = static_cast<DBC*>(ConnectionHandle);
 
     const bool skip_plugin = MapUtils::GetBooleanValue(dbc->conn_attr, KEY_SRW_SKIP, false);
@@ -118,6 +119,7 @@ SQLRETURN SimpleReadWriteSplittingPlugin::GetVerifiedConnection(
             conn->conn_attr.insert_or_assign(KEY_SRW_SKIP, VALUE_BOOL_TRUE); // Skip this plugin.
             conn->conn_attr.insert_or_assign(KEY_SERVER, host);
             conn->plugin_service = dbc_->plugin_service;
+            conn->internal_reconnect = true;
             ret = plugin_head_->Connect(local_hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
             if (SQL_SUCCEEDED(ret)) {
                 conn->conn_attr.erase(KEY_SRW_SKIP);
@@ -173,29 +175,17 @@ SQLRETURN SimpleReadWriteSplittingPlugin::InitializeReaderConnection() {
     }
 
     DBC* conn = SQL_NULL_HDBC;
-    SQLHDBC local_hdbc = SQL_NULL_HDBC;
     SQLRETURN ret = SQL_ERROR;
 
-    if (this->verify_new_conns_) {
+    HostInfo speculative_host;
+    if (DBC* speculative_conn = TakeSpeculativeReader(speculative_host)) {
+        LOG(INFO) << "Using the reader connection opened ahead of the switch: '" << this->read_endpoint << "'";
+        conn = speculative_conn;
+        ret = SQL_SUCCESS;
+    } else if (this->verify_new_conns_) {
         ret = GetVerifiedConnection(this->read_endpoint, READER, nullptr, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT, conn);
     } else {
-        this->odbc_helper_->AllocDbc(henv_, local_hdbc);
-        conn = static_cast<DBC*>(local_hdbc);
-        conn->conn_attr = connection_attributes_;
-        conn->conn_attr.insert_or_assign(KEY_SERVER, this->read_endpoint);
-        conn->conn_attr.insert_or_assign(KEY_SRW_SKIP, VALUE_BOOL_TRUE); // Skip this plugin.
-        conn->plugin_service = dbc_->plugin_service;
-        ret = plugin_head_->Connect(local_hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
-        if (!SQL_SUCCEEDED(ret)) {
-            odbc_helper_->DisconnectAndFree(&local_hdbc);
-            conn = SQL_NULL_HDBC;
-        } else {
-            {
-                const std::lock_guard<std::recursive_mutex> lock_guard(dbc_->env->lock);
-                dbc_->env->dbc_list.remove(conn);
-            }
-            conn->conn_attr.erase(KEY_SRW_SKIP);
-        }
+        conn = OpenInternalConnection(this->read_endpoint, ret);
     }
     if (conn == SQL_NULL_HDBC || !SQL_SUCCEEDED(ret)) {
         const std::string msg = "Failed to connect to reader host: '" + this->reader_host_info_.GetHostPortPair() + "', staying on current connection as fallback.";
@@ -220,29 +210,12 @@ SQLRETURN SimpleReadWriteSplittingPlugin::InitializeWriterConnection() {
     }
 
     DBC* conn = SQL_NULL_HDBC;
-    SQLHDBC local_hdbc = SQL_NULL_HDBC;
     SQLRETURN ret = SQL_ERROR;
 
     if (this->verify_new_conns_) {
         ret = GetVerifiedConnection(this->write_endpoint, WRITER, nullptr, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT, conn);
     } else {
-        this->odbc_helper_->AllocDbc(henv_, local_hdbc);
-        conn = static_cast<DBC*>(local_hdbc);
-        conn->conn_attr = connection_attributes_;
-        conn->conn_attr.insert_or_assign(KEY_SERVER, this->write_endpoint);
-        conn->conn_attr.insert_or_assign(KEY_SRW_SKIP, VALUE_BOOL_TRUE); // Skip this plugin.
-        conn->plugin_service = dbc_->plugin_service;
-        ret = plugin_head_->Connect(local_hdbc, nullptr, nullptr, 0, nullptr, SQL_DRIVER_NOPROMPT);
-        if (!SQL_SUCCEEDED(ret)) {
-            odbc_helper_->DisconnectAndFree(&local_hdbc);
-            conn = SQL_NULL_HDBC;
-        } else {
-            conn->conn_attr.erase(KEY_SRW_SKIP);
-            {
-                const std::lock_guard<std::recursive_mutex> lock_guard(dbc_->env->lock);
-                dbc_->env->dbc_list.remove(conn);
-            }
-        }
+        conn = OpenInternalConnection(this->write_endpoint, ret);
     }
 
     if (conn == SQL_NULL_HDBC || !SQL_SUCCEEDED(ret)) {
@@ -273,6 +246,14 @@ void SimpleReadWriteSplittingPlugin::CloseReaderIfNecessary() {
     // Simple Read/Write will connect to the reader endpoint regardless.
 }
 
+HostInfo SimpleReadWriteSplittingPlugin::GetSpeculativeReaderHost() {
+    // Verified connections are retried until they have the reader role, that is left to the switch itself
+    if (this->verify_new_conns_) {
+        return HostInfo{};
+    }
+    return CreateHostInfo(this->read_endpoint, READER);
+}
+
 bool SimpleReadWriteSplittingPlugin::ShouldUpdateReaderConnection(const HostInfo &current_host) {
     const DBC* cached_reader_conn = GetCurrentReaderConn();
     if (const std::shared_ptr<PluginService> service = plugin_service_.lock()) {
@@ -41,6 +41,7 @@ public:
     SQLRETURN InitializeWriterConnection() override;
     SQLRETURN RefreshAndStoreTopology() override;
     void CloseReaderIfNecessary() override;
+    HostInfo GetSpeculativeReaderHost() override;
     bool ShouldUpdateWriterConnection(const HostInfo &current_host) override;
     bool ShouldUpdateReaderConnection(const HostInfo &current_host) override;
     void SetInitialConnectionHostInfo(SQLHDBC conn, std::string host);
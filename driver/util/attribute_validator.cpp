@@ -31,7 +31,10 @@ bool AttributeValidator::ShouldKeyBeUnsignedInt(const std::string& key) {
         KEY_IGNORE_TOPOLOGY_REQUEST,
         KEY_HIGH_REFRESH_RATE,
         KEY_REFRESH_RATE,
+        KEY_MIN_REFRESH_RATE,
+        KEY_MAX_REFRESH_RATE,
         KEY_FAILOVER_TIMEOUT,
+        KEY_MAX_REPLICA_LAG,
         KEY_LIMITLESS_MONITOR_INTERVAL_MS,
         KEY_ROUTER_MAX_RETRIES,
         KEY_LIMITLESS_MAX_RETRIES,
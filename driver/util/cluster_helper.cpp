@@ -28,40 +28,24 @@
 #include "../odbcapi.h"
 #include "rds_strings.h"
 
+#include "monitoring_query_session.h"
 #include "rds_lib_loader.h"
 
 std::string GetNodeId(SQLHDBC hdbc, const std::shared_ptr<Dialect>& dialect, const std::shared_ptr<OdbcHelper> &odbc_helper) {
-    const std::string node_id_query = dialect->GetNodeIdQuery();
-
-    SQLHSTMT stmt = SQL_NULL_HANDLE;
-    SQLTCHAR node_id[MAX_HOST_SIZE * 2] = {};
-    SQLLEN rt = 0;
-    RdsLibResult res;
-    const DBC* dbc = static_cast<DBC*>(hdbc);
+    DBC* dbc = static_cast<DBC*>(hdbc);
 
     if (!dbc || !dbc->wrapped_dbc || dbc->conn_status != CONN_CONNECTED) {
         return "";
     }
 
-    res = NULL_CHECK_CALL_LIB_FUNC(dbc->env->driver_lib_loader, RDS_FP_SQLAllocHandle, RDS_STR_SQLAllocHandle,
-        SQL_HANDLE_STMT, dbc->wrapped_dbc, &stmt
-    );
-
-    if (SQL_SUCCEEDED(res.fn_result)) {
-        odbc_helper->ExecDirect(&stmt, node_id_query);
-
-        NULL_CHECK_CALL_LIB_FUNC(dbc->env->driver_lib_loader, RDS_FP_SQLBindCol, RDS_STR_SQLBindCol,
-            stmt, 1, SQL_C_TCHAR, &node_id, MAX_HOST_SIZE, &rt
-        );
-
-        NULL_CHECK_CALL_LIB_FUNC(dbc->env->driver_lib_loader, RDS_FP_SQLFetch, RDS_STR_SQLFetch,
-            stmt
-        );
-
-        NULL_CHECK_CALL_LIB_FUNC(dbc->env->driver_lib_loader, RDS_FP_SQLFreeHandle, RDS_STR_SQLFreeHandle,
-            SQL_HANDLE_STMT, stmt
-        );
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(dbc, odbc_helper);
+    MonitoringQuerySession::Query* query = session->Execute(dialect->GetNodeIdQuery());
+    SQLTCHAR* node_id = query ?
+        static_cast<SQLTCHAR*>(query->BindCol(1, SQL_C_TCHAR, MAX_HOST_SIZE, MAX_HOST_SIZE * 2 * sizeof(SQLTCHAR))) : nullptr;
+    if (!node_id) {
+        return "";
     }
+    query->Fetch();
 
 #if UNICODE
     Convert4To2ByteString(odbc_helper->GetUse4BytesBaseDriver(), node_id, nullptr, MAX_HOST_SIZE);
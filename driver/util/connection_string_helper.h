@@ -30,7 +30,12 @@ static std::unordered_set<std::string> const sensitive_key_set = {
 static std::unordered_set<std::string> const internal_wrapper_key_set = {
     KEY_RDS_TEST_CONN,
     KEY_MONITORING_CONN_UUID,
-    KEY_SRW_SKIP
+    KEY_SRW_SKIP,
+    KEY_ENABLE_CONNECTION_POOL,
+    KEY_POOL_MAX_IDLE_PER_HOST,
+    KEY_POOL_IDLE_TIMEOUT_MS,
+    KEY_ENABLE_SESSION_STATE_TRACKING,
+    KEY_VALIDATION_FRESHNESS_MS
 };
 
 static std::unordered_set<std::string> const aws_odbc_key_set = {
@@ -76,13 +81,27 @@ static std::unordered_set<std::string> const aws_odbc_key_set = {
     KEY_SSO_ALLOW_INTERACTIVE,
     KEY_DATABASE_DIALECT,
     KEY_HOST_SELECTOR_STRATEGY,
+    KEY_MAX_REPLICA_LAG,
     KEY_ENABLE_FAILOVER,
     KEY_FAILOVER_MODE,
     KEY_ENDPOINT_TEMPLATE,
     KEY_IGNORE_TOPOLOGY_REQUEST,
     KEY_HIGH_REFRESH_RATE,
     KEY_REFRESH_RATE,
+    KEY_MIN_REFRESH_RATE,
+    KEY_MAX_REFRESH_RATE,
     KEY_FAILOVER_TIMEOUT,
+    KEY_ENABLE_FAILOVER_STANDBY,
+    KEY_FAILOVER_STANDBY_COUNT,
+    KEY_FAILOVER_STANDBY_REFRESH,
+    KEY_ENABLE_PARALLEL_READER_FAILOVER,
+    KEY_READER_FAILOVER_STAGGER,
+    KEY_READER_FAILOVER_MAX_PARALLEL,
+    KEY_ENABLE_WRITER_FAILOVER_PROBING,
+    KEY_WRITER_FAILOVER_PROBE_INTERVAL,
+    KEY_PANIC_PROBE_CONCURRENCY,
+    KEY_TOPOLOGY_CACHE_DIR,
+    KEY_SHARED_TOPOLOGY_MONITORING,
     KEY_CLUSTER_ID,
     KEY_ENABLE_LIMITLESS,
     KEY_LIMITLESS_MODE,
@@ -100,6 +119,7 @@ static std::unordered_set<std::string> const aws_odbc_key_set = {
     KEY_ENABLE_RW_SPLIT,
     KEY_RW_HOST_SELECTOR_STRATEGY,
     KEY_CACHED_READER_KEEP_ALIVE_TIMEOUT_MS,
+    KEY_RW_SPECULATIVE_READER_CONNECT,
     KEY_ENABLE_SRW_SPLIT,
     KEY_SRW_VERIFY_CONNS,
     KEY_SRW_READ_ENDPOINT,
@@ -107,7 +127,12 @@ static std::unordered_set<std::string> const aws_odbc_key_set = {
     KEY_SRW_CONN_TIMEOUT_MS,
     KEY_SRW_CONN_INTERVAL_MS,
     KEY_SRW_VERIFY_INITIAL_CONN_TYPE,
-    KEY_SRW_SKIP
+    KEY_SRW_SKIP,
+    KEY_ENABLE_CONNECTION_POOL,
+    KEY_POOL_MAX_IDLE_PER_HOST,
+    KEY_POOL_IDLE_TIMEOUT_MS,
+    KEY_ENABLE_SESSION_STATE_TRACKING,
+    KEY_VALIDATION_FRESHNESS_MS
 };
 
 static std::unordered_map<std::string, std::string> const alias_to_real_map = {
@@ -108,6 +108,7 @@
 #define VALUE_HIGHEST_WEIGHT_HOST_SELECTOR "HIGHEST_WEIGHT"
 #define VALUE_RANDOM_HOST_SELECTOR "RANDOM_HOST"
 #define VALUE_ROUND_ROBIN_HOST_SELECTOR "ROUND_ROBIN"
+#define KEY_MAX_REPLICA_LAG "MAX_REPLICA_LAG_MS"
 
 /* Database Dialect */
 #define KEY_DATABASE_DIALECT "DATABASE_DIALECT"
@@ -127,7 +128,20 @@
 #define KEY_IGNORE_TOPOLOGY_REQUEST "IGNORE_TOPOLOGY_REQUEST_MS"
 #define KEY_HIGH_REFRESH_RATE "TOPOLOGY_HIGH_REFRESH_RATE_MS"
 #define KEY_REFRESH_RATE "TOPOLOGY_REFRESH_RATE_MS"
+#define KEY_MIN_REFRESH_RATE "TOPOLOGY_MIN_REFRESH_RATE_MS"
+#define KEY_MAX_REFRESH_RATE "TOPOLOGY_MAX_REFRESH_RATE_MS"
 #define KEY_FAILOVER_TIMEOUT "FAILOVER_TIMEOUT_MS"
+#define KEY_ENABLE_FAILOVER_STANDBY "ENABLE_FAILOVER_STANDBY_CONNECTIONS"
+#define KEY_FAILOVER_STANDBY_COUNT "FAILOVER_STANDBY_CONNECTION_COUNT"
+#define KEY_FAILOVER_STANDBY_REFRESH "FAILOVER_STANDBY_REFRESH_MS"
+#define KEY_ENABLE_PARALLEL_READER_FAILOVER "ENABLE_PARALLEL_READER_FAILOVER"
+#define KEY_READER_FAILOVER_STAGGER "READER_FAILOVER_STAGGER_MS"
+#define KEY_READER_FAILOVER_MAX_PARALLEL "READER_FAILOVER_MAX_PARALLEL"
+#define KEY_ENABLE_WRITER_FAILOVER_PROBING "ENABLE_WRITER_FAILOVER_PROBING"
+#define KEY_WRITER_FAILOVER_PROBE_INTERVAL "WRITER_FAILOVER_PROBE_INTERVAL_MS"
+#define KEY_PANIC_PROBE_CONCURRENCY "TOPOLOGY_PANIC_PROBE_CONCURRENCY"
+#define KEY_TOPOLOGY_CACHE_DIR "TOPOLOGY_CACHE_DIR"
+#define KEY_SHARED_TOPOLOGY_MONITORING "ENABLE_SHARED_TOPOLOGY_MONITORING"
 #define KEY_CLUSTER_ID "CLUSTER_ID"
 
 /* Limitless */
@@ -172,6 +186,7 @@
 #define KEY_ENABLE_RW_SPLIT "ENABLE_RW_SPLIT"
 #define KEY_RW_HOST_SELECTOR_STRATEGY "RW_HOST_SELECTOR_STRATEGY"
 #define KEY_CACHED_READER_KEEP_ALIVE_TIMEOUT_MS "CACHED_READER_KEEP_ALIVE_TIMEOUT_MS"
+#define KEY_RW_SPECULATIVE_READER_CONNECT "RW_SPECULATIVE_READER_CONNECT"
 #define KEY_ENABLE_SRW_SPLIT "ENABLE_SRW_SPLIT"
 #define KEY_SRW_VERIFY_CONNS "SRW_VERIFY_CONNS"
 #define KEY_SRW_READ_ENDPOINT "SRW_READ_ENDPOINT"
@@ -181,6 +196,17 @@
 #define KEY_SRW_VERIFY_INITIAL_CONN_TYPE "SRW_VERIFY_INITIAL_CONN_TYPE"
 #define KEY_SRW_SKIP "fe42ba35-34a6-4617-8beb-cc41e6999d43"
 
+/* Underlying Connection Pool */
+#define KEY_ENABLE_CONNECTION_POOL "ENABLE_UNDERLYING_CONNECTION_POOL"
+#define KEY_POOL_MAX_IDLE_PER_HOST "POOL_MAX_IDLE_PER_HOST"
+#define KEY_POOL_IDLE_TIMEOUT_MS "POOL_IDLE_TIMEOUT_MS"
+
+/* Session State */
+#define KEY_ENABLE_SESSION_STATE_TRACKING "ENABLE_SESSION_STATE_TRACKING"
+
+/* Connection Validation */
+#define KEY_VALIDATION_FRESHNESS_MS "VALIDATION_FRESHNESS_MS"
+
 /* Underlying Driver Possible Aliases */
 // UID
 #define ALIAS_KEY_USERNAME_1 "USER"
@@ -0,0 +1,139 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "monitoring_query_session.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "connection_string_keys.h"
+#include "logger_wrapper.h"
+#include "odbc_helper.h"
+
+MonitoringQuerySession::Query::Query(const std::shared_ptr<OdbcHelper>& odbc_helper, const SQLHSTMT stmt)
+    : odbc_helper_{ odbc_helper },
+      stmt_{ stmt } {}
+
+void* MonitoringQuerySession::Query::BindCol(const int column, const int type, const size_t size, const size_t buffer_size) {
+    if (const auto itr = columns_.find(column); itr != columns_.end()) {
+        return itr->second.buffer.data();
+    }
+
+    Column& bound = columns_[column];
+    bound.buffer.resize(std::max(size, buffer_size));
+    const RdsLibResult res = odbc_helper_->BindCol(&stmt_, column, type, bound.buffer.data(), size, &bound.len);
+    if (!SQL_SUCCEEDED(res.fn_result)) {
+        columns_.erase(column);
+        return nullptr;
+    }
+    return bound.buffer.data();
+}
+
+RdsLibResult MonitoringQuerySession::Query::Fetch() {
+    return odbc_helper_->Fetch(&stmt_);
+}
+
+SQLHSTMT MonitoringQuerySession::Query::GetStmt() const {
+    return stmt_;
+}
+
+MonitoringQuerySession::MonitoringQuerySession(
+    const std::shared_ptr<OdbcHelper>& odbc_helper, const SQLHDBC wrapped_dbc, const uint64_t connection_generation)
+    : odbc_helper_{ odbc_helper },
+      wrapped_dbc_{ wrapped_dbc },
+      connection_generation_{ connection_generation } {}
+
+std::shared_ptr<MonitoringQuerySession> MonitoringQuerySession::ForConnection(DBC* dbc, const std::shared_ptr<OdbcHelper>& odbc_helper) {
+    if (!dbc->conn_attr.contains(KEY_MONITORING_CONN_UUID)) {
+        return { new MonitoringQuerySession(odbc_helper, dbc->wrapped_dbc), [](MonitoringQuerySession* session) {
+            session->Close();
+            delete session;
+        } };
+    }
+
+    const std::lock_guard<std::recursive_mutex> lock_guard(dbc->lock);
+    // The statements of a replaced or reconnected underlying connection went with it
+    const uint64_t generation = dbc->connection_generation.load();
+    if (!dbc->monitoring_session || dbc->monitoring_session->GetConnectionGeneration() != generation) {
+        dbc->monitoring_session = std::make_shared<MonitoringQuerySession>(odbc_helper, dbc->wrapped_dbc, generation);
+    }
+    return dbc->monitoring_session;
+}
+
+void MonitoringQuerySession::Release(DBC* dbc) {
+    const std::lock_guard<std::recursive_mutex> lock_guard(dbc->lock);
+    if (dbc->monitoring_session) {
+        if (dbc->monitoring_session->GetConnectionGeneration() == dbc->connection_generation.load()) {
+            dbc->monitoring_session->Close();
+        }
+        dbc->monitoring_session.reset();
+    }
+}
+
+MonitoringQuerySession::Query* MonitoringQuerySession::Execute(const std::string& query) {
+    auto itr = queries_.find(query);
+    if (itr == queries_.end()) {
+        SQLHSTMT stmt = SQL_NULL_HSTMT;
+        if (!SQL_SUCCEEDED(odbc_helper_->BaseAllocStmt(&wrapped_dbc_, &stmt).fn_result)) {
+            return nullptr;
+        }
+        if (!SQL_SUCCEEDED(odbc_helper_->Prepare(&stmt, query).fn_result)) {
+            LOG(ERROR) << "Failed to prepare monitoring query: " << query;
+            odbc_helper_->BaseFreeStmt(&stmt);
+            return nullptr;
+        }
+        itr = queries_.emplace(query, std::unique_ptr<Query>(new Query(odbc_helper_, stmt))).first;
+    }
+
+    // At most one open result per connection, like statements freed after each use
+    for (auto& [other_query, other] : queries_) {
+        if (other->cursor_open_) {
+            odbc_helper_->CloseCursor(other->stmt_);
+            other->cursor_open_ = false;
+        }
+    }
+    Query& prepared = *itr->second;
+    // Columns of a result without rows read as empty, like freshly allocated buffers
+    for (auto& [column, bound] : prepared.columns_) {
+        std::ranges::fill(bound.buffer, 0);
+        bound.len = 0;
+    }
+    if (!SQL_SUCCEEDED(odbc_helper_->Execute(&prepared.stmt_).fn_result)) {
+        // Prepared again on the next run, the connection may have changed state
+        odbc_helper_->BaseFreeStmt(&prepared.stmt_);
+        queries_.erase(itr);
+        return nullptr;
+    }
+    prepared.cursor_open_ = true;
+    return &prepared;
+}
+
+void MonitoringQuerySession::Close() {
+    for (auto& [query, prepared] : queries_) {
+        odbc_helper_->BaseFreeStmt(&prepared->stmt_);
+    }
+    queries_.clear();
+}
+
+SQLHDBC MonitoringQuerySession::GetWrappedDbc() const {
+    return wrapped_dbc_;
+}
+
+uint64_t MonitoringQuerySession::GetConnectionGeneration() const {
+    return connection_generation_;
+}
+
+size_t MonitoringQuerySession::GetPreparedCount() const {
+    return queries_.size();
+}
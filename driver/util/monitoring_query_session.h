@@ -0,0 +1,91 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MONITORING_QUERY_SESSION_H_
+#define MONITORING_QUERY_SESSION_H_
+
+#ifdef WIN32
+    #include <windows.h>
+#endif
+
+#include <sql.h>
+#include <sqltypes.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../driver.h"
+#include "rds_lib_loader.h"
+
+class OdbcHelper;
+
+// Statements of a monitoring connection. Each query is prepared once on the underlying connection,
+// its result columns stay bound to buffers owned by the session and later runs only execute it again.
+// Like the connection itself, a session is used by one thread at a time.
+class MonitoringQuerySession {
+public:
+    class Query {
+    public:
+        // Buffer bound to the result column, bound on first use and cleared before each execution.
+        // The buffer holds buffer_size bytes, defaulting to the size bound, nullptr if binding failed.
+        void* BindCol(int column, int type, size_t size, size_t buffer_size = 0);
+        RdsLibResult Fetch();
+        SQLHSTMT GetStmt() const;
+
+    private:
+        friend class MonitoringQuerySession;
+        struct Column {
+            std::vector<uint8_t> buffer;
+            SQLLEN len = 0;
+        };
+
+        Query(const std::shared_ptr<OdbcHelper>& odbc_helper, SQLHSTMT stmt);
+
+        std::shared_ptr<OdbcHelper> odbc_helper_;
+        SQLHSTMT stmt_;
+        bool cursor_open_ = false;
+        // Nodes keep their addresses, the buffers stay where they were bound
+        std::map<int, Column> columns_;
+    };
+
+    MonitoringQuerySession(const std::shared_ptr<OdbcHelper>& odbc_helper, SQLHDBC wrapped_dbc, uint64_t connection_generation = 0);
+
+    // Session kept on a monitoring connection until it disconnects. Other connections get
+    // a session freeing its statements once released, so they do not keep statements open.
+    static std::shared_ptr<MonitoringQuerySession> ForConnection(DBC* dbc, const std::shared_ptr<OdbcHelper>& odbc_helper);
+    // Frees the session of the connection, called before its underlying connection is disconnected
+    static void Release(DBC* dbc);
+
+    // Prepares the query on first use and executes it, closing the result of the previous execution.
+    // Returns nullptr on failure.
+    Query* Execute(const std::string& query);
+    // Frees the statements, must be called while the underlying connection is open
+    void Close();
+    SQLHDBC GetWrappedDbc() const;
+    // Generation of the DBC's underlying connection the statements were prepared on
+    uint64_t GetConnectionGeneration() const;
+    size_t GetPreparedCount() const;
+
+private:
+    std::shared_ptr<OdbcHelper> odbc_helper_;
+    SQLHDBC wrapped_dbc_;
+    uint64_t connection_generation_;
+    std::unordered_map<std::string, std::unique_ptr<Query>> queries_;
+};
+
+#endif // MONITORING_QUERY_SESSION_H_
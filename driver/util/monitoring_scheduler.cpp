@@ -0,0 +1,249 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "monitoring_scheduler.h"
+
+#include <algorithm>
+
+#include "logger_wrapper.h"
+
+MonitoringScheduler::MonitoringScheduler(const size_t worker_count, const std::chrono::milliseconds tick_ms)
+    : worker_count_{ std::max<size_t>(worker_count, 1) },
+      tick_ms_{ std::max(tick_ms, std::chrono::milliseconds(1)) },
+      wheel_(WHEEL_SIZE) {}
+
+MonitoringScheduler::~MonitoringScheduler() {
+    {
+        const std::lock_guard<std::mutex> lock_guard(lock_);
+        stopping_ = true;
+    }
+    timer_cv_.notify_all();
+    work_cv_.notify_all();
+
+    const std::thread::id self = std::this_thread::get_id();
+    const auto stop_thread = [self](std::thread& thread) {
+        if (!thread.joinable()) {
+            return;
+        }
+        // The last reference may be released by a task running on the scheduler itself
+        if (thread.get_id() == self) {
+            thread.detach();
+        } else {
+            thread.join();
+        }
+    };
+    stop_thread(timer_thread_);
+    for (std::thread& worker : workers_) {
+        stop_thread(worker);
+    }
+}
+
+MonitoringScheduler::TaskId MonitoringScheduler::Schedule(Task task, const std::chrono::milliseconds delay_ms) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    if (workers_.empty()) {
+        StartThreads();
+    }
+
+    const TaskId id = next_id_++;
+    Entry& entry = tasks_[id];
+    entry.task = std::move(task);
+    ArmLocked(id, entry, delay_ms);
+    return id;
+}
+
+void MonitoringScheduler::Wake(const TaskId id) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    const auto itr = tasks_.find(id);
+    if (itr == tasks_.end() || itr->second.cancelled) {
+        return;
+    }
+
+    Entry& entry = itr->second;
+    switch (entry.state) {
+        case TaskState::WAITING:
+            // Its armed timer becomes stale
+            entry.generation++;
+            MakeReadyLocked(id, entry);
+            break;
+        case TaskState::RUNNING:
+            if (entry.runner != std::this_thread::get_id()) {
+                entry.wake_requested = true;
+            }
+            break;
+        case TaskState::READY:
+            break;
+    }
+}
+
+void MonitoringScheduler::Cancel(const TaskId id) {
+    Task to_destroy;
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        const auto itr = tasks_.find(id);
+        if (itr == tasks_.end()) {
+            return;
+        }
+
+        Entry& entry = itr->second;
+        entry.cancelled = true;
+        if (entry.state == TaskState::RUNNING) {
+            // The worker removes it once the run finishes
+            if (entry.runner != std::this_thread::get_id()) {
+                done_cv_.wait(lock, [this, id] { return !tasks_.contains(id); });
+            }
+            return;
+        }
+        // Waiting timers and ready queue entries are skipped once the task is gone
+        to_destroy = std::move(entry.task);
+        tasks_.erase(itr);
+    }
+    // Destroyed outside of the lock, the task may own objects that use the scheduler
+}
+
+bool MonitoringScheduler::IsScheduled(const TaskId id) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    const auto itr = tasks_.find(id);
+    return itr != tasks_.end() && !itr->second.cancelled;
+}
+
+size_t MonitoringScheduler::GetThreadCount() {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    return workers_.size() + (timer_thread_.joinable() ? 1 : 0);
+}
+
+void MonitoringScheduler::StartThreads() {
+    LOG(INFO) << "Starting monitoring scheduler with " << worker_count_ << " worker threads";
+    next_tick_ = std::chrono::steady_clock::now() + tick_ms_;
+    timer_thread_ = std::thread(&MonitoringScheduler::TimerLoop, this);
+    workers_.reserve(worker_count_);
+    for (size_t i = 0; i < worker_count_; i++) {
+        workers_.emplace_back(&MonitoringScheduler::WorkerLoop, this);
+    }
+}
+
+void MonitoringScheduler::ArmLocked(const TaskId id, Entry& entry, const std::chrono::milliseconds delay_ms) {
+    entry.generation++;
+    if (delay_ms <= std::chrono::milliseconds(0)) {
+        MakeReadyLocked(id, entry);
+        return;
+    }
+
+    entry.state = TaskState::WAITING;
+    // Rounded up, a task never runs before its delay has passed
+    const size_t ticks = static_cast<size_t>((delay_ms + tick_ms_ - std::chrono::milliseconds(1)) / tick_ms_);
+    if (armed_timers_ == 0) {
+        // The wheel stood still while empty
+        next_tick_ = std::chrono::steady_clock::now() + tick_ms_;
+    }
+    wheel_[(current_slot_ + ticks) % WHEEL_SIZE].push_back(Timer{ id, entry.generation, (ticks - 1) / WHEEL_SIZE });
+    if (armed_timers_++ == 0) {
+        timer_cv_.notify_one();
+    }
+}
+
+void MonitoringScheduler::MakeReadyLocked(const TaskId id, Entry& entry) {
+    entry.state = TaskState::READY;
+    ready_.push_back(id);
+    work_cv_.notify_one();
+}
+
+void MonitoringScheduler::AdvanceLocked() {
+    current_slot_ = (current_slot_ + 1) % WHEEL_SIZE;
+    std::list<Timer>& slot = wheel_[current_slot_];
+    for (auto itr = slot.begin(); itr != slot.end();) {
+        if (itr->rounds > 0) {
+            itr->rounds--;
+            ++itr;
+            continue;
+        }
+
+        const auto task_itr = tasks_.find(itr->id);
+        if (task_itr != tasks_.end() && !task_itr->second.cancelled
+            && task_itr->second.state == TaskState::WAITING
+            && task_itr->second.generation == itr->generation) {
+            MakeReadyLocked(itr->id, task_itr->second);
+        }
+        itr = slot.erase(itr);
+        armed_timers_--;
+    }
+}
+
+void MonitoringScheduler::TimerLoop() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (!stopping_) {
+        if (armed_timers_ == 0) {
+            timer_cv_.wait(lock, [this] { return stopping_ || armed_timers_ > 0; });
+            continue;
+        }
+
+        timer_cv_.wait_until(lock, next_tick_);
+        // Catches up on ticks missed while the thread was not scheduled
+        while (!stopping_ && armed_timers_ > 0 && std::chrono::steady_clock::now() >= next_tick_) {
+            AdvanceLocked();
+            next_tick_ += tick_ms_;
+        }
+    }
+}
+
+void MonitoringScheduler::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+        work_cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+        if (stopping_) {
+            return;
+        }
+
+        const TaskId id = ready_.front();
+        ready_.pop_front();
+        auto itr = tasks_.find(id);
+        if (itr == tasks_.end() || itr->second.state != TaskState::READY) {
+            // Cancelled while queued
+            continue;
+        }
+
+        Entry& entry = itr->second;
+        entry.state = TaskState::RUNNING;
+        entry.runner = std::this_thread::get_id();
+        entry.wake_requested = false;
+        Task task = entry.task;
+        lock.unlock();
+
+        std::optional<std::chrono::milliseconds> next_delay;
+        try {
+            next_delay = task();
+        } catch (const std::exception& ex) {
+            LOG(ERROR) << "Monitoring task encountered error and was stopped: " << ex.what();
+        }
+        task = nullptr;
+
+        lock.lock();
+        // A running task is only removed here
+        itr = tasks_.find(id);
+        if (itr->second.cancelled || !next_delay.has_value()) {
+            itr->second.cancelled = true;
+            Task to_destroy = std::move(itr->second.task);
+            // Destroyed outside of the lock, the task may own objects that use the scheduler.
+            // Still running until then, so Cancel returns only once the task is destroyed.
+            lock.unlock();
+            to_destroy = nullptr;
+            lock.lock();
+            tasks_.erase(id);
+            done_cv_.notify_all();
+            continue;
+        }
+        Entry& finished = itr->second;
+        finished.runner = std::thread::id();
+        ArmLocked(id, finished, finished.wake_requested ? std::chrono::milliseconds(0) : next_delay.value());
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MONITORING_SCHEDULER_H_
+#define MONITORING_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Process-wide scheduler running monitoring tasks on a small fixed pool of worker threads.
+// Delayed runs are kept in a hashed timer wheel advanced by a single timer thread,
+// so the number of threads does not grow with the number of monitored clusters.
+// Threads are started with the first scheduled task.
+class MonitoringScheduler {
+public:
+    using TaskId = uint64_t;
+    // Runs one iteration of a monitor, returning the delay until the next iteration or std::nullopt once finished.
+    // Tasks share the workers, a task waiting on another task should only wait for a bounded time.
+    using Task = std::function<std::optional<std::chrono::milliseconds>()>;
+
+    static constexpr size_t DEFAULT_WORKER_COUNT = 4;
+    static constexpr std::chrono::milliseconds DEFAULT_TICK_MS = std::chrono::milliseconds(10);
+    static constexpr size_t WHEEL_SIZE = 512;
+
+    explicit MonitoringScheduler(
+        size_t worker_count = DEFAULT_WORKER_COUNT,
+        std::chrono::milliseconds tick_ms = DEFAULT_TICK_MS);
+    ~MonitoringScheduler();
+
+    TaskId Schedule(Task task, std::chrono::milliseconds delay_ms = std::chrono::milliseconds(0));
+    // Runs a waiting task as soon as a worker is free. A task woken by another thread while
+    // it is running runs again right after, a task waking itself is expected to account for
+    // the change in the delay it returns.
+    void Wake(TaskId id);
+    // Stops scheduling the task, waiting for a run in progress on another thread to finish
+    // and for the task to be destroyed
+    void Cancel(TaskId id);
+    bool IsScheduled(TaskId id);
+
+    size_t GetThreadCount();
+
+private:
+    enum class TaskState {
+        WAITING,
+        READY,
+        RUNNING
+    };
+
+    struct Entry {
+        Task task;
+        TaskState state = TaskState::WAITING;
+        // Timers armed for an earlier generation are stale and dropped when they expire
+        uint64_t generation = 0;
+        bool wake_requested = false;
+        bool cancelled = false;
+        std::thread::id runner;
+    };
+
+    struct Timer {
+        TaskId id;
+        uint64_t generation;
+        // Full turns of the wheel left before the timer expires
+        size_t rounds;
+    };
+
+    void StartThreads();
+    // Caller must hold lock_
+    void ArmLocked(TaskId id, Entry& entry, std::chrono::milliseconds delay_ms);
+    void MakeReadyLocked(TaskId id, Entry& entry);
+    void AdvanceLocked();
+    void TimerLoop();
+    void WorkerLoop();
+
+    const size_t worker_count_;
+    const std::chrono::milliseconds tick_ms_;
+
+    std::mutex lock_;
+    std::condition_variable timer_cv_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    bool stopping_ = false;
+
+    std::unordered_map<TaskId, Entry> tasks_;
+    TaskId next_id_ = 1;
+    std::deque<TaskId> ready_;
+
+    std::vector<std::list<Timer>> wheel_;
+    size_t current_slot_ = 0;
+    size_t armed_timers_ = 0;
+    std::chrono::steady_clock::time_point next_tick_;
+
+    std::thread timer_thread_;
+    std::vector<std::thread> workers_;
+};
+
+#endif // MONITORING_SCHEDULER_H_
@@ -16,6 +16,7 @@
 
 #include "../odbcapi_rds_helper.h"
 
+#include "monitoring_query_session.h"
 #include "rds_lib_loader.h"
 #include "rds_strings.h"
 
@@ -29,6 +30,7 @@ OdbcHelper::OdbcHelper(const std::shared_ptr<RdsLibLoader> &lib_loader, const EN
 void OdbcHelper::Disconnect(DBC* dbc) {
     if (dbc) {
         const std::lock_guard<std::recursive_mutex> lock_guard(dbc->lock);
+        MonitoringQuerySession::Release(dbc);
         // Cleanup tracked underlying statements
         const std::list<STMT*> stmt_list = dbc->stmt_list;
         for (STMT* stmt : stmt_list) {
@@ -61,6 +63,8 @@ void OdbcHelper::Disconnect(DBC* dbc) {
                     dbc->wrapped_dbc
                 );
                 dbc->wrapped_dbc = SQL_NULL_HDBC;
+                dbc->connection_generation++;
+                MarkUnverified(dbc);
             } catch (const std::exception& ex) {
                 LOG(ERROR) << "Exception while disconnecting: " << ex.what();
             }
@@ -81,19 +85,53 @@ void OdbcHelper::DisconnectAndFree(SQLHDBC* hdbc) {
 
 bool OdbcHelper::IsClosed(SQLHDBC hdbc) {
     const DBC* local_dbc = static_cast<DBC*>(hdbc);
-    if (hdbc == SQL_NULL_HDBC || local_dbc->wrapped_dbc == SQL_NULL_HDBC) {
+    if (hdbc == SQL_NULL_HDBC) {
+        return true;
+    }
+    if (local_dbc->wrapped_dbc != SQL_NULL_HDBC && IsRecentlyActive(local_dbc)) {
+        return false;
+    }
+    return BaseIsClosed(local_dbc->wrapped_dbc);
+}
+
+void OdbcHelper::MarkActive(DBC* dbc) {
+    dbc->last_activity = std::chrono::steady_clock::now();
+}
+
+void OdbcHelper::MarkUnverified(DBC* dbc) {
+    dbc->last_activity = std::chrono::steady_clock::time_point{};
+}
+
+bool OdbcHelper::IsRecentlyActive(const DBC* dbc) {
+    const std::chrono::steady_clock::time_point last_activity = dbc->last_activity;
+    return last_activity != std::chrono::steady_clock::time_point{}
+        && std::chrono::steady_clock::now() - last_activity < dbc->validation_freshness;
+}
+
+bool OdbcHelper::BaseIsClosed(SQLHDBC wrapped_dbc) {
+    if (wrapped_dbc == SQL_NULL_HDBC) {
         return true;
     }
     SQLUINTEGER connection_state = SQL_CD_FALSE;
     const RdsLibResult res = NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLGetConnectAttr, RDS_STR_SQLGetConnectAttr,
-        local_dbc->wrapped_dbc, SQL_ATTR_CONNECTION_DEAD, &connection_state, sizeof(SQLUINTEGER), nullptr
+        wrapped_dbc, SQL_ATTR_CONNECTION_DEAD, &connection_state, sizeof(SQLUINTEGER), nullptr
     );
 
     if (SQL_SUCCEEDED(res.fn_result)) {
         return connection_state == SQL_CD_TRUE;
     }
+    if (!res.fn_load_success) {
+        return true;
+    }
 
-    return true;
+    // The base driver does not report the connection state, a query is the only way to tell
+    SQLHSTMT stmt = SQL_NULL_HSTMT;
+    if (!SQL_SUCCEEDED(BaseAllocStmt(&wrapped_dbc, &stmt).fn_result)) {
+        return true;
+    }
+    const bool alive = SQL_SUCCEEDED(ExecDirect(&stmt, VALIDATION_QUERY).fn_result);
+    BaseFreeStmt(&stmt);
+    return !alive;
 }
 
 SQLRETURN OdbcHelper::AllocEnv(SQLHENV* henv) {
@@ -162,6 +200,33 @@ RdsLibResult OdbcHelper::ExecDirect(const SQLHSTMT* stmt, const std::string &que
 #endif
 }
 
+RdsLibResult OdbcHelper::Prepare(const SQLHSTMT* stmt, const std::string &query) {
+#if UNICODE
+    if (this->GetUse4BytesBaseDriver()) {
+        const std::wstring wide_query = ConvertUTF8ToWString(query);
+        SQLTCHAR* query_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(wide_query.c_str()));
+        return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_ , RDS_FP_SQLPrepare, RDS_STR_SQLPrepare,
+            *stmt, query_sqltchar, SQL_NTS
+        );
+    }
+    const std::vector<uint16_t> query_vector = ConvertUTF8ToUTF16(query);
+    SQLTCHAR* query_sqltchar = const_cast<SQLTCHAR *>(reinterpret_cast<const SQLTCHAR *>(query_vector.data()));
+    return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_ , RDS_FP_SQLPrepare, RDS_STR_SQLPrepare,
+        *stmt, query_sqltchar, SQL_NTS
+    );
+#else
+    return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_ , RDS_FP_SQLPrepare, RDS_STR_SQLPrepare,
+        *stmt, AS_SQLTCHAR(query), SQL_NTS
+    );
+#endif
+}
+
+RdsLibResult OdbcHelper::Execute(const SQLHSTMT* stmt) {
+    return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLExecute, RDS_STR_SQLExecute,
+        *stmt
+    );
+}
+
 RdsLibResult OdbcHelper::CloseCursor(SQLHSTMT stmt) {
     return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLCloseCursor, RDS_STR_SQLCloseCursor,
         stmt
@@ -186,6 +251,39 @@ RdsLibResult OdbcHelper::BaseFreeStmt(SQLHSTMT* stmt) {
     );
 }
 
+RdsLibResult OdbcHelper::BaseEndTran(SQLHDBC wrapped_dbc, const SQLSMALLINT completion_type) {
+    return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLEndTran, RDS_STR_SQLEndTran,
+        SQL_HANDLE_DBC, wrapped_dbc, completion_type
+    );
+}
+
+RdsLibResult OdbcHelper::BaseSetConnectAttr(
+    SQLHDBC wrapped_dbc,
+    const SQLINTEGER attribute,
+    SQLPOINTER value,
+    const SQLINTEGER length)
+{
+    return NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLSetConnectAttr, RDS_STR_SQLSetConnectAttr,
+        wrapped_dbc, attribute, value, length
+    );
+}
+
+void OdbcHelper::BaseDisconnectAndFree(SQLHDBC wrapped_dbc) {
+    if (wrapped_dbc == SQL_NULL_HDBC) {
+        return;
+    }
+    try {
+        NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLDisconnect, RDS_STR_SQLDisconnect,
+            wrapped_dbc
+        );
+        NULL_CHECK_CALL_LIB_FUNC(this->lib_loader_, RDS_FP_SQLFreeHandle, RDS_STR_SQLFreeHandle,
+            SQL_HANDLE_DBC, wrapped_dbc
+        );
+    } catch (const std::exception& ex) {
+        LOG(ERROR) << "Exception while disconnecting: " << ex.what();
+    }
+}
+
 std::shared_ptr<RdsLibLoader> OdbcHelper::GetLibLoader() {
     return this->lib_loader_;
 }
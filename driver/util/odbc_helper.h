@@ -19,6 +19,7 @@
 #include "../odbcapi.h"
 #include "rds_lib_loader.h"
 
+#include <chrono>
 #include <vector>
 
 // Holds a converted SQLTCHAR buffer and a pointer suitable for passing to the
@@ -31,13 +32,23 @@ struct ConvertedSqltchar {
 
 class OdbcHelper {
 public:
+    static inline const std::chrono::milliseconds DEFAULT_VALIDATION_FRESHNESS_MS = std::chrono::milliseconds(500);
+    // Used when the base driver does not report SQL_ATTR_CONNECTION_DEAD
+    static constexpr char VALIDATION_QUERY[] = "SELECT 1";
+
     OdbcHelper(const std::shared_ptr<RdsLibLoader>& lib_loader, const ENV* env);
 
     virtual void Disconnect(DBC *dbc);
     virtual void Disconnect(SQLHDBC *hdbc);
     virtual void DisconnectAndFree(SQLHDBC *hdbc);
 
+    // Connections that completed a call within their validation freshness window are not probed
     virtual bool IsClosed(SQLHDBC hdbc);
+    // Records a successful call on the connection's underlying connection
+    static void MarkActive(DBC *dbc);
+    // The next validation probes, i.e. after a failed call or once the underlying connection changed
+    static void MarkUnverified(DBC *dbc);
+    static bool IsRecentlyActive(const DBC *dbc);
 
     virtual SQLRETURN AllocEnv(SQLHENV *henv);
     virtual SQLRETURN FreeEnv(SQLHENV *henv);
@@ -47,6 +58,8 @@ public:
     virtual RdsLibResult Fetch(SQLHSTMT *stmt);
     virtual RdsLibResult BindCol(const SQLHSTMT *stmt, int column, int type, void *value, size_t size, SQLLEN *len);
     virtual RdsLibResult ExecDirect(const SQLHSTMT *stmt, const std::string &query);
+    virtual RdsLibResult Prepare(const SQLHSTMT *stmt, const std::string &query);
+    virtual RdsLibResult Execute(const SQLHSTMT *stmt);
 
     virtual RdsLibResult CloseCursor(SQLHSTMT stmt);
 
@@ -54,6 +67,12 @@ public:
     virtual RdsLibResult BaseAllocStmt(const SQLHDBC *wrapped_dbc, SQLHSTMT *stmt);
     virtual RdsLibResult BaseFreeStmt(SQLHSTMT *stmt);
 
+    // Operate directly on an underlying connection handle
+    virtual bool BaseIsClosed(SQLHDBC wrapped_dbc);
+    virtual RdsLibResult BaseEndTran(SQLHDBC wrapped_dbc, SQLSMALLINT completion_type);
+    virtual RdsLibResult BaseSetConnectAttr(SQLHDBC wrapped_dbc, SQLINTEGER attribute, SQLPOINTER value, SQLINTEGER length);
+    virtual void BaseDisconnectAndFree(SQLHDBC wrapped_dbc);
+
     virtual std::shared_ptr<RdsLibLoader> GetLibLoader();
 
     bool GetUse4BytesBaseDriver() const;
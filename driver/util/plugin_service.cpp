@@ -32,6 +32,7 @@
 #include "../host_list_providers/host_list_provider.h"
 #include "../host_list_providers/multi_az_topology_util.h"
 #include "../host_list_providers/rds_host_list_provider.h"
+#include "../host_list_providers/topology_file_cache.h"
 
 PluginService::PluginService(const std::shared_ptr<RdsLibLoader>& lib_loader, std::map<std::string, std::string> original_conn_attr)
     : PluginService(lib_loader, nullptr, original_conn_attr, "") {}
@@ -67,7 +68,16 @@ PluginService::PluginService(const std::shared_ptr<RdsLibLoader>& lib_loader, co
             this->initial_host_.GetPort()
         );
     }
+    if (original_conn_attr_.contains(KEY_TOPOLOGY_CACHE_DIR) && !original_conn_attr_.contains(KEY_CLUSTER_ID)
+        && RdsUtils::GetRdsClusterId(this->initial_host_.GetHost()).empty()) {
+        // A generated cluster ID differs in every process, a persisted topology could never be found again
+        LOG(WARNING) << "Topology cache disabled, " << KEY_TOPOLOGY_CACHE_DIR << " requires a cluster endpoint or " << KEY_CLUSTER_ID;
+        original_conn_attr_.erase(KEY_TOPOLOGY_CACHE_DIR);
+    }
     this->cluster_id_ = InitClusterId(original_conn_attr_);
+    if (original_conn_attr_.contains(KEY_TOPOLOGY_CACHE_DIR)) {
+        LoadPersistedTopology();
+    }
     this->host_selector_ = InitHostSelector(original_conn_attr_);
     this->dialect_ = InitDialect(original_conn_attr_);
     this->odbc_helper_ = std::make_shared<OdbcHelper>(lib_loader, env);
@@ -105,7 +115,8 @@ std::map<std::string, std::string> PluginService::GetOriginalConnAttr() {
 
 HostInfo PluginService::GetCurrentHostInfo() {
     const std::lock_guard<std::mutex> lock_guard(lock_);
-    const std::vector<HostInfo> hosts = GetHosts();
+    const std::shared_ptr<const TopologySnapshot> topology = GetTopologySnapshot();
+    const std::vector<HostInfo>& hosts = topology->hosts;
     if (this->current_host_ != HostInfo{} || hosts.empty()) {
         return this->current_host_;
     }
@@ -181,41 +192,72 @@ void PluginService::ForceRefreshHosts(bool verify_writer, std::chrono::milliseco
     }
 }
 
-std::vector<HostInfo> PluginService::GetHosts() {
-    return topology_map_->Get(this->cluster_id_);
-}
-
-void PluginService::SetHosts(const std::vector<HostInfo>& hosts) {
-    topology_map_->Put(this->cluster_id_, hosts);
+std::shared_ptr<const TopologySnapshot> PluginService::GetTopologySnapshot() {
+    if (std::shared_ptr<const TopologySnapshot> topology = topology_map_->Get(this->cluster_id_)) {
+        return topology;
+    }
+    return EMPTY_TOPOLOGY;
 }
 
-std::vector<HostInfo> PluginService::GetFilteredHosts() {
-    std::vector<HostInfo> hosts = topology_map_->Get(this->cluster_id_);
-    HostFilter host_filter = host_filter_map_->Get(this->cluster_id_);
+std::shared_ptr<const TopologySnapshot> PluginService::GetFilteredTopologySnapshot() {
+    std::shared_ptr<const TopologySnapshot> topology = GetTopologySnapshot();
+    const std::shared_ptr<const HostFilter> host_filter = host_filter_map_->Get(this->cluster_id_);
 
-    if (host_filter.allowed_host_ids.empty() && host_filter.blocked_host_ids.empty()) {
-        return hosts;
+    if (!host_filter || (host_filter->allowed_host_ids.empty() && host_filter->blocked_host_ids.empty())) {
+        return topology;
     }
 
-    std::vector<HostInfo> filtered_hosts;
-    std::copy_if(hosts.begin(), hosts.end(), std::back_inserter(filtered_hosts),
+    // Filtered views are built per call and not published
+    const std::shared_ptr<TopologySnapshot> filtered = std::make_shared<TopologySnapshot>();
+    filtered->version = topology->version;
+    std::copy_if(topology->hosts.begin(), topology->hosts.end(), std::back_inserter(filtered->hosts),
         [&](const HostInfo& host) {
             const std::string host_id = host.GetHostId();
-            if (!host_filter.allowed_host_ids.empty()) {
-                return host_filter.allowed_host_ids.contains(host_id);
+            if (!host_filter->allowed_host_ids.empty()) {
+                return host_filter->allowed_host_ids.contains(host_id);
             }
-            if (!host_filter.blocked_host_ids.empty()) {
-                return !(host_filter.endpoint_type == "READER" && host.IsHostWriter())
-                    && !host_filter.blocked_host_ids.contains(host_id);
+            if (!host_filter->blocked_host_ids.empty()) {
+                return !(host_filter->endpoint_type == "READER" && host.IsHostWriter())
+                    && !host_filter->blocked_host_ids.contains(host_id);
             }
             return true;
         }
     );
-    return filtered_hosts;
+    return filtered;
+}
+
+std::vector<HostInfo> PluginService::GetHosts() {
+    return GetTopologySnapshot()->hosts;
+}
+
+void PluginService::SetHosts(const std::vector<HostInfo>& hosts) {
+    topology_map_->Put(this->cluster_id_,
+        std::make_shared<const TopologySnapshot>(TopologySnapshot{ hosts, topology_version_.fetch_add(1) + 1 }));
+}
+
+void PluginService::SetProvisionalHosts(const std::vector<HostInfo>& hosts) {
+    topology_map_->PutIfAbsent(this->cluster_id_,
+        std::make_shared<const TopologySnapshot>(TopologySnapshot{ hosts, topology_version_.fetch_add(1) + 1, true }));
+}
+
+void PluginService::LoadPersistedTopology() {
+    if (!GetTopologySnapshot()->hosts.empty()) {
+        // Already known to this process
+        return;
+    }
+    const std::vector<HostInfo> hosts = TopologyFileCache(original_conn_attr_.at(KEY_TOPOLOGY_CACHE_DIR)).Read(this->cluster_id_);
+    if (!hosts.empty()) {
+        LOG(INFO) << "Loaded provisional topology of " << hosts.size() << " hosts from the topology cache for: " << this->cluster_id_;
+        SetProvisionalHosts(hosts);
+    }
+}
+
+std::vector<HostInfo> PluginService::GetFilteredHosts() {
+    return GetFilteredTopologySnapshot()->hosts;
 }
 
 void PluginService::SetHostFilter(const HostFilter& filter) {
-    host_filter_map_->Put(this->cluster_id_, filter);
+    host_filter_map_->Put(this->cluster_id_, std::make_shared<const HostFilter>(filter));
 }
 
 std::shared_ptr<BasePlugin> PluginService::GetPluginChain() {
@@ -272,16 +314,22 @@ std::shared_ptr<HostSelector> PluginService::InitHostSelector(const std::map<std
         selector_strategy = HostSelector::GetHostSelectorStrategy(conn_info.at(KEY_HOST_SELECTOR_STRATEGY));
     }
 
+    std::shared_ptr<HostSelector> host_selector;
     switch (selector_strategy) {
         case ROUND_ROBIN:
-            return std::make_shared<RoundRobinHostSelector>();
+            host_selector = std::make_shared<RoundRobinHostSelector>();
+            break;
         case HIGHEST_WEIGHT:
-            return std::make_shared<HighestWeightHostSelector>();
+            host_selector = std::make_shared<HighestWeightHostSelector>();
+            break;
         case RANDOM_HOST:
         case UNKNOWN_STRATEGY:
         default:
-            return std::make_shared<RandomHostSelector>();
+            host_selector = std::make_shared<RandomHostSelector>();
+            break;
     }
+    host_selector->SetMaxReplicaLag(MapUtils::GetMillisecondsValue(conn_info, KEY_MAX_REPLICA_LAG, std::chrono::milliseconds(0)));
+    return host_selector;
 }
 
 std::string PluginService::InitClusterId(std::map<std::string, std::string>& conn_info) {
@@ -351,6 +399,18 @@ std::shared_ptr<Dialect> PluginService::InitDialect(const std::map<std::string,
     }
 }
 
+std::shared_ptr<UnderlyingConnectionPool> PluginService::GetConnectionPool() {
+    return connection_pool_;
+}
+
+std::shared_ptr<MonitoringScheduler> PluginService::GetMonitoringScheduler() {
+    return monitoring_scheduler_;
+}
+
+std::shared_ptr<MonitoringScheduler> PluginService::GetProbeScheduler() {
+    return probe_scheduler_;
+}
+
 void PluginService::UpdateDialect(DBC* dbc) {
     const DatabaseDialectType update_candidate = this->dialect_->GetUpdateCandidate();
     std::shared_ptr<Dialect> new_dialect;
@@ -380,7 +440,7 @@ void PluginService::UpdateDialect(DBC* dbc) {
         }
    } else {
         // Fetch topology directly using the main DBC if not already cached.
-        if (this->GetHosts().empty()) {
+        if (this->GetTopologySnapshot()->hosts.empty()) {
             const std::vector<HostInfo> hosts = this->topology_util_->QueryTopology(dbc, this->initial_host_, this->template_host_);
             if (!hosts.empty()) {
                 this->SetHosts(hosts);
@@ -15,12 +15,15 @@
 #ifndef PLUGIN_SERVICE_H_
 #define PLUGIN_SERVICE_H_
 
+#include "monitoring_scheduler.h"
 #include "sliding_cache_map.h"
+#include "underlying_connection_pool.h"
 
 #include "../host_list_providers/host_list_provider.h"
 #include "../host_list_providers/topology_util.h"
 #include "../host_selector/host_selector.h"
 
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <set>
@@ -28,6 +31,16 @@
 struct DBC;
 struct ENV;
 
+// Published topology of a cluster, never modified once published.
+// Readers share the snapshot instead of copying the host list.
+struct TopologySnapshot {
+    std::vector<HostInfo> hosts;
+    // Increases with every published topology
+    uint64_t version = 0;
+    // Loaded from the topology cache file and not yet confirmed by a topology query
+    bool provisional = false;
+};
+
 struct HostFilter {
     std::set<std::string> allowed_host_ids;
     std::set<std::string> blocked_host_ids;
@@ -66,8 +79,13 @@ class PluginService {
     virtual void RefreshHosts();
     virtual void ForceRefreshHosts(bool verify_writer, std::chrono::milliseconds timeout_ms);
 
+    // Never null, an empty snapshot with version 0 when there is no topology
+    virtual std::shared_ptr<const TopologySnapshot> GetTopologySnapshot();
+    virtual std::shared_ptr<const TopologySnapshot> GetFilteredTopologySnapshot();
     virtual std::vector<HostInfo> GetHosts();
     virtual void SetHosts(const std::vector<HostInfo>& hosts);
+    // Published only while there is no topology for the cluster
+    virtual void SetProvisionalHosts(const std::vector<HostInfo>& hosts);
     virtual std::vector<HostInfo> GetFilteredHosts();
     virtual void SetHostFilter(const HostFilter& filter);
 
@@ -81,9 +99,16 @@ class PluginService {
     static std::shared_ptr<HostSelector> InitHostSelector(const std::map<std::string, std::string>& conn_info);
     static std::string InitClusterId(std::map<std::string, std::string>& conn_info);
     static std::shared_ptr<Dialect> InitDialect(const std::map<std::string, std::string>& conn_info);
+    static std::shared_ptr<UnderlyingConnectionPool> GetConnectionPool();
+    static std::shared_ptr<MonitoringScheduler> GetMonitoringScheduler();
+    static std::shared_ptr<MonitoringScheduler> GetProbeScheduler();
     void UpdateDialect(DBC *dbc);
 
+    static inline const std::shared_ptr<const TopologySnapshot> EMPTY_TOPOLOGY = std::make_shared<const TopologySnapshot>();
+
    private:
+    void LoadPersistedTopology();
+
     std::string cluster_id_;
     std::string original_conn_str_;
     std::map<std::string, std::string> original_conn_attr_;
@@ -104,10 +129,21 @@ class PluginService {
 
     // Shared resources
     // SlidingCacheMap internally thread safe
-    static inline std::shared_ptr<SlidingCacheMap<std::string, std::vector<HostInfo>>> topology_map_ =
-        std::make_shared<SlidingCacheMap<std::string, std::vector<HostInfo>>>();
-    static inline std::shared_ptr<SlidingCacheMap<std::string, HostFilter>> host_filter_map_ =
-        std::make_shared<SlidingCacheMap<std::string, HostFilter>>();
+    static inline std::shared_ptr<SlidingCacheMap<std::string, std::shared_ptr<const TopologySnapshot>>> topology_map_ =
+        std::make_shared<SlidingCacheMap<std::string, std::shared_ptr<const TopologySnapshot>>>();
+    static inline std::shared_ptr<SlidingCacheMap<std::string, std::shared_ptr<const HostFilter>>> host_filter_map_ =
+        std::make_shared<SlidingCacheMap<std::string, std::shared_ptr<const HostFilter>>>();
+    static inline std::atomic<uint64_t> topology_version_{0};
+    // Runs the monitors of every connection, internally thread safe
+    static inline std::shared_ptr<MonitoringScheduler> monitoring_scheduler_ =
+        std::make_shared<MonitoringScheduler>();
+    // Internally thread safe, declared after the scheduler running its evictions
+    static inline std::shared_ptr<UnderlyingConnectionPool> connection_pool_ =
+        std::make_shared<UnderlyingConnectionPool>(monitoring_scheduler_);
+    // Runs panic mode host probes, kept apart as probes block on connects
+    static constexpr size_t PROBE_WORKER_COUNT = 16;
+    static inline std::shared_ptr<MonitoringScheduler> probe_scheduler_ =
+        std::make_shared<MonitoringScheduler>(PROBE_WORKER_COUNT);
 };
 
 #endif  // PLUGIN_SERVICE_H_
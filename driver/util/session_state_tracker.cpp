@@ -0,0 +1,472 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "session_state_tracker.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "../dialect/dialect.h"
+#include "../driver.h"
+#include "logger_wrapper.h"
+#include "odbc_helper.h"
+#include "plugin_service.h"
+#include "rds_strings.h"
+#include "sql_lexer.h"
+
+namespace {
+    const std::string ISOLATION_KEY = "isolation";
+    const std::string VARIABLE_KEY_PREFIX = "var:";
+
+    // Managed by the wrapper through connection attributes and read/write splitting
+    const std::set<std::string> UNTRACKED_VARIABLES = {
+        "autocommit", "transaction_read_only", "tx_read_only", "default_transaction_read_only"
+    };
+
+    constexpr size_t MAX_SETTING_VALUE_SIZE = 1024;
+
+    struct StatementTokens {
+        std::vector<SqlToken> tokens;
+        std::string_view text;
+    };
+
+    bool NextStatementTokens(SqlLexer& lexer, StatementTokens& out)
+    {
+        out.tokens.clear();
+        while (true) {
+            const SqlToken token = lexer.Next();
+            if (token.type == TOKEN_END || token.type == TOKEN_SEMICOLON) {
+                if (!out.tokens.empty()) {
+                    const std::string_view last = out.tokens.back().text;
+                    const char* begin = out.tokens.front().text.data();
+                    out.text = std::string_view(begin, last.data() + last.size() - begin);
+                    return true;
+                }
+                if (token.type == TOKEN_END) {
+                    return false;
+                }
+                continue;
+            }
+            out.tokens.push_back(token);
+        }
+    }
+
+    std::string ToLower(std::string_view text)
+    {
+        std::string lower(text);
+        std::ranges::transform(lower, lower.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return lower;
+    }
+
+    std::string_view Unquote(std::string_view text)
+    {
+        if (text.size() >= 2 && text.front() == text.back() && (text.front() == '\'' || text.front() == '"' || text.front() == '`')) {
+            return text.substr(1, text.size() - 2);
+        }
+        return text;
+    }
+
+    // Compares equal to the server's formatting of the value, i.e. 'UTC' and UTC, or READ-COMMITTED and read committed
+    std::string NormalizeValue(std::string_view value, const bool is_isolation)
+    {
+        std::string normalized(Unquote(value));
+        if (is_isolation) {
+            normalized = ToLower(normalized);
+            std::ranges::replace(normalized, '-', ' ');
+        }
+        return normalized;
+    }
+
+    // Text of the statement from the token at index onwards
+    std::string_view Remainder(const StatementTokens& statement, const size_t index)
+    {
+        const char* begin = statement.tokens[index].text.data();
+        return statement.text.substr(begin - statement.text.data());
+    }
+
+    // MySQL's SET a = 1, b = 2 sets several variables at once
+    bool IsMultipleAssignment(const StatementTokens& statement, const size_t from)
+    {
+        int depth = 0;
+        const std::vector<SqlToken>& tokens = statement.tokens;
+        for (size_t i = from; i < tokens.size(); i++) {
+            if (tokens[i].Equals("(")) {
+                depth++;
+            } else if (tokens[i].Equals(")")) {
+                depth--;
+            } else if (depth == 0 && tokens[i].Equals(",")) {
+                // An assignment follows the comma, rather than another list element as in SET search_path TO a, b
+                for (size_t j = i + 1; j < tokens.size() && !tokens[j].Equals(",") && !tokens[j].Equals("("); j++) {
+                    if (tokens[j].Equals("=") || tokens[j].Equals(":")) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    std::optional<SessionSetting> ParseTokens(const StatementTokens& statement, const std::string& isolation_variable)
+    {
+        const std::vector<SqlToken>& tokens = statement.tokens;
+        const size_t count = tokens.size();
+        const auto is = [&tokens, count](const size_t i, const std::string_view word) {
+            return i < count && tokens[i].Equals(word);
+        };
+
+        SessionSetting setting;
+        setting.statement = std::string(statement.text);
+
+        if (is(0, "USE") && count == 2) {
+            setting.key = "catalog";
+            setting.value = std::string(Unquote(tokens[1].text));
+            return setting;
+        }
+        if ((is(0, "RESET") || is(0, "DISCARD")) && is(1, "ALL") && count == 2) {
+            setting.key = SessionStateTracker::RESET_ALL_KEY;
+            setting.value = SessionStateTracker::DEFAULT_VALUE;
+            return setting;
+        }
+
+        size_t index = 0;
+        if (is(0, "RESET")) {
+            index = 1;
+        } else if (is(0, "SET")) {
+            if (is(1, "LOCAL") || is(1, "GLOBAL") || is(1, "PERSIST") || is(1, "PERSIST_ONLY")) {
+                return {};
+            }
+            const bool session = is(1, "SESSION");
+            index = session ? 2 : 1;
+
+            size_t isolation_index = 0;
+            if (session && is(2, "CHARACTERISTICS") && is(3, "AS") && is(4, "TRANSACTION")) {
+                isolation_index = 5;
+            } else if (session && is(2, "TRANSACTION")) {
+                isolation_index = 3;
+            } else if (is(index, "TRANSACTION")) {
+                // Only applies to the next transaction
+                return {};
+            }
+            if (isolation_index != 0) {
+                // Access modes are left to read/write splitting
+                if (!is(isolation_index, "ISOLATION") || !is(isolation_index + 1, "LEVEL") || count <= isolation_index + 2
+                    || std::ranges::any_of(tokens, [](const SqlToken& token) { return token.Equals(","); }))
+                {
+                    return {};
+                }
+                setting.key = ISOLATION_KEY;
+                setting.variable = isolation_variable;
+                setting.value = NormalizeValue(Remainder(statement, isolation_index + 2), true);
+                return setting;
+            }
+
+            if (is(index, "TIME") && is(index + 1, "ZONE") && count > index + 2) {
+                setting.key = VARIABLE_KEY_PREFIX + "timezone";
+                setting.variable = "timezone";
+                setting.value = NormalizeValue(Remainder(statement, index + 2), false);
+                return setting;
+            }
+            if (is(index, "SCHEMA") && count > index + 1) {
+                setting.key = VARIABLE_KEY_PREFIX + "search_path";
+                setting.variable = "search_path";
+                setting.value = NormalizeValue(Remainder(statement, index + 1), false);
+                return setting;
+            }
+            if ((is(index, "NAMES") || is(index, "CHARSET")) && count > index + 1) {
+                setting.key = "names";
+                setting.value = std::string(Remainder(statement, index + 1));
+                return setting;
+            }
+            if (is(index, "CHARACTER") && is(index + 1, "SET") && count > index + 2) {
+                setting.key = "names";
+                setting.value = std::string(Remainder(statement, index + 2));
+                return setting;
+            }
+        } else {
+            return {};
+        }
+
+        // Variable name, possibly qualified, i.e. search_path, @@SESSION.time_zone or myapp.tenant
+        if (index >= count || tokens[index].type != TOKEN_WORD) {
+            return {};
+        }
+        std::string name(tokens[index].text);
+        index++;
+        while (is(index, ".") && index + 1 < count && tokens[index + 1].type == TOKEN_WORD) {
+            name += "." + std::string(tokens[index + 1].text);
+            index += 2;
+        }
+        name = ToLower(name);
+        bool queryable = true;
+        if (name.starts_with("@@")) {
+            name = name.substr(2);
+            if (name.starts_with("session.") || name.starts_with("local.")) {
+                name = name.substr(name.find('.') + 1);
+            } else if (name.find('.') != std::string::npos) {
+                return {};
+            }
+        } else if (name.starts_with("@")) {
+            // User variables have no server default
+            queryable = false;
+        }
+        if (UNTRACKED_VARIABLES.contains(name)) {
+            return {};
+        }
+
+        setting.key = VARIABLE_KEY_PREFIX + name;
+        setting.variable = queryable ? name : "";
+        if (is(0, "RESET")) {
+            if (index != count) {
+                return {};
+            }
+            setting.value = SessionStateTracker::DEFAULT_VALUE;
+            return setting;
+        }
+
+        if (is(index, "=") || is(index, "TO")) {
+            index++;
+        } else if (is(index, ":") && is(index + 1, "=")) {
+            index += 2;
+        } else {
+            return {};
+        }
+        if (index >= count) {
+            return {};
+        }
+        if (IsMultipleAssignment(statement, index)) {
+            // Keyed by the whole statement so a later change to one of the variables does not drop the others
+            setting.key = "statement:" + setting.statement;
+            setting.variable.clear();
+            setting.value = setting.statement;
+            return setting;
+        }
+        setting.value = (index + 1 == count && tokens[index].Equals("DEFAULT"))
+            ? SessionStateTracker::DEFAULT_VALUE
+            : NormalizeValue(Remainder(statement, index), false);
+        return setting;
+    }
+
+    void QueryServerDefaults(DBC* dbc, SessionStateTracker& tracker, const std::shared_ptr<Dialect>& dialect,
+        const std::shared_ptr<OdbcHelper>& odbc_helper, const std::vector<std::string>& variables)
+    {
+        std::vector<std::optional<std::string>> values(variables.size());
+        const std::string query = dialect ? dialect->GetSessionVariablesQuery(variables) : "";
+        SQLHSTMT stmt = SQL_NULL_HANDLE;
+        if (!query.empty() && SQL_SUCCEEDED(odbc_helper->BaseAllocStmt(&dbc->wrapped_dbc, &stmt).fn_result)) {
+            std::vector<std::vector<SQLTCHAR>> buffers(variables.size(), std::vector<SQLTCHAR>(MAX_SETTING_VALUE_SIZE * 2));
+            std::vector<SQLLEN> lengths(variables.size(), 0);
+            if (SQL_SUCCEEDED(odbc_helper->ExecDirect(&stmt, query).fn_result)) {
+                for (size_t i = 0; i < variables.size(); i++) {
+                    odbc_helper->BindCol(&stmt, static_cast<int>(i + 1), SQL_C_TCHAR, buffers[i].data(), MAX_SETTING_VALUE_SIZE, &lengths[i]);
+                }
+                if (SQL_SUCCEEDED(odbc_helper->Fetch(&stmt).fn_result)) {
+                    for (size_t i = 0; i < variables.size(); i++) {
+                        if (lengths[i] == SQL_NULL_DATA) {
+                            continue;
+                        }
+#if UNICODE
+                        Convert4To2ByteString(odbc_helper->GetUse4BytesBaseDriver(), buffers[i].data(), nullptr, MAX_SETTING_VALUE_SIZE);
+                        values[i] = ConvertUTF16ToUTF8(reinterpret_cast<uint16_t*>(buffers[i].data()));
+#else
+                        values[i] = std::string(reinterpret_cast<const char*>(buffers[i].data()));
+#endif
+                    }
+                }
+            }
+            odbc_helper->BaseFreeStmt(&stmt);
+        }
+        for (size_t i = 0; i < variables.size(); i++) {
+            tracker.SetServerDefault(variables[i], values[i]);
+        }
+    }
+
+    bool ExecuteStatement(DBC* dbc, const std::shared_ptr<OdbcHelper>& odbc_helper, const std::string& statement)
+    {
+        SQLHSTMT stmt = SQL_NULL_HANDLE;
+        if (!SQL_SUCCEEDED(odbc_helper->BaseAllocStmt(&dbc->wrapped_dbc, &stmt).fn_result)) {
+            return false;
+        }
+        const bool succeeded = SQL_SUCCEEDED(odbc_helper->ExecDirect(&stmt, statement).fn_result);
+        odbc_helper->BaseFreeStmt(&stmt);
+        return succeeded;
+    }
+}  // namespace
+
+std::optional<SessionSetting> SessionStateTracker::ParseStatement(const std::string& statement, const std::string& isolation_variable,
+    const bool backslash_escapes)
+{
+    SqlLexer lexer(statement, backslash_escapes);
+    StatementTokens tokens;
+    if (!NextStatementTokens(lexer, tokens)) {
+        return {};
+    }
+    return ParseTokens(tokens, isolation_variable);
+}
+
+void SessionStateTracker::TrackStatement(const std::string& statement, const std::string& isolation_variable,
+    const bool backslash_escapes)
+{
+    SqlLexer lexer(statement, backslash_escapes);
+    StatementTokens tokens;
+    while (NextStatementTokens(lexer, tokens)) {
+        std::optional<SessionSetting> setting = ParseTokens(tokens, isolation_variable);
+        if (!setting) {
+            continue;
+        }
+        setting->sequence = next_sequence_++;
+        if (setting->key == RESET_ALL_KEY) {
+            settings_.clear();
+        }
+        MarkApplied(setting.value());
+        settings_.insert_or_assign(setting->key, std::move(setting.value()));
+    }
+}
+
+void SessionStateTracker::TrackAttribute(const SQLINTEGER attribute, SQLPOINTER value, const SQLINTEGER length)
+{
+    applied_.attributes.insert_or_assign(attribute, std::make_pair(value, length));
+}
+
+void SessionStateTracker::MarkConnected(const std::map<SQLINTEGER, std::pair<SQLPOINTER, SQLINTEGER>>& attributes)
+{
+    applied_.attributes = attributes;
+    applied_.settings.clear();
+}
+
+AppliedSessionState SessionStateTracker::TakeApplied()
+{
+    return std::exchange(applied_, AppliedSessionState{});
+}
+
+void SessionStateTracker::RestoreApplied(AppliedSessionState applied)
+{
+    applied_ = std::move(applied);
+}
+
+std::vector<SessionSetting> SessionStateTracker::GetPendingSettings() const
+{
+    return Diff(nullptr);
+}
+
+std::vector<std::string> SessionStateTracker::GetUnknownDefaults() const
+{
+    std::vector<std::string> unknown_defaults;
+    Diff(&unknown_defaults);
+    return unknown_defaults;
+}
+
+void SessionStateTracker::SetServerDefault(const std::string& variable, const std::optional<std::string>& value)
+{
+    server_defaults_.insert_or_assign(variable, value);
+}
+
+void SessionStateTracker::MarkApplied(const SessionSetting& setting)
+{
+    if (setting.key == RESET_ALL_KEY) {
+        applied_.settings.clear();
+    }
+    applied_.settings.insert_or_assign(setting.key, setting.sequence);
+}
+
+std::vector<SessionSetting> SessionStateTracker::Diff(std::vector<std::string>* unknown_defaults) const
+{
+    std::vector<const SessionSetting*> ordered;
+    ordered.reserve(settings_.size());
+    for (const auto& [key, setting] : settings_) {
+        ordered.push_back(&setting);
+    }
+    std::ranges::sort(ordered, {}, &SessionSetting::sequence);
+
+    std::map<std::string, uint64_t> applied = applied_.settings;
+    std::vector<SessionSetting> pending;
+    for (const SessionSetting* setting : ordered) {
+        const auto applied_setting = applied.find(setting->key);
+        if (applied_setting != applied.end() && applied_setting->second == setting->sequence) {
+            continue;
+        }
+
+        if (setting->key == RESET_ALL_KEY) {
+            // Only needed if something was set on this connection
+            const bool has_changes = std::ranges::any_of(applied, [](const auto& entry) { return entry.first != RESET_ALL_KEY; });
+            if (has_changes) {
+                pending.push_back(*setting);
+            }
+            applied.clear();
+            applied.insert_or_assign(setting->key, setting->sequence);
+            continue;
+        }
+
+        if (applied_setting == applied.end()) {
+            // The connection still has the server default
+            if (setting->value == DEFAULT_VALUE) {
+                continue;
+            }
+            if (!setting->variable.empty()) {
+                const auto server_default = server_defaults_.find(setting->variable);
+                if (server_default == server_defaults_.end()) {
+                    if (unknown_defaults && std::ranges::find(*unknown_defaults, setting->variable) == unknown_defaults->end()) {
+                        unknown_defaults->push_back(setting->variable);
+                    }
+                } else if (server_default->second.has_value()
+                    && NormalizeValue(server_default->second.value(), setting->key == ISOLATION_KEY) == setting->value)
+                {
+                    continue;
+                }
+            }
+        }
+        pending.push_back(*setting);
+        applied.insert_or_assign(setting->key, setting->sequence);
+    }
+    return pending;
+}
+
+void SessionStateTracker::Sync(DBC* dbc)
+{
+    const std::shared_ptr<PluginService> service = dbc->plugin_service;
+    if (!service || dbc->wrapped_dbc == SQL_NULL_HDBC) {
+        return;
+    }
+    const std::shared_ptr<OdbcHelper> odbc_helper = service->GetOdbcHelper();
+    SessionStateTracker& tracker = dbc->session_state;
+
+    for (auto const& [key, val] : dbc->attr_map) {
+        if (key == SQL_ATTR_LOGIN_TIMEOUT || key == SQL_ATTR_CONNECTION_TIMEOUT) {
+            continue;
+        }
+        if (const auto applied = tracker.applied_.attributes.find(key); applied != tracker.applied_.attributes.end() && applied->second == val) {
+            continue;
+        }
+        if (SQL_SUCCEEDED(odbc_helper->BaseSetConnectAttr(dbc->wrapped_dbc, key, val.first, val.second).fn_result)) {
+            tracker.applied_.attributes.insert_or_assign(key, val);
+        } else {
+            LOG(WARNING) << "Error setting connection attribute: " << key;
+        }
+    }
+
+    if (!tracker.HasSettings()) {
+        return;
+    }
+    if (const std::vector<std::string> unknown_defaults = tracker.GetUnknownDefaults(); !unknown_defaults.empty()) {
+        QueryServerDefaults(dbc, tracker, service->GetDialect(), odbc_helper, unknown_defaults);
+    }
+    for (const SessionSetting& setting : tracker.GetPendingSettings()) {
+        if (ExecuteStatement(dbc, odbc_helper, setting.statement)) {
+            LOG(INFO) << "Restored session setting: " << setting.key;
+            tracker.MarkApplied(setting);
+        } else {
+            LOG(WARNING) << "Unable to restore session setting: " << setting.key;
+        }
+    }
+}
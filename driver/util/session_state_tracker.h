@@ -0,0 +1,106 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SESSION_STATE_TRACKER_H_
+#define SESSION_STATE_TRACKER_H_
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <sql.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct DBC;
+
+// A session setting changed through SQL, i.e. SET search_path, USE db or SET SESSION TRANSACTION ISOLATION LEVEL
+struct SessionSetting {
+    // Identifies what the statement sets, a later statement with the same key replaces it
+    std::string key;
+    // Server variable holding the value, empty if it cannot be queried
+    std::string variable;
+    // Normalized value, SessionStateTracker::DEFAULT_VALUE when reset to the server default
+    std::string value;
+    // Replayed as is
+    std::string statement;
+    uint64_t sequence = 0;
+};
+
+// What an underlying connection has applied of the tracked session state
+struct AppliedSessionState {
+    // Absent settings are at the server default
+    std::map<std::string, uint64_t> settings;
+    std::map<SQLINTEGER, std::pair<SQLPOINTER, SQLINTEGER>> attributes;
+};
+
+// Tracks the session state an application configured on its connection, through connection
+// attributes and through SQL, and what the current underlying connection has applied of it.
+// When the underlying connection changes, i.e. failover or a read/write splitting switch,
+// only the difference is replayed. Settings are skipped when a fresh connection's server
+// default already matches, the defaults are queried once and remembered.
+// Not thread safe, guarded by the owning DBC's lock.
+class SessionStateTracker {
+public:
+    static constexpr char DEFAULT_VALUE[] = "DEFAULT";
+    // RESET ALL, DISCARD ALL
+    static constexpr char RESET_ALL_KEY[] = "*";
+
+    // Returns the setting a single statement changes, if any.
+    // Transaction scoped, global, autocommit and read-only settings are not session state tracked here.
+    static std::optional<SessionSetting> ParseStatement(const std::string& statement, const std::string& isolation_variable,
+        bool backslash_escapes = false);
+
+    // Records the settings a successfully executed statement or batch changed on the current connection
+    void TrackStatement(const std::string& statement, const std::string& isolation_variable, bool backslash_escapes = false);
+    // The connection attribute was set on the current connection
+    void TrackAttribute(SQLINTEGER attribute, SQLPOINTER value, SQLINTEGER length);
+    // A fresh connection with the given attributes applied became the current connection
+    void MarkConnected(const std::map<SQLINTEGER, std::pair<SQLPOINTER, SQLINTEGER>>& attributes);
+    // Moves out what the current connection has applied, to be kept with the connection while it is not current
+    AppliedSessionState TakeApplied();
+    // A connection that kept what it has applied became the current connection
+    void RestoreApplied(AppliedSessionState applied);
+
+    // Settings the current connection is missing, in the order they were made
+    std::vector<SessionSetting> GetPendingSettings() const;
+    // Variables whose server default would decide whether a pending setting needs replaying
+    std::vector<std::string> GetUnknownDefaults() const;
+    // Records a fresh connection's value of the variable, nullopt if it could not be read
+    void SetServerDefault(const std::string& variable, const std::optional<std::string>& value);
+    void MarkApplied(const SessionSetting& setting);
+
+    bool HasSettings() const { return !settings_.empty(); }
+
+    // Replays the difference between the tracked state and what the current underlying connection has applied
+    static void Sync(DBC* dbc);
+
+private:
+    // Simulates replaying in sequence order, optionally collecting the server defaults it could not decide on
+    std::vector<SessionSetting> Diff(std::vector<std::string>* unknown_defaults) const;
+
+    // Ordered by key, GetPendingSettings orders by sequence
+    std::map<std::string, SessionSetting> settings_;
+    std::map<std::string, std::optional<std::string>> server_defaults_;
+    uint64_t next_sequence_ = 1;
+
+    // Applied on the current connection
+    AppliedSessionState applied_;
+};
+
+#endif // SESSION_STATE_TRACKER_H_
@@ -15,9 +15,17 @@
 #ifndef SLIDING_CACHE_MAP_H_
 #define SLIDING_CACHE_MAP_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
-#include <map>
+#include <shared_mutex>
+#include <unordered_map>
 
 template <typename V>
 struct CacheEntry {
@@ -26,10 +34,23 @@ struct CacheEntry {
     std::chrono::milliseconds time_to_expire_ms;
 };
 
+// Cache whose entries expire once not accessed for their time to live.
+// Keys are hash partitioned into shards each with their own lock, lookups only take
+// a shared lock and refresh the expiry atomically. Expired entries are removed by a
+// timer wheel per shard, swept as the cache is written to and when its size is read.
 template <typename K, typename V>
 class SlidingCacheMap {
 public:
-    SlidingCacheMap() = default;
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr std::chrono::milliseconds TICK_MS = std::chrono::milliseconds(100);
+    static constexpr size_t WHEEL_SIZE = 256;
+
+    SlidingCacheMap() {
+        const uint64_t now_tick = ToTick(std::chrono::steady_clock::now());
+        for (Shard& shard : shards_) {
+            shard.swept_tick = now_tick;
+        }
+    }
     ~SlidingCacheMap() = default;
 
     void Put(const K& key, const V& value) {
@@ -37,10 +58,11 @@ public:
     };
 
     void Put(const K& key, const V& value, std::chrono::milliseconds ms_ttl) {
-        const std::lock_guard<std::mutex> lock(cache_lock);
-        const std::chrono::steady_clock::time_point expiry_time =
-            std::chrono::steady_clock::now() + ms_ttl;
-        cache[key] = CacheEntry{value, expiry_time, ms_ttl};
+        Shard& shard = GetShard(key);
+        const std::lock_guard<std::shared_mutex> lock(shard.lock);
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        SweepLocked(shard, now);
+        PutLocked(shard, key, std::make_shared<const V>(value), now, ms_ttl);
     }
 
     void PutIfAbsent(const K& key, const V& value) {
@@ -48,83 +70,192 @@ public:
     }
 
     void PutIfAbsent(const K& key, const V& value, std::chrono::milliseconds ms_ttl) {
-        const std::lock_guard<std::mutex> lock(cache_lock);
+        Shard& shard = GetShard(key);
+        const std::lock_guard<std::shared_mutex> lock(shard.lock);
         const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-        if (auto itr = cache.find(key); itr != cache.end()) {
-            CacheEntry<V> & entry = itr->second;
+        SweepLocked(shard, now);
+        if (auto itr = shard.entries.find(key); itr != shard.entries.end()) {
+            Entry& entry = itr->second;
             // Already in cache & is not expired
-            if (entry.expiry > now) {
+            if (entry.expiry.load(std::memory_order_relaxed) > now) {
                 // Update TTL & Return value
-                entry.expiry = now + entry.time_to_expire_ms;
+                entry.expiry.store(now + entry.time_to_expire_ms, std::memory_order_relaxed);
                 return;
             }
         }
         // Either not in cache or is expired, put new into cache
-        const std::chrono::steady_clock::time_point expiry_time =
-            std::chrono::steady_clock::now() + ms_ttl;
-        cache[key] = CacheEntry{value, expiry_time, ms_ttl};
+        PutLocked(shard, key, std::make_shared<const V>(value), now, ms_ttl);
     }
 
     V Get(const K& key) {
-        const std::lock_guard<std::mutex> lock(cache_lock);
-        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-        if (auto itr = cache.find(key); itr != cache.end()) {
-            CacheEntry<V> & entry = itr->second;
-            if (entry.expiry > now) {
-                // Update TTL & Return value
-                entry.expiry = now + entry.time_to_expire_ms;
-                return entry.value;
-            }
-            // Expired, remove from cache
-            cache.erase(itr);
+        // Copied outside of the shard lock
+        if (const std::shared_ptr<const V> value = GetShared(key)) {
+            return *value;
         }
         return {};
     }
 
-    bool Find(const K& key) {
-        const std::lock_guard<std::mutex> lock(cache_lock);
-        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-        if (auto itr = cache.find(key); itr != cache.end()) {
-            CacheEntry<V> & entry = itr->second;
-            if (entry.expiry > now) {
-                // Update TTL & Return found
-                entry.expiry = now + entry.time_to_expire_ms;
-                return true;
-            }
-            // Expired, remove from cache
-            cache.erase(itr);
+    // Returns the cached value without copying it, nullptr when missing or expired
+    std::shared_ptr<const V> GetShared(const K& key) {
+        Shard& shard = GetShard(key);
+        const std::shared_lock<std::shared_mutex> lock(shard.lock);
+        if (Entry* entry = FindLocked(shard, key)) {
+            return entry->value;
         }
-        return false;
+        return nullptr;
+    }
+
+    bool Find(const K& key) {
+        Shard& shard = GetShard(key);
+        const std::shared_lock<std::shared_mutex> lock(shard.lock);
+        return FindLocked(shard, key) != nullptr;
     }
 
     unsigned int Size() {
-        const std::lock_guard<std::mutex> lock(cache_lock);
         const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-        for (auto itr = cache.begin(); itr != cache.end();) {
-            if (itr->second.expiry < now) {
-                itr = cache.erase(itr);
-            } else {
-                ++itr;
+        const uint64_t now_tick = ToTick(now);
+        for (Shard& shard : shards_) {
+            // Shards already swept during this tick are not locked
+            if (shard.swept_tick_hint.load(std::memory_order_relaxed) < now_tick) {
+                const std::lock_guard<std::shared_mutex> lock(shard.lock);
+                SweepLocked(shard, now);
             }
         }
-        return cache.size();
+        return static_cast<unsigned int>(size_.load(std::memory_order_relaxed));
     }
 
     void Clear() {
-        const std::lock_guard<std::mutex> lock(cache_lock);
-        cache.clear();
+        for (Shard& shard : shards_) {
+            const std::lock_guard<std::shared_mutex> lock(shard.lock);
+            size_.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+            shard.entries.clear();
+            for (std::list<Timer>& slot : shard.wheel) {
+                slot.clear();
+            }
+        }
     }
 
     void Delete(const K& key) {
-        const std::lock_guard<std::mutex> lock(cache_lock);
-        cache.erase(key);
+        Shard& shard = GetShard(key);
+        const std::lock_guard<std::shared_mutex> lock(shard.lock);
+        // Its timer is dropped once it expires
+        size_.fetch_sub(shard.entries.erase(key), std::memory_order_relaxed);
     }
 
 private:
+    struct Entry {
+        std::shared_ptr<const V> value;
+        // Refreshed under the shared lock
+        std::atomic<std::chrono::steady_clock::time_point> expiry;
+        std::chrono::milliseconds time_to_expire_ms;
+        // Timers armed for another tick are stale
+        uint64_t armed_tick = 0;
+    };
+
+    struct Timer {
+        K key;
+        uint64_t tick;
+    };
+
+    struct Shard {
+        std::shared_mutex lock;
+        std::unordered_map<K, Entry> entries;
+        std::array<std::list<Timer>, WHEEL_SIZE> wheel;
+        uint64_t swept_tick = 0;
+        // Copy of swept_tick read without the lock
+        std::atomic<uint64_t> swept_tick_hint = 0;
+    };
+
+    static uint64_t ToTick(const std::chrono::steady_clock::time_point time) {
+        return static_cast<uint64_t>(std::max<std::chrono::steady_clock::rep>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) / TICK_MS, 0));
+    }
+
+    // Rounded up and always past the current tick, an entry is never swept before it expires
+    static uint64_t ToExpiryTick(const std::chrono::steady_clock::time_point expiry) {
+        return ToTick(expiry + TICK_MS - std::chrono::milliseconds(1)) + 1;
+    }
+
+    Shard& GetShard(const K& key) {
+        return shards_[std::hash<K>{}(key) % SHARD_COUNT];
+    }
+
+    // Caller must hold the shard lock, shared or exclusive
+    static Entry* FindLocked(Shard& shard, const K& key) {
+        const auto itr = shard.entries.find(key);
+        if (itr == shard.entries.end()) {
+            return nullptr;
+        }
+        Entry& entry = itr->second;
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (entry.expiry.load(std::memory_order_relaxed) <= now) {
+            // Expired, removed by the next sweep
+            return nullptr;
+        }
+        // Update TTL
+        entry.expiry.store(now + entry.time_to_expire_ms, std::memory_order_relaxed);
+        return &entry;
+    }
+
+    // Caller must hold the shard lock exclusively
+    void PutLocked(Shard& shard, const K& key, std::shared_ptr<const V> value,
+        const std::chrono::steady_clock::time_point now, const std::chrono::milliseconds ms_ttl) {
+        auto [itr, inserted] = shard.entries.try_emplace(key);
+        if (inserted) {
+            size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        Entry& entry = itr->second;
+        entry.value = std::move(value);
+        entry.time_to_expire_ms = ms_ttl;
+        entry.expiry.store(now + ms_ttl, std::memory_order_relaxed);
+        ArmLocked(shard, key, entry);
+    }
+
+    static void ArmLocked(Shard& shard, const K& key, Entry& entry) {
+        entry.armed_tick = ToExpiryTick(entry.expiry.load(std::memory_order_relaxed));
+        shard.wheel[entry.armed_tick % WHEEL_SIZE].push_back(Timer{ key, entry.armed_tick });
+    }
+
+    // Caller must hold the shard lock exclusively
+    void SweepLocked(Shard& shard, const std::chrono::steady_clock::time_point now) {
+        const uint64_t now_tick = ToTick(now);
+        if (now_tick <= shard.swept_tick) {
+            return;
+        }
+
+        // Every slot is visited once when more than a full turn has passed
+        const uint64_t slot_count = std::min<uint64_t>(now_tick - shard.swept_tick, WHEEL_SIZE);
+        for (uint64_t i = 1; i <= slot_count; i++) {
+            std::list<Timer>& slot = shard.wheel[(shard.swept_tick + i) % WHEEL_SIZE];
+            for (auto timer = slot.begin(); timer != slot.end();) {
+                if (timer->tick > now_tick) {
+                    // Armed for a later turn of the wheel
+                    ++timer;
+                    continue;
+                }
+
+                const auto itr = shard.entries.find(timer->key);
+                if (itr != shard.entries.end() && itr->second.armed_tick == timer->tick) {
+                    Entry& entry = itr->second;
+                    if (entry.expiry.load(std::memory_order_relaxed) <= now) {
+                        shard.entries.erase(itr);
+                        size_.fetch_sub(1, std::memory_order_relaxed);
+                    } else {
+                        // Accessed since it was armed, lands in a later tick
+                        ArmLocked(shard, timer->key, entry);
+                    }
+                }
+                timer = slot.erase(timer);
+            }
+        }
+        shard.swept_tick = now_tick;
+        shard.swept_tick_hint.store(now_tick, std::memory_order_relaxed);
+    }
+
     static inline const std::chrono::milliseconds
         DEFAULT_EXPIRATION_MS = std::chrono::minutes(15);
-    std::map<K, CacheEntry<V>> cache;
-    mutable std::mutex cache_lock;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> size_ = 0;
 };
 
 #endif // SLIDING_CACHE_MAP_H_
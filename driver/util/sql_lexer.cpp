@@ -0,0 +1,200 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sql_lexer.h"
+
+namespace {
+    bool IsAsciiAlpha(const char c) {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+
+    bool IsAsciiDigit(const char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    bool IsSpace(const char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // Non-ASCII bytes are treated as identifier characters so UTF-8 names stay a single word
+    bool IsWordStart(const char c) {
+        return IsAsciiAlpha(c) || c == '_' || c == '@' || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    bool IsWordPart(const char c) {
+        return IsWordStart(c) || IsAsciiDigit(c) || c == '$';
+    }
+
+    char ToUpperAscii(const char c) {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+    }
+}  // namespace
+
+bool SqlToken::Equals(std::string_view value) const {
+    if (text.size() != value.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); i++) {
+        if (ToUpperAscii(text[i]) != ToUpperAscii(value[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SqlStatementHead::StartsWith(std::string_view sequence) const {
+    size_t matched = 0;
+    size_t pos = 0;
+    while (pos < sequence.size()) {
+        if (sequence[pos] == ' ') {
+            pos++;
+            continue;
+        }
+        size_t end = sequence.find(' ', pos);
+        if (end == std::string_view::npos) {
+            end = sequence.size();
+        }
+        if (matched >= count || !tokens[matched].Equals(sequence.substr(pos, end - pos))) {
+            return false;
+        }
+        matched++;
+        pos = end;
+    }
+    return matched > 0;
+}
+
+SqlLexer::SqlLexer(std::string_view sql, const bool backslash_escapes)
+    : sql_(sql), backslash_escapes_(backslash_escapes) {}
+
+SqlToken SqlLexer::Next() {
+    SqlToken token;
+    token.preceded_by_space = SkipSpaceAndComments();
+    if (pos_ >= sql_.size()) {
+        token.type = TOKEN_END;
+        return token;
+    }
+
+    const size_t start = pos_;
+    const char c = sql_[pos_];
+    size_t dollar_end = std::string_view::npos;
+    if (c == ';') {
+        token.type = TOKEN_SEMICOLON;
+        pos_++;
+    } else if (c == '\'') {
+        token.type = TOKEN_STRING;
+        pos_ = ScanQuoted(start, c, backslash_escapes_);
+    } else if ((c == 'E' || c == 'e') && pos_ + 1 < sql_.size() && sql_[pos_ + 1] == '\'') {
+        // PostgreSQL escape string
+        token.type = TOKEN_STRING;
+        pos_ = ScanQuoted(start + 1, '\'', true);
+    } else if (c == '"' || c == '`') {
+        token.type = TOKEN_QUOTED_IDENTIFIER;
+        pos_ = ScanQuoted(start, c, false);
+    } else if (c == '$' && (dollar_end = ScanDollarQuoted(start)) != std::string_view::npos) {
+        token.type = TOKEN_STRING;
+        pos_ = dollar_end;
+    } else if (IsWordStart(c)) {
+        token.type = TOKEN_WORD;
+        while (pos_ < sql_.size() && IsWordPart(sql_[pos_])) {
+            pos_++;
+        }
+    } else if (IsAsciiDigit(c)) {
+        token.type = TOKEN_NUMBER;
+        while (pos_ < sql_.size() && (IsAsciiDigit(sql_[pos_]) || IsAsciiAlpha(sql_[pos_]) || sql_[pos_] == '.')) {
+            pos_++;
+        }
+    } else {
+        token.type = TOKEN_OPERATOR;
+        pos_++;
+    }
+    token.text = sql_.substr(start, pos_ - start);
+    return token;
+}
+
+bool SqlLexer::NextStatement(SqlStatementHead& head) {
+    head.count = 0;
+    while (true) {
+        const SqlToken token = Next();
+        if (token.type == TOKEN_END) {
+            return !head.Empty();
+        }
+        if (token.type == TOKEN_SEMICOLON) {
+            if (!head.Empty()) {
+                return true;
+            }
+            continue;
+        }
+        if (head.count < SqlStatementHead::MAX_TOKENS) {
+            head.tokens[head.count++] = token;
+        }
+    }
+}
+
+bool SqlLexer::SkipSpaceAndComments() {
+    const size_t start = pos_;
+    while (pos_ < sql_.size()) {
+        if (IsSpace(sql_[pos_])) {
+            pos_++;
+        } else if (sql_.compare(pos_, 2, "/*") == 0) {
+            const size_t end = sql_.find("*/", pos_ + 2);
+            pos_ = end == std::string_view::npos ? sql_.size() : end + 2;
+        } else if (sql_.compare(pos_, 2, "--") == 0) {
+            const size_t end = sql_.find('\n', pos_ + 2);
+            pos_ = end == std::string_view::npos ? sql_.size() : end + 1;
+        } else {
+            break;
+        }
+    }
+    return pos_ != start;
+}
+
+// Returns the position after the closing quote, or the end of input if unterminated.
+// A doubled quote character is an escaped quote, i.e. 'it''s'.
+size_t SqlLexer::ScanQuoted(const size_t start, const char quote, const bool backslash_escapes) const {
+    size_t i = start + 1;
+    while (i < sql_.size()) {
+        const char c = sql_[i];
+        if (backslash_escapes && c == '\\') {
+            i += 2;
+            continue;
+        }
+        if (c == quote) {
+            if (i + 1 < sql_.size() && sql_[i + 1] == quote) {
+                i += 2;
+                continue;
+            }
+            return i + 1;
+        }
+        i++;
+    }
+    return sql_.size();
+}
+
+// PostgreSQL dollar quoting, $$...$$ or $tag$...$tag$.
+// Returns npos if the '$' at start does not open a dollar quote, i.e. a $1 parameter.
+size_t SqlLexer::ScanDollarQuoted(const size_t start) const {
+    size_t tag_end = start + 1;
+    if (tag_end < sql_.size() && (IsAsciiAlpha(sql_[tag_end]) || sql_[tag_end] == '_')) {
+        while (tag_end < sql_.size() && (IsAsciiAlpha(sql_[tag_end]) || IsAsciiDigit(sql_[tag_end]) || sql_[tag_end] == '_')) {
+            tag_end++;
+        }
+    }
+    if (tag_end >= sql_.size() || sql_[tag_end] != '$') {
+        return std::string_view::npos;
+    }
+
+    const std::string_view delimiter = sql_.substr(start, tag_end - start + 1);
+    const size_t close = sql_.find(delimiter, tag_end + 1);
+    return close == std::string_view::npos ? sql_.size() : close + delimiter.size();
+}
@@ -0,0 +1,85 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SQL_LEXER_H_
+#define SQL_LEXER_H_
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+typedef enum {
+    TOKEN_WORD,                 // Keyword, identifier or variable, i.e. SELECT, my_table, @@autocommit
+    TOKEN_NUMBER,
+    TOKEN_STRING,               // '...', E'...' or $tag$...$tag$, quotes and prefix included
+    TOKEN_QUOTED_IDENTIFIER,    // "..." or `...`, quotes included
+    TOKEN_OPERATOR,             // Any other single character, i.e. = ( , .
+    TOKEN_SEMICOLON,
+    TOKEN_END
+} SQL_TOKEN_TYPE;
+
+struct SqlToken {
+    SQL_TOKEN_TYPE type = TOKEN_END;
+    // View into the lexed text, valid as long as the source text is
+    std::string_view text;
+    // Whitespace or a comment separated this token from the previous one
+    bool preceded_by_space = false;
+
+    // ASCII case-insensitive comparison of the token text
+    bool Equals(std::string_view value) const;
+};
+
+// Leading tokens of a single statement
+struct SqlStatementHead {
+    static constexpr size_t MAX_TOKENS = 12;
+
+    std::array<SqlToken, MAX_TOKENS> tokens;
+    size_t count = 0;
+
+    bool Empty() const { return count == 0; }
+
+    // Returns true if the statement begins with the space separated token sequence,
+    // i.e. "SET SESSION TRANSACTION READ ONLY". An empty sequence never matches.
+    bool StartsWith(std::string_view sequence) const;
+};
+
+// Single pass, non-allocating SQL tokenizer.
+// Skips whitespace, block comments (/* */) and line comments (--),
+// and keeps string literals, quoted identifiers and PostgreSQL dollar quoted
+// bodies as single tokens so their contents never affect statement splitting.
+// A backslash only escapes the next character inside E'...' strings, unless the
+// dialect treats every string that way (MySQL).
+class SqlLexer {
+public:
+    explicit SqlLexer(std::string_view sql, bool backslash_escapes = false);
+
+    SqlToken Next();
+
+    // Advances to the next non-empty statement and captures its leading tokens.
+    // The remainder of the statement is consumed up to and including the ';'.
+    // Returns false once the input is exhausted.
+    bool NextStatement(SqlStatementHead& head);
+
+private:
+    // Returns true if any whitespace or comment was skipped
+    bool SkipSpaceAndComments();
+    size_t ScanQuoted(size_t start, char quote, bool backslash_escapes) const;
+    size_t ScanDollarQuoted(size_t start) const;
+
+    std::string_view sql_;
+    const bool backslash_escapes_;
+    size_t pos_ = 0;
+};
+
+#endif // SQL_LEXER_H_
@@ -15,133 +15,297 @@
 #include "sql_query_analyzer.h"
 
 #include "rds_strings.h"
+#include "sql_lexer.h"
 
-std::string SqlQueryAnalyzer::GetFirstSqlStatement(const std::string &statement)
+namespace {
+    SqlStatementHead GetFirstStatementHead(const std::string &statement)
+    {
+        SqlStatementHead head;
+        SqlLexer lexer(statement);
+        lexer.NextStatement(head);
+        return head;
+    }
+
+    bool IsHeadStartingTransaction(const SqlStatementHead &head)
+    {
+        return head.StartsWith("BEGIN")
+            || head.StartsWith("START TRANSACTION")
+            || head.StartsWith("SET AUTOCOMMIT = 0");
+    }
+
+    bool IsHeadClosingTransaction(const SqlStatementHead &head)
+    {
+        return head.StartsWith("COMMIT")
+            || head.StartsWith("ROLLBACK")
+            || head.StartsWith("END")
+            || head.StartsWith("ABORT");
+    }
+
+    bool IsHeadSettingAutoCommit(const SqlStatementHead &head)
+    {
+        return head.StartsWith("SET AUTOCOMMIT");
+    }
+
+    // SET AUTOCOMMIT { = | TO } { 1 | ON | TRUE | '1' | 'ON' | 'TRUE' }
+    bool GetHeadAutoCommitValue(const SqlStatementHead &head)
+    {
+        if (!IsHeadSettingAutoCommit(head) || head.count < 4) {
+            return false;
+        }
+        if (const SqlToken &separator = head.tokens[2]; !separator.Equals("=") && !separator.Equals("TO")) {
+            return false;
+        }
+
+        SqlToken value = head.tokens[3];
+        if (value.type == TOKEN_STRING && value.text.size() >= 2 && value.text.front() == '\'') {
+            value.text = value.text.substr(1, value.text.size() - 2);
+        }
+        return value.Equals("1") || value.Equals("ON") || value.Equals("TRUE");
+    }
+
+    SqlClassification ClassifyHead(const SqlStatementHead &head, const std::shared_ptr<Dialect> &dialect)
+    {
+        uint16_t flags = SQL_CLASS_VALID;
+        if (IsHeadStartingTransaction(head)) {
+            flags |= SQL_CLASS_OPENS_TRANSACTION;
+        }
+        if (IsHeadClosingTransaction(head)) {
+            flags |= SQL_CLASS_CLOSES_TRANSACTION;
+        }
+        if (head.StartsWith("SELECT")) {
+            flags |= SQL_CLASS_SELECT;
+        }
+        if (head.StartsWith("SET") || head.StartsWith("RESET") || head.StartsWith("DISCARD") || head.StartsWith("USE")) {
+            flags |= SQL_CLASS_SETS_SESSION_STATE;
+        }
+        if (IsHeadSettingAutoCommit(head)) {
+            flags |= SQL_CLASS_SETS_AUTOCOMMIT;
+            if (GetHeadAutoCommitValue(head)) {
+                flags |= SQL_CLASS_AUTOCOMMIT_ON;
+            }
+        }
+        if (dialect) {
+            if (const std::optional<bool> read_only = dialect->DoesStatementSetReadOnly(head); read_only.has_value()) {
+                flags |= read_only.value() ? SQL_CLASS_SETS_READ_ONLY : SQL_CLASS_SETS_READ_WRITE;
+            }
+        }
+        return SqlClassification{flags};
+    }
+
+    // Folds statements in execution order into the state the batch leaves the connection in
+    class NetEffect {
+    public:
+        void Add(const SqlClassification &statement)
+        {
+            // A batch only counts as a SELECT if every statement is one, a single write has to reach the writer
+            all_select_ = all_select_ && statement.Has(SQL_CLASS_SELECT);
+            count_++;
+            if (statement.MayChangeSessionState()) {
+                flags_ |= SQL_CLASS_SETS_SESSION_STATE;
+            }
+
+            if (statement.IsSettingAutoCommit()) {
+                if (statement.GetAutoCommitValue()) {
+                    // Turning autocommit on commits an open transaction. Whether one is open is only known
+                    // if the batch itself opened it or turned autocommit off, otherwise it depends on the
+                    // connection and is left to SqlClassification::DoesCloseTransaction
+                    if (transaction_open_ == true || auto_commit_ == false) {
+                        transaction_open_ = false;
+                    }
+                } else if (statement.DoesOpenTransaction()) {
+                    transaction_open_ = true;
+                }
+                auto_commit_ = statement.GetAutoCommitValue();
+            } else if (statement.DoesOpenTransaction()) {
+                transaction_open_ = true;
+            } else if (statement.Has(SQL_CLASS_CLOSES_TRANSACTION)) {
+                transaction_open_ = false;
+            }
+
+            if (const std::optional<bool> read_only = statement.DoesSetReadOnly(); read_only.has_value()) {
+                read_only_ = read_only;
+            }
+        }
+
+        SqlClassification Get() const
+        {
+            uint16_t flags = flags_;
+            if (count_ > 0 && all_select_) {
+                flags |= SQL_CLASS_SELECT;
+            }
+            if (transaction_open_.has_value()) {
+                flags |= transaction_open_.value() ? SQL_CLASS_OPENS_TRANSACTION : SQL_CLASS_CLOSES_TRANSACTION;
+            }
+            if (auto_commit_.has_value()) {
+                flags |= SQL_CLASS_SETS_AUTOCOMMIT;
+                if (auto_commit_.value()) {
+                    flags |= SQL_CLASS_AUTOCOMMIT_ON;
+                }
+            }
+            if (read_only_.has_value()) {
+                flags |= read_only_.value() ? SQL_CLASS_SETS_READ_ONLY : SQL_CLASS_SETS_READ_WRITE;
+            }
+            return SqlClassification{flags};
+        }
+
+    private:
+        uint16_t flags_ = SQL_CLASS_VALID;
+        size_t count_ = 0;
+        bool all_select_ = true;
+        std::optional<bool> transaction_open_;
+        std::optional<bool> auto_commit_;
+        std::optional<bool> read_only_;
+    };
+
+    // Rebuilds the statement text without comments, separating tokens by a single space
+    // wherever the original had whitespace or a comment between them
+    bool NextCanonicalStatement(SqlLexer &lexer, std::string &out)
+    {
+        out.clear();
+        while (true) {
+            const SqlToken token = lexer.Next();
+            if (token.type == TOKEN_END) {
+                return !out.empty();
+            }
+            if (token.type == TOKEN_SEMICOLON) {
+                if (!out.empty()) {
+                    return true;
+                }
+                continue;
+            }
+            if (token.preceded_by_space && !out.empty()) {
+                out.push_back(' ');
+            }
+            out.append(token.text);
+        }
+    }
+}  // namespace
+
+SqlClassification SqlQueryAnalyzer::Classify(const std::string &statement, const std::shared_ptr<Dialect> &dialect)
 {
-    std::vector<std::string> query_list = ParseMultiStatement(statement);
-    if (query_list.empty()) {
-        return statement;
-    }
-    const std::string& first_statement = query_list.front();
-    std::string first_statement_upper = RDS_STR_UPPER(first_statement);
-    // Remove spaces and comments (/* */)
-    const std::regex space_comment_pattern(R"(\s*/\*(.*?)\*/\s*)");
-    first_statement_upper = std::regex_replace(first_statement_upper, space_comment_pattern, " ");
-    first_statement_upper = TrimStr(first_statement_upper);
-
-    return first_statement_upper;
+    if (statement.size() > MAX_CACHED_STATEMENT_LENGTH) {
+        return ClassifyUncached(statement, dialect);
+    }
+
+    // Read-only detection depends on the dialect, so its type is part of the key
+    const uint64_t dialect_salt = dialect ? static_cast<uint64_t>(dialect->GetDialectType()) + 1 : 0;
+    const uint64_t hash = std::hash<std::string_view>{}(statement) ^ (dialect_salt * 0x9E3779B97F4A7C15ULL);
+    const size_t slot = hash % CLASSIFICATION_CACHE_SIZE;
+    std::mutex &slot_lock = classification_cache_locks_[slot % CLASSIFICATION_CACHE_LOCKS];
+
+    std::shared_ptr<const ClassificationCacheEntry> entry;
+    {
+        const std::lock_guard<std::mutex> lock_guard(slot_lock);
+        entry = classification_cache_[slot];
+    }
+    // A hash match alone could return another statement's flags and misroute it
+    if (entry && entry->dialect_salt == dialect_salt && entry->statement == statement) {
+        return entry->classification;
+    }
+
+    const SqlClassification classification = ClassifyUncached(statement, dialect);
+    entry = std::make_shared<const ClassificationCacheEntry>(ClassificationCacheEntry{dialect_salt, statement, classification});
+    {
+        const std::lock_guard<std::mutex> lock_guard(slot_lock);
+        classification_cache_[slot] = std::move(entry);
+    }
+    return classification;
 }
 
-std::vector<std::string> SqlQueryAnalyzer::ParseMultiStatement(const std::string &statement)
+void SqlQueryAnalyzer::ClearClassificationCache()
 {
-    std::string local_statement(statement);
-    if (local_statement.empty()) {
-        return {};
+    for (size_t slot = 0; slot < CLASSIFICATION_CACHE_SIZE; slot++) {
+        const std::lock_guard<std::mutex> lock_guard(classification_cache_locks_[slot % CLASSIFICATION_CACHE_LOCKS]);
+        classification_cache_[slot].reset();
     }
+}
 
-    local_statement = TrimStr(local_statement);
-    if (local_statement.empty()) {
-        return {};
+std::vector<SqlClassification> SqlQueryAnalyzer::ClassifyBatch(const std::string &statement, const std::shared_ptr<Dialect> &dialect)
+{
+    std::vector<SqlClassification> statements;
+    SqlLexer lexer(statement, dialect && dialect->UsesBackslashEscapes());
+    SqlStatementHead head;
+    while (lexer.NextStatement(head)) {
+        statements.push_back(ClassifyHead(head, dialect));
     }
+    return statements;
+}
 
-    // Remove comments
-    const std::regex comment(R"(\s*/\*(.*?)\*/\s*)");
-    local_statement = std::regex_replace(local_statement, comment, " ");
+SqlClassification SqlQueryAnalyzer::GetNetEffect(const std::vector<SqlClassification> &statements)
+{
+    NetEffect net_effect;
+    for (const SqlClassification &classification : statements) {
+        net_effect.Add(classification);
+    }
+    return net_effect.Get();
+}
 
-    // Remove spaces
-    local_statement = std::regex_replace(local_statement, std::regex(" +"), " ");
+SqlClassification SqlQueryAnalyzer::ClassifyUncached(const std::string &statement, const std::shared_ptr<Dialect> &dialect)
+{
+    NetEffect net_effect;
+    SqlLexer lexer(statement, dialect && dialect->UsesBackslashEscapes());
+    SqlStatementHead head;
+    while (lexer.NextStatement(head)) {
+        net_effect.Add(ClassifyHead(head, dialect));
+    }
+    return net_effect.Get();
+}
 
-    std::string delimiter = ";";
-    std::vector<std::string> stmts = SplitStr(local_statement, delimiter);
+std::string SqlQueryAnalyzer::GetFirstSqlStatement(const std::string &statement)
+{
+    SqlLexer lexer(statement);
+    std::string first_statement;
+    NextCanonicalStatement(lexer, first_statement);
+    return RDS_STR_UPPER(first_statement);
+}
 
-    for (auto & stmt : stmts) {
-        stmt = TrimStr(stmt);
+std::vector<std::string> SqlQueryAnalyzer::ParseMultiStatement(const std::string &statement)
+{
+    std::vector<std::string> stmts;
+    SqlLexer lexer(statement);
+    std::string stmt;
+    while (NextCanonicalStatement(lexer, stmt)) {
+        stmts.push_back(stmt);
     }
-
     return stmts;
 }
 
 bool SqlQueryAnalyzer::DoesOpenTransaction(const std::string &statement)
 {
-    const std::string first_statement = GetFirstSqlStatement(statement);
-    return IsStatementStartingTransaction(first_statement);
+    return Classify(statement).DoesOpenTransaction();
 }
 
 bool SqlQueryAnalyzer::DoesCloseTransaction(DBC* dbc, const std::string &statement)
 {
-    if (DoesSwitchAutoCommitFalseTrue(dbc, statement)) {
-        return true;
-    }
-
-    const std::string first_statement = GetFirstSqlStatement(statement);
-    return IsStatementClosingTransaction(first_statement);
+    return Classify(statement).DoesCloseTransaction(dbc->auto_commit);
 }
 
 bool SqlQueryAnalyzer::IsStatementStartingTransaction(const std::string &statement)
 {
-    return statement.starts_with("BEGIN")
-        || statement.starts_with("START TRANSACTION")
-        || statement.starts_with("SET AUTOCOMMIT = 0");
+    return IsHeadStartingTransaction(GetFirstStatementHead(statement));
 }
 
 bool SqlQueryAnalyzer::IsStatementClosingTransaction(const std::string &statement)
 {
-    return statement.starts_with("COMMIT")
-        || statement.starts_with("ROLLBACK")
-        || statement.starts_with("END")
-        || statement.starts_with("ABORT");
+    return IsHeadClosingTransaction(GetFirstStatementHead(statement));
 }
 
 bool SqlQueryAnalyzer::IsStatementSettingAutoCommit(const std::string &statement)
 {
-    const std::string first_statement = GetFirstSqlStatement(statement);
-    return std::string::npos != first_statement.find("SET AUTOCOMMIT");
+    return Classify(statement).IsSettingAutoCommit();
 }
 
 bool SqlQueryAnalyzer::DoesSwitchAutoCommitFalseTrue(DBC* dbc, const std::string &statement)
 {
-    const bool last_auto_commit = dbc->auto_commit;
-    const bool new_auto_commit = IsStatementSettingAutoCommit(statement)
-        ? GetAutoCommitValueFromSqlStatement(statement) : false;
-    return !last_auto_commit && new_auto_commit;
+    return !dbc->auto_commit && Classify(statement).GetAutoCommitValue();
 }
 
 bool SqlQueryAnalyzer::GetAutoCommitValueFromSqlStatement(const std::string &statement)
 {
-    std::string first_statement = GetFirstSqlStatement(statement);
-    size_t separator_index = first_statement.find('=');
-    size_t value_index;
-    if (std::string::npos != separator_index) {
-        value_index = separator_index + 1;
-    } else {
-        separator_index = first_statement.find(" TO ");
-        if (std::string::npos == separator_index) {
-            return false;
-        }
-        value_index = separator_index + 1;
-    }
-
-    first_statement = first_statement.substr(value_index);
-    separator_index = first_statement.find(';');
-    if (std::string::npos != separator_index) {
-        first_statement = first_statement.substr(separator_index);
-    }
-
-    first_statement = TrimStr(first_statement);
-    return
-        std::string::npos != first_statement.find("TRUE")
-        || std::string::npos != first_statement.find('1')
-        || std::string::npos != first_statement.find("ON");
+    return Classify(statement).GetAutoCommitValue();
 }
 
 std::optional<bool> SqlQueryAnalyzer::DoesSetReadOnly(const std::string &statement, std::shared_ptr<Dialect> dialect)
 {
-    const std::vector<std::string> statements = ParseMultiStatement(statement);
-    std::optional<bool> does_set_read_only = {};
-    for (const std::string &stmt : statements) {
-        if (const std::optional<bool> ret = dialect->DoesStatementSetReadOnly(RDS_STR_UPPER(stmt)); ret.has_value()) {
-            does_set_read_only = ret;
-        }
-    }
-    return does_set_read_only;
+    return Classify(statement, dialect).DoesSetReadOnly();
 }
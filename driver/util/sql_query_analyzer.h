@@ -15,14 +15,70 @@
 #ifndef SQL_QUERY_ANALYZER_H_
 #define SQL_QUERY_ANALYZER_H_
 
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "rds_strings.h"
 #include "../dialect/dialect.h"
 #include "../driver.h"
 
+// For a single statement the flags describe that statement, for a batch (see SqlQueryAnalyzer::GetNetEffect)
+// they describe the state the whole batch leaves the connection in
+typedef enum {
+    SQL_CLASS_OPENS_TRANSACTION     = 1 << 0,   // BEGIN, START TRANSACTION, SET AUTOCOMMIT = 0
+    SQL_CLASS_CLOSES_TRANSACTION    = 1 << 1,   // COMMIT, ROLLBACK, END, ABORT
+    SQL_CLASS_SETS_AUTOCOMMIT       = 1 << 2,
+    SQL_CLASS_AUTOCOMMIT_ON         = 1 << 3,
+    SQL_CLASS_SETS_READ_ONLY        = 1 << 4,   // Exclusive with SETS_READ_WRITE
+    SQL_CLASS_SETS_READ_WRITE       = 1 << 5,
+    SQL_CLASS_SELECT                = 1 << 6,   // For a batch, every statement is a SELECT
+    SQL_CLASS_SETS_SESSION_STATE    = 1 << 7,   // SET, RESET, DISCARD or USE, see SessionStateTracker
+    SQL_CLASS_VALID                 = 1 << 15   // Set on every classified statement
+} SQL_CLASSIFICATION_FLAG;
+
+// Compact result of classifying a statement once, see SqlQueryAnalyzer::Classify
+struct SqlClassification {
+    uint16_t flags = 0;
+
+    bool Has(SQL_CLASSIFICATION_FLAG flag) const { return (flags & flag) != 0; }
+    bool DoesOpenTransaction() const { return Has(SQL_CLASS_OPENS_TRANSACTION); }
+    // Setting autocommit on while in manual commit mode also closes the transaction
+    bool DoesCloseTransaction(bool auto_commit) const {
+        return Has(SQL_CLASS_CLOSES_TRANSACTION)
+            || (!auto_commit && Has(SQL_CLASS_AUTOCOMMIT_ON) && !Has(SQL_CLASS_OPENS_TRANSACTION));
+    }
+    bool IsSettingAutoCommit() const { return Has(SQL_CLASS_SETS_AUTOCOMMIT); }
+    bool MayChangeSessionState() const { return Has(SQL_CLASS_SETS_SESSION_STATE); }
+    bool GetAutoCommitValue() const { return Has(SQL_CLASS_AUTOCOMMIT_ON); }
+    std::optional<bool> DoesSetReadOnly() const {
+        if (Has(SQL_CLASS_SETS_READ_ONLY)) {
+            return true;
+        }
+        if (Has(SQL_CLASS_SETS_READ_WRITE)) {
+            return false;
+        }
+        return {};
+    }
+};
+
 class SqlQueryAnalyzer {
 public:
+    // Classifies the statement once per distinct text and dialect type, caching the result process-wide.
+    // The result is the net effect of every statement in the batch.
+    // Read-only changes are only detected when a dialect is given.
+    static SqlClassification Classify(const std::string& statement, const std::shared_ptr<Dialect>& dialect = nullptr);
+    static void ClearClassificationCache();
+    // One entry per non-empty statement of the batch, uncached
+    static std::vector<SqlClassification> ClassifyBatch(const std::string& statement,
+                                                        const std::shared_ptr<Dialect>& dialect = nullptr);
+    // Folds per statement classifications into the state the batch leaves the connection in,
+    // i.e. SET AUTOCOMMIT = 0; UPDATE ...; COMMIT closes the transaction it opened
+    static SqlClassification GetNetEffect(const std::vector<SqlClassification>& statements);
+
     static std::string GetFirstSqlStatement(const std::string& statement);
     static std::vector<std::string> ParseMultiStatement(const std::string& statement);
     static bool DoesOpenTransaction(const std::string& statement);
@@ -34,6 +90,25 @@ public:
     static bool GetAutoCommitValueFromSqlStatement(const std::string& statement);
     static std::optional<bool> DoesSetReadOnly(const std::string &statement,
                                                std::shared_ptr<Dialect> dialect);
+
+private:
+    // Entries keep the statement text, two statements with the same hash only evict each other
+    struct ClassificationCacheEntry {
+        uint64_t dialect_salt;
+        std::string statement;
+        SqlClassification classification;
+    };
+
+    // Direct mapped by the hash of the statement and dialect type
+    static constexpr size_t CLASSIFICATION_CACHE_SIZE = 4096;
+    // Slots are guarded by striped locks, held only to copy or replace an entry
+    static constexpr size_t CLASSIFICATION_CACHE_LOCKS = 64;
+    // Longer statements are usually unique (bulk inserts, generated SQL) and are classified without caching
+    static constexpr size_t MAX_CACHED_STATEMENT_LENGTH = 4096;
+    static inline std::array<std::shared_ptr<const ClassificationCacheEntry>, CLASSIFICATION_CACHE_SIZE> classification_cache_{};
+    static inline std::array<std::mutex, CLASSIFICATION_CACHE_LOCKS> classification_cache_locks_{};
+
+    static SqlClassification ClassifyUncached(const std::string& statement, const std::shared_ptr<Dialect>& dialect);
 };
 
 #endif // SQL_QUERY_ANALYZER_H_
@@ -0,0 +1,310 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "underlying_connection_pool.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <utility>
+
+#include "../host_list_providers/host_list_provider.h"
+
+#include "connection_string_helper.h"
+#include "connection_string_keys.h"
+#include "logger_wrapper.h"
+#include "map_utils.h"
+#include "odbc_helper.h"
+
+ConnectionPoolConfig ConnectionPoolConfig::FromConnAttr(const std::map<std::string, std::string>& conn_attr) {
+    ConnectionPoolConfig config;
+    config.enabled = MapUtils::GetBooleanValue(conn_attr, KEY_ENABLE_CONNECTION_POOL, false);
+    const int max_idle = MapUtils::GetIntValue(conn_attr, KEY_POOL_MAX_IDLE_PER_HOST, DEFAULT_MAX_IDLE_PER_HOST);
+    config.max_idle_per_host = max_idle > 0 ? static_cast<size_t>(max_idle) : 0;
+    config.idle_timeout = MapUtils::GetMillisecondsValue(conn_attr, KEY_POOL_IDLE_TIMEOUT_MS, DEFAULT_IDLE_TIMEOUT_MS);
+    config.validation_freshness = MapUtils::GetMillisecondsValue(
+        conn_attr, KEY_VALIDATION_FRESHNESS_MS, OdbcHelper::DEFAULT_VALIDATION_FRESHNESS_MS);
+    return config;
+}
+
+UnderlyingConnectionPool::UnderlyingConnectionPool(std::shared_ptr<MonitoringScheduler> scheduler)
+    : scheduler_(std::move(scheduler)) {}
+
+UnderlyingConnectionPool::~UnderlyingConnectionPool() {
+    MonitoringScheduler::TaskId task_id = 0;
+    {
+        const std::lock_guard<std::mutex> lock_guard(lock_);
+        task_id = std::exchange(eviction_task_, 0);
+    }
+    // Waits for an eviction in progress, it uses the pool
+    if (task_id != 0) {
+        scheduler_->Cancel(task_id);
+    }
+}
+
+std::string UnderlyingConnectionPool::BuildPoolKey(const ENV* env, const std::map<std::string, std::string>& conn_attr) {
+    // Connections are only shared between identical connection strings, credentials and base driver options included.
+    // The string is hashed so the key does not hold the password.
+    const std::string conn_str = ConnectionStringHelper::BuildMinimumConnectionString(conn_attr);
+    std::ostringstream key;
+    key << static_cast<const void*>(env)
+        << '|' << MapUtils::GetStringValue(conn_attr, KEY_BASE_DRIVER, "")
+        << '|' << MapUtils::GetStringValue(conn_attr, KEY_BASE_DSN, "")
+        << '|' << MapUtils::GetStringValue(conn_attr, KEY_SERVER, "")
+        << '|' << std::hex << std::hash<std::string>{}(conn_str);
+    return key.str();
+}
+
+SQLHDBC UnderlyingConnectionPool::Borrow(const std::string& key) {
+    std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>> to_close;
+    SQLHDBC borrowed = SQL_NULL_HDBC;
+    while (borrowed == SQL_NULL_HDBC) {
+        IdleConnection candidate{};
+        std::shared_ptr<OdbcHelper> odbc_helper;
+        bool fresh = false;
+        {
+            const std::lock_guard<std::mutex> lock_guard(lock_);
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            CollectExpired(now, to_close);
+            const auto it = pools_.find(key);
+            if (it == pools_.end() || it->second.idle.empty()) {
+                break;
+            }
+            candidate = it->second.idle.back();
+            it->second.idle.pop_back();
+            odbc_helper = it->second.odbc_helper;
+            // Its session was just reset, which already required a working connection
+            fresh = now - candidate.idle_since < it->second.validation_freshness;
+        }
+
+        // Validate outside the lock, the base driver may block on a dead socket
+        if (!fresh && odbc_helper->BaseIsClosed(candidate.hdbc)) {
+            LOG(INFO) << "Discarding a dead pooled connection";
+            to_close.emplace_back(candidate.hdbc, odbc_helper);
+        } else {
+            borrowed = candidate.hdbc;
+        }
+    }
+    Close(to_close);
+    return borrowed;
+}
+
+bool UnderlyingConnectionPool::Return(
+    const std::string& key,
+    SQLHDBC hdbc,
+    const ENV* env,
+    const std::shared_ptr<OdbcHelper>& odbc_helper,
+    const ConnectionPoolConfig& config,
+    const std::string& reset_session_query,
+    const std::shared_ptr<HostListProvider>& topology_provider)
+{
+    if (hdbc == SQL_NULL_HDBC) {
+        return false;
+    }
+
+    std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>> to_close;
+    bool pooled = false;
+    MonitoringScheduler::TaskId task_to_wake = 0;
+    // Without a reset query the next borrower would inherit the session
+    if (config.enabled && config.max_idle_per_host > 0 && !reset_session_query.empty()
+        && !odbc_helper->BaseIsClosed(hdbc) && ResetSession(hdbc, odbc_helper, reset_session_query))
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const std::lock_guard<std::mutex> lock_guard(lock_);
+        CollectExpired(now, to_close);
+        HostPool& pool = pools_[key];
+        if (pool.host.empty()) {
+            pool.host = GetHostFromKey(key);
+        }
+        if (topology_provider && pool.topology_provider.expired()) {
+            pool.topology = topology_provider->Subscribe(nullptr);
+            pool.topology_provider = topology_provider;
+        }
+        pool.env = env;
+        pool.odbc_helper = odbc_helper;
+        pool.idle_timeout = config.idle_timeout;
+        pool.validation_freshness = config.validation_freshness;
+        // Keep the most recently used connections, they are the most likely to still be alive
+        while (pool.idle.size() >= config.max_idle_per_host) {
+            to_close.emplace_back(pool.idle.front().hdbc, odbc_helper);
+            pool.idle.pop_front();
+        }
+        pool.idle.push_back(IdleConnection{.hdbc = hdbc, .idle_since = now});
+        pooled = true;
+
+        const std::chrono::steady_clock::time_point expiry = now + std::min(config.idle_timeout, MAX_EVICTION_DELAY_MS);
+        if (scheduler_ && eviction_task_ == 0) {
+            next_eviction_ = expiry;
+            eviction_task_ = scheduler_->Schedule(
+                [this] { return this->RunEviction(); },
+                std::chrono::duration_cast<std::chrono::milliseconds>(expiry - now));
+        } else if (eviction_task_ != 0 && expiry < next_eviction_) {
+            // Expires before the scheduled eviction, the woken eviction computes the new delay
+            next_eviction_ = expiry;
+            task_to_wake = eviction_task_;
+        }
+    } else {
+        to_close.emplace_back(hdbc, odbc_helper);
+    }
+    if (task_to_wake != 0) {
+        scheduler_->Wake(task_to_wake);
+    }
+    Close(to_close);
+    return pooled;
+}
+
+void UnderlyingConnectionPool::EvictIdle() {
+    std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>> to_close;
+    {
+        const std::lock_guard<std::mutex> lock_guard(lock_);
+        CollectExpired(std::chrono::steady_clock::now(), to_close);
+    }
+    Close(to_close);
+}
+
+std::optional<std::chrono::milliseconds> UnderlyingConnectionPool::RunEviction() {
+    std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>> to_close;
+    std::optional<std::chrono::milliseconds> delay;
+    {
+        const std::lock_guard<std::mutex> lock_guard(lock_);
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        CollectExpired(now, to_close);
+        if (pools_.empty()) {
+            // The next pooled connection schedules a new eviction
+            eviction_task_ = 0;
+        } else {
+            next_eviction_ = now + MAX_EVICTION_DELAY_MS;
+            for (const auto& [key, pool] : pools_) {
+                next_eviction_ = std::min(next_eviction_, pool.idle.front().idle_since + pool.idle_timeout);
+            }
+            delay = std::max(std::chrono::milliseconds(0),
+                std::chrono::ceil<std::chrono::milliseconds>(next_eviction_ - now));
+        }
+    }
+    Close(to_close);
+    return delay;
+}
+
+void UnderlyingConnectionPool::Clear(const ENV* env) {
+    std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>> to_close;
+    {
+        const std::lock_guard<std::mutex> lock_guard(lock_);
+        for (auto it = pools_.begin(); it != pools_.end();) {
+            if (it->second.env == env) {
+                for (const IdleConnection& conn : it->second.idle) {
+                    to_close.emplace_back(conn.hdbc, it->second.odbc_helper);
+                }
+                it = pools_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    Close(to_close);
+}
+
+size_t UnderlyingConnectionPool::GetIdleCount(const std::string& key) {
+    const std::lock_guard<std::mutex> lock_guard(lock_);
+    const auto it = pools_.find(key);
+    return it == pools_.end() ? 0 : it->second.idle.size();
+}
+
+// Puts the session back into the state of a freshly opened connection:
+// no open transaction, auto-commit on and any dialect specific session state discarded.
+bool UnderlyingConnectionPool::ResetSession(SQLHDBC hdbc, const std::shared_ptr<OdbcHelper>& odbc_helper, const std::string& reset_session_query) {
+    if (!SQL_SUCCEEDED(odbc_helper->BaseEndTran(hdbc, SQL_ROLLBACK).fn_result)) {
+        LOG(WARNING) << "Unable to roll back a connection being returned to the pool";
+        return false;
+    }
+    if (!SQL_SUCCEEDED(odbc_helper->BaseSetConnectAttr(hdbc, SQL_ATTR_AUTOCOMMIT,
+        reinterpret_cast<SQLPOINTER>(SQL_AUTOCOMMIT_ON), 0).fn_result))
+    {
+        LOG(WARNING) << "Unable to reset auto-commit on a connection being returned to the pool";
+        return false;
+    }
+    if (reset_session_query.empty()) {
+        return true;
+    }
+
+    SQLHSTMT stmt = SQL_NULL_HANDLE;
+    if (!SQL_SUCCEEDED(odbc_helper->BaseAllocStmt(&hdbc, &stmt).fn_result)) {
+        return false;
+    }
+    const bool reset = SQL_SUCCEEDED(odbc_helper->ExecDirect(&stmt, reset_session_query).fn_result);
+    odbc_helper->BaseFreeStmt(&stmt);
+    if (!reset) {
+        LOG(WARNING) << "Unable to reset the session of a connection being returned to the pool";
+    }
+    return reset;
+}
+
+void UnderlyingConnectionPool::CollectExpired(
+    const std::chrono::steady_clock::time_point now, std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>>& to_close)
+{
+    for (auto it = pools_.begin(); it != pools_.end();) {
+        HostPool& pool = it->second;
+        if (IsHostRemoved(pool)) {
+            LOG(INFO) << "Closing idle pooled connections to " << pool.host << ", it was removed from the topology";
+            for (const IdleConnection& conn : pool.idle) {
+                to_close.emplace_back(conn.hdbc, pool.odbc_helper);
+            }
+            pool.idle.clear();
+        }
+        // Connections are appended as they are returned, so the oldest are at the front
+        while (!pool.idle.empty() && now - pool.idle.front().idle_since >= pool.idle_timeout) {
+            to_close.emplace_back(pool.idle.front().hdbc, pool.odbc_helper);
+            pool.idle.pop_front();
+        }
+        if (pool.idle.empty()) {
+            it = pools_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::string UnderlyingConnectionPool::GetHostFromKey(const std::string& key) {
+    // See BuildPoolKey, the server follows the environment, base driver and base DSN
+    size_t start = 0;
+    for (int i = 0; i < 3; i++) {
+        start = key.find('|', start);
+        if (start == std::string::npos) {
+            return "";
+        }
+        start++;
+    }
+    const size_t end = key.rfind('|');
+    return end == std::string::npos || end < start ? "" : key.substr(start, end - start);
+}
+
+bool UnderlyingConnectionPool::IsHostRemoved(HostPool& pool) {
+    if (!pool.topology) {
+        return false;
+    }
+    // Changes were missed, the host may have been removed
+    bool removed = pool.topology->TakeOverflow();
+    TopologyEvent event;
+    while (pool.topology->Poll(event)) {
+        if (event.type == TopologyEvent::Type::HOST_REMOVED && event.host.GetHost() == pool.host) {
+            removed = true;
+        }
+    }
+    return removed;
+}
+
+void UnderlyingConnectionPool::Close(const std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>>& to_close) {
+    for (const auto& [hdbc, odbc_helper] : to_close) {
+        odbc_helper->BaseDisconnectAndFree(hdbc);
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UNDERLYING_CONNECTION_POOL_H_
+#define UNDERLYING_CONNECTION_POOL_H_
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../odbcapi.h"
+#include "../host_list_providers/topology_event_publisher.h"
+
+#include "monitoring_scheduler.h"
+
+struct ENV;
+class HostListProvider;
+class OdbcHelper;
+
+struct ConnectionPoolConfig {
+    static constexpr int DEFAULT_MAX_IDLE_PER_HOST = 4;
+    static inline const std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT_MS = std::chrono::minutes(5);
+
+    bool enabled = false;
+    size_t max_idle_per_host = DEFAULT_MAX_IDLE_PER_HOST;
+    std::chrono::milliseconds idle_timeout = DEFAULT_IDLE_TIMEOUT_MS;
+    // Connections returned more recently than this are borrowed without validating them
+    std::chrono::milliseconds validation_freshness{0};
+
+    static ConnectionPoolConfig FromConnAttr(const std::map<std::string, std::string>& conn_attr);
+};
+
+// Process-wide pool of idle, already connected base driver connections.
+// Connections are grouped by the base environment, host, port, database and
+// authentication identity so a borrowed connection is interchangeable with one
+// the base driver would have opened for the same connection attributes.
+// With a scheduler, idle connections are also evicted in the background while any are pooled.
+class UnderlyingConnectionPool {
+public:
+    // Upper bound between background evictions, so removed hosts are noticed without waiting for the idle timeout
+    static inline const std::chrono::milliseconds MAX_EVICTION_DELAY_MS = std::chrono::seconds(10);
+
+    explicit UnderlyingConnectionPool(std::shared_ptr<MonitoringScheduler> scheduler = nullptr);
+    ~UnderlyingConnectionPool();
+
+    // Connections are only reused for the same base environment and connection string
+    static std::string BuildPoolKey(const ENV* env, const std::map<std::string, std::string>& conn_attr);
+
+    // Returns the most recently returned idle connection for the key that is
+    // still alive, or SQL_NULL_HDBC. Dead connections found along the way are freed.
+    // Connections within their validation freshness window are not validated.
+    SQLHDBC Borrow(const std::string& key);
+
+    // Resets the session of a connection that is no longer in use and keeps it
+    // for reuse. The connection is disconnected and freed instead if it is dead,
+    // the reset fails, there is no reset query or pooling is disabled in the config. Any statements on
+    // the connection must already be freed.
+    // With a topology provider, the idle connections of the key are freed once its host is removed from the topology.
+    // Returns true if the connection was pooled.
+    bool Return(
+        const std::string& key,
+        SQLHDBC hdbc,
+        const ENV* env,
+        const std::shared_ptr<OdbcHelper>& odbc_helper,
+        const ConnectionPoolConfig& config,
+        const std::string& reset_session_query,
+        const std::shared_ptr<HostListProvider>& topology_provider = nullptr);
+
+    // Frees idle connections that exceeded their idle timeout or whose host was removed from the topology
+    void EvictIdle();
+
+    // Frees all idle connections allocated under the base environment.
+    // Must be called before the base environment is freed.
+    void Clear(const ENV* env);
+
+    size_t GetIdleCount(const std::string& key);
+
+private:
+    struct IdleConnection {
+        SQLHDBC hdbc;
+        std::chrono::steady_clock::time_point idle_since;
+    };
+
+    struct HostPool {
+        // Server of the pool key
+        std::string host;
+        const ENV* env = nullptr;
+        std::shared_ptr<OdbcHelper> odbc_helper;
+        std::chrono::milliseconds idle_timeout;
+        std::chrono::milliseconds validation_freshness;
+        std::deque<IdleConnection> idle;
+        // Resubscribed once the provider it came from is gone, its monitor may have been replaced
+        std::shared_ptr<TopologySubscription> topology;
+        std::weak_ptr<HostListProvider> topology_provider;
+    };
+
+    static std::string GetHostFromKey(const std::string& key);
+    // Consumes the topology events of the pool, caller must hold lock_
+    static bool IsHostRemoved(HostPool& pool);
+    bool ResetSession(SQLHDBC hdbc, const std::shared_ptr<OdbcHelper>& odbc_helper, const std::string& reset_session_query);
+    // Collects expired connections and those to removed hosts into to_close, caller must hold lock_
+    void CollectExpired(std::chrono::steady_clock::time_point now, std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>>& to_close);
+    static void Close(const std::vector<std::pair<SQLHDBC, std::shared_ptr<OdbcHelper>>>& to_close);
+    // Background eviction, stops once the pool is empty
+    std::optional<std::chrono::milliseconds> RunEviction();
+
+    std::shared_ptr<MonitoringScheduler> scheduler_;
+    std::mutex lock_;
+    std::unordered_map<std::string, HostPool> pools_;
+    // Guarded by lock_, 0 while no eviction is scheduled
+    MonitoringScheduler::TaskId eviction_task_ = 0;
+    std::chrono::steady_clock::time_point next_eviction_;
+};
+
+#endif // UNDERLYING_CONNECTION_POOL_H_
@@ -0,0 +1,69 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "../../driver/util/sliding_cache_map.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+    const std::string cache_val_a("val_a");
+    const std::string cache_val_b("val_b");
+}
+
+// Reports lookups per second at each thread count as test properties, see --gtest_output=xml
+TEST(SlidingCacheMapBenchmark, contention) {
+    constexpr int KEY_COUNT = 64;
+    const std::chrono::seconds duration(2);
+    for (const int thread_count : {1, 8, 64}) {
+        SlidingCacheMap<std::string, std::string> cache;
+        for (int i = 0; i < KEY_COUNT; i++) {
+            cache.Put(std::to_string(i), cache_val_a);
+        }
+
+        std::atomic<bool> stop = false;
+        std::atomic<uint64_t> lookups = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; t++) {
+            threads.emplace_back([&cache, &stop, &lookups, t] {
+                uint64_t count = 0;
+                for (int i = t; !stop; i++) {
+                    const std::string key = std::to_string(i % KEY_COUNT);
+                    // One write for every hundred lookups, as topology refreshes are rare
+                    if (i % 100 == 0) {
+                        cache.Put(key, cache_val_b);
+                    } else {
+                        cache.GetShared(key);
+                        count++;
+                    }
+                }
+                lookups += count;
+            });
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        const uint64_t lookups_per_sec = lookups / duration.count();
+        RecordProperty("lookups_per_sec_" + std::to_string(thread_count), std::to_string(lookups_per_sec));
+    }
+}
@@ -0,0 +1,70 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "../../driver/util/sql_query_analyzer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../common/sql_statement_corpus.h"
+#include "../../driver/dialect/dialect_aurora_mysql.h"
+
+// Reports the per statement classification cost of the legacy regex analyzer, the lexer and the
+// classification cache as test properties, see --gtest_output=xml
+TEST(SqlQueryAnalyzerBenchmark, classification) {
+    std::shared_ptr<Dialect> dialect = std::make_shared<DialectAuroraMySql>();
+    std::mt19937 rng(42);
+    std::vector<std::string> corpus;
+    for (int i = 0; i < 200; i++) {
+        corpus.push_back(GenerateBatch(rng));
+    }
+
+    auto time_per_statement_ns = [&corpus](const std::function<void(const std::string&)> &classify) {
+        constexpr int ROUNDS = 5;
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; round++) {
+            for (const std::string &sql : corpus) {
+                classify(sql);
+            }
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return elapsed.count() / static_cast<int64_t>(ROUNDS * corpus.size());
+    };
+
+    // Accumulated so the classification calls are not optimized away
+    size_t classified = 0;
+    const int64_t legacy_ns = time_per_statement_ns([&](const std::string &sql) {
+        classified += legacy::DoesOpenTransaction(sql) + legacy::DoesCloseTransaction(false, sql)
+            + legacy::DoesSetReadOnly(sql, dialect->GetSetReadOnlyQuery(), dialect->GetSetReadWriteQuery()).has_value();
+    });
+    const int64_t lexer_ns = time_per_statement_ns([&](const std::string &sql) {
+        classified += SqlQueryAnalyzer::GetNetEffect(SqlQueryAnalyzer::ClassifyBatch(sql, dialect)).flags;
+    });
+    SqlQueryAnalyzer::ClearClassificationCache();
+    const int64_t cached_ns = time_per_statement_ns([&](const std::string &sql) {
+        classified += SqlQueryAnalyzer::Classify(sql, dialect).flags;
+    });
+
+    RecordProperty("legacy_ns_per_statement", std::to_string(legacy_ns));
+    RecordProperty("lexer_ns_per_statement", std::to_string(lexer_ns));
+    RecordProperty("cached_ns_per_statement", std::to_string(cached_ns));
+    EXPECT_GT(classified, 0u);
+}
@@ -0,0 +1,145 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SQL_STATEMENT_CORPUS_H_
+#define SQL_STATEMENT_CORPUS_H_
+
+#include <cctype>
+#include <optional>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../driver/util/rds_strings.h"
+
+// Generated SQL batches shared by the analyzer tests and benchmarks
+
+// Regex based implementation the lexer replaced, kept as the reference for equivalence testing
+namespace legacy {
+    inline std::vector<std::string> ParseMultiStatement(const std::string &statement) {
+        std::string local_statement(statement);
+        local_statement = TrimStr(local_statement);
+        if (local_statement.empty()) {
+            return {};
+        }
+        local_statement = std::regex_replace(local_statement, std::regex(R"(\s*/\*(.*?)\*/\s*)"), " ");
+        local_statement = std::regex_replace(local_statement, std::regex(" +"), " ");
+        std::string delimiter = ";";
+        std::vector<std::string> stmts = SplitStr(local_statement, delimiter);
+        for (auto &stmt : stmts) {
+            stmt = TrimStr(stmt);
+        }
+        return stmts;
+    }
+
+    inline std::string GetFirstSqlStatement(const std::string &statement) {
+        const std::vector<std::string> query_list = ParseMultiStatement(statement);
+        if (query_list.empty()) {
+            return statement;
+        }
+        std::string first_statement_upper = RDS_STR_UPPER(query_list.front());
+        first_statement_upper = std::regex_replace(first_statement_upper, std::regex(R"(\s*/\*(.*?)\*/\s*)"), " ");
+        return TrimStr(first_statement_upper);
+    }
+
+    inline bool DoesOpenTransaction(const std::string &statement) {
+        const std::string first = GetFirstSqlStatement(statement);
+        return first.starts_with("BEGIN") || first.starts_with("START TRANSACTION") || first.starts_with("SET AUTOCOMMIT = 0");
+    }
+
+    inline bool IsStatementSettingAutoCommit(const std::string &statement) {
+        return std::string::npos != GetFirstSqlStatement(statement).find("SET AUTOCOMMIT");
+    }
+
+    inline bool GetAutoCommitValueFromSqlStatement(const std::string &statement) {
+        std::string first_statement = GetFirstSqlStatement(statement);
+        size_t separator_index = first_statement.find('=');
+        if (std::string::npos == separator_index) {
+            separator_index = first_statement.find(" TO ");
+            if (std::string::npos == separator_index) {
+                return false;
+            }
+        }
+        first_statement = first_statement.substr(separator_index + 1);
+        first_statement = TrimStr(first_statement);
+        return std::string::npos != first_statement.find("TRUE")
+            || std::string::npos != first_statement.find('1')
+            || std::string::npos != first_statement.find("ON");
+    }
+
+    inline bool DoesCloseTransaction(const bool auto_commit, const std::string &statement) {
+        const bool new_auto_commit = IsStatementSettingAutoCommit(statement)
+            && GetAutoCommitValueFromSqlStatement(statement);
+        if (!auto_commit && new_auto_commit) {
+            return true;
+        }
+        const std::string first = GetFirstSqlStatement(statement);
+        return first.starts_with("COMMIT") || first.starts_with("ROLLBACK")
+            || first.starts_with("END") || first.starts_with("ABORT");
+    }
+
+    inline std::optional<bool> DoesSetReadOnly(const std::string &statement, const std::string &read_only, const std::string &read_write) {
+        std::optional<bool> does_set_read_only = {};
+        for (const std::string &stmt : ParseMultiStatement(statement)) {
+            const std::string upper = RDS_STR_UPPER(stmt);
+            if (upper.starts_with(read_only)) {
+                does_set_read_only = true;
+            } else if (upper.starts_with(read_write)) {
+                does_set_read_only = false;
+            }
+        }
+        return does_set_read_only;
+    }
+}  // namespace legacy
+
+inline const std::vector<std::string> STATEMENT_TEMPLATES = {
+    "begin", "begin transaction", "start transaction", "start transaction read only",
+    "commit", "rollback", "end", "abort",
+    "select 1", "select a , b from t where c = 2", "update t set a = 1 where b = 2", "insert into t values ( 1 )",
+    "set autocommit = 0", "set autocommit = 1", "set autocommit = on", "set autocommit = off",
+    "set autocommit = true", "set autocommit = false", "set autocommit to 1", "set autocommit to off",
+    "set session transaction read only", "set session transaction read write",
+    "set session characteristics as transaction read only", "set session characteristics as transaction read write",
+};
+
+inline const std::vector<std::string> SEPARATORS = { " ", " ", "  ", " /* c */ ", "/* comment */", "   /**/" };
+
+// Well formed input both implementations agree on: random case, runs of spaces,
+// block comments between words and every statement terminated by ';'
+inline std::string GenerateBatch(std::mt19937 &rng) {
+    auto pick = [&rng](const std::vector<std::string> &from) -> const std::string& {
+        return from[std::uniform_int_distribution<size_t>(0, from.size() - 1)(rng)];
+    };
+    std::string batch = std::uniform_int_distribution<int>(0, 3)(rng) == 0 ? pick(SEPARATORS) : "";
+    const int statement_count = std::uniform_int_distribution<int>(1, 3)(rng);
+    for (int i = 0; i < statement_count; i++) {
+        std::istringstream words(pick(STATEMENT_TEMPLATES));
+        for (std::string word; words >> word;) {
+            if (!batch.empty() && batch.back() != ';') {
+                batch.append(pick(SEPARATORS));
+            } else if (!batch.empty()) {
+                batch.push_back(' ');
+            }
+            for (const char c : word) {
+                batch.push_back(std::uniform_int_distribution<int>(0, 1)(rng) ? std::toupper(c) : c);
+            }
+        }
+        batch.push_back(';');
+    }
+    return batch;
+}
+
+#endif // SQL_STATEMENT_CORPUS_H_
@@ -82,7 +82,7 @@ public:
         SQLSMALLINT *StringLengthPtr, SQLUSMALLINT DriverCompletion), ());
 
     MOCK_METHOD(SQLRETURN, Execute,
-        (SQLHSTMT StatementHandle, SQLTCHAR* StatementText, SQLINTEGER TextLength), ());
+        (SQLHSTMT StatementHandle, ExecutionContext& Context), (override));
 };
 
 class MOCK_HTTP_RESP : public Aws::Http::HttpResponse {
@@ -34,7 +34,7 @@ public:
     MOCK_METHOD(bool, IsSqlStateAccessError, (const char* sql_state, const std::string& error_message), (override));
     MOCK_METHOD(int, GetDefaultPort, (), ());
     MOCK_METHOD(std::string, GetIsReaderQuery, (), ());
-    MOCK_METHOD(std::optional<bool>, DoesStatementSetReadOnly, (std::string statement), ());
+    MOCK_METHOD(std::optional<bool>, DoesStatementSetReadOnly, (const SqlStatementHead& statement), ());
 };
 
 class MOCK_HOST_SELECTOR : public HighestWeightHostSelector {
@@ -55,7 +55,7 @@ public:
 
 class MockHostSelector : public HostSelector {
 public:
-    HostInfo GetHost(std::vector<HostInfo> hosts, bool is_writer, std::unordered_map<std::string, std::string> properties) override {
+    HostInfo GetHost(const std::vector<HostInfo>& hosts, bool is_writer, const std::unordered_map<std::string, std::string>& properties) override {
         return HostInfo();
     }
 };
@@ -64,8 +64,8 @@ class MOCK_HOST_SELECTOR_GMOCK : public HostSelector {
 public:
     using PropMap = std::unordered_map<std::string, std::string>;
     MOCK_METHOD(HostInfo, GetHost,
-        (std::vector<HostInfo> hosts, bool is_writer,
-         PropMap properties), ());
+        (const std::vector<HostInfo>& hosts, bool is_writer,
+         const PropMap& properties), (override));
 };
 
 class MOCK_ODBC_HELPER : public OdbcHelper {
@@ -79,6 +79,7 @@ public:
     MOCK_METHOD(void, DisconnectAndFree, (SQLHDBC* hdbc), ());
     MOCK_METHOD(SQLRETURN, AllocDbc, (SQLHENV& henv, SQLHDBC& hdbc), ());
     MOCK_METHOD(bool, IsClosed, (SQLHDBC hdbc), (override));
+    MOCK_METHOD(RdsLibResult, Prepare, (const SQLHSTMT* stmt, const std::string& query), (override));
 };
 
 class MOCK_PLUGIN_SERVICE : public PluginService {
@@ -86,6 +87,10 @@ public:
     MOCK_PLUGIN_SERVICE() : PluginService() {}
 
     MOCK_METHOD(std::vector<HostInfo>, GetHosts, (), ());
+    // Built from GetHosts, tests only mock the host list
+    std::shared_ptr<const TopologySnapshot> GetTopologySnapshot() override {
+        return std::make_shared<const TopologySnapshot>(TopologySnapshot{ GetHosts(), 1 });
+    }
     MOCK_METHOD(HostInfo, GetCurrentHostInfo, (), ());
     MOCK_METHOD(void, SetCurrentHostInfo, (const HostInfo& info), ());
     MOCK_METHOD(void, SetInitialHostInfo, (const HostInfo& info), ());
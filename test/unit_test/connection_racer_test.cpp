@@ -0,0 +1,222 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "../../driver/plugin/failover/connection_racer.h"
+#include "../../driver/util/connection_string_keys.h"
+
+namespace {
+    // Stands in for a dead reader that only fails once the login timeout expires
+    const std::chrono::milliseconds LOGIN_TIMEOUT(1000);
+    const std::chrono::milliseconds CONNECT_LATENCY(50);
+
+    struct SimulatedHost {
+        std::chrono::milliseconds latency;
+        bool available;
+    };
+}
+
+// Simulates connection attempts with per host latencies
+class ConnectionRacerTest : public testing::Test {
+protected:
+    std::map<std::string, SimulatedHost> hosts;
+    std::map<std::string, SQLHDBC> handles;
+    std::mutex mutex;
+    std::vector<SQLHDBC> closed;
+    std::atomic<int> in_flight{0};
+    std::atomic<int> max_in_flight{0};
+    ConnectionRaceConfig config;
+
+    void SetUp() override {
+        config.enabled = true;
+        config.stagger_ms = std::chrono::milliseconds(100);
+        config.max_parallel = 3;
+    }
+
+    void AddHost(const std::string& host, const std::chrono::milliseconds latency, const bool available) {
+        hosts[host] = SimulatedHost{.latency = latency, .available = available};
+        handles[host] = reinterpret_cast<SQLHDBC>(handles.size() + 1);
+    }
+
+    std::unique_ptr<ConnectionRacer> CreateRacer() {
+        return std::make_unique<ConnectionRacer>(
+            [this](const HostInfo& host, const std::atomic<bool>&) {
+                const int now_in_flight = ++in_flight;
+                int expected = max_in_flight;
+                while (now_in_flight > expected && !max_in_flight.compare_exchange_weak(expected, now_in_flight)) {}
+
+                const SimulatedHost simulated = hosts.at(host.GetHost());
+                std::this_thread::sleep_for(simulated.latency);
+                --in_flight;
+                return simulated.available ? handles.at(host.GetHost()) : SQL_NULL_HDBC;
+            },
+            [this](SQLHDBC hdbc) {
+                const std::lock_guard<std::mutex> lock_guard(mutex);
+                closed.push_back(hdbc);
+            });
+    }
+
+    std::vector<HostInfo> Candidates(const std::vector<std::string>& names) {
+        std::vector<HostInfo> candidates;
+        for (const std::string& name : names) {
+            candidates.emplace_back(name);
+        }
+        return candidates;
+    }
+
+    static std::chrono::steady_clock::time_point Deadline(const std::chrono::milliseconds timeout) {
+        return std::chrono::steady_clock::now() + timeout;
+    }
+};
+
+TEST_F(ConnectionRacerTest, ConfigFromConnAttr) {
+    const ConnectionRaceConfig defaults = ConnectionRaceConfig::FromConnAttr({});
+    EXPECT_FALSE(defaults.enabled);
+    EXPECT_EQ(ConnectionRaceConfig::DEFAULT_STAGGER_MS, defaults.stagger_ms);
+    EXPECT_EQ(ConnectionRaceConfig::DEFAULT_MAX_PARALLEL, defaults.max_parallel);
+
+    const ConnectionRaceConfig configured = ConnectionRaceConfig::FromConnAttr({
+        {KEY_ENABLE_PARALLEL_READER_FAILOVER, VALUE_BOOL_TRUE},
+        {KEY_READER_FAILOVER_STAGGER, "50"},
+        {KEY_READER_FAILOVER_MAX_PARALLEL, "0"}
+    });
+    EXPECT_TRUE(configured.enabled);
+    EXPECT_EQ(std::chrono::milliseconds(50), configured.stagger_ms);
+    EXPECT_EQ(1, configured.max_parallel);
+}
+
+// Serially this would take two login timeouts before reaching the live reader.
+// Racing bounds it by the stagger delays plus the live reader's connect latency.
+TEST_F(ConnectionRacerTest, DeadReadersDoNotDelayFailover) {
+    AddHost("dead-reader-1", LOGIN_TIMEOUT, false);
+    AddHost("dead-reader-2", LOGIN_TIMEOUT, false);
+    AddHost("live-reader", CONNECT_LATENCY, true);
+    const std::unique_ptr<ConnectionRacer> racer = CreateRacer();
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto winner = racer->Race(Candidates({"dead-reader-1", "dead-reader-2", "live-reader"}), config, Deadline(std::chrono::seconds(30)));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(winner.has_value());
+    EXPECT_EQ("live-reader", winner->host_info.GetHost());
+    EXPECT_EQ(handles.at("live-reader"), winner->hdbc);
+    EXPECT_LT(elapsed, 2 * config.stagger_ms + CONNECT_LATENCY + std::chrono::milliseconds(200));
+    EXPECT_LT(elapsed, LOGIN_TIMEOUT);
+}
+
+TEST_F(ConnectionRacerTest, FailedAttemptStartsNextImmediately) {
+    config.stagger_ms = std::chrono::seconds(5);
+    AddHost("refused-reader", std::chrono::milliseconds(10), false);
+    AddHost("live-reader", CONNECT_LATENCY, true);
+    const std::unique_ptr<ConnectionRacer> racer = CreateRacer();
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto winner = racer->Race(Candidates({"refused-reader", "live-reader"}), config, Deadline(std::chrono::seconds(30)));
+
+    ASSERT_TRUE(winner.has_value());
+    EXPECT_EQ("live-reader", winner->host_info.GetHost());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST_F(ConnectionRacerTest, LosingConnectionsAreClosed) {
+    config.stagger_ms = std::chrono::milliseconds(0);
+    AddHost("fast-reader", CONNECT_LATENCY, true);
+    AddHost("slow-reader", 4 * CONNECT_LATENCY, true);
+    std::unique_ptr<ConnectionRacer> racer = CreateRacer();
+
+    const auto winner = racer->Race(Candidates({"fast-reader", "slow-reader"}), config, Deadline(std::chrono::seconds(30)));
+    ASSERT_TRUE(winner.has_value());
+    EXPECT_EQ("fast-reader", winner->host_info.GetHost());
+
+    // Waits for the slow attempt to finish
+    racer.reset();
+    ASSERT_EQ(1, closed.size());
+    EXPECT_EQ(handles.at("slow-reader"), closed[0]);
+}
+
+TEST_F(ConnectionRacerTest, AllAttemptsFail) {
+    AddHost("refused-reader-1", std::chrono::milliseconds(10), false);
+    AddHost("refused-reader-2", std::chrono::milliseconds(10), false);
+    const std::unique_ptr<ConnectionRacer> racer = CreateRacer();
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(racer->Race(Candidates({"refused-reader-1", "refused-reader-2"}), config, Deadline(std::chrono::seconds(30))).has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST_F(ConnectionRacerTest, DeadlineBoundsRace) {
+    AddHost("dead-reader-1", LOGIN_TIMEOUT, false);
+    AddHost("dead-reader-2", LOGIN_TIMEOUT, false);
+    const std::unique_ptr<ConnectionRacer> racer = CreateRacer();
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(racer->Race(Candidates({"dead-reader-1", "dead-reader-2"}), config, Deadline(std::chrono::milliseconds(200))).has_value());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, LOGIN_TIMEOUT);
+}
+
+TEST_F(ConnectionRacerTest, MaxParallelLimitsAttemptsInFlight) {
+    config.stagger_ms = std::chrono::milliseconds(0);
+    config.max_parallel = 2;
+    AddHost("slow-reader-1", std::chrono::milliseconds(200), false);
+    AddHost("slow-reader-2", std::chrono::milliseconds(200), false);
+    AddHost("slow-reader-3", std::chrono::milliseconds(200), false);
+    AddHost("live-reader", CONNECT_LATENCY, true);
+    const std::unique_ptr<ConnectionRacer> racer = CreateRacer();
+
+    const auto winner = racer->Race(
+        Candidates({"slow-reader-1", "slow-reader-2", "slow-reader-3", "live-reader"}), config, Deadline(std::chrono::seconds(30)));
+
+    ASSERT_TRUE(winner.has_value());
+    EXPECT_EQ("live-reader", winner->host_info.GetHost());
+    EXPECT_EQ(2, max_in_flight);
+}
+
+// Writer probes keep their connection and poll its role until the race is decided
+TEST_F(ConnectionRacerTest, ProbesPollUntilPromotion) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::chrono::milliseconds promotion_delay(200);
+    const std::chrono::milliseconds poll_interval(10);
+    std::atomic<int> abandoned_probes{0};
+    std::unique_ptr<ConnectionRacer> racer = std::make_unique<ConnectionRacer>(
+        [&](const HostInfo& host, const std::atomic<bool>& race_decided) -> SQLHDBC {
+            while (!race_decided) {
+                if (host.GetHost() == "promoted-reader" && std::chrono::steady_clock::now() - start >= promotion_delay) {
+                    return reinterpret_cast<SQLHDBC>(1);
+                }
+                std::this_thread::sleep_for(poll_interval);
+            }
+            ++abandoned_probes;
+            return SQL_NULL_HDBC;
+        },
+        [](SQLHDBC) {});
+
+    config.stagger_ms = std::chrono::milliseconds(0);
+    const auto winner = racer->Race(Candidates({"old-writer", "reader", "promoted-reader"}), config, Deadline(std::chrono::seconds(30)));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_TRUE(winner.has_value());
+    EXPECT_EQ("promoted-reader", winner->host_info.GetHost());
+    EXPECT_GE(elapsed, promotion_delay);
+    EXPECT_LT(elapsed, promotion_delay + std::chrono::milliseconds(200));
+
+    racer.reset();
+    EXPECT_EQ(2, abandoned_probes);
+}
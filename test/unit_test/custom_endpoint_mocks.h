@@ -28,7 +28,6 @@ public:
     MOCK_CUSTOM_ENDPOINT_MONITOR() : CustomEndpointMonitor() {};
 
     MOCK_METHOD(bool, HasInfo, (), ());
-    MOCK_METHOD(void, Run, (), ());
 };
 
 #endif // CUSTOM_ENDPOINT_MOCKS_H_
@@ -0,0 +1,90 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../../driver/plugin/execution_context.h"
+#include "../../driver/dialect/dialect_aurora_mysql.h"
+
+namespace {
+    class CountingDialect : public DialectAuroraMySql {
+    public:
+        std::optional<bool> DoesStatementSetReadOnly(const SqlStatementHead& statement) override {
+            calls++;
+            return DialectAuroraMySql::DoesStatementSetReadOnly(statement);
+        }
+        int calls = 0;
+    };
+
+    // Null terminated SQLTCHAR copy of an ASCII statement
+    std::vector<SQLTCHAR> ToSqlTChar(const std::string& sql) {
+        std::vector<SQLTCHAR> text(sql.begin(), sql.end());
+        text.push_back(0);
+        return text;
+    }
+}  // namespace
+
+class ExecutionContextTest : public testing::Test {
+protected:
+    void SetUp() override {
+        SqlQueryAnalyzer::ClearClassificationCache();
+    }
+};
+
+TEST_F(ExecutionContextTest, PreparedExecute) {
+    ExecutionContext context;
+    EXPECT_FALSE(context.IsDirectExecute());
+    EXPECT_EQ("", context.GetQuery());
+    EXPECT_FALSE(context.GetClassification().Has(SQL_CLASS_VALID));
+}
+
+TEST_F(ExecutionContextTest, ClassificationIsMemoized) {
+    std::shared_ptr<CountingDialect> dialect = std::make_shared<CountingDialect>();
+    std::vector<SQLTCHAR> text = ToSqlTChar("set session transaction read only");
+    ExecutionContext context(text.data(), SQL_NTS);
+    EXPECT_EQ("set session transaction read only", context.GetQuery());
+
+    // Without a dialect, read-only changes are not detected
+    EXPECT_EQ(std::nullopt, context.GetClassification().DoesSetReadOnly());
+    EXPECT_EQ(0, dialect->calls);
+
+    EXPECT_EQ(true, context.GetClassification(dialect).DoesSetReadOnly());
+    EXPECT_EQ(true, context.GetClassification(dialect).DoesSetReadOnly());
+    EXPECT_EQ(true, context.GetClassification().DoesSetReadOnly());
+    EXPECT_EQ(1, dialect->calls);
+}
+
+TEST_F(ExecutionContextTest, DialectQuotingRules) {
+    // With backslash escapes the quote is escaped, the statement is a single select
+    const std::string query = "select 'a\\';begin";
+    std::vector<SQLTCHAR> text = ToSqlTChar(query);
+    ExecutionContext context(text.data(), SQL_NTS, query);
+    EXPECT_FALSE(context.GetClassification(std::make_shared<DialectAuroraMySql>()).DoesOpenTransaction());
+}
+
+TEST_F(ExecutionContextTest, StatementFacts) {
+    std::vector<SQLTCHAR> select_text = ToSqlTChar("/* hint */ SELECT 1");
+    ExecutionContext select(select_text.data(), SQL_NTS, "/* hint */ SELECT 1");
+    EXPECT_TRUE(select.IsDirectExecute());
+    EXPECT_TRUE(select.GetClassification().Has(SQL_CLASS_SELECT));
+    EXPECT_FALSE(select.GetClassification().DoesOpenTransaction());
+
+    std::vector<SQLTCHAR> begin_text = ToSqlTChar("begin");
+    ExecutionContext begin(begin_text.data(), SQL_NTS, "begin");
+    EXPECT_FALSE(begin.GetClassification().Has(SQL_CLASS_SELECT));
+    EXPECT_TRUE(begin.GetClassification().DoesOpenTransaction());
+}
@@ -41,7 +41,7 @@ class MockRdsLibLoader : public RdsLibLoader {
 
 class MockHostSelector : public HostSelector {
     public:
-        HostInfo GetHost(std::vector<HostInfo> hosts, bool is_writer, std::unordered_map<std::string, std::string> properties) override {
+        HostInfo GetHost(const std::vector<HostInfo>& hosts, bool is_writer, const std::unordered_map<std::string, std::string>& properties) override {
             return HostInfo();
         }
 };
@@ -138,3 +138,13 @@ TEST_F(HighestWeightHostSelectorTest, get_reader_prefers_reader_over_writer) {
         EXPECT_FALSE(host_info.IsHostWriter());
     }
 }
+
+TEST_F(HighestWeightHostSelectorTest, get_reader_skips_lagging_reader) {
+    HighestWeightHostSelector host_selector;
+    host_selector.SetMaxReplicaLag(std::chrono::milliseconds(1000));
+    HostInfo lagging_reader = reader_host_info_b;
+    lagging_reader.SetReplicaLag(std::chrono::milliseconds(5000));
+    std::vector<HostInfo> hosts = {writer_host_info_a, reader_host_info_a, lagging_reader};
+    HostInfo host_info = host_selector.GetHost(hosts, false, empty_map);
+    EXPECT_EQ(reader_host_info_a.GetHost(), host_info.GetHost());
+}
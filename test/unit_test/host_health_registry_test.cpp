@@ -0,0 +1,118 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "../../driver/host_health_registry.h"
+
+namespace {
+    const std::string HOST = "instance-1.xyz.us-east-1.rds.amazonaws.com";
+    const std::chrono::milliseconds BACKOFF_MS(20);
+    const std::chrono::milliseconds MAX_BACKOFF_MS(40);
+}
+
+TEST(HostHealthRegistryTest, UnknownHostIsAvailable) {
+    HostHealthRegistry registry(2, BACKOFF_MS, MAX_BACKOFF_MS);
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+    EXPECT_EQ(CIRCUIT_CLOSED, registry.GetHealth(HOST).state);
+}
+
+TEST(HostHealthRegistryTest, OpensAfterConsecutiveFailures) {
+    HostHealthRegistry registry(2, BACKOFF_MS, MAX_BACKOFF_MS);
+    registry.RecordFailure(HOST);
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+
+    // A success in between resets the count
+    registry.RecordSuccess(HOST, std::chrono::milliseconds(10));
+    registry.RecordFailure(HOST);
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+
+    registry.RecordFailure(HOST);
+    EXPECT_FALSE(registry.IsAvailable(HOST));
+    EXPECT_EQ(CIRCUIT_OPEN, registry.GetHealth(HOST).state);
+    EXPECT_EQ(BACKOFF_MS, registry.GetHealth(HOST).backoff_ms);
+    // Other hosts are unaffected
+    EXPECT_TRUE(registry.IsAvailable("instance-2.xyz.us-east-1.rds.amazonaws.com"));
+}
+
+TEST(HostHealthRegistryTest, OpenCircuitSkipsThreshold) {
+    HostHealthRegistry registry(2, BACKOFF_MS, MAX_BACKOFF_MS);
+    registry.OpenCircuit(HOST);
+    EXPECT_FALSE(registry.IsAvailable(HOST));
+    EXPECT_EQ(CIRCUIT_OPEN, registry.GetHealth(HOST).state);
+    EXPECT_EQ(BACKOFF_MS, registry.GetHealth(HOST).backoff_ms);
+}
+
+TEST(HostHealthRegistryTest, AdmitsSingleProbeAfterBackoff) {
+    HostHealthRegistry registry(1, BACKOFF_MS, MAX_BACKOFF_MS);
+    registry.RecordFailure(HOST);
+    EXPECT_FALSE(registry.IsAvailable(HOST));
+
+    std::this_thread::sleep_for(BACKOFF_MS);
+    // Checking availability does not admit a probe
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+    EXPECT_EQ(CIRCUIT_OPEN, registry.GetHealth(HOST).state);
+
+    EXPECT_TRUE(registry.TryAdmitProbe(HOST));
+    EXPECT_EQ(CIRCUIT_HALF_OPEN, registry.GetHealth(HOST).state);
+    // The probe is in progress
+    EXPECT_FALSE(registry.IsAvailable(HOST));
+    EXPECT_FALSE(registry.TryAdmitProbe(HOST));
+
+    registry.RecordSuccess(HOST, std::chrono::milliseconds(10));
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+    EXPECT_EQ(CIRCUIT_CLOSED, registry.GetHealth(HOST).state);
+}
+
+TEST(HostHealthRegistryTest, FailedProbeDoublesBackoff) {
+    HostHealthRegistry registry(1, BACKOFF_MS, MAX_BACKOFF_MS);
+    registry.RecordFailure(HOST);
+
+    std::this_thread::sleep_for(BACKOFF_MS);
+    ASSERT_TRUE(registry.TryAdmitProbe(HOST));
+    registry.RecordFailure(HOST);
+    EXPECT_FALSE(registry.IsAvailable(HOST));
+    EXPECT_EQ(BACKOFF_MS * 2, registry.GetHealth(HOST).backoff_ms);
+
+    std::this_thread::sleep_for(BACKOFF_MS * 2);
+    ASSERT_TRUE(registry.TryAdmitProbe(HOST));
+    registry.RecordFailure(HOST);
+    // Capped
+    EXPECT_EQ(MAX_BACKOFF_MS, registry.GetHealth(HOST).backoff_ms);
+}
+
+TEST(HostHealthRegistryTest, AbandonedProbeIsRetried) {
+    HostHealthRegistry registry(1, BACKOFF_MS, MAX_BACKOFF_MS);
+    registry.RecordFailure(HOST);
+
+    std::this_thread::sleep_for(BACKOFF_MS);
+    ASSERT_TRUE(registry.TryAdmitProbe(HOST));
+    // No outcome recorded for the probe
+    std::this_thread::sleep_for(BACKOFF_MS);
+    EXPECT_TRUE(registry.IsAvailable(HOST));
+    EXPECT_TRUE(registry.TryAdmitProbe(HOST));
+}
+
+TEST(HostHealthRegistryTest, TracksConnectLatency) {
+    HostHealthRegistry registry;
+    registry.RecordSuccess(HOST, std::chrono::milliseconds(100));
+    EXPECT_EQ(std::chrono::milliseconds(100), registry.GetHealth(HOST).latency_ms);
+    registry.RecordSuccess(HOST, std::chrono::milliseconds(20));
+    EXPECT_EQ(std::chrono::milliseconds(80), registry.GetHealth(HOST).latency_ms);
+}
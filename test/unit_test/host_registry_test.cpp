@@ -0,0 +1,106 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../driver/host_info.h"
+#include "../../driver/host_registry.h"
+
+TEST(HostRegistryTest, SameHostAndPortShareId) {
+    const HostId id = HostRegistry::Intern("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432);
+    EXPECT_EQ(id, HostRegistry::Intern("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432));
+    EXPECT_NE(id, HostRegistry::Intern("instance-1.xyz.us-east-1.rds.amazonaws.com", 5433));
+    EXPECT_NE(id, HostRegistry::Intern("instance-2.xyz.us-east-1.rds.amazonaws.com", 5432));
+
+    const HostMetadata& metadata = HostRegistry::Get(id);
+    EXPECT_EQ("instance-1.xyz.us-east-1.rds.amazonaws.com", metadata.host);
+    EXPECT_EQ(5432, metadata.port);
+    EXPECT_EQ("instance-1", metadata.host_id);
+    EXPECT_EQ("instance-1.xyz.us-east-1.rds.amazonaws.com:5432", metadata.host_port_pair);
+}
+
+TEST(HostRegistryTest, DefaultHostInfoIsEmptyHost) {
+    const HostInfo host_info;
+    EXPECT_EQ(HostRegistry::EMPTY_HOST_ID, host_info.GetId());
+    EXPECT_EQ("", host_info.GetHost());
+    EXPECT_EQ(HostInfo::NO_PORT, host_info.GetPort());
+    EXPECT_EQ("", host_info.GetHostId());
+}
+
+TEST(HostRegistryTest, HostInfoComparesInternedHost) {
+    const HostInfo writer("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432, UP, WRITER);
+    const HostInfo reader("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432, UP, READER);
+    const HostInfo other_port("instance-1.xyz.us-east-1.rds.amazonaws.com", 5433, UP, WRITER);
+
+    EXPECT_TRUE(writer.IsSameHost(reader));
+    EXPECT_FALSE(writer == reader);
+    EXPECT_FALSE(writer.IsSameHost(other_port));
+    EXPECT_EQ(writer, HostInfo(writer));
+}
+
+TEST(HostRegistryTest, ConcurrentIntern) {
+    constexpr int THREAD_COUNT = 8;
+    constexpr int HOST_COUNT = 2000;
+    std::vector<std::vector<HostId>> ids(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&ids, t] {
+            for (int i = 0; i < HOST_COUNT; i++) {
+                const HostId id = HostRegistry::Intern("concurrent-" + std::to_string(i), 5432);
+                // Metadata is readable as soon as the id is handed out
+                if (HostRegistry::Get(id).host != "concurrent-" + std::to_string(i)) {
+                    return;
+                }
+                ids[t].push_back(id);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        ASSERT_EQ(ids[0], ids[t]);
+    }
+    EXPECT_EQ(HOST_COUNT, std::set<HostId>(ids[0].begin(), ids[0].end()).size());
+}
+
+TEST(HostRegistryTest, FullRegistryKeepsInterning) {
+    HostRegistry registry(1);
+    // The empty host takes the first id
+    for (size_t i = 1; i < HostRegistry::CHUNK_SIZE; i++) {
+        ASSERT_EQ(i, registry.InternHost("host-" + std::to_string(i), 5432));
+    }
+    EXPECT_EQ(HostRegistry::CHUNK_SIZE, registry.GetSize());
+
+    const HostId overflow_id = registry.InternHost("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432);
+    EXPECT_LE(HostRegistry::CHUNK_SIZE, overflow_id);
+    EXPECT_EQ(overflow_id, registry.InternHost("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432));
+    EXPECT_NE(overflow_id, registry.InternHost("instance-2.xyz.us-east-1.rds.amazonaws.com", 5432));
+    EXPECT_EQ(HostRegistry::CHUNK_SIZE + 2, registry.GetSize());
+
+    const HostMetadata& metadata = registry.GetMetadata(overflow_id);
+    EXPECT_EQ("instance-1.xyz.us-east-1.rds.amazonaws.com", metadata.host);
+    EXPECT_EQ(5432, metadata.port);
+    EXPECT_EQ("instance-1", metadata.host_id);
+    EXPECT_EQ("host-1:5432", registry.GetMetadata(1).host_port_pair);
+    // Ids that were never handed out resolve to the empty host
+    EXPECT_EQ("", registry.GetMetadata(overflow_id + 2).host);
+}
+
@@ -0,0 +1,182 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../../driver/driver.h"
+#include "../../driver/util/connection_string_keys.h"
+#include "../../driver/util/monitoring_query_session.h"
+#include "../../driver/util/odbc_helper.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+    const RdsLibResult SUCCESS_RESULT = {.fn_load_success = true, .fn_result = SQL_SUCCESS, .fn_name = ""};
+    const RdsLibResult ERROR_RESULT = {.fn_load_success = true, .fn_result = SQL_ERROR, .fn_name = ""};
+
+    const SQLHDBC UNDERLYING_DBC = reinterpret_cast<SQLHDBC>(0x1000);
+    const SQLHDBC OTHER_UNDERLYING_DBC = reinterpret_cast<SQLHDBC>(0x1001);
+    const SQLHSTMT UNDERLYING_STMT = reinterpret_cast<SQLHSTMT>(0x2000);
+    const std::string QUERY = "SELECT 1";
+    const std::string OTHER_QUERY = "SELECT 2";
+}
+
+class MOCK_SESSION_ODBC_HELPER : public OdbcHelper {
+public:
+    MOCK_SESSION_ODBC_HELPER() : OdbcHelper(std::make_shared<RdsLibLoader>(), nullptr) {};
+    MOCK_METHOD(RdsLibResult, BaseAllocStmt, (const SQLHDBC *wrapped_dbc, SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, BaseFreeStmt, (SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, Prepare, (const SQLHSTMT *stmt, const std::string &query), (override));
+    MOCK_METHOD(RdsLibResult, Execute, (const SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, BindCol, (const SQLHSTMT *stmt, int column, int type, void *value, size_t size, SQLLEN *len), (override));
+    MOCK_METHOD(RdsLibResult, Fetch, (SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, CloseCursor, (SQLHSTMT stmt), (override));
+};
+
+class MonitoringQuerySessionTest : public testing::Test {
+protected:
+    std::shared_ptr<NiceMock<MOCK_SESSION_ODBC_HELPER>> odbc_helper;
+    DBC dbc;
+
+    void SetUp() override {
+        odbc_helper = std::make_shared<NiceMock<MOCK_SESSION_ODBC_HELPER>>();
+        ON_CALL(*odbc_helper, BaseAllocStmt(_, _)).WillByDefault([](const SQLHDBC*, SQLHSTMT* stmt) {
+            *stmt = UNDERLYING_STMT;
+            return SUCCESS_RESULT;
+        });
+        ON_CALL(*odbc_helper, BaseFreeStmt(_)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*odbc_helper, Prepare(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*odbc_helper, Execute(_)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*odbc_helper, BindCol(_, _, _, _, _, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*odbc_helper, Fetch(_)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*odbc_helper, CloseCursor(_)).WillByDefault(Return(SUCCESS_RESULT));
+
+        dbc.wrapped_dbc = UNDERLYING_DBC;
+        dbc.conn_attr.insert_or_assign(KEY_MONITORING_CONN_UUID, "monitoring-uuid");
+    }
+
+    void TearDown() override {
+        dbc.monitoring_session.reset();
+        dbc.wrapped_dbc = SQL_NULL_HDBC;
+    }
+};
+
+TEST_F(MonitoringQuerySessionTest, QueryIsPreparedAndBoundOnce) {
+    EXPECT_CALL(*odbc_helper, Prepare(_, QUERY)).Times(1);
+    EXPECT_CALL(*odbc_helper, BindCol(_, 1, SQL_C_LONG, _, _, _)).Times(1);
+    EXPECT_CALL(*odbc_helper, Execute(_)).Times(3);
+    // Closing the result of the previous run
+    EXPECT_CALL(*odbc_helper, CloseCursor(UNDERLYING_STMT)).Times(2);
+
+    void* buffer = nullptr;
+    for (int i = 0; i < 3; i++) {
+        MonitoringQuerySession::Query* query = MonitoringQuerySession::ForConnection(&dbc, odbc_helper)->Execute(QUERY);
+        ASSERT_NE(nullptr, query);
+        void* bound = query->BindCol(1, SQL_C_LONG, sizeof(SQLINTEGER));
+        ASSERT_NE(nullptr, bound);
+        if (buffer) {
+            EXPECT_EQ(buffer, bound);
+        }
+        buffer = bound;
+        query->Fetch();
+    }
+    EXPECT_EQ(1, dbc.monitoring_session->GetPreparedCount());
+}
+
+TEST_F(MonitoringQuerySessionTest, BufferIsClearedBeforeExecution) {
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    MonitoringQuerySession::Query* query = session->Execute(QUERY);
+    ASSERT_NE(nullptr, query);
+    auto* value = static_cast<SQLINTEGER*>(query->BindCol(1, SQL_C_LONG, sizeof(SQLINTEGER)));
+    ASSERT_NE(nullptr, value);
+    *value = 42;
+
+    // No rows fetched into the buffer
+    ASSERT_EQ(query, session->Execute(QUERY));
+    EXPECT_EQ(0, *value);
+}
+
+TEST_F(MonitoringQuerySessionTest, ReleaseFreesStatements) {
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    ASSERT_NE(nullptr, session->Execute(QUERY));
+    ASSERT_NE(nullptr, session->Execute(OTHER_QUERY));
+    EXPECT_EQ(2, session->GetPreparedCount());
+
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(2);
+    MonitoringQuerySession::Release(&dbc);
+    EXPECT_EQ(nullptr, dbc.monitoring_session);
+    EXPECT_EQ(0, session->GetPreparedCount());
+}
+
+TEST_F(MonitoringQuerySessionTest, ReplacedConnectionGetsNewSession) {
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    ASSERT_NE(nullptr, session->Execute(QUERY));
+
+    // The statements went with the previous underlying connection
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(0);
+    dbc.wrapped_dbc = OTHER_UNDERLYING_DBC;
+    dbc.connection_generation++;
+    const std::shared_ptr<MonitoringQuerySession> replaced = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    EXPECT_NE(session, replaced);
+    EXPECT_EQ(OTHER_UNDERLYING_DBC, replaced->GetWrappedDbc());
+}
+
+TEST_F(MonitoringQuerySessionTest, ReconnectedHandleGetsNewSession) {
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    ASSERT_NE(nullptr, session->Execute(QUERY));
+
+    // Disconnected and connected again on the same handle, the statements did not survive
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(0);
+    dbc.connection_generation += 2;
+    const std::shared_ptr<MonitoringQuerySession> reconnected = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    EXPECT_NE(session, reconnected);
+    EXPECT_EQ(dbc.wrapped_dbc, reconnected->GetWrappedDbc());
+    EXPECT_EQ(0, reconnected->GetPreparedCount());
+}
+
+TEST_F(MonitoringQuerySessionTest, OtherConnectionFreesStatementsAfterUse) {
+    dbc.conn_attr.erase(KEY_MONITORING_CONN_UUID);
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(1);
+    {
+        const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+        ASSERT_NE(nullptr, session->Execute(QUERY));
+    }
+    EXPECT_EQ(nullptr, dbc.monitoring_session);
+}
+
+TEST_F(MonitoringQuerySessionTest, FailedExecutionIsPreparedAgain) {
+    EXPECT_CALL(*odbc_helper, Prepare(_, QUERY)).Times(2);
+    EXPECT_CALL(*odbc_helper, Execute(_))
+        .WillOnce(Return(ERROR_RESULT))
+        .WillOnce(Return(SUCCESS_RESULT));
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(1);
+
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    EXPECT_EQ(nullptr, session->Execute(QUERY));
+    EXPECT_EQ(0, session->GetPreparedCount());
+    EXPECT_NE(nullptr, session->Execute(QUERY));
+}
+
+TEST_F(MonitoringQuerySessionTest, FailedPrepareIsNotKept) {
+    EXPECT_CALL(*odbc_helper, Prepare(_, QUERY)).WillOnce(Return(ERROR_RESULT));
+    EXPECT_CALL(*odbc_helper, Execute(_)).Times(0);
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(1);
+
+    const std::shared_ptr<MonitoringQuerySession> session = MonitoringQuerySession::ForConnection(&dbc, odbc_helper);
+    EXPECT_EQ(nullptr, session->Execute(QUERY));
+    EXPECT_EQ(0, session->GetPreparedCount());
+}
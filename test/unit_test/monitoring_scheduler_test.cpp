@@ -0,0 +1,206 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "../../driver/util/monitoring_scheduler.h"
+
+namespace {
+    const std::chrono::milliseconds TICK_MS(1);
+    const std::chrono::seconds WAIT_TIMEOUT(5);
+
+    template <typename Predicate>
+    bool WaitFor(Predicate predicate) {
+        const auto end = std::chrono::steady_clock::now() + WAIT_TIMEOUT;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > end) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(MonitoringSchedulerTest, RunsAtReturnedInterval) {
+    MonitoringScheduler scheduler(2, TICK_MS);
+    std::atomic<int> runs = 0;
+    const auto start = std::chrono::steady_clock::now();
+    scheduler.Schedule([&runs]() -> std::optional<std::chrono::milliseconds> {
+        if (++runs == 3) {
+            return std::nullopt;
+        }
+        return std::chrono::milliseconds(20);
+    }, std::chrono::milliseconds(20));
+
+    ASSERT_TRUE(WaitFor([&runs] { return runs == 3; }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(60));
+}
+
+TEST(MonitoringSchedulerTest, FinishedTaskIsRemoved) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<int> runs = 0;
+    const MonitoringScheduler::TaskId id = scheduler.Schedule([&runs]() -> std::optional<std::chrono::milliseconds> {
+        runs++;
+        return std::nullopt;
+    });
+
+    ASSERT_TRUE(WaitFor([&scheduler, id] { return !scheduler.IsScheduled(id); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(1, runs);
+}
+
+TEST(MonitoringSchedulerTest, WakeRunsWaitingTask) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<int> runs = 0;
+    const MonitoringScheduler::TaskId id = scheduler.Schedule([&runs]() -> std::optional<std::chrono::milliseconds> {
+        runs++;
+        return std::chrono::hours(1);
+    }, std::chrono::hours(1));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(0, runs);
+    scheduler.Wake(id);
+    ASSERT_TRUE(WaitFor([&runs] { return runs == 1; }));
+    scheduler.Cancel(id);
+}
+
+TEST(MonitoringSchedulerTest, WakeDuringRunRunsAgain) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<int> runs = 0;
+    std::atomic<bool> release = false;
+    const MonitoringScheduler::TaskId id = scheduler.Schedule([&]() -> std::optional<std::chrono::milliseconds> {
+        if (++runs == 1) {
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return std::chrono::hours(1);
+    });
+
+    ASSERT_TRUE(WaitFor([&runs] { return runs == 1; }));
+    scheduler.Wake(id);
+    release = true;
+    ASSERT_TRUE(WaitFor([&runs] { return runs == 2; }));
+    scheduler.Cancel(id);
+}
+
+TEST(MonitoringSchedulerTest, CancelWaitsForRunningTask) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<bool> started = false;
+    std::atomic<bool> finished = false;
+    const MonitoringScheduler::TaskId id = scheduler.Schedule([&]() -> std::optional<std::chrono::milliseconds> {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+        return std::chrono::milliseconds(1);
+    });
+
+    ASSERT_TRUE(WaitFor([&started] { return started.load(); }));
+    scheduler.Cancel(id);
+    EXPECT_TRUE(finished);
+    EXPECT_FALSE(scheduler.IsScheduled(id));
+}
+
+TEST(MonitoringSchedulerTest, CancelWaitsForTaskDestruction) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<bool> started = false;
+    std::atomic<bool> destroyed = false;
+    // Only owned by the task
+    std::shared_ptr<int> owned(new int(0), [&destroyed](const int* value) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        delete value;
+        destroyed = true;
+    });
+    const MonitoringScheduler::TaskId id = scheduler.Schedule(
+        [&started, owned = std::move(owned)]() -> std::optional<std::chrono::milliseconds> {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return std::chrono::milliseconds(1);
+        });
+
+    ASSERT_TRUE(WaitFor([&started] { return started.load(); }));
+    scheduler.Cancel(id);
+    EXPECT_TRUE(destroyed);
+}
+
+TEST(MonitoringSchedulerTest, TaskCancellingItself) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<int> runs = 0;
+    MonitoringScheduler::TaskId id = 0;
+    std::atomic<bool> scheduled = false;
+    id = scheduler.Schedule([&]() -> std::optional<std::chrono::milliseconds> {
+        while (!scheduled) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        runs++;
+        scheduler.Cancel(id);
+        return std::chrono::milliseconds(1);
+    });
+    scheduled = true;
+
+    ASSERT_TRUE(WaitFor([&scheduler, id] { return !scheduler.IsScheduled(id); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(1, runs);
+}
+
+TEST(MonitoringSchedulerTest, DelayLongerThanWheel) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    std::atomic<bool> ran = false;
+    const std::chrono::milliseconds delay = TICK_MS * (MonitoringScheduler::WHEEL_SIZE + 100);
+    const auto start = std::chrono::steady_clock::now();
+    scheduler.Schedule([&ran]() -> std::optional<std::chrono::milliseconds> {
+        ran = true;
+        return std::nullopt;
+    }, delay);
+
+    ASSERT_TRUE(WaitFor([&ran] { return ran.load(); }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, delay);
+}
+
+TEST(MonitoringSchedulerTest, ThreadCountIsBounded) {
+    MonitoringScheduler scheduler(2, TICK_MS);
+    EXPECT_EQ(0, scheduler.GetThreadCount());
+
+    constexpr int TASK_COUNT = 50;
+    std::atomic<int> runs = 0;
+    std::vector<MonitoringScheduler::TaskId> ids;
+    for (int i = 0; i < TASK_COUNT; i++) {
+        ids.push_back(scheduler.Schedule([&runs]() -> std::optional<std::chrono::milliseconds> {
+            runs++;
+            return std::chrono::milliseconds(5);
+        }, std::chrono::milliseconds(i % 10)));
+    }
+
+    ASSERT_TRUE(WaitFor([&runs] { return runs >= TASK_COUNT * 3; }));
+    // Two workers and the timer thread
+    EXPECT_EQ(3, scheduler.GetThreadCount());
+    for (const MonitoringScheduler::TaskId id : ids) {
+        scheduler.Cancel(id);
+    }
+}
+
+TEST(MonitoringSchedulerTest, ThrowingTaskIsStopped) {
+    MonitoringScheduler scheduler(1, TICK_MS);
+    const MonitoringScheduler::TaskId id = scheduler.Schedule([]() -> std::optional<std::chrono::milliseconds> {
+        throw std::runtime_error("monitor failure");
+    });
+
+    ASSERT_TRUE(WaitFor([&scheduler, id] { return !scheduler.IsScheduled(id); }));
+}
@@ -0,0 +1,126 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../../driver/driver.h"
+#include "../../driver/util/odbc_helper.h"
+#include "../../driver/util/rds_lib_loader.h"
+#include "../../driver/util/rds_strings.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+    const RdsLibResult SUCCESS_RESULT = {.fn_load_success = true, .fn_result = SQL_SUCCESS, .fn_name = ""};
+    const RdsLibResult ERROR_RESULT = {.fn_load_success = true, .fn_result = SQL_ERROR, .fn_name = ""};
+
+    const SQLHDBC UNDERLYING_DBC = reinterpret_cast<SQLHDBC>(0x1000);
+
+    SQLRETURN connection_dead_result = SQL_SUCCESS;
+    SQLUINTEGER connection_dead_value = SQL_CD_FALSE;
+
+    SQLRETURN MockGetConnectAttr(SQLHDBC, SQLINTEGER, SQLPOINTER value, SQLINTEGER, SQLINTEGER*) {
+        *static_cast<SQLUINTEGER*>(value) = connection_dead_value;
+        return connection_dead_result;
+    }
+}
+
+class VALIDATION_MOCK_LIB_LOADER : public RdsLibLoader {
+public:
+    VALIDATION_MOCK_LIB_LOADER() : RdsLibLoader("") {}
+
+    FUNC_HANDLE GetFunction(const std::string& function_name) override {
+        if (function_name == RDS_STR_SQLGetConnectAttr) {
+            return reinterpret_cast<FUNC_HANDLE>(&MockGetConnectAttr);
+        }
+        return nullptr;
+    }
+};
+
+// Validation goes through the real IsClosed and BaseIsClosed, only the fallback query is mocked
+class MOCK_VALIDATION_ODBC_HELPER : public OdbcHelper {
+public:
+    MOCK_VALIDATION_ODBC_HELPER() : OdbcHelper(std::make_shared<VALIDATION_MOCK_LIB_LOADER>(), nullptr) {};
+    MOCK_METHOD(RdsLibResult, BaseAllocStmt, (const SQLHDBC *wrapped_dbc, SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, BaseFreeStmt, (SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, ExecDirect, (const SQLHSTMT *stmt, const std::string &query), (override));
+};
+
+class OdbcHelperTest : public testing::Test {
+protected:
+    std::shared_ptr<NiceMock<MOCK_VALIDATION_ODBC_HELPER>> odbc_helper;
+    DBC dbc;
+
+    void SetUp() override {
+        connection_dead_result = SQL_SUCCESS;
+        connection_dead_value = SQL_CD_FALSE;
+        odbc_helper = std::make_shared<NiceMock<MOCK_VALIDATION_ODBC_HELPER>>();
+        ON_CALL(*odbc_helper, BaseAllocStmt(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*odbc_helper, BaseFreeStmt(_)).WillByDefault(Return(SUCCESS_RESULT));
+
+        dbc.wrapped_dbc = UNDERLYING_DBC;
+        dbc.validation_freshness = std::chrono::minutes(1);
+    }
+
+    void TearDown() override {
+        dbc.wrapped_dbc = SQL_NULL_HDBC;
+    }
+};
+
+TEST_F(OdbcHelperTest, RecentlyActiveConnectionIsNotProbed) {
+    connection_dead_value = SQL_CD_TRUE;
+    OdbcHelper::MarkActive(&dbc);
+    EXPECT_FALSE(odbc_helper->IsClosed(&dbc));
+
+    // A failed call requires probing again
+    OdbcHelper::MarkUnverified(&dbc);
+    EXPECT_TRUE(odbc_helper->IsClosed(&dbc));
+}
+
+TEST_F(OdbcHelperTest, StaleConnectionIsProbed) {
+    dbc.validation_freshness = std::chrono::milliseconds(0);
+    OdbcHelper::MarkActive(&dbc);
+
+    connection_dead_value = SQL_CD_TRUE;
+    EXPECT_TRUE(odbc_helper->IsClosed(&dbc));
+    connection_dead_value = SQL_CD_FALSE;
+    EXPECT_FALSE(odbc_helper->IsClosed(&dbc));
+}
+
+TEST_F(OdbcHelperTest, MissingUnderlyingConnectionIsClosed) {
+    OdbcHelper::MarkActive(&dbc);
+    dbc.wrapped_dbc = SQL_NULL_HDBC;
+    EXPECT_TRUE(odbc_helper->IsClosed(&dbc));
+    EXPECT_TRUE(odbc_helper->IsClosed(SQL_NULL_HDBC));
+}
+
+TEST_F(OdbcHelperTest, QueryWhenConnectionDeadIsUnsupported) {
+    connection_dead_result = SQL_ERROR;
+
+    EXPECT_CALL(*odbc_helper, ExecDirect(_, OdbcHelper::VALIDATION_QUERY))
+        .WillOnce(Return(SUCCESS_RESULT))
+        .WillOnce(Return(ERROR_RESULT));
+    EXPECT_CALL(*odbc_helper, BaseFreeStmt(_)).Times(2);
+
+    EXPECT_FALSE(odbc_helper->BaseIsClosed(UNDERLYING_DBC));
+    EXPECT_TRUE(odbc_helper->BaseIsClosed(UNDERLYING_DBC));
+}
+
+TEST_F(OdbcHelperTest, NoQueryWhenConnectionDeadIsSupported) {
+    EXPECT_CALL(*odbc_helper, ExecDirect(_, _)).Times(0);
+    EXPECT_FALSE(odbc_helper->BaseIsClosed(UNDERLYING_DBC));
+}
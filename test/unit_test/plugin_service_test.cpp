@@ -88,6 +88,31 @@ TEST_F(PluginServiceTest, GetFilteredHosts_Blocked) {
     EXPECT_EQ(expected_hosts, topology_hosts);
 }
 
+TEST_F(PluginServiceTest, TopologySnapshot_SharedUntilUpdated) {
+    const std::shared_ptr<const TopologySnapshot> snapshot = plugin_service->GetTopologySnapshot();
+    EXPECT_EQ(all_hosts, snapshot->hosts);
+    EXPECT_EQ(snapshot, plugin_service->GetTopologySnapshot());
+
+    plugin_service->SetHosts({host_a});
+    const std::shared_ptr<const TopologySnapshot> updated = plugin_service->GetTopologySnapshot();
+    EXPECT_EQ(std::vector<HostInfo>{host_a}, updated->hosts);
+    EXPECT_GT(updated->version, snapshot->version);
+
+    // Published snapshots are not modified
+    EXPECT_EQ(all_hosts, snapshot->hosts);
+}
+
+TEST_F(PluginServiceTest, FilteredTopologySnapshot_NoFilter) {
+    plugin_service->SetHostFilter(HostFilter{});
+    EXPECT_EQ(plugin_service->GetTopologySnapshot(), plugin_service->GetFilteredTopologySnapshot());
+}
+
+TEST_F(PluginServiceTest, ProvisionalHosts_NotReplacingTopology) {
+    plugin_service->SetProvisionalHosts({host_a});
+    EXPECT_EQ(all_hosts, plugin_service->GetHosts());
+    EXPECT_FALSE(plugin_service->GetTopologySnapshot()->provisional);
+}
+
 TEST_F(PluginServiceTest, InitClusterId_UserInput) {
     std::map<std::string, std::string> conn_info;
     std::string expected_id = "custom_id";
@@ -14,8 +14,10 @@
 
 #include "../../driver/host_selector/random_host_selector.h"
 
+#include "../../driver/host_health_registry.h"
 #include "../../driver/host_info.h"
 
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -100,3 +102,72 @@ TEST_F(RandomHostSelectorTest, get_reader_prefers_reader_over_writer) {
         EXPECT_FALSE(host_info.IsHostWriter());
     }
 }
+
+TEST_F(RandomHostSelectorTest, get_reader_skips_lagging_reader) {
+    RandomHostSelector host_selector;
+    host_selector.SetMaxReplicaLag(std::chrono::milliseconds(1000));
+    HostInfo lagging_reader = reader_host_info_a;
+    lagging_reader.SetReplicaLag(std::chrono::milliseconds(5000));
+    std::vector<HostInfo> hosts = {writer_host_info_a, lagging_reader, reader_host_info_b};
+    for (int i = 0; i < 100; i++) {
+        HostInfo host_info = host_selector.GetHost(hosts, false, empty_map);
+        EXPECT_EQ(reader_host_info_b.GetHost(), host_info.GetHost());
+    }
+}
+
+TEST_F(RandomHostSelectorTest, get_reader_all_lagging_prefers_writer) {
+    RandomHostSelector host_selector;
+    host_selector.SetMaxReplicaLag(std::chrono::milliseconds(1000));
+    HostInfo lagging_reader = reader_host_info_a;
+    lagging_reader.SetReplicaLag(std::chrono::milliseconds(5000));
+    std::vector<HostInfo> hosts = {writer_host_info_a, lagging_reader};
+    HostInfo host_info = host_selector.GetHost(hosts, false, empty_map);
+    EXPECT_EQ(writer_host_info_a.GetHost(), host_info.GetHost());
+
+    // Still selected when nothing else is available
+    hosts = {writer_host_info_down, lagging_reader};
+    host_info = host_selector.GetHost(hosts, false, empty_map);
+    EXPECT_EQ(lagging_reader.GetHost(), host_info.GetHost());
+}
+
+TEST_F(RandomHostSelectorTest, replica_lag_ignored_without_limit) {
+    RandomHostSelector host_selector;
+    HostInfo lagging_reader = reader_host_info_a;
+    lagging_reader.SetReplicaLag(std::chrono::milliseconds(5000));
+    std::vector<HostInfo> hosts = {writer_host_info_a, lagging_reader};
+    HostInfo host_info = host_selector.GetHost(hosts, false, empty_map);
+    EXPECT_EQ(lagging_reader.GetHost(), host_info.GetHost());
+}
+
+TEST_F(RandomHostSelectorTest, get_reader_skips_open_circuit) {
+    RandomHostSelector host_selector;
+    HostInfo failing_reader("reader_open_circuit", base_port, UP, READER);
+    for (int i = 0; i < HostHealthRegistry::DEFAULT_FAILURE_THRESHOLD; i++) {
+        HostHealthRegistry::Global().RecordFailure(failing_reader.GetHost());
+    }
+    std::vector<HostInfo> hosts = {writer_host_info_a, failing_reader, reader_host_info_b};
+    for (int i = 0; i < 100; i++) {
+        HostInfo host_info = host_selector.GetHost(hosts, false, empty_map);
+        EXPECT_EQ(reader_host_info_b.GetHost(), host_info.GetHost());
+    }
+
+    // Still selected when nothing else is available
+    hosts = {writer_host_info_down, failing_reader};
+    HostInfo host_info = host_selector.GetHost(hosts, false, empty_map);
+    EXPECT_EQ(failing_reader.GetHost(), host_info.GetHost());
+
+    // Once the backoff has passed, only selecting the host admits it as the probe
+    std::this_thread::sleep_for(HostHealthRegistry::DEFAULT_BASE_BACKOFF_MS);
+    hosts = {writer_host_info_a, failing_reader, reader_host_info_b};
+    host_info = host_selector.GetHost(hosts, false, empty_map);
+    while (host_info.GetHost() != failing_reader.GetHost()) {
+        EXPECT_EQ(CIRCUIT_OPEN, HostHealthRegistry::Global().GetHealth(failing_reader.GetHost()).state);
+        host_info = host_selector.GetHost(hosts, false, empty_map);
+    }
+    EXPECT_EQ(CIRCUIT_HALF_OPEN, HostHealthRegistry::Global().GetHealth(failing_reader.GetHost()).state);
+    // Skipped while the probe is in progress
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(reader_host_info_b.GetHost(), host_selector.GetHost(hosts, false, empty_map).GetHost());
+    }
+    HostHealthRegistry::Global().RecordSuccess(failing_reader.GetHost(), std::chrono::milliseconds(10));
+}
@@ -226,3 +226,84 @@ TEST_F(ReadWriteSplittingPluginTest, RefreshAndStoreTopology_EmptyHosts_ReturnsE
     SQLRETURN ret = plugin->RefreshAndStoreTopology();
     EXPECT_EQ(ret, SQL_ERROR);
 }
+
+TEST_F(ReadWriteSplittingPluginTest, AccessModeRoutesNextStatement) {
+    dbc->conn_attr.insert_or_assign(KEY_RW_SPECULATIVE_READER_CONNECT, VALUE_BOOL_FALSE);
+    auto plugin = MakePlugin();
+    dbc->wrapped_dbc = fake_writer_hdbc;
+    plugin->SetCurrentConnection(fake_writer_hdbc);
+
+    DBC* reader_dbc = new DBC();
+    reader_dbc->env = &env;
+    reader_dbc->wrapped_dbc = fake_reader_hdbc;
+    reader_dbc->plugin_head = nullptr;
+
+    ON_CALL(*mock_odbc_helper, AllocDbc(_, _))
+        .WillByDefault([reader_dbc](SQLHENV&, SQLHDBC& hdbc) -> SQLRETURN {
+            hdbc = static_cast<SQLHDBC>(reader_dbc);
+            return SQL_SUCCESS;
+        });
+    ON_CALL(*mock_next_plugin, Connect(_, _, _, _, _, _)).WillByDefault(Return(SQL_SUCCESS));
+
+    STMT stmt;
+    stmt.dbc = dbc;
+    stmt.wrapped_stmt = SQL_NULL_HSTMT;
+    ExecutionContext context;
+
+    plugin->NotifyConnectAttr(dbc, SQL_ATTR_ACCESS_MODE, reinterpret_cast<SQLPOINTER>(SQL_MODE_READ_ONLY));
+    EXPECT_EQ(dbc->wrapped_dbc, fake_writer_hdbc);
+
+    plugin->Execute(&stmt, context);
+    EXPECT_EQ(dbc->wrapped_dbc, fake_reader_hdbc);
+}
+
+TEST_F(ReadWriteSplittingPluginTest, AccessModeUsesSpeculativeReader) {
+    dbc->conn_attr.insert_or_assign(KEY_RW_SPECULATIVE_READER_CONNECT, VALUE_BOOL_TRUE);
+    auto plugin = MakePlugin();
+    dbc->wrapped_dbc = fake_writer_hdbc;
+    plugin->SetCurrentConnection(fake_writer_hdbc);
+
+    DBC* reader_dbc = new DBC();
+    reader_dbc->env = &env;
+    reader_dbc->wrapped_dbc = fake_reader_hdbc;
+    reader_dbc->plugin_head = nullptr;
+
+    // Opened once, in the background, and used by the switch
+    EXPECT_CALL(*mock_odbc_helper, AllocDbc(_, _))
+        .WillOnce([reader_dbc](SQLHENV&, SQLHDBC& hdbc) -> SQLRETURN {
+            hdbc = static_cast<SQLHDBC>(reader_dbc);
+            return SQL_SUCCESS;
+        });
+    ON_CALL(*mock_next_plugin, Connect(_, _, _, _, _, _)).WillByDefault(Return(SQL_SUCCESS));
+
+    STMT stmt;
+    stmt.dbc = dbc;
+    stmt.wrapped_stmt = SQL_NULL_HSTMT;
+    ExecutionContext context;
+
+    plugin->NotifyConnectAttr(dbc, SQL_ATTR_ACCESS_MODE, reinterpret_cast<SQLPOINTER>(SQL_MODE_READ_ONLY));
+    EXPECT_EQ(dbc->wrapped_dbc, fake_writer_hdbc);
+
+    plugin->Execute(&stmt, context);
+    EXPECT_EQ(dbc->wrapped_dbc, fake_reader_hdbc);
+}
+
+TEST_F(ReadWriteSplittingPluginTest, NoSpeculativeReaderBeforeConnect) {
+    dbc->conn_attr.insert_or_assign(KEY_RW_SPECULATIVE_READER_CONNECT, VALUE_BOOL_TRUE);
+    // The plugin chain is only picked up on connect
+    auto plugin = std::make_unique<TestableReadWriteSplittingPlugin>(dbc, mock_next_plugin);
+    dbc->wrapped_dbc = fake_writer_hdbc;
+
+    EXPECT_CALL(*mock_odbc_helper, AllocDbc(_, _)).Times(0);
+    plugin->NotifyConnectAttr(dbc, SQL_ATTR_ACCESS_MODE, reinterpret_cast<SQLPOINTER>(SQL_MODE_READ_ONLY));
+}
+
+TEST_F(ReadWriteSplittingPluginTest, SpeculativeReaderHost) {
+    auto plugin = MakePlugin();
+    EXPECT_EQ(reader_host1.GetHost(), plugin->GetSpeculativeReaderHost().GetHost());
+
+    // Nothing to switch to
+    ON_CALL(*mock_plugin_service, GetHosts())
+        .WillByDefault(Return(std::vector<HostInfo>{writer_host}));
+    EXPECT_TRUE(plugin->GetSpeculativeReaderHost().GetHost().empty());
+}
@@ -310,3 +310,18 @@ TEST_F(RoundRobinHostSelectorTest, get_reader_prefers_reader_over_writer) {
         EXPECT_FALSE(host_info.IsHostWriter());
     }
 }
+
+TEST_F(RoundRobinHostSelectorTest, get_round_robin_skips_lagging_reader) {
+    RoundRobinHostSelector host_selector;
+    host_selector.SetMaxReplicaLag(std::chrono::milliseconds(1000));
+    std::unordered_map<std::string, std::string> props;
+    HostInfo lagging_reader = reader_host_info_b;
+    lagging_reader.SetReplicaLag(std::chrono::milliseconds(5000));
+    std::vector<HostInfo> hosts = {reader_host_info_a, lagging_reader, reader_host_info_c};
+
+    HostInfo host_info = host_selector.GetHost(hosts, false, props);
+    EXPECT_EQ(reader_host_info_a.GetHost(), host_info.GetHost());
+
+    host_info = host_selector.GetHost(hosts, false, props);
+    EXPECT_EQ(reader_host_info_c.GetHost(), host_info.GetHost());
+}
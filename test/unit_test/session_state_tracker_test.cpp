@@ -0,0 +1,202 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "../../driver/util/session_state_tracker.h"
+#include "../../driver/util/sql_query_analyzer.h"
+
+namespace {
+    const std::string PG_ISOLATION = "default_transaction_isolation";
+    const std::string MYSQL_ISOLATION = "transaction_isolation";
+
+    std::vector<std::string> PendingStatements(const SessionStateTracker& tracker) {
+        std::vector<std::string> statements;
+        for (const SessionSetting& setting : tracker.GetPendingSettings()) {
+            statements.push_back(setting.statement);
+        }
+        return statements;
+    }
+}
+
+TEST(SessionStateTrackerTest, ParseVariables) {
+    std::optional<SessionSetting> setting = SessionStateTracker::ParseStatement("SET search_path TO app, public", PG_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("var:search_path", setting->key);
+    EXPECT_EQ("search_path", setting->variable);
+    EXPECT_EQ("app, public", setting->value);
+    EXPECT_EQ("SET search_path TO app, public", setting->statement);
+
+    setting = SessionStateTracker::ParseStatement("set session @@SESSION.Time_Zone = '+00:00'", MYSQL_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("var:time_zone", setting->key);
+    EXPECT_EQ("+00:00", setting->value);
+
+    setting = SessionStateTracker::ParseStatement("SET myapp.tenant = 'acme'", PG_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("var:myapp.tenant", setting->key);
+
+    setting = SessionStateTracker::ParseStatement("SET @batch := 10", MYSQL_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("var:@batch", setting->key);
+    EXPECT_TRUE(setting->variable.empty());
+
+    setting = SessionStateTracker::ParseStatement("SET TIME ZONE 'UTC'", PG_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("timezone", setting->variable);
+    EXPECT_EQ("UTC", setting->value);
+
+    setting = SessionStateTracker::ParseStatement("RESET search_path", PG_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("var:search_path", setting->key);
+    EXPECT_EQ(SessionStateTracker::DEFAULT_VALUE, setting->value);
+
+    setting = SessionStateTracker::ParseStatement("USE `sales`", MYSQL_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("catalog", setting->key);
+    EXPECT_EQ("sales", setting->value);
+}
+
+TEST(SessionStateTrackerTest, ParseIsolationLevel) {
+    std::optional<SessionSetting> setting = SessionStateTracker::ParseStatement(
+        "SET SESSION CHARACTERISTICS AS TRANSACTION ISOLATION LEVEL SERIALIZABLE", PG_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ("isolation", setting->key);
+    EXPECT_EQ(PG_ISOLATION, setting->variable);
+    EXPECT_EQ("serializable", setting->value);
+
+    setting = SessionStateTracker::ParseStatement("SET SESSION TRANSACTION ISOLATION LEVEL READ COMMITTED", MYSQL_ISOLATION);
+    ASSERT_TRUE(setting.has_value());
+    EXPECT_EQ(MYSQL_ISOLATION, setting->variable);
+    EXPECT_EQ("read committed", setting->value);
+}
+
+TEST(SessionStateTrackerTest, ParseIgnoresUntrackedStatements) {
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SELECT 1", PG_ISOLATION).has_value());
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SET LOCAL search_path TO app", PG_ISOLATION).has_value());
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SET GLOBAL max_connections = 10", MYSQL_ISOLATION).has_value());
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SET TRANSACTION ISOLATION LEVEL SERIALIZABLE", MYSQL_ISOLATION).has_value());
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SET SESSION TRANSACTION READ ONLY", MYSQL_ISOLATION).has_value());
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SET autocommit = 0", MYSQL_ISOLATION).has_value());
+    EXPECT_FALSE(SessionStateTracker::ParseStatement("SET SESSION transaction_read_only = 1", MYSQL_ISOLATION).has_value());
+}
+
+TEST(SessionStateTrackerTest, AppliedSettingsAreNotReplayed) {
+    SessionStateTracker tracker;
+    tracker.TrackStatement("SET search_path TO app; SET TIME ZONE 'UTC'", PG_ISOLATION);
+    EXPECT_TRUE(tracker.HasSettings());
+    EXPECT_TRUE(tracker.GetPendingSettings().empty());
+
+    // A later change to the same setting replaces it
+    tracker.TrackStatement("SET search_path TO reporting", PG_ISOLATION);
+    tracker.MarkConnected({});
+    tracker.SetServerDefault("search_path", "\"$user\", public");
+    tracker.SetServerDefault("timezone", "America/Vancouver");
+    EXPECT_EQ((std::vector<std::string>{"SET TIME ZONE 'UTC'", "SET search_path TO reporting"}), PendingStatements(tracker));
+
+    for (const SessionSetting& setting : tracker.GetPendingSettings()) {
+        tracker.MarkApplied(setting);
+    }
+    EXPECT_TRUE(tracker.GetPendingSettings().empty());
+}
+
+TEST(SessionStateTrackerTest, MatchingServerDefaultsAreSkipped) {
+    SessionStateTracker tracker;
+    tracker.TrackStatement("SET SESSION TRANSACTION ISOLATION LEVEL READ COMMITTED", MYSQL_ISOLATION);
+    tracker.TrackStatement("SET @@SESSION.time_zone = '+00:00'", MYSQL_ISOLATION);
+    tracker.TrackStatement("SET @batch = 10", MYSQL_ISOLATION);
+    tracker.TrackStatement("SET sql_mode = DEFAULT", MYSQL_ISOLATION);
+
+    tracker.MarkConnected({});
+    EXPECT_EQ((std::vector<std::string>{MYSQL_ISOLATION, "time_zone"}), tracker.GetUnknownDefaults());
+
+    tracker.SetServerDefault(MYSQL_ISOLATION, "READ-COMMITTED");
+    tracker.SetServerDefault("time_zone", std::nullopt);
+    EXPECT_TRUE(tracker.GetUnknownDefaults().empty());
+    // Resetting to the default is a no-op on a fresh connection, an unreadable default is replayed
+    EXPECT_EQ((std::vector<std::string>{"SET @@SESSION.time_zone = '+00:00'", "SET @batch = 10"}), PendingStatements(tracker));
+}
+
+TEST(SessionStateTrackerTest, ResetAll) {
+    SessionStateTracker tracker;
+    tracker.TrackStatement("SET search_path TO app", PG_ISOLATION);
+    const AppliedSessionState writer = tracker.TakeApplied();
+    tracker.TrackStatement("DISCARD ALL", PG_ISOLATION);
+    tracker.TrackStatement("SET statement_timeout = 1000", PG_ISOLATION);
+
+    // Nothing set on a fresh connection needs resetting
+    tracker.MarkConnected({});
+    tracker.SetServerDefault("statement_timeout", "0");
+    EXPECT_EQ((std::vector<std::string>{"SET statement_timeout = 1000"}), PendingStatements(tracker));
+
+    // Switching back to a connection that still has earlier settings applied
+    tracker.RestoreApplied(writer);
+    EXPECT_EQ((std::vector<std::string>{"DISCARD ALL", "SET statement_timeout = 1000"}), PendingStatements(tracker));
+}
+
+TEST(SessionStateTrackerTest, SwitchingBackReplaysResets) {
+    SessionStateTracker tracker;
+    tracker.MarkConnected({});
+    tracker.TrackStatement("SET search_path TO app; SET statement_timeout = 1000", PG_ISOLATION);
+    tracker.SetServerDefault("search_path", "\"$user\", public");
+    tracker.SetServerDefault("statement_timeout", "0");
+
+    // Writer to a fresh reader, the writer keeps what it has applied
+    AppliedSessionState writer = tracker.TakeApplied();
+    tracker.MarkConnected({});
+    const std::vector<SessionSetting> reader_pending = tracker.GetPendingSettings();
+    EXPECT_EQ((std::vector<std::string>{"SET search_path TO app", "SET statement_timeout = 1000"}), PendingStatements(tracker));
+    for (const SessionSetting& setting : reader_pending) {
+        tracker.MarkApplied(setting);
+    }
+    tracker.TrackStatement("RESET search_path", PG_ISOLATION);
+    tracker.TrackStatement("SET statement_timeout TO DEFAULT", PG_ISOLATION);
+    EXPECT_TRUE(tracker.GetPendingSettings().empty());
+
+    // Back to the writer, which still has the settings the reader reset
+    AppliedSessionState reader = tracker.TakeApplied();
+    tracker.RestoreApplied(std::move(writer));
+    EXPECT_EQ((std::vector<std::string>{"RESET search_path", "SET statement_timeout TO DEFAULT"}), PendingStatements(tracker));
+    for (const SessionSetting& setting : tracker.GetPendingSettings()) {
+        tracker.MarkApplied(setting);
+    }
+
+    // And to the reader again, which is already up to date
+    writer = tracker.TakeApplied();
+    tracker.RestoreApplied(std::move(reader));
+    EXPECT_TRUE(tracker.GetPendingSettings().empty());
+    tracker.TrackStatement("RESET ALL", PG_ISOLATION);
+    tracker.TakeApplied();
+    tracker.RestoreApplied(std::move(writer));
+    EXPECT_EQ((std::vector<std::string>{"RESET ALL"}), PendingStatements(tracker));
+}
+
+TEST(SessionStateTrackerTest, MultipleAssignmentsReplayAsIs) {
+    SessionStateTracker tracker;
+    tracker.TrackStatement("SET sql_mode = 'ANSI', @@SESSION.time_zone = '+00:00'", MYSQL_ISOLATION);
+    tracker.TrackStatement("SET sql_mode = 'TRADITIONAL'", MYSQL_ISOLATION);
+    tracker.MarkConnected({});
+    tracker.SetServerDefault("sql_mode", "");
+
+    EXPECT_EQ((std::vector<std::string>{
+        "SET sql_mode = 'ANSI', @@SESSION.time_zone = '+00:00'",
+        "SET sql_mode = 'TRADITIONAL'"
+    }), PendingStatements(tracker));
+}
+
+TEST(SessionStateTrackerTest, AnalyzerFlagsSessionStatements) {
+    EXPECT_TRUE(SqlQueryAnalyzer::Classify("SET search_path TO app").MayChangeSessionState());
+    EXPECT_TRUE(SqlQueryAnalyzer::Classify("SELECT 1; USE sales").MayChangeSessionState());
+    EXPECT_FALSE(SqlQueryAnalyzer::Classify("SELECT 1").MayChangeSessionState());
+}
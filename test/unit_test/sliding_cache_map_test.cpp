@@ -17,6 +17,7 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -157,3 +158,60 @@ TEST_F(SlidingCacheMapTest, ttl_update_get) {
     EXPECT_EQ(1, cache.Size());
     EXPECT_STREQ(cache_val_a.c_str(), cache.Get(cache_key_a).c_str());
 }
+
+TEST_F(SlidingCacheMapTest, get_shared_no_copy) {
+    SlidingCacheMap<std::string, std::string> cache;
+    EXPECT_EQ(nullptr, cache.GetShared(cache_key_a));
+    cache.Put(cache_key_a, cache_val_a);
+    const std::shared_ptr<const std::string> value = cache.GetShared(cache_key_a);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(cache_val_a, *value);
+    EXPECT_EQ(value, cache.GetShared(cache_key_a));
+
+    // Replacing the value does not change the one already handed out
+    cache.Put(cache_key_a, cache_val_b);
+    EXPECT_EQ(cache_val_a, *value);
+    EXPECT_EQ(cache_val_b, *cache.GetShared(cache_key_a));
+}
+
+TEST_F(SlidingCacheMapTest, cache_delete) {
+    SlidingCacheMap<std::string, std::string> cache;
+    cache.Put(cache_key_a, cache_val_a);
+    cache.Put(cache_key_b, cache_val_b);
+    cache.Delete(cache_key_a);
+    cache.Delete(cache_key_a);
+    EXPECT_EQ(1, cache.Size());
+    EXPECT_FALSE(cache.Find(cache_key_a));
+    EXPECT_TRUE(cache.Find(cache_key_b));
+}
+
+TEST_F(SlidingCacheMapTest, put_if_absent) {
+    SlidingCacheMap<std::string, std::string> cache;
+    cache.PutIfAbsent(cache_key_a, cache_val_a);
+    cache.PutIfAbsent(cache_key_a, cache_val_b);
+    EXPECT_EQ(1, cache.Size());
+    EXPECT_EQ(cache_val_a, cache.Get(cache_key_a));
+}
+
+TEST_F(SlidingCacheMapTest, concurrent_access) {
+    SlidingCacheMap<std::string, std::string> cache;
+    constexpr int THREAD_COUNT = 8;
+    constexpr int KEY_COUNT = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 1000; i++) {
+                const std::string key = std::to_string(i % KEY_COUNT);
+                if (i % 4 == t % 4) {
+                    cache.Put(key, key);
+                } else if (const std::shared_ptr<const std::string> value = cache.GetShared(key)) {
+                    EXPECT_EQ(key, *value);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(KEY_COUNT, cache.Size());
+}
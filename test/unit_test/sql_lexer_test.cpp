@@ -0,0 +1,142 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../../driver/util/sql_lexer.h"
+
+namespace {
+    std::vector<SqlToken> Tokenize(std::string_view sql, const bool backslash_escapes = false) {
+        std::vector<SqlToken> tokens;
+        SqlLexer lexer(sql, backslash_escapes);
+        for (SqlToken token = lexer.Next(); token.type != TOKEN_END; token = lexer.Next()) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    std::vector<std::string> StatementHeads(std::string_view sql) {
+        std::vector<std::string> heads;
+        SqlLexer lexer(sql);
+        SqlStatementHead head;
+        while (lexer.NextStatement(head)) {
+            heads.emplace_back(head.tokens[0].text);
+        }
+        return heads;
+    }
+}  // namespace
+
+class SqlLexerTest : public testing::Test {};
+
+TEST_F(SqlLexerTest, TokenTypes) {
+    const std::vector<SqlToken> tokens = Tokenize("SELECT @@aurora_server_id, 1.5e3 FROM t WHERE a='x';");
+    ASSERT_EQ(11u, tokens.size());
+    EXPECT_EQ(TOKEN_WORD, tokens[0].type);
+    EXPECT_EQ("@@aurora_server_id", tokens[1].text);
+    EXPECT_EQ(TOKEN_WORD, tokens[1].type);
+    EXPECT_EQ(TOKEN_OPERATOR, tokens[2].type);
+    EXPECT_EQ("1.5e3", tokens[3].text);
+    EXPECT_EQ(TOKEN_NUMBER, tokens[3].type);
+    EXPECT_EQ(TOKEN_OPERATOR, tokens[8].type);
+    EXPECT_FALSE(tokens[8].preceded_by_space);
+    EXPECT_EQ("'x'", tokens[9].text);
+    EXPECT_EQ(TOKEN_STRING, tokens[9].type);
+    EXPECT_EQ(TOKEN_SEMICOLON, tokens[10].type);
+}
+
+TEST_F(SqlLexerTest, CommentsAreSkipped) {
+    const std::vector<SqlToken> tokens = Tokenize("/* lead */select/**/1 -- tail ; select 2\n+ 2 /* unterminated ;");
+    ASSERT_EQ(4u, tokens.size());
+    EXPECT_EQ("select", tokens[0].text);
+    EXPECT_TRUE(tokens[0].preceded_by_space);
+    EXPECT_EQ("1", tokens[1].text);
+    EXPECT_TRUE(tokens[1].preceded_by_space);
+    EXPECT_EQ("+", tokens[2].text);
+    EXPECT_EQ("2", tokens[3].text);
+}
+
+TEST_F(SqlLexerTest, QuotedText) {
+    const std::vector<SqlToken> tokens = Tokenize(R"(select 'it''s;', 'a\';b', "x"";y", `z;`)", true);
+    ASSERT_EQ(8u, tokens.size());
+    EXPECT_EQ("'it''s;'", tokens[1].text);
+    EXPECT_EQ(R"('a\';b')", tokens[3].text);
+    EXPECT_EQ(R"("x"";y")", tokens[5].text);
+    EXPECT_EQ(TOKEN_QUOTED_IDENTIFIER, tokens[5].type);
+    EXPECT_EQ("`z;`", tokens[7].text);
+    EXPECT_EQ(TOKEN_QUOTED_IDENTIFIER, tokens[7].type);
+}
+
+TEST_F(SqlLexerTest, BackslashEscapes) {
+    // Standard conforming strings, a backslash is an ordinary character
+    std::vector<SqlToken> tokens = Tokenize(R"(select 'a\'; select 2)");
+    ASSERT_EQ(5u, tokens.size());
+    EXPECT_EQ(R"('a\')", tokens[1].text);
+    EXPECT_EQ(TOKEN_SEMICOLON, tokens[2].type);
+
+    // Escape strings always honor backslashes
+    tokens = Tokenize(R"(select E'a\';b', e'c')");
+    ASSERT_EQ(4u, tokens.size());
+    EXPECT_EQ(R"(E'a\';b')", tokens[1].text);
+    EXPECT_EQ(TOKEN_STRING, tokens[1].type);
+    EXPECT_EQ("e'c'", tokens[3].text);
+
+    // Words starting with an E are not escape strings
+    tokens = Tokenize("select end_date");
+    ASSERT_EQ(2u, tokens.size());
+    EXPECT_EQ(TOKEN_WORD, tokens[1].type);
+}
+
+TEST_F(SqlLexerTest, DollarQuoting) {
+    std::vector<SqlToken> tokens = Tokenize("do $$ begin; end $$; select $fn$ ; $x$ $fn$");
+    ASSERT_EQ(5u, tokens.size());
+    EXPECT_EQ("$$ begin; end $$", tokens[1].text);
+    EXPECT_EQ(TOKEN_STRING, tokens[1].type);
+    EXPECT_EQ("$fn$ ; $x$ $fn$", tokens[4].text);
+
+    // Positional parameters are not dollar quotes
+    tokens = Tokenize("select $1; select $2");
+    ASSERT_EQ(7u, tokens.size());
+    EXPECT_EQ("$", tokens[1].text);
+    EXPECT_EQ(TOKEN_SEMICOLON, tokens[3].type);
+}
+
+TEST_F(SqlLexerTest, NextStatement) {
+    EXPECT_EQ(std::vector<std::string>({"select", "begin", "commit"}),
+        StatementHeads(" ; select ';' ;; begin /* ; */ ; -- ;\n commit"));
+    EXPECT_TRUE(StatementHeads("").empty());
+    EXPECT_TRUE(StatementHeads(" ; /* only a comment */ ;").empty());
+
+    SqlLexer lexer("select a, b, c, d, e, f, g, h, i; rollback");
+    SqlStatementHead head;
+    ASSERT_TRUE(lexer.NextStatement(head));
+    EXPECT_EQ(SqlStatementHead::MAX_TOKENS, head.count);
+    ASSERT_TRUE(lexer.NextStatement(head));
+    EXPECT_TRUE(head.StartsWith("ROLLBACK"));
+    EXPECT_FALSE(lexer.NextStatement(head));
+}
+
+TEST_F(SqlLexerTest, StatementHeadStartsWith) {
+    SqlLexer lexer("Set /* c */ SESSION transaction read only");
+    SqlStatementHead head;
+    ASSERT_TRUE(lexer.NextStatement(head));
+    EXPECT_TRUE(head.StartsWith("SET SESSION TRANSACTION READ ONLY"));
+    EXPECT_TRUE(head.StartsWith("SET  SESSION"));
+    EXPECT_FALSE(head.StartsWith("SET SESSION TRANSACTION READ WRITE"));
+    EXPECT_FALSE(head.StartsWith("SET SESSION TRANSACTION READ ONLY NOW"));
+    EXPECT_FALSE(head.StartsWith("SE"));
+    EXPECT_FALSE(head.StartsWith(""));
+}
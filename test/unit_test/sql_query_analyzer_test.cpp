@@ -16,6 +16,9 @@
 #include <gtest/gtest.h>
 
 #include <map>
+#include <random>
+
+#include "sql_statement_corpus.h"
 
 #include "../../driver/util/sql_query_analyzer.h"
 
@@ -144,3 +147,194 @@ TEST_F(SqlQueryAnalyzerTest, DoesSetReadOnlyPg) {
     EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(" set session characteristics as transaction read write; select 1", dialect), false);
     EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(" select 1; set session characteristics as transaction read write; select 1", dialect), false);
 }
+
+TEST_F(SqlQueryAnalyzerTest, LiteralsAndCommentsDoNotAffectClassification) {
+    std::shared_ptr<Dialect> mysql = std::make_shared<DialectAuroraMySql>();
+    std::shared_ptr<Dialect> pg = std::make_shared<DialectAuroraPostgres>();
+
+    // Delimiters inside literals, quoted identifiers and comments do not split statements
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly("select ';set session transaction read only'", mysql), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly("select 1 /* ; set session transaction read only */", mysql), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly("select 1 -- ; set session transaction read only", mysql), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly("select `a;set session transaction read only`", mysql), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly("select 'it''s; begin'; set session transaction read only", mysql), true);
+    // Backslashes only escape quotes in MySQL strings and PostgreSQL escape strings
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(R"(select 'a\'; set session transaction read only')", mysql), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(
+        R"(select 'a\'; set session characteristics as transaction read only)", pg), true);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(
+        R"(select E'a\'; set session characteristics as transaction read only')", pg), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(
+        "do $$ begin; set session characteristics as transaction read only; end $$", pg), std::nullopt);
+    EXPECT_EQ(SqlQueryAnalyzer::DoesSetReadOnly(
+        "-- switch to reader\nset session characteristics as transaction read only", pg), true);
+
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesOpenTransaction("/* begin */ select 1"));
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesOpenTransaction("-- begin\nselect 1"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesOpenTransaction("-- comment\nbegin"));
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesOpenTransaction("beginning"));
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, "endpoint_refresh()"));
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_manual_commit, "set autocommit = 10"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_manual_commit, "set autocommit = 'on'"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesOpenTransaction("set autocommit=0"));
+    EXPECT_FALSE(SqlQueryAnalyzer::IsStatementSettingAutoCommit("select 'set autocommit = 1'"));
+
+    EXPECT_STREQ("SELECT 'A;B'", SqlQueryAnalyzer::GetFirstSqlStatement("select 'a;b'; select 2").c_str());
+    const std::vector<std::string> statements = SqlQueryAnalyzer::ParseMultiStatement(" ;select 1;; select $x$;$x$ ;");
+    ASSERT_EQ(2u, statements.size());
+    EXPECT_EQ("select 1", statements[0]);
+    EXPECT_EQ("select $x$;$x$", statements[1]);
+}
+
+TEST_F(SqlQueryAnalyzerTest, MatchesLegacyImplementation) {
+    std::shared_ptr<Dialect> mysql = std::make_shared<DialectAuroraMySql>();
+    std::shared_ptr<Dialect> pg = std::make_shared<DialectAuroraPostgres>();
+    std::mt19937 rng(20240611);
+
+    for (int i = 0; i < 2000; i++) {
+        const std::string batch = GenerateBatch(rng);
+        SCOPED_TRACE(batch);
+        EXPECT_EQ(legacy::GetFirstSqlStatement(batch), SqlQueryAnalyzer::GetFirstSqlStatement(batch));
+        // The legacy analyzer only looked at the first statement for transaction and autocommit changes
+        if (SqlQueryAnalyzer::ParseMultiStatement(batch).size() == 1) {
+            EXPECT_EQ(legacy::DoesOpenTransaction(batch), SqlQueryAnalyzer::DoesOpenTransaction(batch));
+            EXPECT_EQ(legacy::DoesCloseTransaction(dbc_auto_commit->auto_commit, batch), SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, batch));
+            EXPECT_EQ(legacy::DoesCloseTransaction(dbc_manual_commit->auto_commit, batch), SqlQueryAnalyzer::DoesCloseTransaction(dbc_manual_commit, batch));
+            EXPECT_EQ(legacy::IsStatementSettingAutoCommit(batch), SqlQueryAnalyzer::IsStatementSettingAutoCommit(batch));
+            if (SqlQueryAnalyzer::IsStatementSettingAutoCommit(batch)) {
+                EXPECT_EQ(legacy::GetAutoCommitValueFromSqlStatement(batch), SqlQueryAnalyzer::GetAutoCommitValueFromSqlStatement(batch));
+            }
+        }
+        EXPECT_EQ(legacy::DoesSetReadOnly(batch, mysql->GetSetReadOnlyQuery(), mysql->GetSetReadWriteQuery()),
+            SqlQueryAnalyzer::DoesSetReadOnly(batch, mysql));
+        EXPECT_EQ(legacy::DoesSetReadOnly(batch, pg->GetSetReadOnlyQuery(), pg->GetSetReadWriteQuery()),
+            SqlQueryAnalyzer::DoesSetReadOnly(batch, pg));
+    }
+}
+
+namespace {
+    class CountingDialect : public DialectAuroraMySql {
+    public:
+        std::optional<bool> DoesStatementSetReadOnly(const SqlStatementHead& statement) override {
+            calls++;
+            return DialectAuroraMySql::DoesStatementSetReadOnly(statement);
+        }
+        int calls = 0;
+    };
+}  // namespace
+
+TEST_F(SqlQueryAnalyzerTest, Classify) {
+    SqlQueryAnalyzer::ClearClassificationCache();
+    std::shared_ptr<Dialect> mysql = std::make_shared<DialectAuroraMySql>();
+
+    EXPECT_TRUE(SqlQueryAnalyzer::Classify("begin").DoesOpenTransaction());
+    EXPECT_TRUE(SqlQueryAnalyzer::Classify("rollback").DoesCloseTransaction(true));
+    EXPECT_FALSE(SqlQueryAnalyzer::Classify("select 1").DoesCloseTransaction(false));
+
+    const SqlClassification autocommit_on = SqlQueryAnalyzer::Classify("set autocommit = on");
+    EXPECT_TRUE(autocommit_on.IsSettingAutoCommit());
+    EXPECT_TRUE(autocommit_on.GetAutoCommitValue());
+    EXPECT_TRUE(autocommit_on.DoesCloseTransaction(false));
+    EXPECT_FALSE(autocommit_on.DoesCloseTransaction(true));
+    EXPECT_FALSE(SqlQueryAnalyzer::Classify("set autocommit = 0").GetAutoCommitValue());
+
+    EXPECT_EQ(std::nullopt, SqlQueryAnalyzer::Classify("set session transaction read only").DoesSetReadOnly());
+    EXPECT_EQ(true, SqlQueryAnalyzer::Classify("set session transaction read only", mysql).DoesSetReadOnly());
+    EXPECT_EQ(false, SqlQueryAnalyzer::Classify(
+        "set session transaction read only; set session transaction read write", mysql).DoesSetReadOnly());
+    EXPECT_EQ(std::nullopt, SqlQueryAnalyzer::Classify("", mysql).DoesSetReadOnly());
+}
+
+TEST_F(SqlQueryAnalyzerTest, ClassifyCachesPerStatementAndDialect) {
+    SqlQueryAnalyzer::ClearClassificationCache();
+    std::shared_ptr<CountingDialect> mysql = std::make_shared<CountingDialect>();
+    std::shared_ptr<Dialect> pg = std::make_shared<DialectAuroraPostgres>();
+    const std::string set_read_only = "set session transaction read only";
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(true, SqlQueryAnalyzer::Classify(set_read_only, mysql).DoesSetReadOnly());
+    }
+    EXPECT_EQ(1, mysql->calls);
+
+    // Same text under another dialect is classified separately
+    EXPECT_EQ(std::nullopt, SqlQueryAnalyzer::Classify(set_read_only, pg).DoesSetReadOnly());
+
+    SqlQueryAnalyzer::ClearClassificationCache();
+    EXPECT_EQ(true, SqlQueryAnalyzer::Classify(set_read_only, mysql).DoesSetReadOnly());
+    EXPECT_EQ(2, mysql->calls);
+
+    // Statements above the length limit are never cached
+    const std::string long_statement = set_read_only + "; select '" + std::string(5000, 'x') + "'";
+    SqlQueryAnalyzer::Classify(long_statement, mysql);
+    SqlQueryAnalyzer::Classify(long_statement, mysql);
+    EXPECT_EQ(6, mysql->calls);
+}
+
+TEST_F(SqlQueryAnalyzerTest, CachedClassificationMatchesStatement) {
+    SqlQueryAnalyzer::ClearClassificationCache();
+    std::shared_ptr<Dialect> mysql = std::make_shared<DialectAuroraMySql>();
+    std::mt19937 rng(7);
+    std::vector<std::string> corpus;
+    // More statements than cache slots, so slots are shared and replaced
+    for (int i = 0; i < 10000; i++) {
+        corpus.push_back(GenerateBatch(rng));
+    }
+
+    for (int round = 0; round < 2; round++) {
+        for (const std::string &sql : corpus) {
+            SCOPED_TRACE(sql);
+            EXPECT_EQ(SqlQueryAnalyzer::GetNetEffect(SqlQueryAnalyzer::ClassifyBatch(sql, mysql)).flags,
+                SqlQueryAnalyzer::Classify(sql, mysql).flags);
+        }
+    }
+}
+
+TEST_F(SqlQueryAnalyzerTest, ClassifyBatch) {
+    std::shared_ptr<Dialect> mysql = std::make_shared<DialectAuroraMySql>();
+    const std::vector<SqlClassification> statements = SqlQueryAnalyzer::ClassifyBatch(
+        "set autocommit = 0; update t set a = 1; set session transaction read only; commit", mysql);
+    ASSERT_EQ(4u, statements.size());
+    EXPECT_TRUE(statements[0].DoesOpenTransaction());
+    EXPECT_TRUE(statements[0].IsSettingAutoCommit());
+    EXPECT_FALSE(statements[0].GetAutoCommitValue());
+    EXPECT_EQ(0, statements[1].flags & ~SQL_CLASS_VALID);
+    EXPECT_EQ(true, statements[2].DoesSetReadOnly());
+    EXPECT_TRUE(statements[3].DoesCloseTransaction(true));
+
+    const SqlClassification net = SqlQueryAnalyzer::GetNetEffect(statements);
+    EXPECT_FALSE(net.DoesOpenTransaction());
+    EXPECT_TRUE(net.DoesCloseTransaction(true));
+    EXPECT_TRUE(net.IsSettingAutoCommit());
+    EXPECT_FALSE(net.GetAutoCommitValue());
+    EXPECT_EQ(true, net.DoesSetReadOnly());
+    EXPECT_EQ(net.flags, SqlQueryAnalyzer::Classify(
+        "set autocommit = 0; update t set a = 1; set session transaction read only; commit", mysql).flags);
+}
+
+TEST_F(SqlQueryAnalyzerTest, BatchNetEffect) {
+    // Transaction opened and closed within the batch
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesOpenTransaction("begin; update t set a = 1; commit"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, "begin; update t set a = 1; commit"));
+    // Transaction left open by a later statement
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesOpenTransaction("select 1; begin; update t set a = 1"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesOpenTransaction("commit; start transaction"));
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, "commit; start transaction"));
+    // Last autocommit change wins
+    EXPECT_TRUE(SqlQueryAnalyzer::IsStatementSettingAutoCommit("select 1; set autocommit = 1"));
+    EXPECT_FALSE(SqlQueryAnalyzer::GetAutoCommitValueFromSqlStatement("set autocommit = 1; set autocommit = 0"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesOpenTransaction("set autocommit = 1; set autocommit = 0"));
+
+    // Turning autocommit back on commits the transaction the batch opened, whatever the connection mode was
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, "set autocommit = 0; update t set a = 1; set autocommit = 1"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, "begin; update t set a = 1; set autocommit = 1"));
+    // Otherwise it only closes a transaction when the connection was in manual commit mode
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_auto_commit, "update t set a = 1; set autocommit = 1"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_manual_commit, "update t set a = 1; set autocommit = 1"));
+    EXPECT_FALSE(SqlQueryAnalyzer::DoesCloseTransaction(dbc_manual_commit, "set autocommit = 1; begin"));
+    EXPECT_TRUE(SqlQueryAnalyzer::DoesSwitchAutoCommitFalseTrue(dbc_manual_commit, "select 1; set autocommit = on"));
+
+    // A batch is only a SELECT if every statement is one
+    EXPECT_TRUE(SqlQueryAnalyzer::Classify("select 1; select 2").Has(SQL_CLASS_SELECT));
+    EXPECT_FALSE(SqlQueryAnalyzer::Classify("select 1; update t set a = 1").Has(SQL_CLASS_SELECT));
+    EXPECT_FALSE(SqlQueryAnalyzer::Classify("update t set a = 1; select 1").Has(SQL_CLASS_SELECT));
+}
@@ -0,0 +1,275 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+
+#include "common_mock_objects.h"
+
+#include "../../driver/driver.h"
+#include "../../driver/plugin/base_plugin.h"
+#include "../../driver/plugin/failover/standby_connection_pool.h"
+#include "../../driver/util/connection_string_keys.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+    const SQLHDBC UNDERLYING_CONN = reinterpret_cast<SQLHDBC>(0x1);
+
+    const HostInfo WRITER_HOST("writer.cluster.com", 5432, UP, WRITER);
+    const HostInfo READER_HOST_A("reader-a.cluster.com", 5432, UP, READER);
+    const HostInfo READER_HOST_B("reader-b.cluster.com", 5432, UP, READER);
+}
+
+class MOCK_STANDBY_PLUGIN : public BasePlugin {
+public:
+    MOCK_STANDBY_PLUGIN() : BasePlugin() {}
+    MOCK_METHOD(SQLRETURN, Connect,
+        (SQLHDBC ConnectionHandle, SQLHWND WindowHandle, SQLTCHAR *OutConnectionString, SQLSMALLINT BufferLength,
+        SQLSMALLINT *StringLengthPtr, SQLUSMALLINT DriverCompletion), (override));
+};
+
+class TEST_STANDBY_TOPOLOGY_PROVIDER : public HostListProvider {
+public:
+    TEST_STANDBY_TOPOLOGY_PROVIDER() : HostListProvider("cluster") {}
+    std::shared_ptr<TopologySubscription> Subscribe(std::function<void()> on_event) override {
+        return publisher.Subscribe(std::move(on_event));
+    }
+
+    TopologyEventPublisher publisher;
+};
+
+class StandbyConnectionPoolTest : public testing::Test {
+protected:
+    ENV env;
+    std::shared_ptr<NiceMock<MOCK_PLUGIN_SERVICE>> mock_plugin_service;
+    std::shared_ptr<NiceMock<MOCK_ODBC_HELPER>> mock_odbc_helper;
+    std::shared_ptr<NiceMock<MOCK_STANDBY_PLUGIN>> mock_plugin;
+    std::vector<std::string> connected_hosts;
+    StandbyConnectionConfig config;
+
+    void SetUp() override {
+        mock_plugin_service = std::make_shared<NiceMock<MOCK_PLUGIN_SERVICE>>();
+        mock_odbc_helper = std::make_shared<NiceMock<MOCK_ODBC_HELPER>>();
+        mock_plugin = std::make_shared<NiceMock<MOCK_STANDBY_PLUGIN>>();
+
+        ON_CALL(*mock_plugin_service, GetHosts()).WillByDefault(Return(std::vector<HostInfo>{WRITER_HOST, READER_HOST_A, READER_HOST_B}));
+        ON_CALL(*mock_plugin_service, GetCurrentHostInfo()).WillByDefault(Return(WRITER_HOST));
+
+        ON_CALL(*mock_odbc_helper, AllocDbc(_, _)).WillByDefault(Invoke([this](SQLHENV& henv, SQLHDBC& hdbc) {
+            DBC* dbc = new DBC();
+            dbc->env = &env;
+            env.dbc_list.push_back(dbc);
+            hdbc = dbc;
+            return SQL_SUCCESS;
+        }));
+        ON_CALL(*mock_odbc_helper, DisconnectAndFree(_)).WillByDefault(Invoke([this](SQLHDBC* hdbc) {
+            DBC* dbc = static_cast<DBC*>(*hdbc);
+            env.dbc_list.remove(dbc);
+            delete dbc;
+            *hdbc = SQL_NULL_HDBC;
+        }));
+        ON_CALL(*mock_odbc_helper, IsClosed(_)).WillByDefault(Return(false));
+
+        ON_CALL(*mock_plugin, Connect(_, _, _, _, _, _)).WillByDefault(Invoke(
+            [this](SQLHDBC hdbc, SQLHWND, SQLTCHAR*, SQLSMALLINT, SQLSMALLINT*, SQLUSMALLINT) {
+                DBC* dbc = static_cast<DBC*>(hdbc);
+                connected_hosts.push_back(dbc->conn_attr.at(KEY_SERVER));
+                dbc->wrapped_dbc = UNDERLYING_CONN;
+                return SQL_SUCCESS;
+            }));
+
+        config.enabled = true;
+        config.standby_count = 1;
+    }
+
+    std::shared_ptr<StandbyConnectionPool> CreatePool() {
+        const std::map<std::string, std::string> conn_attr = {{KEY_SERVER, WRITER_HOST.GetHost()}};
+        const std::shared_ptr<HostConnectionFactory> factory = std::make_shared<HostConnectionFactory>(
+            conn_attr, mock_plugin_service, mock_plugin, mock_odbc_helper, &env);
+        return std::make_shared<StandbyConnectionPool>(mock_plugin_service, factory, config);
+    }
+};
+
+TEST_F(StandbyConnectionPoolTest, ConfigFromConnAttr) {
+    const StandbyConnectionConfig defaults = StandbyConnectionConfig::FromConnAttr({});
+    EXPECT_FALSE(defaults.enabled);
+    EXPECT_EQ(StandbyConnectionConfig::DEFAULT_STANDBY_COUNT, defaults.standby_count);
+    EXPECT_EQ(StandbyConnectionConfig::DEFAULT_REFRESH_MS, defaults.refresh_ms);
+
+    const StandbyConnectionConfig configured = StandbyConnectionConfig::FromConnAttr({
+        {KEY_ENABLE_FAILOVER_STANDBY, VALUE_BOOL_TRUE},
+        {KEY_FAILOVER_STANDBY_COUNT, "2"},
+        {KEY_FAILOVER_STANDBY_REFRESH, "1000"}
+    });
+    EXPECT_TRUE(configured.enabled);
+    EXPECT_EQ(2, configured.standby_count);
+    EXPECT_EQ(std::chrono::milliseconds(1000), configured.refresh_ms);
+}
+
+TEST_F(StandbyConnectionPoolTest, RefreshOpensStandbysToOtherHosts) {
+    config.standby_count = 2;
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+
+    pool->RefreshStandbys();
+
+    EXPECT_EQ(2, pool->GetStandbyCount());
+    EXPECT_EQ((std::vector<std::string>{READER_HOST_A.GetHost(), READER_HOST_B.GetHost()}), connected_hosts);
+    // Standbys are owned by the pool, not the application's environment
+    EXPECT_TRUE(env.dbc_list.empty());
+
+    // Already at the configured count
+    pool->RefreshStandbys();
+    EXPECT_EQ(2, connected_hosts.size());
+}
+
+TEST_F(StandbyConnectionPoolTest, RefreshPrefersReaders) {
+    config.standby_count = 2;
+    ON_CALL(*mock_plugin_service, GetCurrentHostInfo()).WillByDefault(Return(READER_HOST_A));
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+
+    pool->RefreshStandbys();
+
+    EXPECT_EQ((std::vector<std::string>{READER_HOST_B.GetHost(), WRITER_HOST.GetHost()}), connected_hosts);
+}
+
+TEST_F(StandbyConnectionPoolTest, RefreshReplacesUnusableStandbys) {
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+    pool->RefreshStandbys();
+    ASSERT_EQ(std::vector<std::string>{READER_HOST_A.GetHost()}, connected_hosts);
+
+    // Reader A left the topology
+    ON_CALL(*mock_plugin_service, GetHosts()).WillByDefault(Return(std::vector<HostInfo>{WRITER_HOST, READER_HOST_B}));
+    pool->RefreshStandbys();
+    EXPECT_EQ(1, pool->GetStandbyCount());
+    EXPECT_EQ(READER_HOST_B.GetHost(), connected_hosts.back());
+
+    // Reader B's connection died
+    EXPECT_CALL(*mock_odbc_helper, IsClosed(_)).WillOnce(Return(true)).WillRepeatedly(Return(false));
+    pool->RefreshStandbys();
+    EXPECT_EQ(1, pool->GetStandbyCount());
+    EXPECT_EQ(3, connected_hosts.size());
+}
+
+TEST_F(StandbyConnectionPoolTest, ValidationDoesNotBlockTake) {
+    config.standby_count = 2;
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+    pool->RefreshStandbys();
+    ASSERT_EQ(2, pool->GetStandbyCount());
+
+    // The validation of the first standby hangs until released
+    std::promise<void> validating;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> calls = 0;
+    ON_CALL(*mock_odbc_helper, IsClosed(_)).WillByDefault(Invoke([&](SQLHDBC) {
+        if (calls++ == 0) {
+            validating.set_value();
+            released.wait();
+        }
+        return false;
+    }));
+    std::thread refresh([&pool] { pool->RefreshStandbys(); });
+    validating.get_future().wait();
+
+    EXPECT_EQ(UNDERLYING_CONN, pool->TakeUnderlyingConnection(READER_HOST_B.GetHost()));
+    release.set_value();
+    refresh.join();
+
+    // Reader A is kept and reader B replaced
+    EXPECT_EQ(2, pool->GetStandbyCount());
+    EXPECT_EQ(3, connected_hosts.size());
+}
+
+TEST_F(StandbyConnectionPoolTest, FailedConnectIsNotKept) {
+    EXPECT_CALL(*mock_plugin, Connect(_, _, _, _, _, _)).WillRepeatedly(Return(SQL_ERROR));
+    EXPECT_CALL(*mock_odbc_helper, DisconnectAndFree(_)).Times(2);
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+
+    pool->RefreshStandbys();
+
+    EXPECT_EQ(0, pool->GetStandbyCount());
+}
+
+TEST_F(StandbyConnectionPoolTest, TakeUnderlyingConnection) {
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+    pool->RefreshStandbys();
+
+    EXPECT_EQ(SQL_NULL_HDBC, pool->TakeUnderlyingConnection(READER_HOST_B.GetHost()));
+    EXPECT_EQ(UNDERLYING_CONN, pool->TakeUnderlyingConnection(READER_HOST_A.GetHost()));
+    EXPECT_EQ(0, pool->GetStandbyCount());
+    EXPECT_EQ(SQL_NULL_HDBC, pool->TakeUnderlyingConnection(READER_HOST_A.GetHost()));
+}
+
+TEST_F(StandbyConnectionPoolTest, TakeDiscardsDeadStandby) {
+    const std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+    pool->RefreshStandbys();
+
+    EXPECT_CALL(*mock_odbc_helper, IsClosed(_)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_odbc_helper, DisconnectAndFree(_)).Times(1);
+    EXPECT_EQ(SQL_NULL_HDBC, pool->TakeUnderlyingConnection(READER_HOST_A.GetHost()));
+    EXPECT_EQ(0, pool->GetStandbyCount());
+}
+
+TEST_F(StandbyConnectionPoolTest, MonitorRefreshesOnScheduler) {
+    config.refresh_ms = std::chrono::milliseconds(10);
+    std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+
+    pool->StartMonitor();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pool->GetStandbyCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(1, pool->GetStandbyCount());
+
+    // Stops the task before closing the standbys
+    pool.reset();
+    EXPECT_TRUE(env.dbc_list.empty());
+}
+
+TEST_F(StandbyConnectionPoolTest, RemovedHostWakesMonitor) {
+    // Only topology changes refresh the standbys within the test
+    config.refresh_ms = std::chrono::hours(1);
+    const std::shared_ptr<TEST_STANDBY_TOPOLOGY_PROVIDER> provider = std::make_shared<TEST_STANDBY_TOPOLOGY_PROVIDER>();
+    std::atomic<bool> removed = false;
+    ON_CALL(*mock_plugin_service, GetHostListProvider()).WillByDefault(Return(provider));
+    ON_CALL(*mock_plugin_service, GetHosts()).WillByDefault(Invoke([&removed] {
+        return removed ? std::vector<HostInfo>{WRITER_HOST, READER_HOST_B} : std::vector<HostInfo>{WRITER_HOST, READER_HOST_A, READER_HOST_B};
+    }));
+    std::shared_ptr<StandbyConnectionPool> pool = CreatePool();
+
+    pool->StartMonitor();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (provider->publisher.GetSubscriptionCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1, pool->GetStandbyCount());
+    EXPECT_EQ(std::vector<std::string>{READER_HOST_A.GetHost()}, connected_hosts);
+
+    removed = true;
+    provider->publisher.Publish({WRITER_HOST, READER_HOST_A, READER_HOST_B}, {WRITER_HOST, READER_HOST_B});
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (connected_hosts.size() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    pool.reset();
+    EXPECT_EQ((std::vector<std::string>{READER_HOST_A.GetHost(), READER_HOST_B.GetHost()}), connected_hosts);
+    EXPECT_TRUE(env.dbc_list.empty());
+}
@@ -0,0 +1,177 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "common_mock_objects.h"
+
+#include "../../driver/driver.h"
+#include "../../driver/odbcapi_rds_helper.h"
+#include "../../driver/util/rds_lib_loader.h"
+#include "../../driver/util/rds_strings.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+    const SQLHDBC UNDERLYING_DBC = reinterpret_cast<SQLHDBC>(0x1000);
+    const SQLHSTMT UNDERLYING_STMT = reinterpret_cast<SQLHSTMT>(0x2000);
+
+    std::vector<SQLUSMALLINT> bound_params;
+    std::vector<SQLUSMALLINT> bound_cols;
+    std::vector<SQLINTEGER> set_attrs;
+
+    SQLRETURN MockAllocHandle(SQLSMALLINT, SQLHANDLE, SQLHANDLE* output) {
+        *output = UNDERLYING_STMT;
+        return SQL_SUCCESS;
+    }
+
+    SQLRETURN MockSetStmtAttr(SQLHSTMT, SQLINTEGER attribute, SQLPOINTER, SQLINTEGER) {
+        set_attrs.push_back(attribute);
+        return SQL_SUCCESS;
+    }
+
+    SQLRETURN MockBindParameter(SQLHSTMT, SQLUSMALLINT number, SQLSMALLINT, SQLSMALLINT, SQLSMALLINT, SQLULEN,
+        SQLSMALLINT, SQLPOINTER, SQLLEN, SQLLEN*) {
+        bound_params.push_back(number);
+        return SQL_SUCCESS;
+    }
+
+    SQLRETURN MockBindCol(SQLHSTMT, SQLUSMALLINT number, SQLSMALLINT, SQLPOINTER, SQLLEN, SQLLEN*) {
+        bound_cols.push_back(number);
+        return SQL_SUCCESS;
+    }
+
+    SQLRETURN MockSuccess() { return SQL_SUCCESS; }
+}
+
+class RESTORE_MOCK_LIB_LOADER : public RdsLibLoader {
+public:
+    RESTORE_MOCK_LIB_LOADER() : RdsLibLoader("") {}
+
+    FUNC_HANDLE GetFunction(const std::string& function_name) override {
+        if (function_name == RDS_STR_SQLAllocHandle) {
+            return reinterpret_cast<FUNC_HANDLE>(&MockAllocHandle);
+        }
+        if (function_name == RDS_STR_SQLSetStmtAttr) {
+            return reinterpret_cast<FUNC_HANDLE>(&MockSetStmtAttr);
+        }
+        if (function_name == RDS_STR_SQLBindParameter) {
+            return reinterpret_cast<FUNC_HANDLE>(&MockBindParameter);
+        }
+        if (function_name == RDS_STR_SQLBindCol) {
+            return reinterpret_cast<FUNC_HANDLE>(&MockBindCol);
+        }
+        return reinterpret_cast<FUNC_HANDLE>(&MockSuccess);
+    }
+};
+
+class StatementRestoreTest : public testing::Test {
+protected:
+    ENV env;
+    DBC dbc;
+    STMT* stmt = nullptr;
+    std::shared_ptr<NiceMock<MOCK_PLUGIN_SERVICE>> mock_plugin_service;
+    std::shared_ptr<NiceMock<MOCK_ODBC_HELPER>> mock_odbc_helper;
+    SQLINTEGER param_value = 0;
+    SQLLEN param_ind = 0;
+    SQLCHAR col_value[16] = {0};
+    SQLLEN col_ind = 0;
+
+    void SetUp() override {
+        bound_params.clear();
+        bound_cols.clear();
+        set_attrs.clear();
+
+        env.driver_lib_loader = std::make_shared<RESTORE_MOCK_LIB_LOADER>();
+        mock_plugin_service = std::make_shared<NiceMock<MOCK_PLUGIN_SERVICE>>();
+        mock_odbc_helper = std::make_shared<NiceMock<MOCK_ODBC_HELPER>>();
+        ON_CALL(*mock_plugin_service, GetOdbcHelper()).WillByDefault(Return(mock_odbc_helper));
+
+        dbc.env = &env;
+        dbc.plugin_service = mock_plugin_service;
+        dbc.wrapped_dbc = UNDERLYING_DBC;
+
+        // Prepared and bound on an underlying connection that failover has since replaced
+        stmt = new STMT();
+        stmt->dbc = &dbc;
+        stmt->wrapped_stmt = SQL_NULL_HSTMT;
+        stmt->attr_map.insert_or_assign(SQL_ATTR_QUERY_TIMEOUT, std::make_pair(reinterpret_cast<SQLPOINTER>(5), 0));
+        stmt->prepared_query = "SELECT name FROM users WHERE id = ?";
+        stmt->param_bindings.insert_or_assign(1, ParamBinding{
+            SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param_value, 0, &param_ind});
+        stmt->col_bindings.insert_or_assign(1, ColBinding{SQL_C_CHAR, col_value, sizeof(col_value), &col_ind});
+    }
+
+    void TearDown() override {
+        delete stmt;
+        dbc.plugin_service.reset();
+    }
+};
+
+TEST_F(StatementRestoreTest, RestoresPreparedStatementAndBindings) {
+    EXPECT_CALL(*mock_odbc_helper, Prepare(_, "SELECT name FROM users WHERE id = ?"))
+        .WillOnce(Return(RdsLibResult{.fn_load_success = true, .fn_result = SQL_SUCCESS}));
+
+    EXPECT_EQ(SQL_SUCCESS, RDS_RestoreStmt(stmt));
+
+    EXPECT_EQ(UNDERLYING_STMT, stmt->wrapped_stmt);
+    EXPECT_EQ(std::vector<SQLINTEGER>{SQL_ATTR_QUERY_TIMEOUT}, set_attrs);
+    EXPECT_EQ(std::vector<SQLUSMALLINT>{1}, bound_params);
+    EXPECT_EQ(std::vector<SQLUSMALLINT>{1}, bound_cols);
+}
+
+TEST_F(StatementRestoreTest, FailedPrepareIsReported) {
+    EXPECT_CALL(*mock_odbc_helper, Prepare(_, _))
+        .WillOnce(Return(RdsLibResult{.fn_load_success = true, .fn_result = SQL_ERROR}));
+
+    EXPECT_EQ(SQL_ERROR, RDS_RestoreStmt(stmt));
+
+    // Bindings are still restored, a later prepare by the application can use them
+    EXPECT_EQ(UNDERLYING_STMT, stmt->wrapped_stmt);
+    EXPECT_EQ(std::vector<SQLUSMALLINT>{1}, bound_params);
+}
+
+TEST_F(StatementRestoreTest, UnpreparedStatementIsNotPrepared) {
+    stmt->prepared_query.reset();
+    EXPECT_CALL(*mock_odbc_helper, Prepare(_, _)).Times(0);
+
+    EXPECT_TRUE(RDS_EnsureWrappedStmt(stmt));
+    EXPECT_EQ(std::vector<SQLUSMALLINT>{1}, bound_cols);
+
+    // Already restored
+    EXPECT_TRUE(RDS_EnsureWrappedStmt(stmt));
+    EXPECT_EQ(1, bound_cols.size());
+}
+
+TEST_F(StatementRestoreTest, NoUnderlyingConnection) {
+    dbc.wrapped_dbc = SQL_NULL_HDBC;
+
+    EXPECT_FALSE(RDS_EnsureWrappedStmt(stmt));
+    EXPECT_EQ(SQL_ERROR, RDS_RestoreStmt(stmt));
+    EXPECT_TRUE(stmt->err != nullptr);
+}
+
+TEST_F(StatementRestoreTest, BindingsAreTracked) {
+    stmt->wrapped_stmt = UNDERLYING_STMT;
+
+    RDS_BindParameter(stmt, 2, ParamBinding{SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &param_value, 0, &param_ind});
+    EXPECT_EQ(2, stmt->param_bindings.size());
+
+    // Unbinding a column
+    RDS_BindCol(stmt, 1, ColBinding{SQL_C_CHAR, nullptr, 0, nullptr});
+    EXPECT_TRUE(stmt->col_bindings.empty());
+}
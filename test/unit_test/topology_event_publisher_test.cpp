@@ -0,0 +1,148 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../../driver/host_list_providers/topology_event_publisher.h"
+
+namespace {
+    const std::chrono::steady_clock::time_point NOW = std::chrono::steady_clock::now();
+    const HostInfo WRITER_A("instance-a", 5432, UP, WRITER, 0, NOW);
+    const HostInfo READER_A("instance-a", 5432, UP, READER, 0, NOW);
+    const HostInfo READER_B("instance-b", 5432, UP, READER, 0, NOW);
+    const HostInfo WRITER_B("instance-b", 5432, UP, WRITER, 0, NOW);
+    const HostInfo DOWN_READER_B("instance-b", 5432, DOWN, READER, 0, NOW);
+    const HostInfo READER_C("instance-c", 5432, UP, READER, 0, NOW);
+
+    std::vector<TopologyEvent> Drain(TopologySubscription& subscription) {
+        std::vector<TopologyEvent> events;
+        TopologyEvent event;
+        while (subscription.Poll(event)) {
+            events.push_back(event);
+        }
+        return events;
+    }
+}
+
+TEST(TopologyEventPublisherTest, InitialTopology) {
+    const std::vector<TopologyEvent> events = TopologyEventPublisher::GetEvents({}, { WRITER_A, READER_B });
+    ASSERT_EQ(3, events.size());
+    EXPECT_EQ(TopologyEvent::Type::WRITER_CHANGED, events[0].type);
+    EXPECT_TRUE(events[0].host.IsSameHost(WRITER_A));
+    EXPECT_TRUE(events[0].previous_host.GetHost().empty());
+    EXPECT_EQ(TopologyEvent::Type::HOST_ADDED, events[1].type);
+    EXPECT_EQ(TopologyEvent::Type::HOST_ADDED, events[2].type);
+}
+
+TEST(TopologyEventPublisherTest, WriterChanged) {
+    const std::vector<TopologyEvent> events = TopologyEventPublisher::GetEvents(
+        { WRITER_A, READER_B }, { READER_A, WRITER_B });
+    ASSERT_EQ(1, events.size());
+    EXPECT_EQ(TopologyEvent::Type::WRITER_CHANGED, events[0].type);
+    EXPECT_TRUE(events[0].host.IsSameHost(WRITER_B));
+    EXPECT_TRUE(events[0].previous_host.IsSameHost(WRITER_A));
+}
+
+TEST(TopologyEventPublisherTest, HostsAddedRemovedAndStateChanged) {
+    const std::vector<TopologyEvent> events = TopologyEventPublisher::GetEvents(
+        { WRITER_A, READER_B, READER_C }, { WRITER_A, DOWN_READER_B });
+    ASSERT_EQ(2, events.size());
+    EXPECT_EQ(TopologyEvent::Type::HOST_STATE_CHANGED, events[0].type);
+    EXPECT_EQ(DOWN, events[0].host.GetHostState());
+    EXPECT_EQ(UP, events[0].previous_host.GetHostState());
+    EXPECT_EQ(TopologyEvent::Type::HOST_REMOVED, events[1].type);
+    EXPECT_TRUE(events[1].host.IsSameHost(READER_C));
+
+    EXPECT_TRUE(TopologyEventPublisher::GetEvents({ WRITER_A, READER_B }, { WRITER_A, READER_B }).empty());
+}
+
+TEST(TopologyEventPublisherTest, DeliversToSubscribers) {
+    TopologyEventPublisher publisher;
+    std::atomic<int> notified = 0;
+    const std::shared_ptr<TopologySubscription> first = publisher.Subscribe([&notified] { notified++; });
+    const std::shared_ptr<TopologySubscription> second = publisher.Subscribe();
+
+    publisher.Publish({ WRITER_A, READER_B }, { READER_A, WRITER_B });
+    // No change, no notification
+    publisher.Publish({ READER_A, WRITER_B }, { READER_A, WRITER_B });
+
+    EXPECT_EQ(1, notified);
+    EXPECT_EQ(1, Drain(*first).size());
+    EXPECT_EQ(1, Drain(*second).size());
+    EXPECT_TRUE(Drain(*first).empty());
+}
+
+TEST(TopologyEventPublisherTest, ReleasedSubscriptionEnds) {
+    TopologyEventPublisher publisher;
+    std::shared_ptr<TopologySubscription> subscription = publisher.Subscribe();
+    EXPECT_EQ(1, publisher.GetSubscriptionCount());
+
+    subscription.reset();
+    EXPECT_EQ(0, publisher.GetSubscriptionCount());
+    publisher.Publish({}, { WRITER_A });
+}
+
+TEST(TopologyEventPublisherTest, OverflowIsReported) {
+    TopologyEventPublisher publisher;
+    const std::shared_ptr<TopologySubscription> subscription = publisher.Subscribe();
+    for (size_t i = 0; i < TopologySubscription::CAPACITY / 2 + 1; i++) {
+        publisher.Publish({ WRITER_A, READER_B }, { READER_A, WRITER_B });
+        publisher.Publish({ READER_A, WRITER_B }, { WRITER_A, READER_B });
+    }
+
+    EXPECT_TRUE(subscription->TakeOverflow());
+    EXPECT_FALSE(subscription->TakeOverflow());
+    EXPECT_EQ(TopologySubscription::CAPACITY, Drain(*subscription).size());
+}
+
+TEST(TopologyEventPublisherTest, ConcurrentConsumer) {
+    TopologyEventPublisher publisher;
+    const std::shared_ptr<TopologySubscription> subscription = publisher.Subscribe();
+    constexpr int PUBLISH_COUNT = 10000;
+    std::atomic<bool> done = false;
+
+    std::thread producer([&] {
+        for (int i = 0; i < PUBLISH_COUNT; i++) {
+            publisher.Publish({ WRITER_A }, { WRITER_A, READER_C });
+            publisher.Publish({ WRITER_A, READER_C }, { WRITER_A });
+        }
+        done = true;
+    });
+
+    size_t received = 0;
+    TopologyEvent event;
+    bool expect_added = true;
+    while (true) {
+        if (!subscription->Poll(event)) {
+            if (done) {
+                break;
+            }
+            continue;
+        }
+        received++;
+        // Events arrive in order until one is dropped
+        if (subscription->TakeOverflow()) {
+            break;
+        }
+        EXPECT_EQ(expect_added ? TopologyEvent::Type::HOST_ADDED : TopologyEvent::Type::HOST_REMOVED, event.type);
+        expect_added = !expect_added;
+    }
+    producer.join();
+    EXPECT_GT(received, 0);
+}
@@ -0,0 +1,183 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../driver/host_list_providers/topology_file_cache.h"
+
+namespace {
+    const std::string CLUSTER_ID = "database-cluster.cluster-xyz.us-east-1.rds.amazonaws.com";
+    const std::vector<HostInfo> HOSTS = {
+        HostInfo("instance-1.xyz.us-east-1.rds.amazonaws.com", 5432, UP, WRITER, 10),
+        HostInfo("instance-2.xyz.us-east-1.rds.amazonaws.com", 5432, UP, READER, 20),
+        HostInfo("instance-3.xyz.us-east-1.rds.amazonaws.com", 5432, DOWN, READER, 30)
+    };
+}
+
+class TopologyFileCacheTest : public testing::Test {
+protected:
+    std::filesystem::path directory;
+
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+            ("topology_file_cache_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove_all(directory, ec);
+    }
+};
+
+TEST_F(TopologyFileCacheTest, WriteAndRead) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+
+    const std::vector<HostInfo> hosts = cache.Read(CLUSTER_ID);
+    ASSERT_EQ(HOSTS.size(), hosts.size());
+    for (size_t i = 0; i < HOSTS.size(); i++) {
+        EXPECT_EQ(HOSTS[i], hosts[i]);
+    }
+
+    // Replaced by a later write
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, { HOSTS[1] }));
+    EXPECT_EQ(1, cache.Read(CLUSTER_ID).size());
+    // Only the topology file is left behind
+    EXPECT_EQ(1, std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()));
+}
+
+TEST_F(TopologyFileCacheTest, ReplicaLagIsKept) {
+    const TopologyFileCache cache(directory);
+    std::vector<HostInfo> lagging = HOSTS;
+    lagging[1].SetReplicaLag(std::chrono::milliseconds(2500));
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, lagging));
+
+    const std::vector<HostInfo> hosts = cache.Read(CLUSTER_ID);
+    ASSERT_EQ(lagging.size(), hosts.size());
+    for (size_t i = 0; i < lagging.size(); i++) {
+        EXPECT_EQ(lagging[i].GetReplicaLag(), hosts[i].GetReplicaLag());
+    }
+}
+
+TEST_F(TopologyFileCacheTest, MissingFile) {
+    const TopologyFileCache cache(directory);
+    EXPECT_TRUE(cache.Read(CLUSTER_ID).empty());
+}
+
+TEST_F(TopologyFileCacheTest, CorruptedFileIsIgnored) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+
+    const std::filesystem::path path = cache.GetPath(CLUSTER_ID);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('#');
+    }
+    EXPECT_TRUE(cache.Read(CLUSTER_ID).empty());
+
+    std::filesystem::resize_file(path, 10);
+    EXPECT_TRUE(cache.Read(CLUSTER_ID).empty());
+}
+
+TEST_F(TopologyFileCacheTest, OutdatedFileIsIgnored) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+
+    // Write time follows the checksum, and is not covered by it
+    {
+        std::fstream file(cache.GetPath(CLUSTER_ID), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(32);
+        const int64_t written_at = std::chrono::duration_cast<std::chrono::seconds>(
+            (std::chrono::system_clock::now() - std::chrono::minutes(1)).time_since_epoch()).count();
+        file.write(reinterpret_cast<const char*>(&written_at), sizeof(written_at));
+    }
+    EXPECT_EQ(HOSTS.size(), cache.Read(CLUSTER_ID).size());
+    EXPECT_EQ(HOSTS.size(), cache.Read(CLUSTER_ID, std::chrono::minutes(2)).size());
+    EXPECT_TRUE(cache.Read(CLUSTER_ID, std::chrono::seconds(30)).empty());
+}
+
+TEST_F(TopologyFileCacheTest, OversizedHostCountIsIgnored) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+
+    // Host count follows the magic and format version, and is not covered by the checksum
+    {
+        std::fstream file(cache.GetPath(CLUSTER_ID), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(12);
+        const uint32_t host_count = UINT32_MAX;
+        file.write(reinterpret_cast<const char*>(&host_count), sizeof(host_count));
+    }
+    EXPECT_TRUE(cache.Read(CLUSTER_ID).empty());
+}
+
+#ifndef WIN32
+TEST_F(TopologyFileCacheTest, FilesAreOnlyAccessibleByOwner) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+    TopologyFileLock lock(cache.GetLockPath(CLUSTER_ID));
+    ASSERT_TRUE(lock.TryLock());
+
+    const std::filesystem::perms owner_only = std::filesystem::perms::owner_read | std::filesystem::perms::owner_write;
+    EXPECT_EQ(owner_only, std::filesystem::status(cache.GetPath(CLUSTER_ID)).permissions());
+    EXPECT_EQ(owner_only, std::filesystem::status(cache.GetLockPath(CLUSTER_ID)).permissions());
+
+    // Writable by others, the topology may have been planted
+    std::filesystem::permissions(cache.GetPath(CLUSTER_ID), std::filesystem::perms::others_write, std::filesystem::perm_options::add);
+    EXPECT_TRUE(cache.Read(CLUSTER_ID).empty());
+}
+
+TEST_F(TopologyFileCacheTest, SymlinkIsNotFollowed) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+
+    const std::filesystem::path target = directory / "target";
+    std::filesystem::rename(cache.GetPath(CLUSTER_ID), target);
+    std::filesystem::create_symlink(target, cache.GetPath(CLUSTER_ID));
+    EXPECT_TRUE(cache.Read(CLUSTER_ID).empty());
+}
+#endif
+
+TEST_F(TopologyFileCacheTest, OtherClusterIsIgnored) {
+    const TopologyFileCache cache(directory);
+    ASSERT_TRUE(cache.Write(CLUSTER_ID, HOSTS));
+
+    // Simulates a file name collision
+    const std::string other_cluster_id = "other-cluster";
+    std::filesystem::rename(cache.GetPath(CLUSTER_ID), cache.GetPath(other_cluster_id));
+    EXPECT_TRUE(cache.Read(other_cluster_id).empty());
+}
+
+TEST_F(TopologyFileCacheTest, LeaderLockIsExclusive) {
+    const TopologyFileCache cache(directory);
+    auto leader = std::make_unique<TopologyFileLock>(cache.GetLockPath(CLUSTER_ID));
+    TopologyFileLock follower(cache.GetLockPath(CLUSTER_ID));
+
+    ASSERT_TRUE(leader->TryLock());
+    EXPECT_TRUE(leader->IsLocked());
+    EXPECT_FALSE(follower.TryLock());
+    EXPECT_FALSE(follower.IsLocked());
+
+    // Taken over once the leader is gone
+    leader.reset();
+    EXPECT_TRUE(follower.TryLock());
+}
@@ -0,0 +1,70 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "../../driver/host_list_providers/topology_refresh_policy.h"
+
+namespace {
+    const std::chrono::milliseconds FLOOR_MS(1000);
+    const std::chrono::milliseconds CEILING_MS(6000);
+    const std::chrono::steady_clock::time_point NOW = std::chrono::steady_clock::now();
+}
+
+TEST(TopologyRefreshPolicyTest, BacksOffWhileStable) {
+    TopologyRefreshPolicy policy(FLOOR_MS, CEILING_MS);
+    EXPECT_EQ(FLOOR_MS, policy.NextDelay(NOW));
+
+    policy.OnRefresh(false);
+    EXPECT_EQ(std::chrono::milliseconds(2000), policy.NextDelay(NOW));
+    policy.OnRefresh(false);
+    EXPECT_EQ(std::chrono::milliseconds(4000), policy.NextDelay(NOW));
+    policy.OnRefresh(false);
+    EXPECT_EQ(CEILING_MS, policy.NextDelay(NOW));
+    policy.OnRefresh(false);
+    EXPECT_EQ(CEILING_MS, policy.NextDelay(NOW));
+}
+
+TEST(TopologyRefreshPolicyTest, ChangeAndErrorResetToFloor) {
+    TopologyRefreshPolicy policy(FLOOR_MS, CEILING_MS);
+    policy.OnRefresh(false);
+    policy.OnRefresh(false);
+    policy.OnRefresh(true);
+    EXPECT_EQ(FLOOR_MS, policy.NextDelay(NOW));
+
+    policy.OnRefresh(false);
+    policy.OnConnectionError();
+    EXPECT_EQ(FLOOR_MS, policy.NextDelay(NOW));
+}
+
+TEST(TopologyRefreshPolicyTest, HintKeepsFloorUntilItEnds) {
+    TopologyRefreshPolicy policy(FLOOR_MS, CEILING_MS);
+    const std::chrono::steady_clock::time_point hint_end = NOW + std::chrono::seconds(30);
+    EXPECT_TRUE(policy.Hint(hint_end, NOW));
+    // Extending an active hint
+    EXPECT_FALSE(policy.Hint(hint_end, NOW + std::chrono::seconds(1)));
+
+    policy.OnRefresh(false);
+    policy.OnRefresh(false);
+    EXPECT_EQ(FLOOR_MS, policy.NextDelay(NOW + std::chrono::seconds(10)));
+    EXPECT_EQ(std::chrono::milliseconds(4000), policy.NextDelay(hint_end));
+}
+
+TEST(TopologyRefreshPolicyTest, CeilingBelowFloor) {
+    TopologyRefreshPolicy policy(FLOOR_MS, std::chrono::milliseconds(10));
+    policy.OnRefresh(false);
+    EXPECT_EQ(FLOOR_MS, policy.NextDelay(NOW));
+}
@@ -0,0 +1,293 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "../../driver/dialect/dialect_aurora_mysql.h"
+#include "../../driver/dialect/dialect_aurora_postgres.h"
+#include "../../driver/driver.h"
+#include "../../driver/host_list_providers/aurora_topology_util.h"
+#include "../../driver/host_list_providers/multi_az_topology_util.h"
+#include "../../driver/util/odbc_helper.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+    const RdsLibResult SUCCESS_RESULT = {.fn_load_success = true, .fn_result = SQL_SUCCESS, .fn_name = ""};
+    const RdsLibResult NO_DATA_RESULT = {.fn_load_success = true, .fn_result = SQL_NO_DATA, .fn_name = ""};
+
+    const SQLHDBC UNDERLYING_DBC = reinterpret_cast<SQLHDBC>(0x1000);
+    const HostInfo INITIAL_HOST("cluster.cluster-xyz.us-east-2.rds.amazonaws.com", 5432, UP, WRITER);
+    const HostInfo HOST_TEMPLATE("?.xyz.us-east-2.rds.amazonaws.com", HostInfo::NO_PORT, UP, WRITER);
+
+    struct TopologyRow {
+        std::string node_id;
+        bool is_writer;
+        std::string instance_id;
+        bool is_reader;
+        SQLINTEGER replica_lag_ms = 0;
+    };
+
+    // Multi-AZ layout: id, endpoint, port, connected instance id, writer id
+    struct MultiAzTopologyRow {
+        std::string node_id;
+        std::string endpoint;
+        std::string instance_id;
+        std::string writer_id;
+    };
+
+    // Null terminated ASCII copy into a bound SQLTCHAR buffer
+    void CopyToSqlTChar(void* buffer, const std::string& value) {
+        auto* text = static_cast<SQLTCHAR*>(buffer);
+        for (size_t i = 0; i < value.size(); i++) {
+            text[i] = static_cast<SQLTCHAR>(value[i]);
+        }
+        text[value.size()] = 0;
+    }
+}
+
+// Returns rows through the buffers bound by the topology util
+class MOCK_TOPOLOGY_ODBC_HELPER : public OdbcHelper {
+public:
+    MOCK_TOPOLOGY_ODBC_HELPER() : OdbcHelper(std::make_shared<RdsLibLoader>(), nullptr) {
+        ON_CALL(*this, BaseAllocStmt(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*this, BaseFreeStmt(_)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*this, Prepare(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*this, CloseCursor(_)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*this, Execute(_)).WillByDefault([this](const SQLHSTMT*) {
+            next_row = 0;
+            return SUCCESS_RESULT;
+        });
+        ON_CALL(*this, BindCol(_, _, _, _, _, _)).WillByDefault(
+            [this](const SQLHSTMT*, const int column, int, void* value, size_t, SQLLEN*) {
+                bound[column] = value;
+                return SUCCESS_RESULT;
+            });
+        ON_CALL(*this, Fetch(_)).WillByDefault([this](SQLHSTMT*) {
+            if (!multi_az_rows.empty()) {
+                if (next_row >= multi_az_rows.size()) {
+                    return NO_DATA_RESULT;
+                }
+                const MultiAzTopologyRow& row = multi_az_rows[next_row++];
+                CopyToSqlTChar(bound[1], row.node_id);
+                CopyToSqlTChar(bound[2], row.endpoint);
+                CopyToSqlTChar(bound[4], row.instance_id);
+                CopyToSqlTChar(bound[5], row.writer_id);
+                return SUCCESS_RESULT;
+            }
+            if (next_row >= rows.size()) {
+                return NO_DATA_RESULT;
+            }
+            const TopologyRow& row = rows[next_row++];
+            CopyToSqlTChar(bound[1], row.node_id);
+            *static_cast<bool*>(bound[2]) = row.is_writer;
+            *static_cast<SQLREAL*>(bound[3]) = 0;
+            *static_cast<SQLINTEGER*>(bound[4]) = row.replica_lag_ms;
+            if (bound.contains(5)) {
+                CopyToSqlTChar(bound[5], row.instance_id);
+                *static_cast<bool*>(bound[6]) = row.is_reader;
+            }
+            return SUCCESS_RESULT;
+        });
+    }
+
+    MOCK_METHOD(RdsLibResult, BaseAllocStmt, (const SQLHDBC *wrapped_dbc, SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, BaseFreeStmt, (SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, Prepare, (const SQLHSTMT *stmt, const std::string &query), (override));
+    MOCK_METHOD(RdsLibResult, Execute, (const SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, BindCol, (const SQLHSTMT *stmt, int column, int type, void *value, size_t size, SQLLEN *len), (override));
+    MOCK_METHOD(RdsLibResult, Fetch, (SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, CloseCursor, (SQLHSTMT stmt), (override));
+
+    std::vector<TopologyRow> rows;
+    std::vector<MultiAzTopologyRow> multi_az_rows;
+    size_t next_row = 0;
+    std::map<int, void*> bound;
+};
+
+// Identity queries of dialects without a combined query
+class MOCK_IDENTITY_TOPOLOGY_UTIL : public AuroraTopologyUtil {
+public:
+    MOCK_IDENTITY_TOPOLOGY_UTIL(const std::shared_ptr<OdbcHelper> &odbc_helper, const std::shared_ptr<Dialect> &dialect)
+        : AuroraTopologyUtil(odbc_helper, dialect) {};
+    MOCK_METHOD(std::string, GetInstanceId, (SQLHDBC hdbc), (override));
+    MOCK_METHOD(HOST_ROLE, GetConnectionRole, (SQLHDBC hdbc), (override));
+};
+
+// Aurora dialect of a server without the combined query
+class DIALECT_AURORA_WITHOUT_IDENTITY_QUERY : public DialectAuroraMySql {
+public:
+    std::string GetTopologyAndIdentityQuery() override { return ""; };
+};
+
+class TopologyUtilTest : public testing::Test {
+protected:
+    std::shared_ptr<NiceMock<MOCK_TOPOLOGY_ODBC_HELPER>> odbc_helper;
+    DBC dbc;
+
+    void SetUp() override {
+        odbc_helper = std::make_shared<NiceMock<MOCK_TOPOLOGY_ODBC_HELPER>>();
+        odbc_helper->rows = {
+            {"instance-1", true, "instance-2", true},
+            {"instance-2", false, "instance-2", true}
+        };
+
+        dbc.wrapped_dbc = UNDERLYING_DBC;
+        dbc.conn_status = CONN_CONNECTED;
+        dbc.conn_attr.insert_or_assign(KEY_MONITORING_CONN_UUID, "monitoring-uuid");
+    }
+
+    void TearDown() override {
+        dbc.monitoring_session.reset();
+        dbc.wrapped_dbc = SQL_NULL_HDBC;
+    }
+};
+
+TEST_F(TopologyUtilTest, CombinedQueryIsSingleRoundTrip) {
+    const std::shared_ptr<Dialect> dialect = std::make_shared<DialectAuroraPostgres>();
+    AuroraTopologyUtil topology_util(odbc_helper, dialect);
+    EXPECT_CALL(*odbc_helper, Prepare(_, dialect->GetTopologyAndIdentityQuery())).Times(1);
+    EXPECT_CALL(*odbc_helper, Execute(_)).Times(1);
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    EXPECT_EQ("instance-2", fetched.instance_id);
+    EXPECT_EQ(READER, fetched.role);
+    ASSERT_EQ(2, fetched.hosts.size());
+    EXPECT_EQ("instance-1.xyz.us-east-2.rds.amazonaws.com", topology_util.GetWriter(fetched.hosts).GetHost());
+}
+
+TEST_F(TopologyUtilTest, ConnectedToWriter) {
+    odbc_helper->rows = {{"instance-1", true, "instance-1", false}};
+    AuroraTopologyUtil topology_util(odbc_helper, std::make_shared<DialectAuroraMySql>());
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    EXPECT_EQ("instance-1", fetched.instance_id);
+    EXPECT_EQ(WRITER, fetched.role);
+    EXPECT_EQ(1, fetched.hosts.size());
+}
+
+TEST_F(TopologyUtilTest, SeparateQueriesWithoutCombinedQuery) {
+    const std::shared_ptr<Dialect> dialect = std::make_shared<DIALECT_AURORA_WITHOUT_IDENTITY_QUERY>();
+    ASSERT_TRUE(dialect->GetTopologyAndIdentityQuery().empty());
+    MOCK_IDENTITY_TOPOLOGY_UTIL topology_util(odbc_helper, dialect);
+    EXPECT_CALL(topology_util, GetInstanceId(_)).WillOnce(Return("instance-2"));
+    EXPECT_CALL(topology_util, GetConnectionRole(_)).WillOnce(Return(READER));
+    EXPECT_CALL(*odbc_helper, Prepare(_, dialect->GetTopologyQuery())).Times(1);
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    EXPECT_FALSE(fetched.query_failed);
+    EXPECT_EQ("instance-2", fetched.instance_id);
+    EXPECT_EQ(READER, fetched.role);
+    EXPECT_EQ(2, fetched.hosts.size());
+}
+
+TEST_F(TopologyUtilTest, SeparateQueriesWithoutInstanceIdFailed) {
+    MOCK_IDENTITY_TOPOLOGY_UTIL topology_util(odbc_helper, std::make_shared<DIALECT_AURORA_WITHOUT_IDENTITY_QUERY>());
+    EXPECT_CALL(topology_util, GetInstanceId(_)).WillOnce(Return(""));
+    EXPECT_CALL(topology_util, GetConnectionRole(_)).Times(0);
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    EXPECT_TRUE(fetched.query_failed);
+    EXPECT_TRUE(fetched.hosts.empty());
+}
+
+TEST_F(TopologyUtilTest, InvalidConnectionIsNotQueried) {
+    AuroraTopologyUtil topology_util(odbc_helper, std::make_shared<DialectAuroraPostgres>());
+    EXPECT_CALL(*odbc_helper, Execute(_)).Times(0);
+
+    dbc.conn_status = CONN_NOT_CONNECTED;
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+    EXPECT_TRUE(fetched.query_failed);
+    EXPECT_TRUE(fetched.instance_id.empty());
+    EXPECT_TRUE(fetched.hosts.empty());
+}
+
+TEST_F(TopologyUtilTest, NoRowsHasNoIdentity) {
+    odbc_helper->rows.clear();
+    AuroraTopologyUtil topology_util(odbc_helper, std::make_shared<DialectAuroraPostgres>());
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+    // The connection answered, it is not treated as dead
+    EXPECT_FALSE(fetched.query_failed);
+    EXPECT_TRUE(fetched.instance_id.empty());
+    EXPECT_TRUE(fetched.hosts.empty());
+}
+
+TEST_F(TopologyUtilTest, FailedQueryIsFlagged) {
+    ON_CALL(*odbc_helper, Execute(_)).WillByDefault(Return(RdsLibResult{.fn_load_success = true, .fn_result = SQL_ERROR, .fn_name = ""}));
+    AuroraTopologyUtil topology_util(odbc_helper, std::make_shared<DialectAuroraPostgres>());
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+    EXPECT_TRUE(fetched.query_failed);
+    EXPECT_TRUE(fetched.hosts.empty());
+}
+
+TEST_F(TopologyUtilTest, MultiAzConnectedToWriter) {
+    odbc_helper->multi_az_rows = {
+        {"db-1", "instance-1.xyz.us-east-2.rds.amazonaws.com", "db-1", "db-1"},
+        {"db-2", "instance-2.xyz.us-east-2.rds.amazonaws.com", "db-1", "db-1"}
+    };
+    const std::shared_ptr<Dialect> dialect = std::make_shared<DialectMultiAzClusterPostgres>();
+    MultiAzTopologyUtil topology_util(odbc_helper, dialect);
+    EXPECT_CALL(*odbc_helper, Prepare(_, dialect->GetTopologyAndIdentityQuery())).Times(1);
+    EXPECT_CALL(*odbc_helper, Execute(_)).Times(1);
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    EXPECT_FALSE(fetched.query_failed);
+    EXPECT_EQ("db-1", fetched.instance_id);
+    EXPECT_EQ(WRITER, fetched.role);
+    ASSERT_EQ(2, fetched.hosts.size());
+    EXPECT_EQ("instance-1.xyz.us-east-2.rds.amazonaws.com", topology_util.GetWriter(fetched.hosts).GetHost());
+}
+
+TEST_F(TopologyUtilTest, MultiAzConnectedToReader) {
+    odbc_helper->multi_az_rows = {
+        {"db-1", "instance-1.xyz.us-east-2.rds.amazonaws.com", "db-2", "db-1"},
+        {"db-2", "instance-2.xyz.us-east-2.rds.amazonaws.com", "db-2", "db-1"}
+    };
+    MultiAzTopologyUtil topology_util(odbc_helper, std::make_shared<DialectMultiAzClusterPostgres>());
+
+    const TopologyUtil::TopologyAndIdentity fetched = topology_util.QueryTopologyAndIdentity(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    EXPECT_FALSE(fetched.query_failed);
+    EXPECT_EQ("db-2", fetched.instance_id);
+    EXPECT_EQ(READER, fetched.role);
+    ASSERT_EQ(2, fetched.hosts.size());
+    EXPECT_EQ("instance-1.xyz.us-east-2.rds.amazonaws.com", topology_util.GetWriter(fetched.hosts).GetHost());
+}
+
+TEST_F(TopologyUtilTest, ReaderReplicaLagIsCaptured) {
+    odbc_helper->rows = {
+        {"instance-1", true, "instance-1", false, 0},
+        {"instance-2", false, "instance-1", false, 2500}
+    };
+    AuroraTopologyUtil topology_util(odbc_helper, std::make_shared<DialectAuroraPostgres>());
+
+    const std::vector<HostInfo> hosts = topology_util.QueryTopology(&dbc, INITIAL_HOST, HOST_TEMPLATE);
+
+    ASSERT_EQ(2, hosts.size());
+    for (const HostInfo& host : hosts) {
+        EXPECT_EQ(host.IsHostWriter() ? std::chrono::milliseconds(0) : std::chrono::milliseconds(2500), host.GetReplicaLag());
+    }
+}
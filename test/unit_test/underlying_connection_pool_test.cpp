@@ -0,0 +1,290 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "../../driver/host_list_providers/host_list_provider.h"
+#include "../../driver/util/connection_string_keys.h"
+#include "../../driver/util/monitoring_scheduler.h"
+#include "../../driver/util/odbc_helper.h"
+#include "../../driver/util/underlying_connection_pool.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+
+namespace {
+    const RdsLibResult SUCCESS_RESULT = {.fn_load_success = true, .fn_result = SQL_SUCCESS, .fn_name = ""};
+    const RdsLibResult ERROR_RESULT = {.fn_load_success = true, .fn_result = SQL_ERROR, .fn_name = ""};
+
+    const std::string POOL_KEY = "pool_key";
+    const std::string RESET_QUERY = "DISCARD ALL";
+    const ENV* const POOL_ENV = reinterpret_cast<const ENV*>(0x10);
+    const ENV* const OTHER_ENV = reinterpret_cast<const ENV*>(0x20);
+    const SQLHDBC CONN_A = reinterpret_cast<SQLHDBC>(0x1);
+    const SQLHDBC CONN_B = reinterpret_cast<SQLHDBC>(0x2);
+}
+
+class MOCK_POOL_ODBC_HELPER : public OdbcHelper {
+public:
+    MOCK_POOL_ODBC_HELPER() : OdbcHelper(std::make_shared<RdsLibLoader>(), nullptr) {};
+    MOCK_METHOD(bool, BaseIsClosed, (SQLHDBC wrapped_dbc), (override));
+    MOCK_METHOD(RdsLibResult, BaseEndTran, (SQLHDBC wrapped_dbc, SQLSMALLINT completion_type), (override));
+    MOCK_METHOD(RdsLibResult, BaseSetConnectAttr, (SQLHDBC wrapped_dbc, SQLINTEGER attribute, SQLPOINTER value, SQLINTEGER length), (override));
+    MOCK_METHOD(void, BaseDisconnectAndFree, (SQLHDBC wrapped_dbc), (override));
+    MOCK_METHOD(RdsLibResult, BaseAllocStmt, (const SQLHDBC *wrapped_dbc, SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, BaseFreeStmt, (SQLHSTMT *stmt), (override));
+    MOCK_METHOD(RdsLibResult, ExecDirect, (const SQLHSTMT *stmt, const std::string &query), (override));
+};
+
+class TEST_TOPOLOGY_PROVIDER : public HostListProvider {
+public:
+    TEST_TOPOLOGY_PROVIDER() : HostListProvider("cluster") {}
+    std::shared_ptr<TopologySubscription> Subscribe(std::function<void()> on_event) override {
+        return publisher.Subscribe(std::move(on_event));
+    }
+
+    TopologyEventPublisher publisher;
+};
+
+class UnderlyingConnectionPoolTest : public testing::Test {
+protected:
+    std::shared_ptr<NiceMock<MOCK_POOL_ODBC_HELPER>> mock_odbc_helper;
+    ConnectionPoolConfig config;
+
+    void SetUp() override {
+        mock_odbc_helper = std::make_shared<NiceMock<MOCK_POOL_ODBC_HELPER>>();
+        ON_CALL(*mock_odbc_helper, BaseIsClosed(_)).WillByDefault(Return(false));
+        ON_CALL(*mock_odbc_helper, BaseEndTran(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*mock_odbc_helper, BaseSetConnectAttr(_, _, _, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*mock_odbc_helper, BaseAllocStmt(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*mock_odbc_helper, BaseFreeStmt(_)).WillByDefault(Return(SUCCESS_RESULT));
+        ON_CALL(*mock_odbc_helper, ExecDirect(_, _)).WillByDefault(Return(SUCCESS_RESULT));
+
+        config.enabled = true;
+        config.max_idle_per_host = 4;
+        config.idle_timeout = std::chrono::minutes(5);
+    }
+};
+
+TEST_F(UnderlyingConnectionPoolTest, ConfigFromConnAttr) {
+    const ConnectionPoolConfig defaults = ConnectionPoolConfig::FromConnAttr({});
+    EXPECT_FALSE(defaults.enabled);
+    EXPECT_EQ(ConnectionPoolConfig::DEFAULT_MAX_IDLE_PER_HOST, defaults.max_idle_per_host);
+    EXPECT_EQ(ConnectionPoolConfig::DEFAULT_IDLE_TIMEOUT_MS, defaults.idle_timeout);
+    EXPECT_EQ(OdbcHelper::DEFAULT_VALIDATION_FRESHNESS_MS, defaults.validation_freshness);
+
+    const ConnectionPoolConfig configured = ConnectionPoolConfig::FromConnAttr({
+        {KEY_ENABLE_CONNECTION_POOL, VALUE_BOOL_TRUE},
+        {KEY_POOL_MAX_IDLE_PER_HOST, "2"},
+        {KEY_POOL_IDLE_TIMEOUT_MS, "1000"},
+        {KEY_VALIDATION_FRESHNESS_MS, "0"}
+    });
+    EXPECT_TRUE(configured.enabled);
+    EXPECT_EQ(2, configured.max_idle_per_host);
+    EXPECT_EQ(std::chrono::milliseconds(1000), configured.idle_timeout);
+    EXPECT_EQ(std::chrono::milliseconds(0), configured.validation_freshness);
+}
+
+TEST_F(UnderlyingConnectionPoolTest, PoolKeyConnectionString) {
+    const std::map<std::string, std::string> conn_attr = {
+        {KEY_SERVER, "instance-1.xyz.us-east-2.rds.amazonaws.com"},
+        {KEY_DB_USERNAME, "user"},
+        {KEY_DB_PASSWORD, "password"}
+    };
+    const std::string key = UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, conn_attr);
+
+    EXPECT_EQ(key, UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, conn_attr));
+    EXPECT_EQ(std::string::npos, key.find("password"));
+
+    std::map<std::string, std::string> other_password = conn_attr;
+    other_password[KEY_DB_PASSWORD] = "wrong";
+    EXPECT_NE(key, UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, other_password));
+
+    std::map<std::string, std::string> other_driver_option = conn_attr;
+    other_driver_option["SSLMODE"] = "disable";
+    EXPECT_NE(key, UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, other_driver_option));
+
+    std::map<std::string, std::string> other_host = conn_attr;
+    other_host[KEY_SERVER] = "instance-2.xyz.us-east-2.rds.amazonaws.com";
+    EXPECT_NE(key, UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, other_host));
+
+    std::map<std::string, std::string> other_user = conn_attr;
+    other_user[KEY_DB_USERNAME] = "admin";
+    EXPECT_NE(key, UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, other_user));
+
+    EXPECT_NE(key, UnderlyingConnectionPool::BuildPoolKey(OTHER_ENV, conn_attr));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, BorrowMostRecentlyReturned) {
+    UnderlyingConnectionPool pool;
+    EXPECT_EQ(SQL_NULL_HDBC, pool.Borrow(POOL_KEY));
+
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_B, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_EQ(2, pool.GetIdleCount(POOL_KEY));
+
+    EXPECT_EQ(CONN_B, pool.Borrow(POOL_KEY));
+    EXPECT_EQ(CONN_A, pool.Borrow(POOL_KEY));
+    EXPECT_EQ(SQL_NULL_HDBC, pool.Borrow(POOL_KEY));
+    EXPECT_EQ(SQL_NULL_HDBC, pool.Borrow("other_key"));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, ReturnResetsSession) {
+    UnderlyingConnectionPool pool;
+    EXPECT_CALL(*mock_odbc_helper, BaseEndTran(CONN_A, SQL_ROLLBACK)).WillOnce(Return(SUCCESS_RESULT));
+    EXPECT_CALL(*mock_odbc_helper, BaseSetConnectAttr(CONN_A, SQL_ATTR_AUTOCOMMIT, _, _)).WillOnce(Return(SUCCESS_RESULT));
+    EXPECT_CALL(*mock_odbc_helper, ExecDirect(_, "DISCARD ALL")).WillOnce(Return(SUCCESS_RESULT));
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(_)).Times(0);
+
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, "DISCARD ALL"));
+    EXPECT_EQ(1, pool.GetIdleCount(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, FailedResetClosesConnection) {
+    UnderlyingConnectionPool pool;
+    EXPECT_CALL(*mock_odbc_helper, ExecDirect(_, _)).WillOnce(Return(ERROR_RESULT));
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+
+    EXPECT_FALSE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, "DISCARD ALL"));
+    EXPECT_EQ(0, pool.GetIdleCount(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, DisabledClosesConnection) {
+    UnderlyingConnectionPool pool;
+    config.enabled = false;
+    EXPECT_CALL(*mock_odbc_helper, BaseEndTran(_, _)).Times(0);
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+
+    EXPECT_FALSE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_EQ(SQL_NULL_HDBC, pool.Borrow(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, NoResetQueryClosesConnection) {
+    UnderlyingConnectionPool pool;
+    EXPECT_CALL(*mock_odbc_helper, BaseEndTran(_, _)).Times(0);
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+
+    EXPECT_FALSE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, ""));
+    EXPECT_EQ(SQL_NULL_HDBC, pool.Borrow(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, MaxIdlePerHostClosesOldest) {
+    UnderlyingConnectionPool pool;
+    config.max_idle_per_host = 1;
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_B)).Times(0);
+
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_B, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_EQ(1, pool.GetIdleCount(POOL_KEY));
+    EXPECT_EQ(CONN_B, pool.Borrow(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, BorrowSkipsDeadConnections) {
+    UnderlyingConnectionPool pool;
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_B, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+
+    EXPECT_CALL(*mock_odbc_helper, BaseIsClosed(CONN_B)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_odbc_helper, BaseIsClosed(CONN_A)).WillOnce(Return(false));
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_B)).Times(1);
+
+    EXPECT_EQ(CONN_A, pool.Borrow(POOL_KEY));
+    EXPECT_EQ(0, pool.GetIdleCount(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, BorrowSkipsValidationOfFreshConnections) {
+    UnderlyingConnectionPool pool;
+    config.validation_freshness = std::chrono::minutes(1);
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+
+    EXPECT_CALL(*mock_odbc_helper, BaseIsClosed(_)).Times(0);
+    EXPECT_EQ(CONN_A, pool.Borrow(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, IdleTimeoutEvictsConnections) {
+    UnderlyingConnectionPool pool;
+    config.idle_timeout = std::chrono::milliseconds(0);
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+    pool.EvictIdle();
+    EXPECT_EQ(0, pool.GetIdleCount(POOL_KEY));
+    EXPECT_EQ(SQL_NULL_HDBC, pool.Borrow(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, ScheduledEvictionClosesIdleConnections) {
+    const std::shared_ptr<MonitoringScheduler> scheduler = std::make_shared<MonitoringScheduler>(1, std::chrono::milliseconds(1));
+    UnderlyingConnectionPool pool(scheduler);
+    config.idle_timeout = std::chrono::milliseconds(20);
+
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+
+    // Neither borrowed nor returned again, the eviction runs on its own
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pool.GetIdleCount(POOL_KEY) > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(0, pool.GetIdleCount(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, ScheduledEvictionKeepsFreshConnections) {
+    const std::shared_ptr<MonitoringScheduler> scheduler = std::make_shared<MonitoringScheduler>(1, std::chrono::milliseconds(1));
+    UnderlyingConnectionPool pool(scheduler);
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(1, pool.GetIdleCount(POOL_KEY));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, ClearOnlyFreesEnvConnections) {
+    UnderlyingConnectionPool pool;
+    EXPECT_TRUE(pool.Return(POOL_KEY, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY));
+    EXPECT_TRUE(pool.Return("other_key", CONN_B, OTHER_ENV, mock_odbc_helper, config, RESET_QUERY));
+
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_B)).Times(0);
+    pool.Clear(POOL_ENV);
+
+    EXPECT_EQ(0, pool.GetIdleCount(POOL_KEY));
+    EXPECT_EQ(1, pool.GetIdleCount("other_key"));
+}
+
+TEST_F(UnderlyingConnectionPoolTest, RemovedHostEvictsConnections) {
+    UnderlyingConnectionPool pool;
+    const HostInfo removed_host("instance-1.xyz.us-east-2.rds.amazonaws.com", 5432, UP, READER);
+    const HostInfo kept_host("instance-2.xyz.us-east-2.rds.amazonaws.com", 5432, UP, WRITER);
+    const std::string removed_key = UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, {{KEY_SERVER, removed_host.GetHost()}});
+    const std::string kept_key = UnderlyingConnectionPool::BuildPoolKey(POOL_ENV, {{KEY_SERVER, kept_host.GetHost()}});
+    const std::shared_ptr<TEST_TOPOLOGY_PROVIDER> provider = std::make_shared<TEST_TOPOLOGY_PROVIDER>();
+    EXPECT_TRUE(pool.Return(removed_key, CONN_A, POOL_ENV, mock_odbc_helper, config, RESET_QUERY, provider));
+    EXPECT_TRUE(pool.Return(kept_key, CONN_B, POOL_ENV, mock_odbc_helper, config, RESET_QUERY, provider));
+    EXPECT_EQ(2, provider->publisher.GetSubscriptionCount());
+
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_A)).Times(1);
+    EXPECT_CALL(*mock_odbc_helper, BaseDisconnectAndFree(CONN_B)).Times(0);
+    provider->publisher.Publish({ kept_host, removed_host }, { kept_host });
+    pool.EvictIdle();
+
+    EXPECT_EQ(0, pool.GetIdleCount(removed_key));
+    EXPECT_EQ(1, pool.GetIdleCount(kept_key));
+    // The subscription ends with the connections of the host
+    EXPECT_EQ(1, provider->publisher.GetSubscriptionCount());
+}